@@ -4,8 +4,10 @@
  *	  Functions for building a cache of Oids.
  *
  * The temporal extension builds a cache of OIDs in global arrays in order to 
- * avoid (slow) lookups. The global arrays are initialized at the loading 
- * of the extension.
+ * avoid (slow) lookups. The global arrays are initialized on first use from
+ * the schema in which the extension is installed, and are reset by syscache
+ * and relcache invalidation callbacks. The operator Oids are only loaded
+ * when an operator is requested for the first time.
  *
  * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
  *		Universite Libre de Bruxelles
@@ -20,6 +22,9 @@
 #include <postgres.h>
 #include <catalog/pg_type.h>
 
+/* Name of the extension as registered in pg_extension */
+#define EXTENSION_NAME "mobilitydb"
+
 /*
  * The list of built-in and temporal types that must be cached. 
  */
@@ -112,6 +117,7 @@ typedef enum
 extern Oid type_oid(CachedType t);
 extern Oid oper_oid(CachedOp op, CachedType lt, CachedType rt);
 extern void populate_oidcache();
+extern void populate_opcache();
 
 extern Datum fill_opcache(PG_FUNCTION_ARGS);
 
@@ -62,6 +62,7 @@ extern Datum period_timespan(PG_FUNCTION_ARGS);
 extern Datum period_eq(PG_FUNCTION_ARGS);
 extern Datum period_ne(PG_FUNCTION_ARGS);
 extern Datum period_cmp(PG_FUNCTION_ARGS);
+extern Datum period_sortsupport(PG_FUNCTION_ARGS);
 extern Datum period_lt(PG_FUNCTION_ARGS);
 extern Datum period_le(PG_FUNCTION_ARGS);
 extern Datum period_ge(PG_FUNCTION_ARGS);
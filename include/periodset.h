@@ -75,6 +75,7 @@ extern PeriodSet *periodset_shift_internal(PeriodSet *ps, Interval *interval);
 /* Functions for defining B-tree index */
 
 extern Datum periodset_cmp(PG_FUNCTION_ARGS);
+extern Datum periodset_sortsupport(PG_FUNCTION_ARGS);
 extern Datum periodset_eq(PG_FUNCTION_ARGS);
 extern Datum periodset_ne(PG_FUNCTION_ARGS);
 extern Datum periodset_lt(PG_FUNCTION_ARGS);
@@ -83,6 +83,8 @@ struct temporal_duration_struct
 #define MOBDB_FLAGS_GET_Z(flags) 			((bool) (((flags) & 0x08)>>3))
 #define MOBDB_FLAGS_GET_T(flags) 			((bool) (((flags) & 0x10)>>4))
 #define MOBDB_FLAGS_GET_GEODETIC(flags) 	((bool) (((flags) & 0x20)>>5))
+/* The following flag is only used for TemporalSeq */
+#define MOBDB_FLAGS_GET_BLOCKS(flags) 		((bool) (((flags) & 0x40)>>6))
 
 #define MOBDB_FLAGS_SET_LINEAR(flags, value) \
 	((flags) = (value) ? ((flags) | 0x01) : ((flags) & 0xFE))
@@ -97,6 +99,9 @@ struct temporal_duration_struct
 	((flags) = (value) ? ((flags) | 0x10) : ((flags) & 0xEF))
 #define MOBDB_FLAGS_SET_GEODETIC(flags, value) \
 	((flags) = (value) ? ((flags) | 0x20) : ((flags) & 0xDF))
+/* The following flag is only used for TemporalSeq */
+#define MOBDB_FLAGS_SET_BLOCKS(flags, value) \
+	((flags) = (value) ? ((flags) | 0x40) : ((flags) & 0xBF))
 
 /*****************************************************************************
  * Struct definitions
@@ -370,6 +375,14 @@ extern Datum temporal_start_timestamp(PG_FUNCTION_ARGS);
 extern Datum temporal_end_timestamp(PG_FUNCTION_ARGS);
 extern Datum temporal_timestamp_n(PG_FUNCTION_ARGS);
 extern Datum temporal_shift(PG_FUNCTION_ARGS);
+extern Datum temporal_resample(PG_FUNCTION_ARGS);
+extern Datum temporal_time_split(PG_FUNCTION_ARGS);
+extern Datum tfloat_simplify(PG_FUNCTION_ARGS);
+
+extern int temporal_time_split_internal(Temporal *temp, TimestampTz origin,
+	int64 width, Temporal ***fragments, TimestampTz **buckets);
+extern Temporal *temporal_simplify_internal(Temporal *temp, double eps,
+	bool synchronized, bool streaming);
 
 extern Datum temporal_ever_eq(PG_FUNCTION_ARGS);
 extern Datum temporal_ever_ne(PG_FUNCTION_ARGS);
@@ -409,6 +422,8 @@ extern Datum temporal_minus_max(PG_FUNCTION_ARGS);
 extern Datum temporal_at_timestamp(PG_FUNCTION_ARGS);
 extern Datum temporal_minus_timestamp(PG_FUNCTION_ARGS);
 extern Datum temporal_value_at_timestamp(PG_FUNCTION_ARGS);
+extern Datum temporal_values_at_timestamps(PG_FUNCTION_ARGS);
+extern Datum temporal_values_at_timestampset(PG_FUNCTION_ARGS);
 extern Datum temporal_at_timestampset(PG_FUNCTION_ARGS);
 extern Datum temporal_minus_timestampset(PG_FUNCTION_ARGS);
 extern Datum temporal_at_period(PG_FUNCTION_ARGS);
@@ -422,10 +437,14 @@ extern Datum temporal_intersects_periodset(PG_FUNCTION_ARGS);
  
 extern Temporal *temporal_at_min_internal(Temporal *temp);
 extern TemporalInst *temporal_at_timestamp_internal(Temporal *temp, TimestampTz t);
+extern Temporal *temporal_at_period_internal(Temporal *temp, Period *p);
 extern Temporal *temporal_at_periodset_internal(Temporal *temp, PeriodSet *ps);
 extern void temporal_period(Period *p, Temporal *temp);
 extern char *temporal_to_string(Temporal *temp, char *(*value_out)(Oid, Datum));
 extern void temporal_bbox(void *box, const Temporal *temp);
+extern void temporal_bbox_slice(void *box, Datum value);
+extern void temporal_period_slice(Period *p, Datum value);
+extern Temporal *temporal_detoast_period(Datum value, Period *p);
 
 /* Comparison functions */
 
@@ -435,9 +454,12 @@ extern Datum temporal_eq(PG_FUNCTION_ARGS);
 extern Datum temporal_ge(PG_FUNCTION_ARGS);
 extern Datum temporal_gt(PG_FUNCTION_ARGS);
 extern Datum temporal_cmp(PG_FUNCTION_ARGS);
+extern Datum temporal_sortsupport(PG_FUNCTION_ARGS);
 extern Datum temporal_hash(PG_FUNCTION_ARGS);
+extern Datum temporal_hash_extended(PG_FUNCTION_ARGS);
 
 extern uint32 temporal_hash_internal(const Temporal *temp);
+extern uint64 temporal_hash_extended_internal(const Temporal *temp, uint64 seed);
 
 /*****************************************************************************/
 
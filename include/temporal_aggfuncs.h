@@ -15,6 +15,7 @@
 
 #include <postgres.h>
 #include <catalog/pg_type.h>
+#include <storage/buffile.h>
 #include "temporal.h"
 
 /*****************************************************************************/
@@ -33,6 +34,20 @@ typedef struct
 	int next[SKIPLIST_MAXLEVEL];
 } Elem;
 
+/*
+ * Temporary files keeping the runs spilled by a skip list, one file per run.
+ * It is allocated in the aggregation context, which closes the files when it
+ * is reset.
+ */
+typedef struct
+{
+	MemoryContextCallback callback;
+	BufFile **files;
+	int *lengths;				/* number of values of each run */
+	int count;
+	int maxcount;
+} SkipListSpill;
+
 typedef struct
 {
 	int capacity;
@@ -45,6 +60,10 @@ typedef struct
 	void *extra;
 	size_t extrasize;
 	Elem *elems;
+	size_t memsize;				/* size of the values in memory */
+	SkipListSpill *spill;		/* runs spilled to disk when exceeding work_mem */
+	Datum (*func)(Datum, Datum);	/* aggregate function of the runs */
+	bool crossings;
 } SkipList;
 
 /*****************************************************************************/
@@ -109,6 +128,15 @@ extern Datum ttext_tmin_combinefn(PG_FUNCTION_ARGS);
 extern Datum ttext_tmax_transfn(PG_FUNCTION_ARGS);
 extern Datum ttext_tmax_combinefn(PG_FUNCTION_ARGS);
 
+extern Datum temporal_tcount_bins_transfn(PG_FUNCTION_ARGS);
+extern Datum tnumber_tsum_bins_transfn(PG_FUNCTION_ARGS);
+extern Datum temporal_bins_combinefn(PG_FUNCTION_ARGS);
+extern Datum temporal_bins_serialize(PG_FUNCTION_ARGS);
+extern Datum temporal_bins_deserialize(PG_FUNCTION_ARGS);
+extern Datum temporal_tcount_bins_finalfn(PG_FUNCTION_ARGS);
+extern Datum tnumber_tsum_bins_finalfn(PG_FUNCTION_ARGS);
+extern Datum tnumber_tavg_bins_finalfn(PG_FUNCTION_ARGS);
+
 /*****************************************************************************/
 
 #endif
@@ -17,6 +17,7 @@
 #include <commands/vacuum.h>
 #include <utils/rangetypes.h>
 #include <parser/parse_oper.h>
+#include <utils/timestamp.h>
 #include <statistics/extended_stats_internal.h>
 
 /* 
@@ -66,6 +67,40 @@ typedef struct
 	void *std_extra_data;
 } TemporalAnalyzeExtraData;
 
+/* 
+ * It is not possible to represent the joint distribution of the value and 
+ * time dimensions of temporal numbers with the standard statistics kinds and
+ * thus it is necessary to define a new stakind
+ */
+#define STATISTIC_KIND_TBOX_HISTOGRAM  10
+
+/* Maximum number of cells of the histogram in each dimension */
+#define TBOX_STATS_MAX_BINS  100
+
+/*
+ * Convert a timestamp into the coordinate of the time dimension of a
+ * histogram, expressed in seconds since the PostgreSQL epoch
+ */
+#define STATS_TIMESTAMP(t) ((float4) ((double) (t) / USECS_PER_SEC))
+
+/*
+ * Two-dimensional histogram of the bounding boxes of temporal numbers, 
+ * stored in the stanumbers array of a statistics slot. Each cell contains 
+ * the proportion of the sample boxes that overlaps the cell, so that the sum
+ * of all the cells is equal to the number of features in the histogram.
+ */
+typedef struct
+{
+	float4		xsize;			/* number of cells in the value dimension */
+	float4		tsize;			/* number of cells in the time dimension */
+	float4		xmin;			/* extent of the value dimension */
+	float4		xmax;
+	float4		tmin;			/* extent of the time dimension */
+	float4		tmax;
+	float4		features;		/* number of features in the histogram */
+	float4		value[1];		/* cells, the value dimension varies fastest */
+} TBOX_STATS;
+
 /*
  * Extra information used by the default analysis routines
  */
@@ -30,6 +30,7 @@ extern Datum tor_tbool_bool(PG_FUNCTION_ARGS);
 extern Datum tor_tbool_tbool(PG_FUNCTION_ARGS);
 
 extern Datum tnot_tbool(PG_FUNCTION_ARGS);
+extern Datum tbool_when_true(PG_FUNCTION_ARGS);
 
 
 /*****************************************************************************/
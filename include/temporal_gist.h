@@ -20,6 +20,7 @@
 
 extern Datum gist_temporal_consistent(PG_FUNCTION_ARGS);
 extern Datum gist_temporal_compress(PG_FUNCTION_ARGS);
+extern Datum temporal_hilbert_key(PG_FUNCTION_ARGS);
 
 /*****************************************************************************/
 
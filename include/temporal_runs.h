@@ -0,0 +1,60 @@
+/*****************************************************************************
+ *
+ * temporal_runs.h
+ *	  Run-length representation of temporal values with stepwise
+ *	  interpolation.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_RUNS_H__
+#define __TEMPORAL_RUNS_H__
+
+#include <postgres.h>
+#include <catalog/pg_type.h>
+#include "timetypes.h"
+#include "temporal.h"
+
+/*****************************************************************************/
+
+/* Maximal period during which a stepwise temporal value is constant */
+
+typedef struct
+{
+	Period		period;
+	Datum		value;
+} TemporalRun;
+
+/* Ordered and non-overlapping runs, adjacent runs have different values.
+ * The values are not copied, they point to the memory of the caller */
+
+typedef struct
+{
+	Oid			valuetypid;
+	int			count;
+	int			maxcount;
+	TemporalRun *runs;
+} TemporalRuns;
+
+/*****************************************************************************/
+
+extern TemporalRuns *truns_make(Oid valuetypid, int maxcount);
+extern void truns_free(TemporalRuns *runs);
+extern void truns_append(TemporalRuns *runs, Datum value, TimestampTz lower,
+	TimestampTz upper, bool lower_inc, bool upper_inc);
+extern TemporalRuns *truns_from_temporal(Temporal *temp);
+extern TemporalS *truns_to_temporals(TemporalRuns *runs);
+extern Temporal *truns_to_temporal(TemporalRuns *runs);
+
+extern TemporalRuns *truns_sync(TemporalRuns *runs1, TemporalRuns *runs2,
+	Datum (*func)(Datum, Datum), Oid valuetypid);
+extern TemporalRuns *truns_at_value(TemporalRuns *runs, Datum value);
+extern PeriodSet *truns_when_value(TemporalRuns *runs, Datum value);
+
+/*****************************************************************************/
+
+#endif
@@ -16,6 +16,7 @@
 #include <postgres.h>
 #include <catalog/pg_type.h>
 #include <utils/rangetypes.h>
+#include <utils/sortsupport.h>
 #include "timetypes.h"
 #include "temporal.h"
 #include "postgis.h"
@@ -99,6 +100,34 @@ extern Datum datum2_le2(Datum l, Datum r, Oid typel, Oid typer);
 extern Datum datum2_gt2(Datum l, Datum r, Oid typel, Oid typer);
 extern Datum datum2_ge2(Datum l, Datum r, Oid typel, Oid typer);
 
+/* Space-filling curve functions */
+
+#define HILBERT_MAX_BITS	31
+
+extern uint32 hilbert_coord(double value, double min, double max, int bits);
+extern uint64 hilbert_index(uint32 *coords, int ndims, int bits);
+
+/* Bucket functions */
+
+extern int64 interval_width(Interval *interval);
+extern int64 timestamp_bucket(TimestampTz t, TimestampTz origin, int64 width);
+
+/* Sort support functions */
+
+extern void sortsupport_abbrev_init(SortSupport ssup, 
+	int (*comparator)(Datum, Datum, SortSupport), 
+	Datum (*converter)(Datum, SortSupport));
+extern Datum sortsupport_abbrev_key(int64 key, SortSupport ssup);
+extern int64 double_abbrev_key(double d);
+
+/* Hash functions */
+
+extern uint64 hash64_init(uint64 seed);
+extern uint64 hash64_word(uint64 state, uint64 word);
+extern uint64 hash64_bytes(uint64 state, const void *data, size_t len);
+extern uint64 hash64_finish(uint64 state);
+extern uint64 datum_hash_update(uint64 state, Datum value, Oid type);
+
 /*****************************************************************************/
 
 #endif
@@ -72,6 +72,8 @@ extern TimestampTz temporali_start_timestamp(TemporalI *ti);
 extern TimestampTz temporali_end_timestamp(TemporalI *ti);
 extern ArrayType *temporali_timestamps(TemporalI *ti);
 extern TemporalI *temporali_shift(TemporalI *ti, Interval *interval);
+extern TemporalI *temporali_resample(TemporalI *ti, TimestampTz origin, 
+	int64 step);
 
 extern bool temporali_ever_eq(TemporalI *ti, Datum value);
 extern bool temporali_ever_lt(TemporalI *ti, Datum value);
@@ -97,6 +99,8 @@ extern TemporalI *temporali_at_max(TemporalI *ti);
 extern TemporalI *temporali_minus_max(TemporalI *ti);
 extern TemporalInst *temporali_at_timestamp(TemporalI *ti, TimestampTz t);
 extern bool temporali_value_at_timestamp(TemporalI *ti, TimestampTz t, Datum *result);
+extern void temporali_values_at_timestamps(TemporalI *ti, TimestampTz *times,
+	int count, Datum *values, bool *nulls);
 extern TemporalI * temporali_minus_timestamp(TemporalI *ti, TimestampTz t);
 extern TemporalI *temporali_at_timestampset(TemporalI *ti, TimestampSet *ts);
 extern TemporalI *temporali_minus_timestampset(TemporalI *ti, TimestampSet *ts);
@@ -120,7 +124,7 @@ extern bool temporali_eq(TemporalI *ti1, TemporalI *ti2);
 
 /* Function for defining hash index */
 
-extern uint32 temporali_hash(TemporalI *ti);
+extern uint64 temporali_hash_update(uint64 state, TemporalI *ti);
 
 /*****************************************************************************/
 
@@ -83,6 +83,8 @@ extern TemporalInst *tnumberinst_minus_range(TemporalInst *inst, RangeType *rang
 
 extern TemporalInst *temporalinst_at_timestamp(TemporalInst *inst, TimestampTz t);
 extern bool temporalinst_value_at_timestamp(TemporalInst *inst, TimestampTz t, Datum *result);
+extern void temporalinst_values_at_timestamps(TemporalInst *inst, 
+	TimestampTz *times, int count, Datum *values, bool *nulls);
 extern TemporalInst *temporalinst_minus_timestamp(TemporalInst *inst, TimestampTz t);
 extern TemporalInst *temporalinst_at_timestampset(TemporalInst *inst, TimestampSet *ts);
 extern TemporalInst *temporalinst_minus_timestampset(TemporalInst *inst, TimestampSet *ts);
@@ -106,7 +108,7 @@ extern bool temporalinst_eq(TemporalInst *inst1, TemporalInst *inst2);
 
 /* Function for defining hash index */
 
-extern uint32 temporalinst_hash(TemporalInst *inst);
+extern uint64 temporalinst_hash_update(uint64 state, TemporalInst *inst);
 
 /*****************************************************************************/
 
@@ -101,6 +101,10 @@ extern bool temporals_timestamp_n(TemporalS *ts, int n, TimestampTz *result);
 extern TimestampTz *temporals_timestamps1(TemporalS *ts, int *count);
 extern ArrayType *temporals_timestamps(TemporalS *ts);
 extern TemporalS *temporals_shift(TemporalS *ts, Interval *interval);
+extern TemporalS *temporals_resample(TemporalS *ts, TimestampTz origin, 
+	int64 step);
+extern TemporalS *temporals_simplify(TemporalS *ts, double eps,
+	bool synchronized, bool streaming);
 
 extern bool temporals_ever_eq(TemporalS *ts, Datum value);
 extern bool temporals_ever_lt(TemporalS *ts, Datum value);
@@ -126,6 +130,8 @@ extern TemporalS *temporals_at_max(TemporalS *ts);
 extern TemporalS *temporals_minus_max(TemporalS *ts);
 extern TemporalInst *temporals_at_timestamp(TemporalS *ts, TimestampTz t);
 extern bool temporals_value_at_timestamp(TemporalS *ts, TimestampTz t, Datum *result);
+extern void temporals_values_at_timestamps(TemporalS *ts, TimestampTz *times,
+	int count, Datum *values, bool *nulls);
 extern TemporalS *temporals_minus_timestamp(TemporalS *ts, TimestampTz t);
 extern TemporalI *temporals_at_timestampset(TemporalS *ts, TimestampSet *ts1);
 extern TemporalS *temporals_minus_timestampset(TemporalS *ts, TimestampSet *ts1);
@@ -150,7 +156,7 @@ extern bool temporals_eq(TemporalS *ts1, TemporalS *ts2);
 
 /* Function for defining hash index */
 
-extern uint32 temporals_hash(TemporalS *ts);
+extern uint64 temporals_hash_update(uint64 state, TemporalS *ts);
 
 /*****************************************************************************/
 
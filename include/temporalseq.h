@@ -18,6 +18,9 @@
 #include <utils/rangetypes.h>
 #include "temporal.h"
 
+/* Number of segments summarized by each block bounding box of a sequence */
+#define TEMPORALSEQ_BLOCK_SIZE 64
+
 /*****************************************************************************/
 
 extern TemporalInst *temporalseq_inst_n(TemporalSeq *seq, int index);
@@ -84,6 +87,11 @@ extern int tfloatseq_ranges1(RangeType **result, TemporalSeq *seq);
 extern PeriodSet *temporalseq_get_time(TemporalSeq *seq);
 extern void *temporalseq_bbox_ptr(TemporalSeq *seq);
 extern void temporalseq_bbox(void *box, TemporalSeq *seq);
+extern int temporalseq_block_count(TemporalSeq *seq);
+extern void *temporalseq_block_bbox_ptr(TemporalSeq *seq, int k);
+extern int temporalseq_block_skip(TemporalSeq *seq, int i, 
+	bool (*pred)(void *, void *), void *arg);
+extern void temporalseq_shift_blocks(TemporalSeq *seq, Interval *interval);
 extern RangeType *tfloatseq_range(TemporalSeq *seq);
 extern ArrayType *tfloatseq_ranges(TemporalSeq *seq);
 extern Datum temporalseq_min_value(TemporalSeq *seq);
@@ -98,6 +106,10 @@ extern TimestampTz *temporalseq_timestamps1(TemporalSeq *seq);
 extern ArrayType *temporalseq_timestamps(TemporalSeq *seq);
 extern TemporalSeq *temporalseq_shift(TemporalSeq *seq, 
 	Interval *interval);
+extern TemporalSeq *temporalseq_resample(TemporalSeq *seq, 
+	TimestampTz origin, int64 step);
+extern TemporalSeq *temporalseq_simplify(TemporalSeq *seq, double eps,
+	bool synchronized, bool streaming);
 
 extern bool temporalseq_ever_eq(TemporalSeq *seq, Datum value);
 extern bool temporalseq_ever_lt(TemporalSeq *seq, Datum value);
@@ -142,6 +154,8 @@ extern TemporalInst *temporalseq_at_timestamp1(TemporalInst *inst1,
 	TemporalInst *inst2, bool linear, TimestampTz t);
 extern TemporalInst *temporalseq_at_timestamp(TemporalSeq *seq, TimestampTz t);
 extern bool temporalseq_value_at_timestamp(TemporalSeq *seq, TimestampTz t, Datum *result);
+extern void temporalseq_values_at_timestamps(TemporalSeq *seq, 
+	TimestampTz *times, int count, Datum *values, bool *nulls);
 extern int temporalseq_minus_timestamp1(TemporalSeq **result, TemporalSeq *seq, 
 	TimestampTz t);
 extern TemporalS *temporalseq_minus_timestamp(TemporalSeq *seq, TimestampTz t);
@@ -174,7 +188,7 @@ extern bool temporalseq_eq(TemporalSeq *seq1, TemporalSeq *seq2);
 
 /* Function for defining hash index */
 
-extern uint32 temporalseq_hash(TemporalSeq *seq);
+extern uint64 temporalseq_hash_update(uint64 state, TemporalSeq *seq);
 
 /*****************************************************************************/
 
@@ -27,11 +27,16 @@ extern Datum gist_period_penalty(PG_FUNCTION_ARGS);
 extern Datum gist_period_picksplit(PG_FUNCTION_ARGS);
 extern Datum gist_period_same(PG_FUNCTION_ARGS);
 extern Datum gist_period_fetch(PG_FUNCTION_ARGS);
+extern Datum timestampset_hilbert_key(PG_FUNCTION_ARGS);
+extern Datum period_hilbert_key(PG_FUNCTION_ARGS);
+extern Datum periodset_hilbert_key(PG_FUNCTION_ARGS);
 
 extern bool index_leaf_consistent_time(Period *key, Period *query, StrategyNumber strategy);
 extern bool index_internal_consistent_period(Period *key, Period *query, StrategyNumber strategy);
 extern bool index_period_bbox_recheck(StrategyNumber strategy);
 
+extern uint64 period_hilbert_key_internal(const Period *p, const Period *extent);
+
 #endif
 
 /*****************************************************************************/
\ No newline at end of file
@@ -22,6 +22,10 @@
 /* Miscellaneous */
 
 extern void time_type_oid(Oid timetypid);
+extern int time_gallop(void *set, int from, int count, TimestampTz t, 
+	bool (*before)(void *, int, TimestampTz));
+extern bool timestampset_time_before(void *ts, int i, TimestampTz t);
+extern bool periodset_per_before(void *ps, int i, TimestampTz t);
 
 /* contains? */
 
@@ -62,6 +62,7 @@ extern TimestampSet *timestampset_shift_internal(TimestampSet *ts, Interval *int
 /* Functions for defining B-tree index */
 
 extern Datum timestampset_cmp(PG_FUNCTION_ARGS);
+extern Datum timestampset_sortsupport(PG_FUNCTION_ARGS);
 extern Datum timestampset_eq(PG_FUNCTION_ARGS);
 extern Datum timestampset_ne(PG_FUNCTION_ARGS);
 extern Datum timestampset_lt(PG_FUNCTION_ARGS);
@@ -0,0 +1,26 @@
+/*****************************************************************************
+ *
+ * tnumber_eval.h
+ *	Fused evaluation of arithmetic expressions over temporal floats.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TNUMBER_EVAL_H__
+#define __TNUMBER_EVAL_H__
+
+#include <postgres.h>
+#include <catalog/pg_type.h>
+
+/*****************************************************************************/
+
+extern Datum tnumber_eval(PG_FUNCTION_ARGS);
+extern Datum tnumber_eval_bool(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
@@ -25,6 +25,8 @@ extern Datum gist_tbox_picksplit(PG_FUNCTION_ARGS);
 extern Datum gist_tnumber_consistent(PG_FUNCTION_ARGS);
 extern Datum gist_tnumber_compress(PG_FUNCTION_ARGS);
 extern Datum gist_tbox_same(PG_FUNCTION_ARGS);
+extern Datum tbox_hilbert_key(PG_FUNCTION_ARGS);
+extern Datum tnumber_hilbert_key(PG_FUNCTION_ARGS);
 
 /* The following functions are also called by IndexSpgistTnumber.c */
 extern bool index_leaf_consistent_tbox(TBOX *key, TBOX *query, StrategyNumber strategy);
@@ -14,6 +14,10 @@
 #ifndef __POSTGIS_H__
 #define __POSTGIS_H__
 
+#include <postgres.h>
+#include <fmgr.h>
+#include <liblwgeom.h>
+
 /*
  * This macro is based on PG_FREE_IF_COPY, except that it accepts two pointers.
  * See PG_FREE_IF_COPY comment in src/include/fmgr.h in postgres source code
@@ -27,6 +31,9 @@
 
 extern void srid_is_latlong(FunctionCallInfo fcinfo, int srid);
 extern int clamp_srid(int srid);
+extern int spheroid_init_from_srid(FunctionCallInfo fcinfo, int srid, SPHEROID *s);
+extern int GetProjectionsUsingFCInfo(FunctionCallInfo fcinfo, int srid1,
+	int srid2, projPJ *pj1, projPJ *pj2);
 extern int getSRIDbySRS(const char* srs);
 extern char *getSRSbySRID(int32_t srid, bool short_crs);
 extern int lwprint_double(double d, int maxdd, char* buf, size_t bufsize);
@@ -23,6 +23,8 @@ extern Datum tpoint_extent_combinefn(PG_FUNCTION_ARGS);
 
 extern Datum tpoint_tcentroid_transfn(PG_FUNCTION_ARGS);
 extern Datum tpoint_tcentroid_combinefn(PG_FUNCTION_ARGS);
+extern Datum tpoint_tcentroid_serialize(PG_FUNCTION_ARGS);
+extern Datum tpoint_tcentroid_deserialize(PG_FUNCTION_ARGS);
 extern Datum tpoint_tcentroid_finalfn(PG_FUNCTION_ARGS);
 
 /*****************************************************************************/
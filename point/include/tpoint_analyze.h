@@ -18,6 +18,9 @@
 #include <commands/vacuum.h>
 #include <liblwgeom.h>
 
+#include "temporal.h"
+#include "temporal_analyze.h"
+
 /*****************************************************************************/
 
 /**
@@ -27,6 +30,14 @@
 */
 #define ND_DIMS 4
 
+/**
+* Kind of the joint spatiotemporal histogram, which is an ND histogram whose
+* last dimension is the time dimension. It follows the kinds of the time
+* types and the temporal numbers and stays out of the range 100-199 that is
+* reserved for PostGIS.
+*/
+#define STATISTIC_KIND_NDT 11
+
 /**
 * N-dimensional box type for calculations, to avoid doing
 * explicit axis conversions from GBOX in all calculations
@@ -51,6 +62,7 @@ extern int nd_box_init(ND_BOX *a);
 extern int nd_box_init_bounds(ND_BOX *a, int ndims);
 extern int nd_box_merge(const ND_BOX *source, ND_BOX *target, int ndims);
 extern void nd_box_from_gbox(const GBOX *gbox, ND_BOX *nd_box);
+extern void nd_box_from_stbox(const STBOX *box, ND_BOX *nd_box);
 
 extern void gserialized_compute_stats(VacAttrStats *stats, int sample_rows, 
     int total_rows, double notnull_cnt, const ND_BOX **sample_boxes, 
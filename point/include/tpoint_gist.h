@@ -20,12 +20,36 @@
 
 /*****************************************************************************/
 
+/* Compact key of the gist_tgeompoint_2dt_ops operator class */
+
+typedef struct
+{
+	float4		xmin;			/* minimum x value rounded down */
+	float4		xmax;			/* maximum x value rounded up */
+	float4		ymin;			/* minimum y value rounded down */
+	float4		ymax;			/* maximum y value rounded up */
+	TimestampTz	tmin;			/* minimum timestamp */
+	TimestampTz	tmax;			/* maximum timestamp */
+} STBOX2DT;
+
+/*****************************************************************************/
+
 extern Datum gist_tpoint_consistent(PG_FUNCTION_ARGS);
 extern Datum gist_tpoint_union(PG_FUNCTION_ARGS);
 extern Datum gist_tpoint_penalty(PG_FUNCTION_ARGS);
 extern Datum gist_tpoint_picksplit(PG_FUNCTION_ARGS);
 extern Datum gist_tpoint_same(PG_FUNCTION_ARGS);
 extern Datum gist_tpoint_compress(PG_FUNCTION_ARGS);
+extern Datum gist_tpoint_2dt_consistent(PG_FUNCTION_ARGS);
+extern Datum gist_tpoint_2dt_union(PG_FUNCTION_ARGS);
+extern Datum gist_tpoint_2dt_compress(PG_FUNCTION_ARGS);
+extern Datum gist_tpoint_2dt_penalty(PG_FUNCTION_ARGS);
+extern Datum gist_tpoint_2dt_picksplit(PG_FUNCTION_ARGS);
+extern Datum gist_tpoint_2dt_same(PG_FUNCTION_ARGS);
+extern Datum stbox2dt_in(PG_FUNCTION_ARGS);
+extern Datum stbox2dt_out(PG_FUNCTION_ARGS);
+extern Datum stbox_hilbert_key(PG_FUNCTION_ARGS);
+extern Datum tpoint_hilbert_key(PG_FUNCTION_ARGS);
 
 /* The following functions are also called by IndexSpgistTPoint.c */
 extern bool index_tpoint_recheck(StrategyNumber strategy);
@@ -39,6 +39,9 @@ extern POINT2D gs_get_point2d(GSERIALIZED *gs);
 extern POINT3DZ gs_get_point3dz(GSERIALIZED *gs);
 extern POINT2D datum_get_point2d(Datum value);
 extern POINT3DZ datum_get_point3dz(Datum value);
+extern POINT3DZ tpointinst_point3dz(TemporalInst *inst, bool hasz);
+extern double segments_min_dist(POINT3DZ p1, POINT3DZ p2, POINT3DZ q1,
+	POINT3DZ q2);
 extern bool datum_point_eq(Datum geopoint1, Datum geopoint2);
 extern GSERIALIZED* geometry_serialize(LWGEOM* geom);
 
@@ -49,7 +52,6 @@ extern Datum tpoint_set_srid(PG_FUNCTION_ARGS);
 
 extern Temporal *tpoint_set_srid_internal(Temporal *temp, int32 srid) ;
 extern int tpoint_srid_internal(Temporal *t);
-extern TemporalInst *tgeompointinst_transform(TemporalInst *inst, Datum srid);
 
 /* Cast functions */
 
@@ -87,6 +89,14 @@ extern Datum tgeompointi_twcentroid(TemporalI *ti);
 extern Datum tgeompointseq_twcentroid(TemporalSeq *seq);
 extern Datum tgeompoints_twcentroid(TemporalS *ts);
 
+/* Simplification functions */
+
+extern Datum tpoint_simplify(PG_FUNCTION_ARGS);
+
+/* Space-time split functions */
+
+extern Datum tpoint_space_time_split(PG_FUNCTION_ARGS);
+
 /* Restriction functions */
 
 extern Datum tpoint_at_geometry(PG_FUNCTION_ARGS);
@@ -32,6 +32,8 @@ extern Datum geom_touches(Datum geom1, Datum geom2);
 extern Datum geom_within(Datum geom1, Datum geom2);
 extern Datum geom_dwithin2d(Datum geom1, Datum geom2, Datum dist);
 extern Datum geom_dwithin3d(Datum geom1, Datum geom2, Datum dist);
+extern Datum geompoint_dwithin2d(Datum point1, Datum point2, Datum dist);
+extern Datum geompoint_dwithin3d(Datum point1, Datum point2, Datum dist);
 extern Datum geom_relate(Datum geom1, Datum geom2);
 extern Datum geom_relate_pattern(Datum geom1, Datum geom2, Datum pattern);
 
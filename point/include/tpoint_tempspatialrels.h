@@ -53,6 +53,13 @@ extern Datum twithin_tpoint_tpoint(PG_FUNCTION_ARGS);
 extern Datum tdwithin_geo_tpoint(PG_FUNCTION_ARGS);
 extern Datum tdwithin_tpoint_geo(PG_FUNCTION_ARGS);
 extern Datum tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS);
+extern Datum tdwithin_pairs(PG_FUNCTION_ARGS);
+
+extern Datum when_intersects_geo_tpoint(PG_FUNCTION_ARGS);
+extern Datum when_intersects_tpoint_geo(PG_FUNCTION_ARGS);
+extern Datum when_dwithin_geo_tpoint(PG_FUNCTION_ARGS);
+extern Datum when_dwithin_tpoint_geo(PG_FUNCTION_ARGS);
+extern Datum when_dwithin_tpoint_tpoint(PG_FUNCTION_ARGS);
 
 extern Datum trelate_geo_tpoint(PG_FUNCTION_ARGS);
 extern Datum trelate_tpoint_geo(PG_FUNCTION_ARGS);
@@ -111,24 +111,11 @@ BLRauenberg (double x, double y, double z)
 	return result;
 }
 
-/* Get Datum from 2D point */
+/* Project a WGS84 longitude/latitude point */
 
-static Datum
-point2d_get_datum(POINT2D point2D)
-{
-	LWPOINT *p = lwpoint_make2d(4326, point2D.x, point2D.y);
-	GSERIALIZED *result = geometry_serialize((LWGEOM *)p);
-
-	return PointerGetDatum(result);
-}
-
-static Datum
-gk(Datum inst)
+static POINT2D
+gk_point2d(POINT2D point2D)
 {
-	eqwgs = (awgs * awgs - bwgs * bwgs) / (awgs * awgs);
-	eqbes = (abes * abes - bbes * bbes) / (abes * abes);
-	POINT2D point2D = datum_get_point2d(inst);
-	POINT2D result;
 	double x = point2D.x;
 	double y = point2D.y;
 	double a = (x / 180) * Pi;
@@ -152,8 +139,14 @@ gk(Datum inst)
 	p = BLRauenberg(X, Y, Z);
 	double b2 = p.x;
 	double l2 = p.y;
-	result = BesselBLToGaussKrueger(b2, l2);
-	return point2d_get_datum(result);
+	return BesselBLToGaussKrueger(b2, l2);
+}
+
+static void
+gk_init(void)
+{
+	eqwgs = (awgs * awgs - bwgs * bwgs) / (awgs * awgs);
+	eqbes = (abes * abes - bbes * bbes) / (abes * abes);
 }
 
 /* Transform geometry to Gauss Kruger Projection */
@@ -170,9 +163,8 @@ geometry_transform_gk_internal(GSERIALIZED *gs)
 			lwpoint = lwpoint_construct_empty(0, false, false);
 		else
 		{
-			POINT2D point2D	= gs_get_point2d(gs);
-			Datum geom = gk(point2d_get_datum(point2D));
-			point2D	= datum_get_point2d(geom);
+			gk_init();
+			POINT2D point2D	= gk_point2d(gs_get_point2d(gs));
 			lwpoint = lwpoint_make2d(4326, point2D.x, point2D.y);
 		}
 		result = geometry_serialize((LWGEOM *)lwpoint);
@@ -188,26 +180,24 @@ geometry_transform_gk_internal(GSERIALIZED *gs)
 		}
 		else
 		{
-			LWPOINT *lwpoint = NULL;
 			LWGEOM *lwgeom = lwgeom_from_gserialized(gs);
-			line = lwgeom_as_lwline(lwgeom);
-			uint32_t numPoints = line->points->npoints;
-			LWPOINT **points = palloc(sizeof(LWPOINT *) * numPoints);
-			for (uint32_t i = 0; i < numPoints; i++)
+			POINTARRAY *points = lwgeom_as_lwline(lwgeom)->points;
+			POINTARRAY *pa = ptarray_construct(false, false, points->npoints);
+			POINT4D pt = {0, 0, 0, 0};
+			gk_init();
+			for (uint32_t i = 0; i < points->npoints; i++)
 			{
-				lwpoint = lwline_get_lwpoint((LWLINE*)lwgeom, i);
-				Datum point2d_datum = PointerGetDatum(gserialized_from_lwgeom(lwpoint_as_lwgeom(lwpoint), 0));
-				Datum geom = gk(point2d_datum);
-				POINT2D point2D	= datum_get_point2d(geom);
-				points[i] = lwpoint_make2d(4326, point2D.x, point2D.y);
+				POINT2D point2D;
+				getPoint2d_p(points, i, &point2D);
+				point2D = gk_point2d(point2D);
+				pt.x = point2D.x;
+				pt.y = point2D.y;
+				ptarray_set_point4d(pa, i, &pt);
 			}
-
-			line = lwline_from_ptarray(4326, numPoints, points);
+			line = lwline_construct(4326, NULL, pa);
 			result = geometry_serialize(lwline_as_lwgeom(line));
-			lwline_free(line);lwpoint_free(lwpoint);lwgeom_free(lwgeom);
-			for( uint32_t i = 0; i < numPoints; i++)
-				lwpoint_free(points[i]);
-			pfree(points);
+			lwline_free(line);
+			lwgeom_free(lwgeom);
 		}
 	}
 	else
@@ -217,29 +207,53 @@ geometry_transform_gk_internal(GSERIALIZED *gs)
 	return result;
 }
 
+/*
+ * Project in one pass the instants of an array. The coordinates are read
+ * directly from the serialized points and written into a single serialized
+ * 2D point that is copied into each resulting instant.
+ */
+static TemporalInst **
+tgeompointinstarr_transform_gk(TemporalInst **instants, int count)
+{
+	TemporalInst **result = palloc(sizeof(TemporalInst *) * count);
+	LWPOINT *lwpoint = lwpoint_make2d(4326, 0, 0);
+	GSERIALIZED *gs = geometry_serialize((LWGEOM *)lwpoint);
+	double *coords = (double *)((uint8_t *) gs->data + 8);
+	gk_init();
+	for (int i = 0; i < count; i++)
+	{
+		POINT2D point2D = gk_point2d(datum_get_point2d(
+			temporalinst_value(instants[i])));
+		coords[0] = point2D.x;
+		coords[1] = point2D.y;
+		result[i] = temporalinst_make(PointerGetDatum(gs), instants[i]->t,
+			type_oid(T_GEOMETRY));
+	}
+	lwpoint_free(lwpoint);
+	pfree(gs);
+	return result;
+}
+
 static TemporalInst *
 tgeompointinst_transform_gk(TemporalInst *inst)
 {
-	Datum geom = gk(temporalinst_value(inst));
-	TemporalInst *result = temporalinst_make(geom, inst->t,
-		type_oid(T_GEOMETRY));
-	pfree(DatumGetPointer(geom));
+	TemporalInst **instants = tgeompointinstarr_transform_gk(&inst, 1);
+	TemporalInst *result = instants[0];
+	pfree(instants);
 	return result;
 }
 
 static TemporalI *
 tgeompointi_transform_gk_internal(TemporalI *ti)
 {
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
-	for (int i = 0; i < ti->count; i++)
-	{
-		TemporalInst *inst = temporali_inst_n(ti, i);
-		instants[i] = tgeompointinst_transform_gk(inst);
-	}
-	TemporalI *result = temporali_from_temporalinstarr(instants, ti->count);
+	TemporalInst **instants = temporali_instants(ti);
+	TemporalInst **projected = tgeompointinstarr_transform_gk(instants,
+		ti->count);
+	TemporalI *result = temporali_from_temporalinstarr(projected, ti->count);
 
 	for (int i = 0; i < ti->count; i++)
-		pfree(instants[i]);
+		pfree(projected[i]);
+	pfree(projected);
 	pfree(instants);
 
 	return result;
@@ -248,18 +262,16 @@ tgeompointi_transform_gk_internal(TemporalI *ti)
 static TemporalSeq *
 tgeompointseq_transform_gk_internal(TemporalSeq *seq)
 {
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * seq->count);
-	for (int i = 0; i < seq->count; i++)
-	{
-		TemporalInst *inst = temporalseq_inst_n(seq, i);
-		instants[i] = tgeompointinst_transform_gk(inst);
-	}
-	TemporalSeq *result = temporalseq_from_temporalinstarr(instants,
+	TemporalInst **instants = temporalseq_instants(seq);
+	TemporalInst **projected = tgeompointinstarr_transform_gk(instants,
+		seq->count);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(projected,
 		seq->count, seq->period.lower_inc, seq->period.upper_inc, 
 		MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
 
 	for (int i = 0; i < seq->count; i++)
-		pfree(instants[i]);
+		pfree(projected[i]);
+	pfree(projected);
 	pfree(instants);
 
 	return result;
@@ -270,21 +282,8 @@ tgeompoints_transform_gk_internal(TemporalS *ts)
 {
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->count);
 	for (int i = 0; i < ts->count; i++)
-	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		TemporalInst **instants = palloc(sizeof(TemporalInst *) * seq->count);
-		for (int j = 0; j < seq->count; j++)
-		{
-			TemporalInst *inst = temporalseq_inst_n(seq, j);
-			instants[j] = tgeompointinst_transform_gk(inst);
-		}
-		sequences[i] = temporalseq_from_temporalinstarr(instants,
-			seq->count, seq->period.lower_inc, seq->period.upper_inc, 
-			MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
-		for (int j = 0; j < seq->count; j++)
-			pfree(instants[j]);
-		pfree(instants);
-	}
+		sequences[i] = tgeompointseq_transform_gk_internal(
+			temporals_seq_n(ts, i));
 	TemporalS *result = temporals_from_temporalseqarr(sequences,
 		ts->count, MOBDB_FLAGS_GET_LINEAR(ts->flags), false);
 
@@ -297,6 +297,24 @@ CREATE FUNCTION shift(tgeogpoint, interval)
 	AS 'MODULE_PATHNAME', 'temporal_shift'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION resample(tgeompoint, interval)
+	RETURNS tgeompoint
+	AS 'MODULE_PATHNAME', 'temporal_resample'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION resample(tgeogpoint, interval)
+	RETURNS tgeogpoint
+	AS 'MODULE_PATHNAME', 'temporal_resample'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION timeSplit(tgeompoint, interval, timestamptz DEFAULT '2000-01-03')
+	RETURNS TABLE(tbucket timestamptz, fragment tgeompoint)
+	AS 'MODULE_PATHNAME', 'temporal_time_split'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION timeSplit(tgeogpoint, interval, timestamptz DEFAULT '2000-01-03')
+	RETURNS TABLE(tbucket timestamptz, fragment tgeogpoint)
+	AS 'MODULE_PATHNAME', 'temporal_time_split'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION startValue(tgeompoint)
 	RETURNS geometry(Point)
 	AS 'MODULE_PATHNAME', 'temporal_start_value'
@@ -618,6 +636,23 @@ CREATE FUNCTION valueAtTimestamp(tgeogpoint, timestamptz)
 	AS 'MODULE_PATHNAME', 'temporal_value_at_timestamp'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION valueAtTimestamps(tgeompoint, timestamptz[])
+	RETURNS geometry[]
+	AS 'MODULE_PATHNAME', 'temporal_values_at_timestamps'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION valueAtTimestamps(tgeogpoint, timestamptz[])
+	RETURNS geography[]
+	AS 'MODULE_PATHNAME', 'temporal_values_at_timestamps'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION valueAtTimestamps(tgeompoint, timestampset)
+	RETURNS geometry[]
+	AS 'MODULE_PATHNAME', 'temporal_values_at_timestampset'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION valueAtTimestamps(tgeogpoint, timestampset)
+	RETURNS geography[]
+	AS 'MODULE_PATHNAME', 'temporal_values_at_timestampset'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION atTimestampSet(tgeompoint, timestampset)
 	RETURNS tgeompoint
 	AS 'MODULE_PATHNAME', 'temporal_at_timestampset'
@@ -741,6 +776,11 @@ CREATE FUNCTION tgeompoint_cmp(tgeompoint, tgeompoint)
 	AS 'MODULE_PATHNAME', 'temporal_cmp'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION tgeompoint_sortsupport(internal)
+	RETURNS void
+	AS 'MODULE_PATHNAME', 'temporal_sortsupport'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE OPERATOR < (
 	LEFTARG = tgeompoint, RIGHTARG = tgeompoint,
 	PROCEDURE = tgeompoint_lt,
@@ -791,7 +831,8 @@ CREATE OPERATOR CLASS tgeompoint_ops
 		OPERATOR	3	=,
 		OPERATOR	4	>=,
 		OPERATOR	5	>,
-		FUNCTION	1	tgeompoint_cmp(tgeompoint, tgeompoint);
+		FUNCTION	1	tgeompoint_cmp(tgeompoint, tgeompoint),
+		FUNCTION	2	tgeompoint_sortsupport(internal);
 
 /******************************************************************************/
 
@@ -824,6 +865,11 @@ CREATE FUNCTION tgeogpoint_cmp(tgeogpoint, tgeogpoint)
 	AS 'MODULE_PATHNAME', 'temporal_cmp'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION tgeogpoint_sortsupport(internal)
+	RETURNS void
+	AS 'MODULE_PATHNAME', 'temporal_sortsupport'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE OPERATOR < (
 	LEFTARG = tgeogpoint, RIGHTARG = tgeogpoint,
 	PROCEDURE = tgeogpoint_lt,
@@ -868,7 +914,8 @@ CREATE OPERATOR CLASS tgeogpoint_ops
 		OPERATOR	3	=,
 		OPERATOR	4	>=,
 		OPERATOR	5	>,
-		FUNCTION	1	tgeogpoint_cmp(tgeogpoint, tgeogpoint);
+		FUNCTION	1	tgeogpoint_cmp(tgeogpoint, tgeogpoint),
+		FUNCTION	2	tgeogpoint_sortsupport(internal);
 
 /******************************************************************************/
 
@@ -876,19 +923,29 @@ CREATE FUNCTION tgeompoint_hash(tgeompoint)
 	RETURNS integer
 	AS 'MODULE_PATHNAME', 'temporal_hash'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tgeompoint_hash_extended(tgeompoint, bigint)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'temporal_hash_extended'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION tgeogpoint_hash(tgeogpoint)
 	RETURNS integer
 	AS 'MODULE_PATHNAME', 'temporal_hash'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tgeogpoint_hash_extended(tgeogpoint, bigint)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'temporal_hash_extended'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR CLASS hash_tgeompoint_ops
 	DEFAULT FOR TYPE tgeompoint USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   tgeompoint_hash(tgeompoint);
+    FUNCTION    1   tgeompoint_hash(tgeompoint),
+    FUNCTION    2   tgeompoint_hash_extended(tgeompoint, bigint);
 CREATE OPERATOR CLASS hash_tgeogpoint_ops
 	DEFAULT FOR TYPE tgeogpoint USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   tgeogpoint_hash(tgeogpoint);
+    FUNCTION    1   tgeogpoint_hash(tgeogpoint),
+    FUNCTION    2   tgeogpoint_hash_extended(tgeogpoint, bigint);
 
 /******************************************************************************/
 
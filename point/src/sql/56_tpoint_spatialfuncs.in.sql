@@ -119,6 +119,20 @@ CREATE FUNCTION azimuth(tgeogpoint)
 	AS 'MODULE_PATHNAME', 'tpoint_azimuth'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION simplify(tgeompoint, epsilon float, 
+	synchronized boolean DEFAULT false, streaming boolean DEFAULT false)
+	RETURNS tgeompoint
+	AS 'MODULE_PATHNAME', 'tpoint_simplify'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION spaceTimeSplit(tgeompoint, xsize float, ysize float,
+	duration interval, sorigin geometry DEFAULT 'Point(0 0)',
+	torigin timestamptz DEFAULT '2000-01-03')
+	RETURNS TABLE(cellx integer, celly integer, tbucket timestamptz,
+		fragment tgeompoint)
+	AS 'MODULE_PATHNAME', 'tpoint_space_time_split'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
 
 CREATE FUNCTION atGeometry(tgeompoint, geometry)
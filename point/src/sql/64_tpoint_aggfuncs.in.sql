@@ -66,6 +66,33 @@ CREATE AGGREGATE tcount(tgeogpoint) (
 	PARALLEL = SAFE
 );
 
+CREATE FUNCTION tcount_bins_transfn(internal, tgeompoint, timestamptz, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_bins_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_bins_transfn(internal, tgeogpoint, timestamptz, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_bins_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE AGGREGATE tcount_bins(tgeompoint, timestamptz, interval) (
+	SFUNC = tcount_bins_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbins_combinefn,
+	FINALFUNC = tcount_bins_finalfn,
+	SERIALFUNC = tbins_serialize,
+	DESERIALFUNC = tbins_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tcount_bins(tgeogpoint, timestamptz, interval) (
+	SFUNC = tcount_bins_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbins_combinefn,
+	FINALFUNC = tcount_bins_finalfn,
+	SERIALFUNC = tbins_serialize,
+	DESERIALFUNC = tbins_deserialize,
+	PARALLEL = SAFE
+);
+
 CREATE FUNCTION wcount_transfn(internal, tgeompoint, interval)
 	RETURNS internal
 	AS 'MODULE_PATHNAME', 'temporal_wcount_transfn'
@@ -102,6 +129,14 @@ CREATE FUNCTION tcentroid_combinefn(internal, internal)
 	RETURNS internal
 	AS 'MODULE_PATHNAME', 'tpoint_tcentroid_combinefn'
 	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcentroid_serialize(internal)
+	RETURNS bytea
+	AS 'MODULE_PATHNAME', 'tpoint_tcentroid_serialize'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tcentroid_deserialize(bytea, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'tpoint_tcentroid_deserialize'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION tcentroid_finalfn(internal)
 	RETURNS tgeompoint
 	AS 'MODULE_PATHNAME', 'tpoint_tcentroid_finalfn'
@@ -112,8 +147,8 @@ CREATE AGGREGATE tcentroid(tgeompoint) (
 	STYPE = internal,
 	COMBINEFUNC = tcentroid_combinefn,
 	FINALFUNC = tcentroid_finalfn,
-	SERIALFUNC = tagg_serialize,
-	DESERIALFUNC = tagg_deserialize,
+	SERIALFUNC = tcentroid_serialize,
+	DESERIALFUNC = tcentroid_deserialize,
 	PARALLEL = SAFE
 );
 
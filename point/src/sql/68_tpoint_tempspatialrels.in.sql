@@ -231,6 +231,43 @@ CREATE FUNCTION tdwithin(tgeogpoint, tgeogpoint, dist float8)
 	AS 'MODULE_PATHNAME', 'tdwithin_tpoint_tpoint'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+/*****************************************************************************/
+
+CREATE FUNCTION tdwithin_pairs(tgeompoint[], dist float8)
+	RETURNS TABLE(i integer, j integer, period period)
+	AS 'MODULE_PATHNAME', 'tdwithin_pairs'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/*****************************************************************************
+ * whenIntersects and whenDwithin
+ *****************************************************************************/
+
+CREATE FUNCTION whenIntersects(geometry, tgeompoint)
+	RETURNS periodset
+	AS 'MODULE_PATHNAME', 'when_intersects_geo_tpoint'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION whenIntersects(tgeompoint, geometry)
+	RETURNS periodset
+	AS 'MODULE_PATHNAME', 'when_intersects_tpoint_geo'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION whenDwithin(geometry, tgeompoint, dist float8)
+	RETURNS periodset
+	AS 'MODULE_PATHNAME', 'when_dwithin_geo_tpoint'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION whenDwithin(tgeompoint, geometry, dist float8)
+	RETURNS periodset
+	AS 'MODULE_PATHNAME', 'when_dwithin_tpoint_geo'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION whenDwithin(tgeompoint, tgeompoint, dist float8)
+	RETURNS periodset
+	AS 'MODULE_PATHNAME', 'when_dwithin_tpoint_tpoint'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION whenDwithin(tgeogpoint, tgeogpoint, dist float8)
+	RETURNS periodset
+	AS 'MODULE_PATHNAME', 'when_dwithin_tpoint_tpoint'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************
  * trelate (2 arguments)
  *****************************************************************************/
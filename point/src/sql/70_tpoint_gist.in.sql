@@ -170,3 +170,145 @@ CREATE OPERATOR CLASS gist_tgeogpoint_ops
 	FUNCTION	7	gist_tpoint_same(stbox, stbox, internal);
 	
 /******************************************************************************/
+
+/******************************************************************************
+ * Operator class with compact 2D+T keys for tgeompoint. The spatial bounds
+ * are stored as float4 and the Z dimension is dropped, which increases the
+ * fanout of the index for planar trajectories.
+ ******************************************************************************/
+
+CREATE TYPE stbox2dt;
+
+CREATE FUNCTION stbox2dt_in(cstring)
+	RETURNS stbox2dt
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION stbox2dt_out(stbox2dt)
+	RETURNS cstring
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE TYPE stbox2dt (
+	internallength = 32,
+	input = stbox2dt_in,
+	output = stbox2dt_out,
+	storage = plain,
+	alignment = double
+);
+
+CREATE FUNCTION gist_tgeompoint_2dt_consistent(internal, tgeompoint, smallint, oid, internal)
+	RETURNS bool
+	AS 'MODULE_PATHNAME', 'gist_tpoint_2dt_consistent'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_tpoint_2dt_union(internal, internal)
+	RETURNS stbox2dt
+	AS 'MODULE_PATHNAME', 'gist_tpoint_2dt_union'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_tpoint_2dt_compress(internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'gist_tpoint_2dt_compress'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_tpoint_2dt_penalty(internal, internal, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'gist_tpoint_2dt_penalty'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_tpoint_2dt_picksplit(internal, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'gist_tpoint_2dt_picksplit'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_tpoint_2dt_same(stbox2dt, stbox2dt, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'gist_tpoint_2dt_same'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS gist_tgeompoint_2dt_ops
+	FOR TYPE tgeompoint USING gist AS
+	STORAGE stbox2dt,
+	-- strictly left
+	OPERATOR	1		<< (tgeompoint, geometry),  
+	OPERATOR	1		<< (tgeompoint, stbox),  
+	OPERATOR	1		<< (tgeompoint, tgeompoint),  
+	-- overlaps or left
+	OPERATOR	2		&< (tgeompoint, geometry),  
+	OPERATOR	2		&< (tgeompoint, stbox),  
+	OPERATOR	2		&< (tgeompoint, tgeompoint),  
+	-- overlaps	
+	OPERATOR	3		&& (tgeompoint, geometry),  
+	OPERATOR	3		&& (tgeompoint, stbox),  
+	OPERATOR	3		&& (tgeompoint, tgeompoint),  
+	-- overlaps or right
+	OPERATOR	4		&> (tgeompoint, geometry),  
+	OPERATOR	4		&> (tgeompoint, stbox),  
+	OPERATOR	4		&> (tgeompoint, tgeompoint),  
+  	-- strictly right
+	OPERATOR	5		>> (tgeompoint, geometry),  
+	OPERATOR	5		>> (tgeompoint, stbox),  
+	OPERATOR	5		>> (tgeompoint, tgeompoint),  
+  	-- same
+	OPERATOR	6		~= (tgeompoint, geometry),  
+	OPERATOR	6		~= (tgeompoint, stbox),  
+	OPERATOR	6		~= (tgeompoint, tgeompoint),  
+	-- contains
+	OPERATOR	7		@> (tgeompoint, geometry),  
+	OPERATOR	7		@> (tgeompoint, stbox),  
+	OPERATOR	7		@> (tgeompoint, tgeompoint),  
+	-- contained by
+	OPERATOR	8		<@ (tgeompoint, geometry),  
+	OPERATOR	8		<@ (tgeompoint, stbox),  
+	OPERATOR	8		<@ (tgeompoint, tgeompoint),  
+	-- overlaps or below
+	OPERATOR	9		&<| (tgeompoint, geometry),  
+	OPERATOR	9		&<| (tgeompoint, stbox),  
+	OPERATOR	9		&<| (tgeompoint, tgeompoint),  
+	-- strictly below
+	OPERATOR	10		<<| (tgeompoint, geometry),  
+	OPERATOR	10		<<| (tgeompoint, stbox),  
+	OPERATOR	10		<<| (tgeompoint, tgeompoint),  
+	-- strictly above
+	OPERATOR	11		|>> (tgeompoint, geometry),  
+	OPERATOR	11		|>> (tgeompoint, stbox),  
+	OPERATOR	11		|>> (tgeompoint, tgeompoint),  
+	-- overlaps or above
+	OPERATOR	12		|&> (tgeompoint, geometry),  
+	OPERATOR	12		|&> (tgeompoint, stbox),  
+	OPERATOR	12		|&> (tgeompoint, tgeompoint),  
+	-- overlaps or before
+	OPERATOR	28		&<# (tgeompoint, stbox),
+	OPERATOR	28		&<# (tgeompoint, tgeompoint),
+	-- strictly before
+	OPERATOR	29		<<# (tgeompoint, stbox),
+	OPERATOR	29		<<# (tgeompoint, tgeompoint),
+	-- strictly after
+	OPERATOR	30		#>> (tgeompoint, stbox),
+	OPERATOR	30		#>> (tgeompoint, tgeompoint),
+	-- overlaps or after
+	OPERATOR	31		#&> (tgeompoint, stbox),
+	OPERATOR	31		#&> (tgeompoint, tgeompoint),
+	-- functions
+	FUNCTION	1	gist_tgeompoint_2dt_consistent(internal, tgeompoint, smallint, oid, internal),
+	FUNCTION	2	gist_tpoint_2dt_union(internal, internal),
+	FUNCTION	3	gist_tpoint_2dt_compress(internal),
+	FUNCTION	5	gist_tpoint_2dt_penalty(internal, internal, internal),
+	FUNCTION	6	gist_tpoint_2dt_picksplit(internal, internal),
+	FUNCTION	7	gist_tpoint_2dt_same(stbox2dt, stbox2dt, internal);
+
+/******************************************************************************
+ * Hilbert keys for sorting the rows before CREATE INDEX, e.g.,
+ *   CREATE TABLE t1 AS SELECT * FROM t ORDER BY
+ *     hilbertKey(trip, (SELECT extent(trip) FROM t));
+ ******************************************************************************/
+
+CREATE FUNCTION hilbertKey(stbox, stbox)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'stbox_hilbert_key'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION hilbertKey(tgeompoint, stbox)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'tpoint_hilbert_key'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION hilbertKey(tgeogpoint, stbox)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'tpoint_hilbert_key'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/******************************************************************************/
@@ -15,158 +15,17 @@
 #include "tpoint_aggfuncs.h"
 
 #include <assert.h>
+#include <libpq/pqformat.h>
+#include <utils/memutils.h>
 
+#include "period.h"
+#include "timeops.h"
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
-#include "doublen.h"
-#include "temporal_aggfuncs.h"
 #include "tpoint.h"
 #include "tpoint_spatialfuncs.h"
 
-/*****************************************************************************
- * Generic functions
- *****************************************************************************/
-
-struct GeoAggregateState
-{
-	int32_t srid;
-	bool hasz;
-};
-
-static void
-geoaggstate_check(SkipList *state, int32_t srid, bool hasz)
-{
-	if(! state)
-		return;
-	struct GeoAggregateState *extra = state->extra;
-	if (extra && extra->srid != srid)
-		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-			errmsg("Geometries must have the same SRID for temporal aggregation")));
-	if (extra && extra->hasz != hasz)
-		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-			errmsg("Geometries must have the same dimensionality for temporal aggregation")));
-}
-
-static void 
-geoaggstate_check_as(SkipList *state1, SkipList *state2)
-{
-	struct GeoAggregateState *extra2 = state2->extra;
-	if (extra2)
-		geoaggstate_check(state1, extra2->srid, extra2->hasz);
-}
-
-static void
-geoaggstate_check_t(SkipList *state, Temporal *t)
-{
-	geoaggstate_check(state, tpoint_srid_internal(t), MOBDB_FLAGS_GET_Z(t->flags) != 0);
-}
-
-/*****************************************************************************/
-
-/*
- * Transform a temporal point type into a temporal double3/double4 type for 
- * performing centroid aggregation 
- */
-static TemporalInst *
-tpointinst_transform_tcentroid(TemporalInst *inst)
-{
-	TemporalInst *result;
-	if (MOBDB_FLAGS_GET_Z(inst->flags))
-	{
-		POINT3DZ point = datum_get_point3dz(temporalinst_value(inst));
-		double4 dvalue;
-		double4_set(&dvalue, point.x, point.y, point.z, 1);
-		result = temporalinst_make(PointerGetDatum(&dvalue), inst->t,
-			type_oid(T_DOUBLE4));
-	}
-	else 
-	{
-		POINT2D point = datum_get_point2d(temporalinst_value(inst));
-		double3 dvalue;
-		double3_set(&dvalue, point.x, point.y, 1);
-		result = temporalinst_make(PointerGetDatum(&dvalue), inst->t,
-			type_oid(T_DOUBLE3));
-	}
-	return result;
-}
-
-static TemporalInst **
-tpointi_transform_tcentroid(TemporalI *ti)
-{
-	TemporalInst **result = palloc(sizeof(TemporalInst *) * ti->count);
-	for (int i = 0; i < ti->count; i++)
-	{
-		TemporalInst *inst = temporali_inst_n(ti, i);
-		result[i] = tpointinst_transform_tcentroid(inst);
-	}
-	return result;
-}
-
-static TemporalSeq *
-tpointseq_transform_tcentroid(TemporalSeq *seq)
-{
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * seq->count);
-	for (int i = 0; i < seq->count; i++)
-	{
-		TemporalInst *inst = temporalseq_inst_n(seq, i);
-		instants[i] = tpointinst_transform_tcentroid(inst);
-	}
-	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, 
-		seq->count, seq->period.lower_inc, seq->period.upper_inc, 
-		MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
-	
-	for (int i = 0; i < seq->count; i++)
-		pfree(instants[i]);
-	pfree(instants);
-		
-	return result;
-}
-
-static TemporalSeq **
-tpoints_transform_tcentroid(TemporalS *ts)
-{
-	TemporalSeq **result = palloc(sizeof(TemporalSeq *) * ts->count);
-	for (int i = 0; i < ts->count; i++)
-	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		result[i] = tpointseq_transform_tcentroid(seq);
-	}
-	return result;
-}
-
-/* Dispatch function  */
-
-static Temporal **
-tpoint_transform_tcentroid(Temporal *temp, int *count)
-{
-	Temporal **result = NULL;
-	if (temp->duration == TEMPORALINST) 
-	{
-		result = palloc(sizeof(Temporal *));
-		result[0] = (Temporal *)tpointinst_transform_tcentroid((TemporalInst *)temp);
-		*count = 1;
-	}
-	else if (temp->duration == TEMPORALI)
-	{
-		result = (Temporal **)tpointi_transform_tcentroid((TemporalI *) temp);
-		*count = ((TemporalI *)temp)->count;
-	} 
-	else if (temp->duration == TEMPORALSEQ)
-	{
-		result = palloc(sizeof(Temporal *));
-		result[0] = (Temporal *)tpointseq_transform_tcentroid((TemporalSeq *) temp);
-		*count = 1;
-	}
-	else if (temp->duration == TEMPORALS)
-	{
-		result = (Temporal **)tpoints_transform_tcentroid((TemporalS *) temp);
-		*count = ((TemporalS *)temp)->count;
-	}
-	assert(result != NULL);
-	return result;
-}
-
 /*****************************************************************************
  * Extent
  *****************************************************************************/
@@ -280,15 +139,443 @@ tpoint_extent_combinefn(PG_FUNCTION_ARGS)
 
 /*****************************************************************************
  * Centroid
+ *
+ * The state of the temporal centroid keeps, for each timestamp, the running
+ * sums of the coordinates together with the number of points added, as flat
+ * doubles. Instants are kept in a single array ordered by timestamp while
+ * sequences are kept as an ordered array of disjoint pieces, each of them
+ * with its own array of running sums. Adding a value thus only touches the
+ * pieces it overlaps and does not allocate a double3/double4 value for each
+ * instant as would be the case with the generic skip list.
  *****************************************************************************/
 
+#define CENTROID_INITIAL_CAPACITY 64
+
+/* Running sums at a timestamp */
+typedef struct
+{
+	TimestampTz t;
+	double x;
+	double y;
+	double z;
+	double count;
+} CentroidPoint;
+
+/* Running sums over a period */
+typedef struct
+{
+	Period period;
+	int count;
+	CentroidPoint *points;
+} CentroidSeq;
+
+/* Aggregate state, either TEMPORALINST or TEMPORALSEQ */
+typedef struct
+{
+	int32_t srid;
+	bool hasz;
+	bool linear;
+	int16 duration;
+	int count;
+	int capacity;
+	CentroidPoint *instants;
+	CentroidSeq *sequences;
+} CentroidState;
+
+static CentroidState *
+tcentroid_state_make(FunctionCallInfo fcinfo, int32_t srid, bool hasz, 
+	bool linear, int16 duration, int capacity)
+{
+	MemoryContext ctx;
+	if (!AggCheckCallContext(fcinfo, &ctx))
+		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+				errmsg("Operation not supported")));
+	CentroidState *result = MemoryContextAllocZero(ctx, sizeof(CentroidState));
+	result->srid = srid;
+	result->hasz = hasz;
+	result->linear = linear;
+	result->duration = duration;
+	result->capacity = Max(capacity, CENTROID_INITIAL_CAPACITY);
+	if (duration == TEMPORALINST)
+		result->instants = MemoryContextAlloc(ctx, 
+			sizeof(CentroidPoint) * result->capacity);
+	else
+		result->sequences = MemoryContextAlloc(ctx, 
+			sizeof(CentroidSeq) * result->capacity);
+	return result;
+}
+
+static void
+tcentroid_state_check(CentroidState *state, int32_t srid, bool hasz, 
+	bool linear, int16 duration)
+{
+	if (state->srid != srid)
+		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+			errmsg("Geometries must have the same SRID for temporal aggregation")));
+	if (state->hasz != hasz)
+		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+			errmsg("Geometries must have the same dimensionality for temporal aggregation")));
+	if (state->duration != duration)
+		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+			errmsg("Cannot aggregate temporal values of different duration")));
+	if (duration == TEMPORALSEQ && state->linear != linear)
+		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+			errmsg("Cannot aggregate temporal values of different interpolation")));
+}
+
+static void
+tcentroid_state_reserve(CentroidState *state, int count)
+{
+	if (count <= state->capacity)
+		return;
+	while (count > state->capacity)
+		state->capacity *= 2;
+	/* repalloc keeps the chunk in the aggregate context */
+	if (state->duration == TEMPORALINST)
+		state->instants = repalloc(state->instants, 
+			sizeof(CentroidPoint) * state->capacity);
+	else
+		state->sequences = repalloc(state->sequences, 
+			sizeof(CentroidSeq) * state->capacity);
+}
+
+static void
+tcentroid_point_set(CentroidPoint *point, TemporalInst *inst, bool hasz)
+{
+	point->t = inst->t;
+	if (hasz)
+	{
+		POINT3DZ p = datum_get_point3dz(temporalinst_value(inst));
+		point->x = p.x;
+		point->y = p.y;
+		point->z = p.z;
+	}
+	else
+	{
+		POINT2D p = datum_get_point2d(temporalinst_value(inst));
+		point->x = p.x;
+		point->y = p.y;
+		point->z = 0;
+	}
+	point->count = 1;
+}
+
+static void
+tcentroid_seq_set(CentroidSeq *result, TemporalSeq *seq, bool hasz)
+{
+	result->period = seq->period;
+	result->count = seq->count;
+	result->points = palloc(sizeof(CentroidPoint) * seq->count);
+	for (int i = 0; i < seq->count; i++)
+		tcentroid_point_set(&result->points[i], temporalseq_inst_n(seq, i), hasz);
+}
+
+/*
+ * Add to the result the running sums of the piece at the timestamp, which 
+ * must be contained in the period of the piece
+ */
+static void
+tcentroid_seq_value_add(const CentroidSeq *seq, TimestampTz t, bool linear,
+	CentroidPoint *result)
+{
+	/* Last point of the piece at or before the timestamp */
+	int first = 0, last = seq->count - 1;
+	while (first < last)
+	{
+		int middle = (first + last + 1) / 2;
+		if (timestamp_cmp_internal(seq->points[middle].t, t) <= 0)
+			first = middle;
+		else
+			last = middle - 1;
+	}
+	const CentroidPoint *point1 = &seq->points[first];
+	if (! linear || first == seq->count - 1 || 
+		timestamp_cmp_internal(point1->t, t) == 0)
+	{
+		result->x += point1->x;
+		result->y += point1->y;
+		result->z += point1->z;
+		result->count += point1->count;
+		return;
+	}
+	const CentroidPoint *point2 = &seq->points[first + 1];
+	double ratio = (double) (t - point1->t) / (double) (point2->t - point1->t);
+	result->x += point1->x + (point2->x - point1->x) * ratio;
+	result->y += point1->y + (point2->y - point1->y) * ratio;
+	result->z += point1->z + (point2->z - point1->z) * ratio;
+	result->count += point1->count + (point2->count - point1->count) * ratio;
+}
+
+/*
+ * Set the result to the sum of one or two pieces over the period given by 
+ * the bounds, which must be covered by the pieces. The points of the 
+ * result are the bounds and the points of the pieces between them, as done
+ * by the synchronization of two sequences. Returns false if the period is
+ * empty.
+ */
+static bool
+tcentroid_seq_at(CentroidSeq *result, const CentroidSeq *seq1, 
+	const CentroidSeq *seq2, TimestampTz lower, TimestampTz upper, 
+	bool lower_inc, bool upper_inc, bool linear)
+{
+	int cmp = timestamp_cmp_internal(lower, upper);
+	if (cmp > 0 || (cmp == 0 && (! lower_inc || ! upper_inc)))
+		return false;
+
+	int count1 = seq1 ? seq1->count : 0;
+	int count2 = seq2 ? seq2->count : 0;
+	TimestampTz *times = palloc(sizeof(TimestampTz) * (count1 + count2 + 2));
+	int i = 0, j = 0, count = 0;
+	times[count++] = lower;
+	while (i < count1 && timestamp_cmp_internal(seq1->points[i].t, lower) <= 0)
+		i++;
+	while (j < count2 && timestamp_cmp_internal(seq2->points[j].t, lower) <= 0)
+		j++;
+	while ((i < count1 && timestamp_cmp_internal(seq1->points[i].t, upper) < 0) ||
+		(j < count2 && timestamp_cmp_internal(seq2->points[j].t, upper) < 0))
+	{
+		TimestampTz t = (j == count2 || (i < count1 && 
+			timestamp_cmp_internal(seq1->points[i].t, seq2->points[j].t) <= 0)) ?
+			seq1->points[i].t : seq2->points[j].t;
+		times[count++] = t;
+		if (i < count1 && timestamp_cmp_internal(seq1->points[i].t, t) == 0)
+			i++;
+		if (j < count2 && timestamp_cmp_internal(seq2->points[j].t, t) == 0)
+			j++;
+	}
+	if (cmp < 0)
+		times[count++] = upper;
+
+	period_set(&result->period, lower, upper, lower_inc, upper_inc);
+	result->count = count;
+	result->points = palloc0(sizeof(CentroidPoint) * count);
+	for (int k = 0; k < count; k++)
+	{
+		result->points[k].t = times[k];
+		if (seq1)
+			tcentroid_seq_value_add(seq1, times[k], linear, &result->points[k]);
+		if (seq2)
+			tcentroid_seq_value_add(seq2, times[k], linear, &result->points[k]);
+	}
+	/* A stepwise piece keeps the previous value at an exclusive upper bound */
+	if (! linear && ! upper_inc && count > 1)
+	{
+		result->points[count - 1] = result->points[count - 2];
+		result->points[count - 1].t = upper;
+	}
+	pfree(times);
+	return true;
+}
+
+/* Add instants ordered by timestamp to the state */
+static void
+tcentroid_add_instants(CentroidState *state, const CentroidPoint *points, 
+	int count)
+{
+	if (count == 0)
+		return;
+	tcentroid_state_reserve(state, state->count + count);
+	/* First instant of the state that is not before the new ones */
+	int first = 0, last = state->count;
+	while (first < last)
+	{
+		int middle = (first + last) / 2;
+		if (timestamp_cmp_internal(state->instants[middle].t, points[0].t) < 0)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	/* Usual case where the values are added in temporal order */
+	if (first == state->count)
+	{
+		memcpy(&state->instants[state->count], points, 
+			sizeof(CentroidPoint) * count);
+		state->count += count;
+		return;
+	}
+
+	/* Merge the new instants with the tail of the state */
+	int tailcount = state->count - first;
+	CentroidPoint *tail = palloc(sizeof(CentroidPoint) * tailcount);
+	memcpy(tail, &state->instants[first], sizeof(CentroidPoint) * tailcount);
+	int i = 0, j = 0, k = first;
+	while (i < tailcount && j < count)
+	{
+		int cmp = timestamp_cmp_internal(tail[i].t, points[j].t);
+		if (cmp == 0)
+		{
+			state->instants[k] = tail[i++];
+			state->instants[k].x += points[j].x;
+			state->instants[k].y += points[j].y;
+			state->instants[k].z += points[j].z;
+			state->instants[k++].count += points[j++].count;
+		}
+		else if (cmp < 0)
+			state->instants[k++] = tail[i++];
+		else
+			state->instants[k++] = points[j++];
+	}
+	while (i < tailcount)
+		state->instants[k++] = tail[i++];
+	while (j < count)
+		state->instants[k++] = points[j++];
+	state->count = k;
+	pfree(tail);
+}
+
+/* 
+ * Add a piece to the state. Only the pieces of the state overlapping the
+ * new one are recomputed, they are replaced by the parts before, between,
+ * and after them together with their intersections with the new piece.
+ */
+static void
+tcentroid_add_seq(CentroidState *state, const CentroidSeq *seq)
+{
+	const Period *s = &seq->period;
+	/* First piece of the state that is not before the new one */
+	int first = 0, last = state->count;
+	while (first < last)
+	{
+		int middle = (first + last) / 2;
+		if (before_period_period_internal(&state->sequences[middle].period,
+				(Period *) s))
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	/* First piece of the state that is after the new one */
+	int start = first;
+	last = state->count;
+	while (first < last)
+	{
+		int middle = (first + last) / 2;
+		if (before_period_period_internal((Period *) s, 
+				&state->sequences[middle].period))
+			last = middle;
+		else
+			first = middle + 1;
+	}
+	int end = first;
+
+	int overlap = end - start;
+	CentroidSeq *pieces = palloc(sizeof(CentroidSeq) * (2 * overlap + 1));
+	int count = 0;
+	if (overlap == 0)
+	{
+		pieces[count].period = seq->period;
+		pieces[count].count = seq->count;
+		pieces[count].points = palloc(sizeof(CentroidPoint) * seq->count);
+		memcpy(pieces[count++].points, seq->points, 
+			sizeof(CentroidPoint) * seq->count);
+	}
+	for (int i = start; i < end; i++)
+	{
+		const CentroidSeq *piece = &state->sequences[i];
+		const Period *p = &piece->period;
+		/* Part before the piece */
+		if (i == start)
+		{
+			if (period_cmp_bounds(p->lower, s->lower, true, true, 
+					p->lower_inc, s->lower_inc) < 0)
+				count += tcentroid_seq_at(&pieces[count], piece, NULL, 
+					p->lower, s->lower, p->lower_inc, ! s->lower_inc, 
+					state->linear);
+			else
+				count += tcentroid_seq_at(&pieces[count], seq, NULL, 
+					s->lower, p->lower, s->lower_inc, ! p->lower_inc, 
+					state->linear);
+		}
+		else
+		{
+			const Period *prev = &state->sequences[i - 1].period;
+			count += tcentroid_seq_at(&pieces[count], seq, NULL, prev->upper,
+				p->lower, ! prev->upper_inc, ! p->lower_inc, state->linear);
+		}
+		/* Intersection of the piece and the new one */
+		bool lowerp = period_cmp_bounds(p->lower, s->lower, true, true,
+			p->lower_inc, s->lower_inc) > 0;
+		bool upperp = period_cmp_bounds(p->upper, s->upper, false, false,
+			p->upper_inc, s->upper_inc) < 0;
+		count += tcentroid_seq_at(&pieces[count], piece, seq, 
+			lowerp ? p->lower : s->lower, upperp ? p->upper : s->upper, 
+			lowerp ? p->lower_inc : s->lower_inc, 
+			upperp ? p->upper_inc : s->upper_inc, state->linear);
+		/* Part after the piece */
+		if (i == end - 1)
+		{
+			if (period_cmp_bounds(p->upper, s->upper, false, false, 
+					p->upper_inc, s->upper_inc) > 0)
+				count += tcentroid_seq_at(&pieces[count], piece, NULL, 
+					s->upper, p->upper, ! s->upper_inc, p->upper_inc, 
+					state->linear);
+			else
+				count += tcentroid_seq_at(&pieces[count], seq, NULL, 
+					p->upper, s->upper, ! p->upper_inc, s->upper_inc, 
+					state->linear);
+		}
+	}
+
+	/* Replace the overlapping pieces of the state by the new ones */
+	for (int i = start; i < end; i++)
+		pfree(state->sequences[i].points);
+	tcentroid_state_reserve(state, state->count - overlap + count);
+	memmove(&state->sequences[start + count], &state->sequences[end],
+		sizeof(CentroidSeq) * (state->count - end));
+	memcpy(&state->sequences[start], pieces, sizeof(CentroidSeq) * count);
+	state->count += count - overlap;
+	pfree(pieces);
+}
+
+/* Add a temporal point to the state */
+static void
+tcentroid_add_temporal(CentroidState *state, Temporal *temp)
+{
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST)
+	{
+		CentroidPoint point;
+		tcentroid_point_set(&point, (TemporalInst *) temp, state->hasz);
+		tcentroid_add_instants(state, &point, 1);
+	}
+	else if (temp->duration == TEMPORALI)
+	{
+		TemporalI *ti = (TemporalI *) temp;
+		CentroidPoint *points = palloc(sizeof(CentroidPoint) * ti->count);
+		for (int i = 0; i < ti->count; i++)
+			tcentroid_point_set(&points[i], temporali_inst_n(ti, i), state->hasz);
+		tcentroid_add_instants(state, points, ti->count);
+		pfree(points);
+	}
+	else if (temp->duration == TEMPORALSEQ)
+	{
+		CentroidSeq seq;
+		tcentroid_seq_set(&seq, (TemporalSeq *) temp, state->hasz);
+		tcentroid_add_seq(state, &seq);
+		pfree(seq.points);
+	}
+	else if (temp->duration == TEMPORALS)
+	{
+		TemporalS *ts = (TemporalS *) temp;
+		for (int i = 0; i < ts->count; i++)
+		{
+			CentroidSeq seq;
+			tcentroid_seq_set(&seq, temporals_seq_n(ts, i), state->hasz);
+			tcentroid_add_seq(state, &seq);
+			pfree(seq.points);
+		}
+	}
+}
+
+/*****************************************************************************/
+/* Centroid transition function */
+
 PG_FUNCTION_INFO_V1(tpoint_tcentroid_transfn);
 
 PGDLLEXPORT Datum
 tpoint_tcentroid_transfn(PG_FUNCTION_ARGS)
 {
-	SkipList *state = PG_ARGISNULL(0) ? NULL : 
-		(SkipList *) PG_GETARG_POINTER(0);
+	CentroidState *state = PG_ARGISNULL(0) ? NULL : 
+		(CentroidState *) PG_GETARG_POINTER(0);
 	if (PG_ARGISNULL(1))
 	{
 		if (state)
@@ -298,38 +585,20 @@ tpoint_tcentroid_transfn(PG_FUNCTION_ARGS)
 	}
 	Temporal *temp = PG_GETARG_TEMPORAL(1);
 
-	geoaggstate_check_t(state, temp);
-	Datum (*func)(Datum, Datum) = MOBDB_FLAGS_GET_Z(temp->flags) ?
-		&datum_sum_double4 : &datum_sum_double3;
-
-	int count;
-	Temporal **temporals = tpoint_transform_tcentroid(temp, &count);
+	int32_t srid = tpoint_srid_internal(temp);
+	bool hasz = MOBDB_FLAGS_GET_Z(temp->flags) != 0;
+	bool linear = MOBDB_FLAGS_GET_LINEAR(temp->flags) != 0;
+	int16 duration = (temp->duration == TEMPORALINST || 
+		temp->duration == TEMPORALI) ? TEMPORALINST : TEMPORALSEQ;
 	if (state)
-	{
-		if (skiplist_headval(state)->duration != temporals[0]->duration)
-			ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-				errmsg("Cannot aggregate temporal values of different duration")));
-		if (MOBDB_FLAGS_GET_LINEAR(skiplist_headval(state)->flags) != 
-				MOBDB_FLAGS_GET_LINEAR(temporals[0]->flags))
-			ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-				errmsg("Cannot aggregate temporal values of different interpolation")));
-
-		skiplist_splice(fcinfo, state, temporals, count, func, false);
-	}
+		tcentroid_state_check(state, srid, hasz, linear, duration);
 	else
-	{
-		state = skiplist_make(fcinfo, temporals, count);
-		struct GeoAggregateState extra =
-		{
-			.srid = tpoint_srid_internal(temp),
-			.hasz = MOBDB_FLAGS_GET_Z(temp->flags) != 0
-		};
-		aggstate_set_extra(fcinfo, state, &extra, sizeof(struct GeoAggregateState));
-	}
+		state = tcentroid_state_make(fcinfo, srid, hasz, linear, duration, 0);
+
+	MemoryContext oldctx = MemoryContextSwitchTo(GetMemoryChunkContext(state));
+	tcentroid_add_temporal(state, temp);
+	MemoryContextSwitchTo(oldctx);
 
-	for (int i = 0; i< count; i++)
-		pfree(temporals[i]);
-	pfree(temporals);		
 	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_POINTER(state);
 }
@@ -342,119 +611,168 @@ PG_FUNCTION_INFO_V1(tpoint_tcentroid_combinefn);
 PGDLLEXPORT Datum
 tpoint_tcentroid_combinefn(PG_FUNCTION_ARGS)
 {
-	SkipList *state1 = PG_ARGISNULL(0) ? NULL : 
-		(SkipList *) PG_GETARG_POINTER(0);
-	SkipList *state2 = PG_ARGISNULL(1) ? NULL :
-		(SkipList *) PG_GETARG_POINTER(1);
-
-	geoaggstate_check_as(state1, state2);
-	struct GeoAggregateState *extra = NULL;
-	if (state1 && state1->extra) 
-		extra = state1->extra;
-	if (state2 && state2->extra) 
-		extra = state2->extra;
-	assert(extra != NULL);
-	Datum (*func)(Datum, Datum) = extra->hasz ?
-		&datum_sum_double4 : &datum_sum_double3;
-	SkipList *result = temporal_tagg_combinefn(fcinfo, state1, state2, 
-		func, false);
+	CentroidState *state1 = PG_ARGISNULL(0) ? NULL : 
+		(CentroidState *) PG_GETARG_POINTER(0);
+	CentroidState *state2 = PG_ARGISNULL(1) ? NULL :
+		(CentroidState *) PG_GETARG_POINTER(1);
+	if (! state1 && ! state2)
+		PG_RETURN_NULL();
+	if (! state2)
+		PG_RETURN_POINTER(state1);
+	if (! state1)
+		PG_RETURN_POINTER(state2);
+
+	tcentroid_state_check(state1, state2->srid, state2->hasz, state2->linear,
+		state2->duration);
+	MemoryContext oldctx = MemoryContextSwitchTo(GetMemoryChunkContext(state1));
+	if (state1->duration == TEMPORALINST)
+		tcentroid_add_instants(state1, state2->instants, state2->count);
+	else
+	{
+		for (int i = 0; i < state2->count; i++)
+			tcentroid_add_seq(state1, &state2->sequences[i]);
+	}
+	MemoryContextSwitchTo(oldctx);
 
-	PG_RETURN_POINTER(result);
+	PG_RETURN_POINTER(state1);
 }
 
 /*****************************************************************************/
+/* Centroid serialize and deserialize functions */
 
-/* Centroid final function */
+PG_FUNCTION_INFO_V1(tpoint_tcentroid_serialize);
 
-TemporalI *
-tpointinst_tcentroid_finalfn(TemporalInst **instants, int count)
+PGDLLEXPORT Datum
+tpoint_tcentroid_serialize(PG_FUNCTION_ARGS)
 {
-	TemporalInst **newinstants = palloc(sizeof(TemporalInst *) * count);
-	for (int i = 0; i < count; i++)
+	CentroidState *state = (CentroidState *) PG_GETARG_POINTER(0);
+	StringInfoData buf;
+	pq_begintypsend(&buf);
+	pq_sendint32(&buf, (uint32) state->srid);
+	pq_sendbyte(&buf, state->hasz ? 1 : 0);
+	pq_sendbyte(&buf, state->linear ? 1 : 0);
+	pq_sendint16(&buf, (uint16) state->duration);
+	pq_sendint32(&buf, (uint32) state->count);
+	/* The running sums are sent as is since the workers share the binary format */
+	if (state->duration == TEMPORALINST)
+		pq_sendbytes(&buf, (char *) state->instants, 
+			(int) (sizeof(CentroidPoint) * state->count));
+	else
 	{
-		TemporalInst *inst = instants[i];
-		Datum value = 0;
-		assert(inst->valuetypid == type_oid(T_DOUBLE4) || 
-			inst->valuetypid == type_oid(T_DOUBLE3));
-		if (inst->valuetypid == type_oid(T_DOUBLE4))
+		for (int i = 0; i < state->count; i++)
 		{
-			double4 *value4 = (double4 *)DatumGetPointer(temporalinst_value(inst));
-			assert(value4->d != 0);
-			double valuea = value4->a / value4->d;
-			double valueb = value4->b / value4->d;
-			double valuec = value4->c / value4->d;
-			value = call_function3(LWGEOM_makepoint, Float8GetDatum(valuea),
-				Float8GetDatum(valueb), Float8GetDatum(valuec));
+			CentroidSeq *seq = &state->sequences[i];
+			pq_sendbytes(&buf, (char *) &seq->period, sizeof(Period));
+			pq_sendint32(&buf, (uint32) seq->count);
+			pq_sendbytes(&buf, (char *) seq->points, 
+				(int) (sizeof(CentroidPoint) * seq->count));
 		}
-		else if (inst->valuetypid == type_oid(T_DOUBLE3))
+	}
+	PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
+}
+
+PG_FUNCTION_INFO_V1(tpoint_tcentroid_deserialize);
+
+PGDLLEXPORT Datum
+tpoint_tcentroid_deserialize(PG_FUNCTION_ARGS)
+{
+	bytea *data = PG_GETARG_BYTEA_P(0);
+	StringInfoData buf =
+	{
+		.cursor = 0,
+		.data = VARDATA(data),
+		.len = VARSIZE(data) - VARHDRSZ,
+		.maxlen = VARSIZE(data) - VARHDRSZ
+	};
+	int32_t srid = (int32_t) pq_getmsgint(&buf, 4);
+	bool hasz = pq_getmsgbyte(&buf) != 0;
+	bool linear = pq_getmsgbyte(&buf) != 0;
+	int16 duration = (int16) pq_getmsgint(&buf, 2);
+	int count = pq_getmsgint(&buf, 4);
+	CentroidState *result = tcentroid_state_make(fcinfo, srid, hasz, linear,
+		duration, count);
+	if (duration == TEMPORALINST)
+		memcpy(result->instants, pq_getmsgbytes(&buf, 
+			(int) (sizeof(CentroidPoint) * count)), sizeof(CentroidPoint) * count);
+	else
+	{
+		MemoryContext oldctx = MemoryContextSwitchTo(GetMemoryChunkContext(result));
+		for (int i = 0; i < count; i++)
 		{
-			double3 *value3 = (double3 *)DatumGetPointer(temporalinst_value(inst));
-			assert(value3->c != 0);
-			double valuea = value3->a / value3->c;
-			double valueb = value3->b / value3->c;
-			value = call_function2(LWGEOM_makepoint, Float8GetDatum(valuea),
-				Float8GetDatum(valueb));
+			CentroidSeq *seq = &result->sequences[i];
+			memcpy(&seq->period, pq_getmsgbytes(&buf, sizeof(Period)), 
+				sizeof(Period));
+			seq->count = pq_getmsgint(&buf, 4);
+			seq->points = palloc(sizeof(CentroidPoint) * seq->count);
+			memcpy(seq->points, pq_getmsgbytes(&buf, 
+				(int) (sizeof(CentroidPoint) * seq->count)), 
+				sizeof(CentroidPoint) * seq->count);
 		}
-		newinstants[i] = temporalinst_make(value, inst->t, type_oid(T_GEOMETRY));
-		pfree(DatumGetPointer(value));
+		MemoryContextSwitchTo(oldctx);
 	}
-	TemporalI *result = temporali_from_temporalinstarr(newinstants, count);
+	result->count = count;
+	pq_getmsgend(&buf);
+	PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************/
+/* Centroid final function */
 
-	for (int i = 0; i < count; i++)
-		pfree(newinstants[i]);
-	pfree(newinstants);
-	
+static TemporalInst *
+tcentroid_point_finalfn(const CentroidPoint *point, int32_t srid, bool hasz)
+{
+	LWPOINT *lwpoint;
+	assert(point->count != 0);
+	if (hasz)
+		lwpoint = lwpoint_make3dz(srid, point->x / point->count, 
+			point->y / point->count, point->z / point->count);
+	else
+		lwpoint = lwpoint_make2d(srid, point->x / point->count, 
+			point->y / point->count);
+	Datum value = PointerGetDatum(geometry_serialize((LWGEOM *) lwpoint));
+	TemporalInst *result = temporalinst_make(value, point->t, 
+		type_oid(T_GEOMETRY));
+	lwpoint_free(lwpoint);
+	pfree(DatumGetPointer(value));
 	return result;
 }
 
-TemporalS *
-tpointseq_tcentroid_finalfn(TemporalSeq **sequences, int count)
+static TemporalI *
+tcentroid_instants_finalfn(CentroidState *state)
 {
-	TemporalSeq **newsequences = palloc(sizeof(TemporalSeq *) * count);
-	for (int i = 0; i < count; i++)
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * state->count);
+	for (int i = 0; i < state->count; i++)
+		instants[i] = tcentroid_point_finalfn(&state->instants[i], 
+			state->srid, state->hasz);
+	TemporalI *result = temporali_from_temporalinstarr(instants, state->count);
+	for (int i = 0; i < state->count; i++)
+		pfree(instants[i]);
+	pfree(instants);
+	return result;
+}
+
+static TemporalS *
+tcentroid_sequences_finalfn(CentroidState *state)
+{
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * state->count);
+	for (int i = 0; i < state->count; i++)
 	{
-		TemporalSeq *seq = sequences[i];
+		CentroidSeq *seq = &state->sequences[i];
 		TemporalInst **instants = palloc(sizeof(TemporalInst *) * seq->count);
 		for (int j = 0; j < seq->count; j++)
-		{
-			TemporalInst *inst = temporalseq_inst_n(seq, j);
-			Datum value = 0;
-			assert(inst->valuetypid == type_oid(T_DOUBLE4) || 
-				inst->valuetypid == type_oid(T_DOUBLE3));
-			if (inst->valuetypid == type_oid(T_DOUBLE4))
-			{
-				double4 *value4 = (double4 *)DatumGetPointer(temporalinst_value(inst));
-				double valuea = value4->a / value4->d;
-				double valueb = value4->b / value4->d;
-				double valuec = value4->c / value4->d;
-				value = call_function3(LWGEOM_makepoint, Float8GetDatum(valuea),
-					Float8GetDatum(valueb), Float8GetDatum(valuec));
-			}
-			else if (inst->valuetypid == type_oid(T_DOUBLE3))
-			{
-				double3 *value3 = (double3 *)DatumGetPointer(temporalinst_value(inst));
-				double valuea = value3->a / value3->c;
-				double valueb = value3->b / value3->c;
-				value = call_function2(LWGEOM_makepoint, Float8GetDatum(valuea),
-					Float8GetDatum(valueb));
-			}
-			instants[j] = temporalinst_make(value, inst->t, type_oid(T_GEOMETRY));
-			pfree(DatumGetPointer(value));
-		}
-		newsequences[i] = temporalseq_from_temporalinstarr(instants, 
-			seq->count, seq->period.lower_inc, seq->period.upper_inc, 
-			MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
+			instants[j] = tcentroid_point_finalfn(&seq->points[j], 
+				state->srid, state->hasz);
+		sequences[i] = temporalseq_from_temporalinstarr(instants, seq->count,
+			seq->period.lower_inc, seq->period.upper_inc, state->linear, true);
 		for (int j = 0; j < seq->count; j++)
 			pfree(instants[j]);
 		pfree(instants);
 	}
-	TemporalS *result = temporals_from_temporalseqarr(newsequences, count, 
-		MOBDB_FLAGS_GET_LINEAR(newsequences[0]->flags), true);
-
-	for (int i = 0; i < count; i++)
-		pfree(newsequences[i]);
-	pfree(newsequences);
-	
+	TemporalS *result = temporals_from_temporalseqarr(sequences, state->count,
+		state->linear, true);
+	for (int i = 0; i < state->count; i++)
+		pfree(sequences[i]);
+	pfree(sequences);
 	return result;
 }
 
@@ -464,27 +782,14 @@ PGDLLEXPORT Datum
 tpoint_tcentroid_finalfn(PG_FUNCTION_ARGS)
 {
 	/* The final function is strict, we do not need to test for null values */
-	SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
-	if (state->length == 0)
+	CentroidState *state = (CentroidState *) PG_GETARG_POINTER(0);
+	if (state->count == 0)
 		PG_RETURN_NULL();
 
-	Temporal **values = skiplist_values(state);
-	Temporal *result = NULL;
-	assert(values[0]->duration == TEMPORALINST ||
-		values[0]->duration == TEMPORALSEQ);
-	if (values[0]->duration == TEMPORALINST)
-		result = (Temporal *)tpointinst_tcentroid_finalfn(
-			(TemporalInst **)values, state->length);
-	else if (values[0]->duration == TEMPORALSEQ)
-		result = (Temporal *)tpointseq_tcentroid_finalfn(
-			(TemporalSeq **)values, state->length);
-
-	int32_t srid = ((struct GeoAggregateState *) state->extra)->srid;
-	Temporal *sridresult = tpoint_set_srid_internal(result, srid);
-	pfree(values);
-	pfree(result);
-
-	PG_RETURN_POINTER(sridresult);
+	Temporal *result = (state->duration == TEMPORALINST) ?
+		(Temporal *) tcentroid_instants_finalfn(state) :
+		(Temporal *) tcentroid_sequences_finalfn(state);
+	PG_RETURN_POINTER(result);
 }
 
 /*****************************************************************************/
@@ -22,6 +22,15 @@
  * For the time dimension, the statistics collected in Slots 3 and 4 depend on 
  * the duration. Please refer to file temporal_analyze.c for more information.
  * 
+ * Finally, a joint spatiotemporal histogram is collected in the next free slot
+ * - Slot 5
+ * 		- stakind contains the type of statistics which is STATISTIC_KIND_NDT.
+ * 		- stanumbers stores the (X, Y, [Z,] T) histogram of occurrence of
+ * 		  features, with the same layout as the ND histogram of PostGIS.
+ * This histogram captures the correlation between space and time that is 
+ * lost when the selectivity of the spatial and time dimensions is estimated 
+ * separately and multiplied.
+ * 
  * Portions Copyright (c) 2020, Esteban Zimanyi, Mahmoud Sakr, Mohamed Bakli,
  *		Universite Libre de Bruxelles
  * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
@@ -327,6 +336,46 @@ nd_box_from_gbox(const GBOX *gbox, ND_BOX *nd_box)
 	}
 }
 
+/** 
+* Set the values of an #ND_BOX from the spatial dimensions of an #STBOX.
+* As for a #GBOX, geodetic boxes have three dimensions.
+*/
+void
+nd_box_from_stbox(const STBOX *box, ND_BOX *nd_box)
+{
+	int d = 0;
+
+	nd_box_init(nd_box);
+	nd_box->min[d] = (float4) box->xmin;
+	nd_box->max[d] = (float4) box->xmax;
+	d++;
+	nd_box->min[d] = (float4) box->ymin;
+	nd_box->max[d] = (float4) box->ymax;
+	d++;
+	if (MOBDB_FLAGS_GET_GEODETIC(box->flags) ||
+		MOBDB_FLAGS_GET_Z(box->flags))
+	{
+		nd_box->min[d] = (float4) box->zmin;
+		nd_box->max[d] = (float4) box->zmax;
+	}
+}
+
+/**
+* Return true if the spatial dimensions of an #STBOX are finite and not NaN
+*/
+static bool
+stbox_is_valid_nd(const STBOX *box)
+{
+	if (! MOBDB_FLAGS_GET_X(box->flags) ||
+		! isfinite(box->xmin) || ! isfinite(box->xmax) ||
+		! isfinite(box->ymin) || ! isfinite(box->ymax))
+		return false;
+	if (MOBDB_FLAGS_GET_Z(box->flags) &&
+		(! isfinite(box->zmin) || ! isfinite(box->zmax)))
+		return false;
+	return true;
+}
+
 /**
 * The difference between the fourth and first quintile values,
 * the "inter-quintile range"
@@ -518,10 +567,10 @@ nd_box_array_distribution(const ND_BOX **nd_boxes, int num_boxes, const ND_BOX *
  * can then use the histogram
  */
 
-void
-gserialized_compute_stats(VacAttrStats *stats, int sample_rows, int total_rows,
+static ND_STATS *
+nd_stats_compute(VacAttrStats *stats, int sample_rows, int total_rows,
 	double notnull_cnt, const ND_BOX **sample_boxes, ND_BOX *sum, 
-	ND_BOX *sample_extent, int *slot_idx, int ndims)
+	ND_BOX *sample_extent, int ndims, size_t *nd_stats_size_out)
 {
 	MemoryContext old_context;
 	int d, i;						/* Counters */
@@ -547,9 +596,6 @@ gserialized_compute_stats(VacAttrStats *stats, int sample_rows, int total_rows,
 	double sample_distribution[ND_DIMS]; /* How homogeneous is distribution of sample in each axis? */
 	double total_distribution;		/* Total of sample_distribution */
 
-	int stats_slot;					/* What slot is this data going into? (2D vs ND) */
-	int stats_kind;					/* And this is what? (2D vs ND) */
-
 	/* Initialize boxes */
 	nd_box_init(&avg);
 	nd_box_init(&stddev);
@@ -572,8 +618,7 @@ gserialized_compute_stats(VacAttrStats *stats, int sample_rows, int total_rows,
 	if (! notnull_cnt)
 	{
 		elog(NOTICE, "no non-null/empty features, unable to compute statistics");
-		stats->stats_valid = false;
-		return;
+		return NULL;
 	}
 
 	/*
@@ -812,14 +857,35 @@ gserialized_compute_stats(VacAttrStats *stats, int sample_rows, int total_rows,
 	if (! histogram_features)
 	{
 		elog(NOTICE, " no features lie in the stats histogram, invalid stats");
-		stats->stats_valid = false;
-		return;
+		return NULL;
 	}
 
 	nd_stats->histogram_features = histogram_features;
 	nd_stats->histogram_cells = histo_cells;
 	nd_stats->cells_covered = (float4) total_cell_count;
 
+	*nd_stats_size_out = nd_stats_size;
+	return nd_stats;
+}
+
+void
+gserialized_compute_stats(VacAttrStats *stats, int sample_rows, int total_rows,
+	double notnull_cnt, const ND_BOX **sample_boxes, ND_BOX *sum, 
+	ND_BOX *sample_extent, int *slot_idx, int ndims)
+{
+	ND_STATS *nd_stats;				/* Our histogram */
+	size_t	nd_stats_size;		   /* Size of the histogram */
+	int stats_slot;					/* What slot is this data going into? (2D vs ND) */
+	int stats_kind;					/* And this is what? (2D vs ND) */
+
+	nd_stats = nd_stats_compute(stats, sample_rows, total_rows, notnull_cnt,
+		sample_boxes, sum, sample_extent, ndims, &nd_stats_size);
+	if (! nd_stats)
+	{
+		stats->stats_valid = false;
+		return;
+	}
+
 	/* Put this histogram data into the right slot/kind */
 	if (ndims == 2)
 	{
@@ -841,6 +907,36 @@ gserialized_compute_stats(VacAttrStats *stats, int sample_rows, int total_rows,
 	(*slot_idx)++;
 }
 
+/*
+ * Compute the joint spatiotemporal histogram from the sample boxes that 
+ * have the time dimension as their last dimension. The histogram is stored
+ * in the next free slot, if any, and its absence is not an error since the
+ * selectivity functions fall back to the separate spatial and time 
+ * statistics.
+ */
+static void
+ndt_compute_stats(VacAttrStats *stats, int sample_rows, int total_rows,
+	double notnull_cnt, const ND_BOX **sample_boxes, ND_BOX *sum, 
+	ND_BOX *sample_extent, int *slot_idx, int ndims)
+{
+	ND_STATS *nd_stats;
+	size_t	nd_stats_size;
+
+	if (*slot_idx >= STATISTIC_NUM_SLOTS)
+		return;
+
+	nd_stats = nd_stats_compute(stats, sample_rows, total_rows, notnull_cnt,
+		sample_boxes, sum, sample_extent, ndims, &nd_stats_size);
+	if (! nd_stats)
+		return;
+
+	stats->stakind[*slot_idx] = STATISTIC_KIND_NDT;
+	stats->staop[*slot_idx] = InvalidOid;
+	stats->stanumbers[*slot_idx] = (float4*) nd_stats;
+	stats->numnumbers[*slot_idx] = (int) (nd_stats_size/sizeof(float4));
+	(*slot_idx)++;
+}
+
 static void
 tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 	int sample_rows, double total_rows)
@@ -853,13 +949,17 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 	ND_BOX sum;						/* Sum of extents of sample boxes */
 	const ND_BOX **sample_boxes;	/* ND_BOXes for each of the sample features */
 	ND_BOX sample_extent;			/* Extent of the raw sample */
+	ND_BOX ndt_sum;					/* Sum of extents of spatiotemporal boxes */
+	const ND_BOX **ndt_boxes;		/* Spatiotemporal ND_BOXes of the sample */
+	ND_BOX ndt_extent;				/* Spatiotemporal extent of the raw sample */
 	int   ndims = 2;				/* Dimensionality of the sample */
 	float8 *time_lengths;
 	PeriodBound *time_lowers,
 		   *time_uppers;
 
-	/* Initialize sum */
+	/* Initialize sums */
 	nd_box_init(&sum);
+	nd_box_init(&ndt_sum);
 
 	/*
 	 * This is where gserialized_analyze_nd
@@ -872,6 +972,7 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 	 * its worth saving...
 	 */
 	sample_boxes = palloc(sizeof(ND_BOX *) * sample_rows);
+	ndt_boxes = palloc(sizeof(ND_BOX *) * sample_rows);
 
 	time_lowers = (PeriodBound *) palloc(sizeof(PeriodBound) * sample_rows);
 	time_uppers = (PeriodBound *) palloc(sizeof(PeriodBound) * sample_rows);
@@ -891,12 +992,11 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 	{
 		Datum value;
 		Temporal *temp;
-		GSERIALIZED *traj;
+		STBOX box;
 		Period period;
 		PeriodBound period_lower,
 				period_upper;
-		GBOX gbox;
-		ND_BOX *nd_box;
+		ND_BOX *nd_box, *ndt_box;
 		bool is_null;
 		bool is_copy;
 
@@ -911,15 +1011,19 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 
 		/* Get temporal point */
 		temp = DatumGetTemporal(value);
-
-		/* TO VERIFY */
-		is_copy = VARATT_IS_EXTENDED(temp);
+		is_copy = (Pointer) temp != DatumGetPointer(value);
 
 		/* How many bytes does this sample use? */
 		total_width += VARSIZE(temp);
 
-		/* Get trajectory and period from temporal point */
-		traj = (GSERIALIZED *) DatumGetPointer(tpoint_values_internal(temp));
+		/* 
+		 * Get the bounding box and the period from temporal point. The 
+		 * bounding box is precomputed for all durations but TemporalInst,
+		 * for which it is computed from a single point, so there is no need
+		 * to construct the trajectory of the temporal point.
+		 */
+		memset(&box, 0, sizeof(STBOX));
+		temporal_bbox(&box, temp);
 		temporal_period(&period, temp);
 
 		/* Remember time bounds and length for further usage in histograms */
@@ -929,42 +1033,43 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 		time_lengths[notnull_cnt] = period_to_secs(period_upper.val, 
 			period_lower.val);
 
-		/* Read the bounds from the trajectory. */
-		if (LW_FAILURE == gserialized_get_gbox_p(traj, &gbox))
-		{
-			/* Skip empties too. */
-			continue;
-		}
-
 		/* Check bounds for validity (finite and not NaN) */
-		if (! gbox_is_valid(&gbox))
+		if (! stbox_is_valid_nd(&box))
 		{
+			if (is_copy)
+				pfree(temp);
 			continue;
 		}
 
-		/* If we're in 2D/3D mode, zero out the higher dimensions for "safety" 
-		 * If we're in 3D mode set ndims to 3 */
-		if (! MOBDB_FLAGS_GET_Z(temp->flags))
-			gbox.zmin = gbox.zmax = gbox.mmin = gbox.mmax = 0.0;
-		else
-		{
-			gbox.mmin = gbox.mmax = 0.0;
+		/* If we're in 3D mode set ndims to 3 */
+		if (MOBDB_FLAGS_GET_Z(temp->flags))
 			ndims = 3;
-		}
 
-		/* Convert gbox to n-d box */
+		/* Convert the bounding box to n-d box */
 		nd_box = palloc0(sizeof(ND_BOX));
-		nd_box_from_gbox(&gbox, nd_box);
+		nd_box_from_stbox(&box, nd_box);
 
 		/* Cache n-d bounding box */
 		sample_boxes[notnull_cnt] = nd_box;
 
-		/* Initialize sample extent before merging first entry */
+		/* Cache n-d bounding box extended with the time dimension, which is
+		 * always the last one so that 2D and 3D points share the code */
+		ndt_box = palloc(sizeof(ND_BOX));
+		memcpy(ndt_box, nd_box, sizeof(ND_BOX));
+		ndt_box->min[ndims] = STATS_TIMESTAMP(period.lower);
+		ndt_box->max[ndims] = STATS_TIMESTAMP(period.upper);
+		ndt_boxes[notnull_cnt] = ndt_box;
+
+		/* Initialize sample extents before merging first entry */
 		if (! notnull_cnt)
+		{
 			nd_box_init_bounds(&sample_extent, ndims);
+			nd_box_init_bounds(&ndt_extent, ndims + 1);
+		}
 
 		/* Add current sample to overall sample extent */
 		nd_box_merge(nd_box, &sample_extent, ndims);
+		nd_box_merge(ndt_box, &ndt_extent, ndims + 1);
 
 		/* Add bounds coordinates to sums for stddev calculation */
 		for (d = 0; d < ndims; d++)
@@ -972,6 +1077,11 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 			sum.min[d] += nd_box->min[d];
 			sum.max[d] += nd_box->max[d];
 		}
+		for (d = 0; d <= ndims; d++)
+		{
+			ndt_sum.min[d] += ndt_box->min[d];
+			ndt_sum.max[d] += ndt_box->max[d];
+		}
 
 		/* Increment our "good feature" count */
 		notnull_cnt++;
@@ -979,7 +1089,6 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 		/* Free up memory if our sample temporal point was copied */
 		if (is_copy)
 			pfree(temp);
-		pfree(traj);
 
 		/* Give backend a chance of interrupting us */
 		vacuum_delay_point();
@@ -1007,6 +1116,10 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 		/* Compute statistics for time dimension */
 		period_compute_stats1(stats, notnull_cnt, &slot_idx,
 			time_lowers, time_uppers, time_lengths);
+
+		/* Compute joint statistics for the spatial and time dimensions */
+		ndt_compute_stats(stats, sample_rows, (int) total_rows, notnull_cnt,
+			ndt_boxes, &ndt_sum, &ndt_extent, &slot_idx, ndims + 1);
 	}
 	else if (null_cnt > 0)
 	{
@@ -471,13 +471,11 @@ PG_FUNCTION_INFO_V1(tpoint_expand_spatial);
 PGDLLEXPORT Datum
 tpoint_expand_spatial(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	double d = PG_GETARG_FLOAT8(1);
 	STBOX box;
 	memset(&box, 0, sizeof(STBOX));
-	temporal_bbox(&box, temp);
+	temporal_bbox_slice(&box, PG_GETARG_DATUM(0));
 	STBOX *result = stbox_expand_spatial_internal(&box, d);
-	PG_FREE_IF_COPY(temp, 0);	
 	PG_RETURN_POINTER(result);
 }
 
@@ -520,13 +518,11 @@ PG_FUNCTION_INFO_V1(tpoint_expand_temporal);
 PGDLLEXPORT Datum
 tpoint_expand_temporal(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Datum interval = PG_GETARG_DATUM(1);
 	STBOX box;
 	memset(&box, 0, sizeof(STBOX));
-	temporal_bbox(&box, temp);
+	temporal_bbox_slice(&box, PG_GETARG_DATUM(0));
 	STBOX *result = stbox_expand_temporal_internal(&box, interval);
-	PG_FREE_IF_COPY(temp, 0);	
 	PG_RETURN_POINTER(result);
 }
 
@@ -565,12 +561,10 @@ PGDLLEXPORT Datum
 overlaps_bbox_stbox_tpoint(PG_FUNCTION_ARGS)
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(1));
 	bool result = overlaps_stbox_stbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -606,13 +600,11 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_tpoint_stbox);
 PGDLLEXPORT Datum
 overlaps_bbox_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
 	bool result = overlaps_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -671,12 +663,10 @@ PGDLLEXPORT Datum
 contains_bbox_stbox_tpoint(PG_FUNCTION_ARGS)
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(1));
 	bool result = contains_stbox_stbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -712,13 +702,11 @@ PG_FUNCTION_INFO_V1(contains_bbox_tpoint_stbox);
 PGDLLEXPORT Datum
 contains_bbox_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
 	bool result = contains_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -777,12 +765,10 @@ PGDLLEXPORT Datum
 contained_bbox_stbox_tpoint(PG_FUNCTION_ARGS)
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(1));
 	bool result = contained_stbox_stbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -818,13 +804,11 @@ PG_FUNCTION_INFO_V1(contained_bbox_tpoint_stbox);
 PGDLLEXPORT Datum
 contained_bbox_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
 	bool result = contained_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -883,12 +867,10 @@ PGDLLEXPORT Datum
 same_bbox_stbox_tpoint(PG_FUNCTION_ARGS)
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(1));
 	bool result = same_stbox_stbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -924,13 +906,11 @@ PG_FUNCTION_INFO_V1(same_bbox_tpoint_stbox);
 PGDLLEXPORT Datum
 same_bbox_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
 	bool result = same_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -12,11 +12,14 @@
 
 #include "tpoint_gist.h"
 
+#include <float.h>
+#include <math.h>
 #include <utils/timestamp.h>
 #include <access/gist.h>
 
 #include "temporaltypes.h"
 #include "oidcache.h"
+#include "temporal_util.h"
 #include "tpoint.h"
 #include "tpoint_boxops.h"
 #include "tpoint_posops.h"
@@ -235,6 +238,40 @@ index_tpoint_recheck(StrategyNumber strategy)
 	}
 }
 
+/*
+ * Transform the query argument of the consistent method into a box
+ * initializing the dimensions that must not be taken into account by the
+ * operators to infinity. Returns false if the query is empty.
+ */
+static bool
+gist_tpoint_query_stbox(FunctionCallInfo fcinfo, STBOX *query, Oid subtype)
+{
+	if (subtype == type_oid(T_GEOMETRY) || subtype == type_oid(T_GEOGRAPHY))
+	{
+		/* Since function gist_tpoint_consistent is strict, query is not NULL */
+		if (!geo_to_stbox_internal(query, PG_GETARG_GSERIALIZED_P(1)))
+			return false;
+	}
+	else if (subtype == type_oid(T_STBOX))
+	{
+		STBOX *box = PG_GETARG_STBOX_P(1);
+		if (box == NULL)
+			return false;
+		memcpy(query, box, sizeof(STBOX));
+	}
+	else if (temporal_type_oid(subtype))
+	{
+		Temporal *temp = PG_GETARG_TEMPORAL(1);
+		if (temp == NULL)
+			return false;
+		temporal_bbox(query, temp);
+		PG_FREE_IF_COPY(temp, 1);
+	}
+	else
+		elog(ERROR, "unrecognized subtype: %d", subtype);
+	return true;
+}
+
 PG_FUNCTION_INFO_V1(gist_tpoint_consistent);
 
 PGDLLEXPORT Datum
@@ -253,33 +290,8 @@ gist_tpoint_consistent(PG_FUNCTION_ARGS)
 	if (key == NULL)
 		PG_RETURN_BOOL(false);
 	
-	/*
-	 * Transform the query into a box initializing the dimensions that must
-	 * not be taken into account by the operators to infinity.
-	 */
-	if (subtype == type_oid(T_GEOMETRY) || subtype == type_oid(T_GEOGRAPHY))
-	{
-		/* Since function gist_tpoint_consistent is strict, query is not NULL */
-		if (!geo_to_stbox_internal(&query, PG_GETARG_GSERIALIZED_P(1)))
-			PG_RETURN_BOOL(false);										  
-	}
-	else if (subtype == type_oid(T_STBOX))
-	{
-		STBOX *box = PG_GETARG_STBOX_P(1);
-		if (box == NULL)
-			PG_RETURN_BOOL(false);
-		memcpy(&query, box, sizeof(STBOX));
-	}
-	else if (temporal_type_oid(subtype))
-	{
-		Temporal *temp = PG_GETARG_TEMPORAL(1);
-		if (temp == NULL)
-			PG_RETURN_BOOL(false);
-		temporal_bbox(&query, temp);
-		PG_FREE_IF_COPY(temp, 1);
-	}
-	else
-		elog(ERROR, "unrecognized strategy number: %d", strategy);
+	if (!gist_tpoint_query_stbox(fcinfo, &query, subtype))
+		PG_RETURN_BOOL(false);
 	
 	if (GIST_LEAF(entry))
 		result = index_leaf_consistent_stbox(key, &query, strategy);
@@ -1155,4 +1167,404 @@ gist_tpoint_compress(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(entry);
 }
 
+/*****************************************************************************
+ * Compact 2D+T keys
+ *
+ * The keys of the gist_tgeompoint_2dt_ops operator class only keep the
+ * X, Y and T dimensions, with the spatial coordinates rounded outward to
+ * float4 as PostGIS does for its 2D index keys. The key takes 32 bytes
+ * instead of the 72 bytes of an STBOX, which more than doubles the fanout
+ * of the tree. Since the keys enclose the actual boxes, both leaf and
+ * internal entries are tested with the necessary conditions of the
+ * internal-page consistent method and the operator is always rechecked.
+ *****************************************************************************/
+
+/*
+ * Largest float4 less than or equal to the double
+ */
+static float4
+next_float4_down(double d)
+{
+	float4 result;
+	if (d > (double) FLT_MAX)
+		return FLT_MAX;
+	if (d <= (double) -FLT_MAX)
+		return -FLT_MAX;
+	result = (float4) d;
+	if ((double) result <= d)
+		return result;
+	return nextafterf(result, -FLT_MAX);
+}
+
+/*
+ * Smallest float4 greater than or equal to the double
+ */
+static float4
+next_float4_up(double d)
+{
+	float4 result;
+	if (d > (double) FLT_MAX)
+		return FLT_MAX;
+	if (d <= (double) -FLT_MAX)
+		return -FLT_MAX;
+	result = (float4) d;
+	if ((double) result >= d)
+		return result;
+	return nextafterf(result, FLT_MAX);
+}
+
+static void
+stbox2dt_set(STBOX2DT *key, const STBOX *box)
+{
+	key->xmin = next_float4_down(box->xmin);
+	key->xmax = next_float4_up(box->xmax);
+	key->ymin = next_float4_down(box->ymin);
+	key->ymax = next_float4_up(box->ymax);
+	key->tmin = box->tmin;
+	key->tmax = box->tmax;
+}
+
+static void
+stbox2dt_to_stbox(STBOX *box, const STBOX2DT *key)
+{
+	memset(box, 0, sizeof(STBOX));
+	box->xmin = key->xmin;
+	box->xmax = key->xmax;
+	box->ymin = key->ymin;
+	box->ymax = key->ymax;
+	box->tmin = key->tmin;
+	box->tmax = key->tmax;
+	MOBDB_FLAGS_SET_X(box->flags, true);
+	MOBDB_FLAGS_SET_T(box->flags, true);
+}
+
+/*
+ * Returns false if for all boxes enclosed by the key the predicate
+ * box op query is false. The comparisons on each dimension are combined
+ * with bitwise operators so that the test compiles into straight-line code.
+ */
+static bool
+gist_consistent_stbox2dt(const STBOX2DT *key, const STBOX *query,
+	StrategyNumber strategy)
+{
+	bool hasx = MOBDB_FLAGS_GET_X(query->flags),
+		hast = MOBDB_FLAGS_GET_T(query->flags);
+	
+	switch (strategy)
+	{
+		case RTOverlapStrategyNumber:
+		case RTContainedByStrategyNumber:
+			return (! hasx ||
+					((key->xmin <= query->xmax) & (key->xmax >= query->xmin) &
+					 (key->ymin <= query->ymax) & (key->ymax >= query->ymin))) &&
+				(! hast ||
+					((key->tmin <= query->tmax) & (key->tmax >= query->tmin)));
+		case RTContainsStrategyNumber:
+		case RTSameStrategyNumber:
+			return (! hasx ||
+					((key->xmin <= query->xmin) & (key->xmax >= query->xmax) &
+					 (key->ymin <= query->ymin) & (key->ymax >= query->ymax))) &&
+				(! hast ||
+					((key->tmin <= query->tmin) & (key->tmax >= query->tmax)));
+		case RTLeftStrategyNumber:
+			return ! hasx || key->xmin < query->xmin;
+		case RTOverLeftStrategyNumber:
+			return ! hasx || key->xmin <= query->xmax;
+		case RTRightStrategyNumber:
+			return ! hasx || key->xmax > query->xmax;
+		case RTOverRightStrategyNumber:
+			return ! hasx || key->xmax >= query->xmin;
+		case RTBelowStrategyNumber:
+			return ! hasx || key->ymin < query->ymin;
+		case RTOverBelowStrategyNumber:
+			return ! hasx || key->ymin <= query->ymax;
+		case RTAboveStrategyNumber:
+			return ! hasx || key->ymax > query->ymax;
+		case RTOverAboveStrategyNumber:
+			return ! hasx || key->ymax >= query->ymin;
+		/* The Z dimension is not kept in the key */
+		case RTFrontStrategyNumber:
+		case RTOverFrontStrategyNumber:
+		case RTBackStrategyNumber:
+		case RTOverBackStrategyNumber:
+			return true;
+		/* Bounds of the periods are not kept, see index_leaf_consistent_stbox */
+		case RTBeforeStrategyNumber:
+			return ! hast || key->tmin <= query->tmin;
+		case RTOverBeforeStrategyNumber:
+			return ! hast || key->tmin <= query->tmax;
+		case RTAfterStrategyNumber:
+			return ! hast || key->tmax >= query->tmax;
+		case RTOverAfterStrategyNumber:
+			return ! hast || key->tmax >= query->tmin;
+		default:
+			elog(ERROR, "unrecognized strategy number: %d", strategy);
+			return false;		/* keep compiler quiet */
+	}
+}
+
+PG_FUNCTION_INFO_V1(gist_tpoint_2dt_consistent);
+
+PGDLLEXPORT Datum
+gist_tpoint_2dt_consistent(PG_FUNCTION_ARGS)
+{
+	GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
+	Oid subtype = PG_GETARG_OID(3);
+	bool *recheck = (bool *) PG_GETARG_POINTER(4);
+	STBOX2DT *key = (STBOX2DT *) DatumGetPointer(entry->key);
+	STBOX query;
+	
+	/* The keys are lossy for all strategies */
+	*recheck = true;
+	
+	if (key == NULL)
+		PG_RETURN_BOOL(false);
+	
+	if (!gist_tpoint_query_stbox(fcinfo, &query, subtype))
+		PG_RETURN_BOOL(false);
+	
+	PG_RETURN_BOOL(gist_consistent_stbox2dt(key, &query, strategy));
+}
+
+PG_FUNCTION_INFO_V1(gist_tpoint_2dt_union);
+
+PGDLLEXPORT Datum
+gist_tpoint_2dt_union(PG_FUNCTION_ARGS)
+{
+	GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
+	STBOX2DT *cur, *pageunion;
+	int	i;
+	
+	pageunion = (STBOX2DT *) palloc(sizeof(STBOX2DT));
+	cur = (STBOX2DT *) DatumGetPointer(entryvec->vector[0].key);
+	memcpy(pageunion, cur, sizeof(STBOX2DT));
+	for (i = 1; i < entryvec->n; i++)
+	{
+		cur = (STBOX2DT *) DatumGetPointer(entryvec->vector[i].key);
+		pageunion->xmin = Min(pageunion->xmin, cur->xmin);
+		pageunion->xmax = Max(pageunion->xmax, cur->xmax);
+		pageunion->ymin = Min(pageunion->ymin, cur->ymin);
+		pageunion->ymax = Max(pageunion->ymax, cur->ymax);
+		pageunion->tmin = Min(pageunion->tmin, cur->tmin);
+		pageunion->tmax = Max(pageunion->tmax, cur->tmax);
+	}
+	PG_RETURN_POINTER(pageunion);
+}
+
+PG_FUNCTION_INFO_V1(gist_tpoint_2dt_compress);
+
+PGDLLEXPORT Datum
+gist_tpoint_2dt_compress(PG_FUNCTION_ARGS)
+{
+	GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	if (entry->leafkey)
+	{
+		GISTENTRY *retval = palloc(sizeof(GISTENTRY));
+		Temporal *temp = DatumGetTemporal(entry->key);
+		STBOX2DT *key = palloc(sizeof(STBOX2DT));
+		STBOX box;
+		memset(&box, 0, sizeof(STBOX));
+		temporal_bbox(&box, temp);
+		stbox2dt_set(key, &box);
+		gistentryinit(*retval, PointerGetDatum(key), entry->rel, entry->page,
+			entry->offset, false);
+		PG_RETURN_POINTER(retval);
+	}
+	PG_RETURN_POINTER(entry);
+}
+
+/*
+ * Area-time volume of a key for penalty-calculation purposes, defined as
+ * for the size_stbox function above. In particular, the size of a key with
+ * a zero-width dimension is zero, so that the penalty is never negative.
+ */
+static double
+size_stbox2dt(const STBOX2DT *key)
+{
+	if (key->xmax <= key->xmin || key->ymax <= key->ymin ||
+		key->tmax <= key->tmin)
+		return 0.0;
+	if (isnan(key->xmax) || isnan(key->ymax))
+		return get_float8_infinity();
+	return ((double) key->xmax - (double) key->xmin) *
+		((double) key->ymax - (double) key->ymin) *
+		(double) (key->tmax - key->tmin);
+}
+
+PG_FUNCTION_INFO_V1(gist_tpoint_2dt_penalty);
+
+PGDLLEXPORT Datum
+gist_tpoint_2dt_penalty(PG_FUNCTION_ARGS)
+{
+	GISTENTRY *origentry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	GISTENTRY *newentry = (GISTENTRY *) PG_GETARG_POINTER(1);
+	float *result = (float *) PG_GETARG_POINTER(2);
+	STBOX2DT *orig = (STBOX2DT *) DatumGetPointer(origentry->key);
+	STBOX2DT *new = (STBOX2DT *) DatumGetPointer(newentry->key);
+	STBOX2DT unionkey;
+	
+	unionkey.xmin = Min(orig->xmin, new->xmin);
+	unionkey.xmax = Max(orig->xmax, new->xmax);
+	unionkey.ymin = Min(orig->ymin, new->ymin);
+	unionkey.ymax = Max(orig->ymax, new->ymax);
+	unionkey.tmin = Min(orig->tmin, new->tmin);
+	unionkey.tmax = Max(orig->tmax, new->tmax);
+	*result = (float) (size_stbox2dt(&unionkey) - size_stbox2dt(orig));
+	PG_RETURN_POINTER(result);
+}
+
+/*
+ * The double sorting split of gist_tpoint_picksplit is applied to the keys
+ * expanded into boxes. The resulting boxes are unions of float4 values and
+ * are thus converted back without loss.
+ */
+PG_FUNCTION_INFO_V1(gist_tpoint_2dt_picksplit);
+
+PGDLLEXPORT Datum
+gist_tpoint_2dt_picksplit(PG_FUNCTION_ARGS)
+{
+	GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
+	GIST_SPLITVEC *v = (GIST_SPLITVEC *) PG_GETARG_POINTER(1);
+	GistEntryVector *boxvec;
+	STBOX *boxes;
+	STBOX2DT *left, *right;
+	int i;
+	
+	boxvec = palloc(GEVHDRSZ + entryvec->n * sizeof(GISTENTRY));
+	boxvec->n = entryvec->n;
+	boxes = palloc(entryvec->n * sizeof(STBOX));
+	for (i = FirstOffsetNumber; i < entryvec->n; i++)
+	{
+		boxvec->vector[i] = entryvec->vector[i];
+		stbox2dt_to_stbox(&boxes[i],
+			(STBOX2DT *) DatumGetPointer(entryvec->vector[i].key));
+		boxvec->vector[i].key = PointerGetDatum(&boxes[i]);
+	}
+	DirectFunctionCall2(gist_tpoint_picksplit, PointerGetDatum(boxvec),
+		PointerGetDatum(v));
+	
+	left = palloc(sizeof(STBOX2DT));
+	right = palloc(sizeof(STBOX2DT));
+	stbox2dt_set(left, (STBOX *) DatumGetPointer(v->spl_ldatum));
+	stbox2dt_set(right, (STBOX *) DatumGetPointer(v->spl_rdatum));
+	v->spl_ldatum = PointerGetDatum(left);
+	v->spl_rdatum = PointerGetDatum(right);
+	pfree(boxes);
+	pfree(boxvec);
+	PG_RETURN_POINTER(v);
+}
+
+PG_FUNCTION_INFO_V1(gist_tpoint_2dt_same);
+
+PGDLLEXPORT Datum
+gist_tpoint_2dt_same(PG_FUNCTION_ARGS)
+{
+	STBOX2DT *b1 = (STBOX2DT *) DatumGetPointer(PG_GETARG_DATUM(0));
+	STBOX2DT *b2 = (STBOX2DT *) DatumGetPointer(PG_GETARG_DATUM(1));
+	bool *result = (bool *) PG_GETARG_POINTER(2);
+	if (b1 && b2)
+		*result = (b1->xmin == b2->xmin && b1->xmax == b2->xmax &&
+				   b1->ymin == b2->ymin && b1->ymax == b2->ymax &&
+				   b1->tmin == b2->tmin && b1->tmax == b2->tmax);
+	else
+		*result = (b1 == NULL && b2 == NULL);
+	PG_RETURN_POINTER(result);
+}
+
+/*
+ * Input/output functions of the storage type of the operator class
+ */
+PG_FUNCTION_INFO_V1(stbox2dt_in);
+
+PGDLLEXPORT Datum
+stbox2dt_in(PG_FUNCTION_ARGS)
+{
+	ereport(ERROR,(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+		errmsg("function stbox2dt_in not implemented")));
+	PG_RETURN_POINTER(NULL);
+}
+
+PG_FUNCTION_INFO_V1(stbox2dt_out);
+
+PGDLLEXPORT Datum
+stbox2dt_out(PG_FUNCTION_ARGS)
+{
+	STBOX2DT *key = (STBOX2DT *) PG_GETARG_POINTER(0);
+	char *tmin = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(key->tmin));
+	char *tmax = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(key->tmax));
+	char *result = psprintf("STBOX2DT((%.8g,%.8g,%s),(%.8g,%.8g,%s))",
+		key->xmin, key->ymin, tmin, key->xmax, key->ymax, tmax);
+	pfree(tmin); pfree(tmax);
+	PG_RETURN_CSTRING(result);
+}
+
+/*****************************************************************************
+ * Hilbert keys for temporal points
+ *****************************************************************************/
+
+/*
+ * Position of the center of the box along the Hilbert curve filling the
+ * extent. Only the dimensions present in both boxes are taken into account.
+ */
+static uint64
+stbox_hilbert_key_internal(const STBOX *box, const STBOX *extent)
+{
+	uint32 coords[4];
+	int ndims = 0, bits;
+	double center[4], min[4], max[4];
+	if (MOBDB_FLAGS_GET_X(box->flags) && MOBDB_FLAGS_GET_X(extent->flags))
+	{
+		center[ndims] = box->xmin / 2.0 + box->xmax / 2.0;
+		min[ndims] = extent->xmin;
+		max[ndims++] = extent->xmax;
+		center[ndims] = box->ymin / 2.0 + box->ymax / 2.0;
+		min[ndims] = extent->ymin;
+		max[ndims++] = extent->ymax;
+		if ((MOBDB_FLAGS_GET_Z(box->flags) || MOBDB_FLAGS_GET_GEODETIC(box->flags)) &&
+			(MOBDB_FLAGS_GET_Z(extent->flags) || MOBDB_FLAGS_GET_GEODETIC(extent->flags)))
+		{
+			center[ndims] = box->zmin / 2.0 + box->zmax / 2.0;
+			min[ndims] = extent->zmin;
+			max[ndims++] = extent->zmax;
+		}
+	}
+	if (MOBDB_FLAGS_GET_T(box->flags) && MOBDB_FLAGS_GET_T(extent->flags))
+	{
+		center[ndims] = (double) box->tmin / 2.0 + (double) box->tmax / 2.0;
+		min[ndims] = (double) extent->tmin;
+		max[ndims++] = (double) extent->tmax;
+	}
+	if (ndims == 0)
+		return 0;
+	bits = ndims == 1 ? HILBERT_MAX_BITS : 63 / ndims;
+	for (int i = 0; i < ndims; i++)
+		coords[i] = hilbert_coord(center[i], min[i], max[i], bits);
+	return hilbert_index(coords, ndims, bits);
+}
+
+PG_FUNCTION_INFO_V1(stbox_hilbert_key);
+
+PGDLLEXPORT Datum
+stbox_hilbert_key(PG_FUNCTION_ARGS)
+{
+	STBOX *box = PG_GETARG_STBOX_P(0);
+	STBOX *extent = PG_GETARG_STBOX_P(1);
+	PG_RETURN_INT64((int64) stbox_hilbert_key_internal(box, extent));
+}
+
+PG_FUNCTION_INFO_V1(tpoint_hilbert_key);
+
+PGDLLEXPORT Datum
+tpoint_hilbert_key(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	STBOX *extent = PG_GETARG_STBOX_P(1);
+	STBOX box;
+	memset(&box, 0, sizeof(STBOX));
+	temporal_bbox(&box, temp);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_INT64((int64) stbox_hilbert_key_internal(&box, extent));
+}
+
 /*****************************************************************************/
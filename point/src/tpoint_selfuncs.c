@@ -543,31 +543,6 @@ tpoint_const_to_stbox(Node *other, STBOX *box)
 	return true;
 }
 
-/* 
- * Set the values of an ND_BOX from an STBOX 
- * The function only takes into account the x, y, and z dimensions of the box?
- * and assumes that they exist. This is to be ensured by the calling function.
- */
-static void
-nd_box_from_stbox(const STBOX *box, ND_BOX *nd_box)
-{
-	int d = 0;
-
-	nd_box_init(nd_box);
-	nd_box->min[d] = (float4) box->xmin;
-	nd_box->max[d] = (float4) box->xmax;
-	d++;
-	nd_box->min[d] = (float4) box->ymin;
-	nd_box->max[d] = (float4) box->ymax;
-	d++;
-	if (MOBDB_FLAGS_GET_GEODETIC(box->flags) ||
-		MOBDB_FLAGS_GET_Z(box->flags))
-	{
-		nd_box->min[d] = (float4) box->zmin;
-		nd_box->max[d] = (float4) box->zmax;
-	}
-}
-
 /* Get the enum value associated to the operator */
 static bool
 tpoint_cachedop(Oid operator, CachedOp *cachedOp)
@@ -843,6 +818,110 @@ calc_geo_selectivity(VariableStatData *vardata, const STBOX *box, CachedOp op)
 	return selectivity;
 }
 
+/*
+ * This function returns an estimate of the selectivity of a search STBOX 
+ * that has both the spatial and the time dimensions by looking at the joint
+ * spatiotemporal histogram. Only the bounding box operators are considered
+ * since the position operators restrict a single dimension.
+ * The function returns -1 if the histogram is not available.
+ */
+static float8
+calc_geo_time_selectivity(VariableStatData *vardata, const STBOX *box)
+{
+	ND_STATS *nd_stats;
+	AttStatsSlot sslot;	
+	int d; /* counter */
+	float8 selectivity;
+	ND_BOX nd_box;
+	ND_IBOX nd_ibox;
+	int at[ND_DIMS];
+	double cell_size[ND_DIMS];
+	double min[ND_DIMS];
+	double max[ND_DIMS];
+	double total_count = 0.0;
+	int ndims, tdim;
+
+	if (!(HeapTupleIsValid(vardata->statsTuple) &&
+		  get_attstatsslot(&sslot, vardata->statsTuple, STATISTIC_KIND_NDT, 
+			InvalidOid, ATTSTATSSLOT_NUMBERS)))
+		return -1;
+
+	/* Clone the stats here so we can release the attstatsslot immediately */
+	nd_stats = palloc(sizeof(float4) * sslot.nnumbers);
+	memcpy(nd_stats, sslot.numbers, sizeof(float4) * sslot.nnumbers);
+	free_attstatsslot(&sslot);
+
+	/* The time dimension is the last one of the histogram */
+	ndims = (int) nd_stats->ndims;
+	tdim = ndims - 1;
+
+	/* Initialize nd_box. If the histogram has a Z dimension that the box
+	 * does not have, the box is unbounded on that dimension */
+	nd_box_from_stbox(box, &nd_box);
+	if (ndims == 4 && ! MOBDB_FLAGS_GET_Z(box->flags) && 
+		! MOBDB_FLAGS_GET_GEODETIC(box->flags))
+	{
+		nd_box.min[Z_DIM] = -1 * FLT_MAX;
+		nd_box.max[Z_DIM] = FLT_MAX;
+	}
+	nd_box.min[tdim] = STATS_TIMESTAMP(box->tmin);
+	nd_box.max[tdim] = STATS_TIMESTAMP(box->tmax);
+
+	/* Full histogram extent overlaps box is false? */
+	if (! nd_box_intersects(&(nd_stats->extent), &nd_box, ndims))
+	{
+		pfree(nd_stats);
+		return 0.0;
+	}
+
+	/* Calculate the overlap of the box on the histogram */
+	nd_box_overlap(nd_stats, &nd_box, &nd_ibox);
+
+	/* Work out some measurements of the histogram */
+	memset(at, 0, sizeof(int) * ND_DIMS);
+	for (d = 0; d < ndims; d++)
+	{
+		/* Cell size in each dim */
+		min[d] = nd_stats->extent.min[d];
+		max[d] = nd_stats->extent.max[d];
+		cell_size[d] = (max[d] - min[d]) / nd_stats->size[d];
+		/* Initialize the counter */
+		at[d] = nd_ibox.min[d];
+	}
+
+	/* Move through all the overlap values and sum them */
+	do
+	{
+		float cell_count, ratio;
+		ND_BOX nd_cell;
+		memset(&nd_cell, 0, sizeof(ND_BOX));
+
+		/* We have to pro-rate partially overlapped cells. */
+		for (d = 0; d < ndims; d++)
+		{
+			nd_cell.min[d] = (float4) (min[d] + (at[d]+0) * cell_size[d]);
+			nd_cell.max[d] = (float4) (min[d] + (at[d]+1) * cell_size[d]);
+		}
+
+		ratio = (float4) (nd_box_ratio_overlaps(&nd_box, &nd_cell, ndims));
+		cell_count = nd_stats->value[nd_stats_value_index(nd_stats, at)];
+
+		/* Add the pro-rated count for this cell to the overall total */
+		total_count += cell_count * ratio;
+	}
+	while (nd_increment(&nd_ibox, ndims, at));
+
+	/* Scale by the number of features in our histogram to get the proportion */
+	selectivity = total_count / nd_stats->histogram_features;
+	pfree(nd_stats);
+
+	/* Prevent rounding overflows */
+	if (selectivity > 1.0) selectivity = 1.0;
+	else if (selectivity < 0.0) selectivity = 0.0;
+
+	return selectivity;
+}
+
 /*****************************************************************************/
 
 PG_FUNCTION_INFO_V1(tpoint_sel);
@@ -924,6 +1003,23 @@ tpoint_sel(PG_FUNCTION_ARGS)
 
 	assert(MOBDB_FLAGS_GET_X(constBox.flags) || MOBDB_FLAGS_GET_T(constBox.flags));
 	
+	/* 
+	 * Estimate the selectivity of the bounding box operators for a box with 
+	 * both the spatial and time dimensions from the joint histogram, if any
+	 */
+	if (MOBDB_FLAGS_GET_X(constBox.flags) && MOBDB_FLAGS_GET_T(constBox.flags) &&
+		(cachedOp == OVERLAPS_OP || cachedOp == CONTAINS_OP || 
+		 cachedOp == CONTAINED_OP || cachedOp == SAME_OP))
+	{
+		selec = calc_geo_time_selectivity(&vardata, &constBox);
+		if (selec >= 0.0)
+		{
+			ReleaseVariableStats(vardata);
+			CLAMP_PROBABILITY(selec);
+			PG_RETURN_FLOAT8(selec);
+		}
+	}
+
 	/* Enable the multiplication of the selectivity of the spatial and time 
 	 * dimensions since either may be missing */
 	selec = 1.0; 
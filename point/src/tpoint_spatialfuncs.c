@@ -14,6 +14,8 @@
 
 #include <assert.h>
 #include <float.h>
+#include <math.h>
+#include <funcapi.h>
 #include <utils/builtins.h>
 #include <utils/timestamp.h>
 
@@ -234,12 +236,6 @@ geometry_serialize(LWGEOM *geom)
 
 /* Call to PostGIS external functions */
 
-static Datum
-datum_transform(Datum value, Datum srid)
-{
-	return call_function2(transform, value, srid);
-}
-
 static Datum
 geog_to_geom(Datum value)
 {
@@ -407,24 +403,138 @@ tpoint_set_srid(PG_FUNCTION_ARGS)
 
 /*****************************************************************************/
 
-/* Transform a temporal geometry point into another spatial reference system */
+/*
+ * Reproject in a single call the coordinates of an array of instants, which
+ * are modified in place
+ */
+static void
+tgeompointinstarr_transform(TemporalInst **instants, int count, int srid,
+	projPJ inpj, projPJ outpj)
+{
+	bool hasz = MOBDB_FLAGS_GET_Z(instants[0]->flags);
+	int dims = hasz ? 3 : 2;
+	POINTARRAY *pa = ptarray_construct(hasz, false, (uint32_t) count);
+	double *coords = (double *) pa->serialized_pointlist;
+	for (int i = 0; i < count; i++)
+	{
+		GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(
+			temporalinst_value(instants[i]));
+		memcpy(&coords[i * dims], (uint8_t *) gs->data + 8,
+			sizeof(double) * dims);
+	}
+	if (ptarray_transform(pa, inpj, outpj) == LW_FAILURE)
+		elog(ERROR, "Transform: failed to reproject the coordinates");
+	for (int i = 0; i < count; i++)
+	{
+		GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(
+			temporalinst_value(instants[i]));
+		memcpy((uint8_t *) gs->data + 8, &coords[i * dims],
+			sizeof(double) * dims);
+		gserialized_set_srid(gs, srid);
+	}
+	ptarray_free(pa);
+}
 
-TemporalInst *
-tgeompointinst_transform(TemporalInst *inst, Datum srid)
+static TemporalInst *
+tgeompointinst_transform1(TemporalInst *inst, int srid,
+	projPJ inpj, projPJ outpj)
 {
-	return tfunc2_temporalinst(inst, srid, &datum_transform,
-		type_oid(T_GEOMETRY));
+	TemporalInst *result = temporalinst_copy(inst);
+	tgeompointinstarr_transform(&result, 1, srid, inpj, outpj);
+	return result;
+}
+
+static TemporalI *
+tgeompointi_transform(TemporalI *ti, int srid, projPJ inpj, projPJ outpj)
+{
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
+	for (int i = 0; i < ti->count; i++)
+		instants[i] = temporalinst_copy(temporali_inst_n(ti, i));
+	tgeompointinstarr_transform(instants, ti->count, srid, inpj, outpj);
+	TemporalI *result = temporali_from_temporalinstarr(instants, ti->count);
+	for (int i = 0; i < ti->count; i++)
+		pfree(instants[i]);
+	pfree(instants);
+	return result;
+}
+
+static TemporalSeq *
+tgeompointseq_transform(TemporalSeq *seq, int srid, projPJ inpj,
+	projPJ outpj)
+{
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * seq->count);
+	for (int i = 0; i < seq->count; i++)
+		instants[i] = temporalinst_copy(temporalseq_inst_n(seq, i));
+	tgeompointinstarr_transform(instants, seq->count, srid, inpj, outpj);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants,
+		seq->count, seq->period.lower_inc, seq->period.upper_inc,
+		MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
+	for (int i = 0; i < seq->count; i++)
+		pfree(instants[i]);
+	pfree(instants);
+	return result;
+}
+
+static TemporalS *
+tgeompoints_transform(TemporalS *ts, int srid, projPJ inpj, projPJ outpj)
+{
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->count);
+	for (int i = 0; i < ts->count; i++)
+		sequences[i] = tgeompointseq_transform(temporals_seq_n(ts, i), srid,
+			inpj, outpj);
+	TemporalS *result = temporals_from_temporalseqarr(sequences, ts->count,
+		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
+	for (int i = 0; i < ts->count; i++)
+		pfree(sequences[i]);
+	pfree(sequences);
+	return result;
 }
 
+/*
+ * The PROJ transformation is resolved once per call through PostGIS, which
+ * caches it in the function call context, so that the coordinates of each
+ * sequence are reprojected in a single call instead of once per instant
+ */
 PG_FUNCTION_INFO_V1(tpoint_transform);
 
 PGDLLEXPORT Datum
 tpoint_transform(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	Datum srid = PG_GETARG_DATUM(1);
-	Temporal *result = tfunc2_temporal(temp, srid, &datum_transform,
-		type_oid(T_GEOMETRY));
+	int srid = PG_GETARG_INT32(1);
+	int srid_in = tpoint_srid_internal(temp);
+	if (srid == SRID_UNKNOWN)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("%d is an invalid target SRID", SRID_UNKNOWN)));
+	if (srid_in == SRID_UNKNOWN)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("Input temporal point has unknown (%d) SRID", SRID_UNKNOWN)));
+	if (srid_in == srid)
+	{
+		Temporal *result = temporal_copy(temp);
+		PG_FREE_IF_COPY(temp, 0);
+		PG_RETURN_POINTER(result);
+	}
+
+	projPJ inpj, outpj;
+	if (GetProjectionsUsingFCInfo(fcinfo, srid_in, srid, &inpj, &outpj) ==
+		LW_FAILURE)
+		elog(ERROR, "Failure reading projections from spatial_ref_sys.");
+
+	ensure_valid_duration(temp->duration);
+	Temporal *result = NULL;
+	if (temp->duration == TEMPORALINST)
+		result = (Temporal *)tgeompointinst_transform1((TemporalInst *)temp,
+			srid, inpj, outpj);
+	else if (temp->duration == TEMPORALI)
+		result = (Temporal *)tgeompointi_transform((TemporalI *)temp,
+			srid, inpj, outpj);
+	else if (temp->duration == TEMPORALSEQ)
+		result = (Temporal *)tgeompointseq_transform((TemporalSeq *)temp,
+			srid, inpj, outpj);
+	else if (temp->duration == TEMPORALS)
+		result = (Temporal *)tgeompoints_transform((TemporalS *)temp,
+			srid, inpj, outpj);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_POINTER(result);
 }
@@ -877,6 +987,136 @@ tpoint_trajectory(PG_FUNCTION_ARGS)
 	PG_RETURN_DATUM(result);
 }
 
+/*****************************************************************************
+ * Segment kernels
+ *
+ * The length, speed, and azimuth functions below read the coordinates of
+ * consecutive instants directly from the serialized points and process them
+ * in tight loops over plain arrays of doubles, instead of building and
+ * measuring a two-point line per segment. Geodetic computations are made on
+ * the spheroid associated to the SRID, as done by geography_length and
+ * geography_azimuth.
+ *****************************************************************************/
+
+/*
+ * Spheroid used for the computations on a temporal geography point.
+ * Returns false for temporal geometry points.
+ */
+static bool
+tpoint_spheroid(FunctionCallInfo fcinfo, Temporal *temp, SPHEROID *s)
+{
+	ensure_point_base_type(temp->valuetypid);
+	if (temp->valuetypid != type_oid(T_GEOGRAPHY))
+		return false;
+	spheroid_init_from_srid(fcinfo, tpoint_srid_internal(temp), s);
+	return true;
+}
+
+/*
+ * Coordinates of the instants of the sequence as an array of x, y[, z]
+ * doubles
+ */
+static double *
+tpointseq_coords(TemporalSeq *seq, bool hasz)
+{
+	int dims = hasz ? 3 : 2;
+	double *result = palloc(sizeof(double) * dims * seq->count);
+	for (int i = 0; i < seq->count; i++)
+	{
+		GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(
+			temporalinst_value(temporalseq_inst_n(seq, i)));
+		memcpy(&result[i * dims], (uint8_t *) gs->data + 8,
+			sizeof(double) * dims);
+	}
+	return result;
+}
+
+/*
+ * Lengths of the count - 1 segments defined by the coordinates
+ */
+static void
+segments_length(double *coords, int count, bool hasz, const SPHEROID *s,
+	double *result)
+{
+	if (s != NULL)
+	{
+		int dims = hasz ? 3 : 2;
+		/* Two-point line whose point list is moved along the coordinates */
+		POINTARRAY *pa = ptarray_construct_reference_data(hasz, false, 2,
+			(uint8_t *) coords);
+		LWLINE *line = lwline_construct(SRID_UNKNOWN, NULL, pa);
+		for (int i = 0; i < count - 1; i++)
+		{
+			pa->serialized_pointlist = (uint8_t *) &coords[i * dims];
+			result[i] = lwgeom_length_spheroid(lwline_as_lwgeom(line), s);
+		}
+		lwline_free(line);
+	}
+	else if (hasz)
+	{
+		for (int i = 0; i < count - 1; i++)
+		{
+			const double *p = &coords[i * 3];
+			double dx = p[3] - p[0], dy = p[4] - p[1], dz = p[5] - p[2];
+			result[i] = sqrt(dx * dx + dy * dy + dz * dz);
+		}
+	}
+	else
+	{
+		for (int i = 0; i < count - 1; i++)
+		{
+			const double *p = &coords[i * 2];
+			double dx = p[2] - p[0], dy = p[3] - p[1];
+			result[i] = sqrt(dx * dx + dy * dy);
+		}
+	}
+}
+
+/*
+ * Azimuths of the count - 1 segments defined by the coordinates. The
+ * azimuth of a segment whose end points have the same x and y coordinates
+ * is undefined and set to NaN.
+ */
+static void
+segments_azimuth(double *coords, int count, bool hasz, const SPHEROID *s,
+	double *result)
+{
+	int dims = hasz ? 3 : 2;
+	if (s != NULL)
+	{
+		POINTARRAY *pa1 = ptarray_construct_reference_data(hasz, false, 1,
+			(uint8_t *) coords);
+		POINTARRAY *pa2 = ptarray_construct_reference_data(hasz, false, 1,
+			(uint8_t *) coords);
+		LWPOINT *point1 = lwpoint_construct(SRID_UNKNOWN, NULL, pa1);
+		LWPOINT *point2 = lwpoint_construct(SRID_UNKNOWN, NULL, pa2);
+		for (int i = 0; i < count - 1; i++)
+		{
+			const double *p = &coords[i * dims];
+			if (p[0] == p[dims] && p[1] == p[dims + 1])
+			{
+				result[i] = get_float8_nan();
+				continue;
+			}
+			pa1->serialized_pointlist = (uint8_t *) p;
+			pa2->serialized_pointlist = (uint8_t *) &p[dims];
+			result[i] = lwgeom_azumith_spheroid(point1, point2, s);
+		}
+		lwpoint_free(point1);
+		lwpoint_free(point2);
+	}
+	else
+	{
+		for (int i = 0; i < count - 1; i++)
+		{
+			const double *p = &coords[i * dims];
+			double dx = p[dims] - p[0], dy = p[dims + 1] - p[1];
+			result[i] = (dx == 0 && dy == 0) ? get_float8_nan() :
+				fmod(2 * M_PI + M_PI / 2 - atan2(dy, dx), 2 * M_PI);
+		}
+	}
+}
+
 /*****************************************************************************
  * Length functions
  *****************************************************************************/
@@ -884,33 +1124,43 @@ tpoint_trajectory(PG_FUNCTION_ARGS)
 /* Length traversed by the temporal point */
 
 static double
-tpointseq_length(TemporalSeq *seq)
+tpointseq_length(TemporalSeq *seq, const SPHEROID *s)
 {
 	assert(MOBDB_FLAGS_GET_LINEAR(seq->flags));
-	Datum traj = tpointseq_trajectory(seq);
-	GSERIALIZED *gstraj = (GSERIALIZED *)DatumGetPointer(traj);
-	if (gserialized_get_type(gstraj) == POINTTYPE)
+	if (seq->count == 1)
 		return 0;
-	
-	/* We are sure that the trajectory is a line */
+
+	bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
+	double *coords = tpointseq_coords(seq, hasz);
 	double result = 0.0;
-	ensure_point_base_type(seq->valuetypid);
-	if (seq->valuetypid == type_oid(T_GEOMETRY))
-		/* The next function call works for 2D and 3D */
-		result = DatumGetFloat8(call_function1(LWGEOM_length_linestring, traj));
-	else if (seq->valuetypid == type_oid(T_GEOGRAPHY))
-		result = DatumGetFloat8(call_function2(geography_length, traj,
-			BoolGetDatum(true)));
+	if (s != NULL)
+	{
+		/* The whole sequence is measured at once */
+		POINTARRAY *pa = ptarray_construct_reference_data(hasz, false,
+			seq->count, (uint8_t *) coords);
+		LWLINE *line = lwline_construct(SRID_UNKNOWN, NULL, pa);
+		result = lwgeom_length_spheroid(lwline_as_lwgeom(line), s);
+		lwline_free(line);
+	}
+	else
+	{
+		double *lengths = palloc(sizeof(double) * (seq->count - 1));
+		segments_length(coords, seq->count, hasz, NULL, lengths);
+		for (int i = 0; i < seq->count - 1; i++)
+			result += lengths[i];
+		pfree(lengths);
+	}
+	pfree(coords);
 	return result;
 }
 
 static double
-tpoints_length(TemporalS *ts)
+tpoints_length(TemporalS *ts, const SPHEROID *s)
 {
 	assert(MOBDB_FLAGS_GET_LINEAR(ts->flags));
 	double result = 0;
 	for (int i = 0; i < ts->count; i++)
-		result += tpointseq_length(temporals_seq_n(ts, i));
+		result += tpointseq_length(temporals_seq_n(ts, i), s);
 	return result;
 }
 
@@ -921,15 +1171,20 @@ tpoint_length(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	double result = 0.0;
+	SPHEROID s;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST || temp->duration == TEMPORALI ||
 		(temp->duration == TEMPORALSEQ && ! MOBDB_FLAGS_GET_LINEAR(temp->flags)) ||
 		(temp->duration == TEMPORALS && ! MOBDB_FLAGS_GET_LINEAR(temp->flags)))
 		;
-	else if (temp->duration == TEMPORALSEQ)
-		result = tpointseq_length((TemporalSeq *)temp);	
-	else if (temp->duration == TEMPORALS)
-		result = tpoints_length((TemporalS *)temp);	
+	else
+	{
+		SPHEROID *sp = tpoint_spheroid(fcinfo, temp, &s) ? &s : NULL;
+		if (temp->duration == TEMPORALSEQ)
+			result = tpointseq_length((TemporalSeq *)temp, sp);
+		else if (temp->duration == TEMPORALS)
+			result = tpoints_length((TemporalS *)temp, sp);
+	}
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_FLOAT8(result);
 }
@@ -961,6 +1216,10 @@ tpointi_cumulative_length(TemporalI *ti)
 	return result;
 }
 
+/*
+ * N.B. The cumulative length is computed on the plane for both geometries
+ * and geographies
+ */
 static TemporalSeq *
 tpointseq_cumulative_length(TemporalSeq *seq, double prevlength)
 {
@@ -990,27 +1249,23 @@ tpointseq_cumulative_length(TemporalSeq *seq, double prevlength)
 	else
 	/* Linear interpolation */
 	{
-		TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
-		Datum value1 = temporalinst_value(inst1);
+		bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
+		double *coords = tpointseq_coords(seq, hasz);
+		double *lengths = palloc(sizeof(double) * (seq->count - 1));
+		segments_length(coords, seq->count, hasz, NULL, lengths);
 		double length = prevlength;
-		instants[0] = temporalinst_make(Float8GetDatum(length), inst1->t,
+		TemporalInst *inst = temporalseq_inst_n(seq, 0);
+		instants[0] = temporalinst_make(Float8GetDatum(length), inst->t,
 				FLOAT8OID);
 		for (int i = 1; i < seq->count; i++)
 		{
-			TemporalInst *inst2 = temporalseq_inst_n(seq, i);
-			Datum value2 = temporalinst_value(inst2);
-			if (datum_ne(value1, value2, inst1->valuetypid))
-			{
-				Datum line = geompoint_trajectory(value1, value2);
-				/* The next function works for 2D and 3D */
-				length += DatumGetFloat8(call_function1(LWGEOM_length_linestring, line));	
-				pfree(DatumGetPointer(line));
-			}
-			instants[i] = temporalinst_make(Float8GetDatum(length), inst2->t,
+			length += lengths[i - 1];
+			inst = temporalseq_inst_n(seq, i);
+			instants[i] = temporalinst_make(Float8GetDatum(length), inst->t,
 				FLOAT8OID);
-			inst1 = inst2;
-			value1 = value2;
 		}
+		pfree(lengths);
+		pfree(coords);
 	}
 	TemporalSeq *result = temporalseq_from_temporalinstarr(instants,
 		seq->count, seq->period.lower_inc, seq->period.upper_inc,
@@ -1070,7 +1325,7 @@ tpoint_cumulative_length(PG_FUNCTION_ARGS)
  *****************************************************************************/
 
 static TemporalSeq *
-tpointseq_speed(TemporalSeq *seq)
+tpointseq_speed(TemporalSeq *seq, const SPHEROID *s)
 {
 	/* Instantaneous sequence */
 	if (seq->count == 1)
@@ -1090,36 +1345,23 @@ tpointseq_speed(TemporalSeq *seq)
 	else
 	/* Linear interpolation */
 	{
-		TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
-		Datum value1 = temporalinst_value(inst1);
-		double speed;
+		bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
+		double *coords = tpointseq_coords(seq, hasz);
+		double *speeds = palloc(sizeof(double) * (seq->count - 1));
+		TimestampTz *times = palloc(sizeof(TimestampTz) * seq->count);
+		for (int i = 0; i < seq->count; i++)
+			times[i] = temporalseq_inst_n(seq, i)->t;
+		segments_length(coords, seq->count, hasz, s, speeds);
 		for (int i = 0; i < seq->count - 1; i++)
-		{
-			TemporalInst *inst2 = temporalseq_inst_n(seq, i + 1);
-			Datum value2 = temporalinst_value(inst2);
-			if (datum_point_eq(value1, value2))
-				speed = 0;
-			else
-			{
-				Datum traj = geompoint_trajectory(value1, value2);
-				double length = 0.0; /* Make compiler quiet */
-				ensure_point_base_type(seq->valuetypid);
-				if (seq->valuetypid == type_oid(T_GEOMETRY))
-					/* The next function works for 2D and 3D */
-					length = DatumGetFloat8(call_function1(LWGEOM_length_linestring, traj));
-				else if (seq->valuetypid == type_oid(T_GEOGRAPHY))
-					length = DatumGetFloat8(call_function2(geography_length, traj,
-						BoolGetDatum(true)));
-				pfree(DatumGetPointer(traj));
-				speed = length / ((double)(inst2->t - inst1->t) / 1000000);
-			}
-			instants[i] = temporalinst_make(Float8GetDatum(speed), inst1->t,
+			speeds[i] /= (double) (times[i + 1] - times[i]) / 1000000;
+		for (int i = 0; i < seq->count - 1; i++)
+			instants[i] = temporalinst_make(Float8GetDatum(speeds[i]), times[i],
 				FLOAT8OID);
-			inst1 = inst2;
-			value1 = value2;
-		}			
-		instants[seq->count - 1] = temporalinst_make(Float8GetDatum(speed),
-			seq->period.upper, FLOAT8OID);
+		instants[seq->count - 1] = temporalinst_make(
+			Float8GetDatum(speeds[seq->count - 2]), seq->period.upper, FLOAT8OID);
+		pfree(times);
+		pfree(speeds);
+		pfree(coords);
 	}
 	/* The resulting sequence has stepwise interpolation */
 	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, seq->count,
@@ -1131,7 +1373,7 @@ tpointseq_speed(TemporalSeq *seq)
 }
 
 static TemporalS *
-tpoints_speed(TemporalS *ts)
+tpoints_speed(TemporalS *ts, const SPHEROID *s)
 {
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->count);
 	int k = 0;
@@ -1139,7 +1381,7 @@ tpoints_speed(TemporalS *ts)
 	{
 		TemporalSeq *seq = temporals_seq_n(ts, i);
 		if (seq->count > 1)
-			sequences[k++] = tpointseq_speed(seq);
+			sequences[k++] = tpointseq_speed(seq, s);
 	}
 	if (k == 0)
 	{
@@ -1163,13 +1405,18 @@ tpoint_speed(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Temporal *result = NULL;
+	SPHEROID s;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST || temp->duration == TEMPORALI)
 		;
-	else if (temp->duration == TEMPORALSEQ)
-		result = (Temporal *)tpointseq_speed((TemporalSeq *)temp);	
-	else if (temp->duration == TEMPORALS)
-		result = (Temporal *)tpoints_speed((TemporalS *)temp);	
+	else
+	{
+		SPHEROID *sp = tpoint_spheroid(fcinfo, temp, &s) ? &s : NULL;
+		if (temp->duration == TEMPORALSEQ)
+			result = (Temporal *)tpointseq_speed((TemporalSeq *)temp, sp);
+		else if (temp->duration == TEMPORALS)
+			result = (Temporal *)tpoints_speed((TemporalS *)temp, sp);
+	}
 	PG_FREE_IF_COPY(temp, 0);
 	if (result == NULL)
 		PG_RETURN_NULL();
@@ -1455,33 +1702,29 @@ tgeompoint_twcentroid(PG_FUNCTION_ARGS)
  *****************************************************************************/
 
 static int
-tpointseq_azimuth1(TemporalSeq **result, TemporalSeq *seq)
+tpointseq_azimuth1(TemporalSeq **result, TemporalSeq *seq, const SPHEROID *s)
 {
 	/* Instantaneous sequence */
 	if (seq->count == 1)
 		return 0;
 	
 	/* We are sure that there are at least 2 instants */
+	bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
+	double *coords = tpointseq_coords(seq, hasz);
+	double *azimuths = palloc(sizeof(double) * (seq->count - 1));
+	segments_azimuth(coords, seq->count, hasz, s, azimuths);
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * seq->count);
 	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
-	Datum value1 = temporalinst_value(inst1);
 	int k = 0, l = 0;
 	Datum azimuth = 0; /* Make the compiler quiet */
 	bool lower_inc = seq->period.lower_inc, upper_inc;
 	for (int i = 1; i < seq->count; i++)
 	{
 		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
-		Datum value2 = temporalinst_value(inst2);
 		upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
-		if (datum_ne(value1, value2, seq->valuetypid))
+		if (! isnan(azimuths[i - 1]))
 		{
-			ensure_point_base_type(inst1->valuetypid);
-			if (inst1->valuetypid == type_oid(T_GEOMETRY))
-				azimuth = call_function2(LWGEOM_azimuth, temporalinst_value(inst1),
-					temporalinst_value(inst2));
-			else if (inst1->valuetypid == type_oid(T_GEOGRAPHY))
-				azimuth = call_function2(geography_azimuth, temporalinst_value(inst1),
-					temporalinst_value(inst2));
+			azimuth = Float8GetDatum(azimuths[i - 1]);
 			instants[k++] = temporalinst_make(azimuth,
 				inst1->t, FLOAT8OID);
 		}
@@ -1501,7 +1744,6 @@ tpointseq_azimuth1(TemporalSeq **result, TemporalSeq *seq)
 			lower_inc = true;
 		}
 		inst1 = inst2;
-		value1 = value2;
 	}
 	if (k != 0)
 	{
@@ -1512,15 +1754,17 @@ tpointseq_azimuth1(TemporalSeq **result, TemporalSeq *seq)
 	}
 
 	pfree(instants);
+	pfree(azimuths);
+	pfree(coords);
 
 	return l;
 }
 
 TemporalS *
-tpointseq_azimuth(TemporalSeq *seq)
+tpointseq_azimuth(TemporalSeq *seq, const SPHEROID *s)
 {
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * seq->count);
-	int count = tpointseq_azimuth1(sequences, seq);
+	int count = tpointseq_azimuth1(sequences, seq, s);
 	if (count == 0)
 	{
 		pfree(sequences);
@@ -1537,17 +1781,17 @@ tpointseq_azimuth(TemporalSeq *seq)
 }
 
 TemporalS *
-tpoints_azimuth(TemporalS *ts)
+tpoints_azimuth(TemporalS *ts, const SPHEROID *s)
 {
 	if (ts->count == 1)
-		return tpointseq_azimuth(temporals_seq_n(ts, 0));
+		return tpointseq_azimuth(temporals_seq_n(ts, 0), s);
 
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->totalcount);
 	int k = 0;
 	for (int i = 0; i < ts->count; i++)
 	{
 		TemporalSeq *seq = temporals_seq_n(ts, i);
-		k += tpointseq_azimuth1(&sequences[k], seq);
+		k += tpointseq_azimuth1(&sequences[k], seq, s);
 	}
 	if (k == 0)
 		return NULL;
@@ -1570,21 +1814,573 @@ tpoint_azimuth(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Temporal *result = NULL;
+	SPHEROID s;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST || temp->duration == TEMPORALI ||
 		(temp->duration == TEMPORALSEQ && ! MOBDB_FLAGS_GET_LINEAR(temp->flags)) ||
 		(temp->duration == TEMPORALS && ! MOBDB_FLAGS_GET_LINEAR(temp->flags)))
 		;
-	else if (temp->duration == TEMPORALSEQ)
-		result = (Temporal *)tpointseq_azimuth((TemporalSeq *)temp);	
-	else if (temp->duration == TEMPORALS)
-		result = (Temporal *)tpoints_azimuth((TemporalS *)temp);
+	else
+	{
+		SPHEROID *sp = tpoint_spheroid(fcinfo, temp, &s) ? &s : NULL;
+		if (temp->duration == TEMPORALSEQ)
+			result = (Temporal *)tpointseq_azimuth((TemporalSeq *)temp, sp);
+		else if (temp->duration == TEMPORALS)
+			result = (Temporal *)tpoints_azimuth((TemporalS *)temp, sp);
+	}
 	PG_FREE_IF_COPY(temp, 0);
 	if (result == NULL)
 		PG_RETURN_NULL();
 	PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Simplification
+ *****************************************************************************/
+
+PG_FUNCTION_INFO_V1(tpoint_simplify);
+/*
+ * Simplify the temporal point keeping the distance between the removed 
+ * instants and the simplified trajectory below a tolerance. The distance is
+ * measured either to the trajectory or, when synchronized is true, to the 
+ * position of the simplified point at the timestamp of the instant.
+ */
+PGDLLEXPORT Datum
+tpoint_simplify(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	double eps = PG_GETARG_FLOAT8(1);
+	bool synchronized = PG_GETARG_BOOL(2);
+	bool streaming = PG_GETARG_BOOL(3);
+	Temporal *result = temporal_simplify_internal(temp, eps, synchronized,
+		streaming);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************
+ * Space-time split
+ * The plane is split into cells of a regular grid and the time line into
+ * buckets. The segments of a sequence are clipped analytically against the
+ * grid lines and the bucket boundaries. A point lying on a grid line or a
+ * bucket boundary belongs to the cell or bucket starting there.
+ *****************************************************************************/
+
+typedef struct
+{
+	double xorigin;
+	double yorigin;
+	double xsize;
+	double ysize;
+	TimestampTz torigin;
+	int64 width;
+} STGrid;
+
+/* Instant of a sequence or crossing of a grid line or a bucket boundary */
+typedef struct
+{
+	TimestampTz t;
+	double x;
+	double y;
+	double z;
+	int cellx;
+	int celly;
+	int64 tbucket;
+} STKnot;
+
+/* Crossing of a segment with a grid line or a bucket boundary */
+typedef struct
+{
+	double ratio;
+	int axis;			/* 0 for x, 1 for y, 2 for time */
+	int64 number;		/* number of the grid line or of the bucket */
+	TimestampTz t;		/* timestamp of the bucket boundary */
+} STCrossing;
+
+typedef struct
+{
+	int cellx;
+	int celly;
+	int64 tbucket;
+	int order;
+	Temporal *fragment;
+} STFragment;
+
+static int
+stgrid_cell(double value, double origin, double size)
+{
+	double result = floor((value - origin) / size);
+	if (result < PG_INT32_MIN || result > PG_INT32_MAX)
+		ereport(ERROR, (errcode(ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE),
+			errmsg("Cell number out of range, the cell size is too small")));
+	return (int) result;
+}
+
+static void
+stknot_set(STKnot *knot, const STGrid *grid, TimestampTz t, double x, 
+	double y, double z)
+{
+	knot->t = t;
+	knot->x = x;
+	knot->y = y;
+	knot->z = z;
+	knot->cellx = stgrid_cell(x, grid->xorigin, grid->xsize);
+	knot->celly = stgrid_cell(y, grid->yorigin, grid->ysize);
+	knot->tbucket = timestamp_bucket(t, grid->torigin, grid->width);
+}
+
+static bool
+stknot_same_key(const STKnot *knot, int cellx, int celly, int64 tbucket)
+{
+	return knot->cellx == cellx && knot->celly == celly && 
+		knot->tbucket == tbucket;
+}
+
+static int
+stcrossing_cmp(const void *a, const void *b)
+{
+	double ratio1 = ((const STCrossing *) a)->ratio;
+	double ratio2 = ((const STCrossing *) b)->ratio;
+	return (ratio1 < ratio2) ? -1 : ((ratio1 > ratio2) ? 1 : 0);
+}
+
+static int
+stfragment_cmp(const void *a, const void *b)
+{
+	const STFragment *f1 = (const STFragment *) a;
+	const STFragment *f2 = (const STFragment *) b;
+	if (f1->tbucket != f2->tbucket)
+		return (f1->tbucket < f2->tbucket) ? -1 : 1;
+	if (f1->cellx != f2->cellx)
+		return (f1->cellx < f2->cellx) ? -1 : 1;
+	if (f1->celly != f2->celly)
+		return (f1->celly < f2->celly) ? -1 : 1;
+	return (f1->order < f2->order) ? -1 : ((f1->order > f2->order) ? 1 : 0);
+}
+
+/* Position of a temporal point instant, with a zero z for 2D points */
+
+POINT3DZ
+tpointinst_point3dz(TemporalInst *inst, bool hasz)
+{
+	POINT3DZ result;
+	if (hasz)
+		result = datum_get_point3dz(temporalinst_value(inst));
+	else
+	{
+		POINT2D point = datum_get_point2d(temporalinst_value(inst));
+		result.x = point.x;
+		result.y = point.y;
+		result.z = 0;
+	}
+	return result;
+}
+
+/* Add the crossings of the grid lines of one axis strictly inside a segment */
+static int
+stsegment_crossings(STCrossing *crossings, int axis, double value1, 
+	double value2, double origin, double size)
+{
+	if (value1 == value2)
+		return 0;
+	int cell1 = stgrid_cell(value1, origin, size);
+	int cell2 = stgrid_cell(value2, origin, size);
+	double min = Min(value1, value2), max = Max(value1, value2);
+	int count = 0;
+	for (int k = Min(cell1, cell2) + 1; k <= Max(cell1, cell2); k++)
+	{
+		double line = origin + k * size;
+		if (line <= min || line >= max)
+			continue;
+		crossings[count].ratio = (line - value1) / (value2 - value1);
+		crossings[count].axis = axis;
+		crossings[count].number = k;
+		crossings[count++].t = 0;
+	}
+	return count;
+}
+
+/*
+ * Returns the instants of the sequence together with the points where its
+ * segments cross a grid line or a bucket boundary
+ */
+static STKnot *
+tpointseq_stknots(TemporalSeq *seq, const STGrid *grid, bool hasz, 
+	int *count)
+{
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	int capacity = seq->count * 2;
+	STKnot *result = palloc(sizeof(STKnot) * capacity);
+	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
+	POINT3DZ p1 = tpointinst_point3dz(inst1, hasz);
+	stknot_set(&result[0], grid, inst1->t, p1.x, p1.y, p1.z);
+	int k = 1;
+	for (int i = 1; i < seq->count; i++)
+	{
+		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
+		POINT3DZ p2 = tpointinst_point3dz(inst2, hasz);
+		int64 bucket1 = timestamp_bucket(inst1->t, grid->torigin, grid->width);
+		int64 bucket2 = timestamp_bucket(inst2->t, grid->torigin, grid->width);
+		int maxcount = (int) (bucket2 - bucket1) + (linear ? 
+			abs(stgrid_cell(p2.x, grid->xorigin, grid->xsize) - 
+				stgrid_cell(p1.x, grid->xorigin, grid->xsize)) + 
+			abs(stgrid_cell(p2.y, grid->yorigin, grid->ysize) - 
+				stgrid_cell(p1.y, grid->yorigin, grid->ysize)) : 0);
+		STCrossing *crossings = palloc(sizeof(STCrossing) * (maxcount + 1));
+		int ncross = 0;
+		double duration = (double) (inst2->t - inst1->t);
+		for (int64 b = bucket1 + 1; b <= bucket2; b++)
+		{
+			TimestampTz t = grid->torigin + b * grid->width;
+			if (t <= inst1->t || t >= inst2->t)
+				continue;
+			crossings[ncross].ratio = (double) (t - inst1->t) / duration;
+			crossings[ncross].axis = 2;
+			crossings[ncross].number = b;
+			crossings[ncross++].t = t;
+		}
+		if (linear)
+		{
+			ncross += stsegment_crossings(&crossings[ncross], 0, p1.x, p2.x,
+				grid->xorigin, grid->xsize);
+			ncross += stsegment_crossings(&crossings[ncross], 1, p1.y, p2.y,
+				grid->yorigin, grid->ysize);
+			qsort(crossings, (size_t) ncross, sizeof(STCrossing), 
+				&stcrossing_cmp);
+		}
+		if (k + ncross + 1 > capacity)
+		{
+			capacity = (k + ncross + 1) * 2;
+			result = repalloc(result, sizeof(STKnot) * capacity);
+		}
+		int first = k;
+		for (int j = 0; j < ncross; j++)
+		{
+			STCrossing *c = &crossings[j];
+			TimestampTz t = (c->axis == 2) ? c->t : 
+				inst1->t + (TimestampTz) rint(c->ratio * duration);
+			if (t >= inst2->t)
+				continue;
+			if (t <= result[k - 1].t)
+			{
+				/* Crossings that round to the same timestamp are merged */
+				if (k - 1 < first || t < result[k - 1].t)
+					continue;
+			}
+			else
+			{
+				if (linear)
+					stknot_set(&result[k++], grid, t, 
+						p1.x + (p2.x - p1.x) * c->ratio,
+						p1.y + (p2.y - p1.y) * c->ratio,
+						p1.z + (p2.z - p1.z) * c->ratio);
+				else
+					stknot_set(&result[k++], grid, t, p1.x, p1.y, p1.z);
+			}
+			/* Points on a grid line belong to the cell starting there */
+			if (c->axis == 0)
+			{
+				result[k - 1].x = grid->xorigin + c->number * grid->xsize;
+				result[k - 1].cellx = (int) c->number;
+			}
+			else if (c->axis == 1)
+			{
+				result[k - 1].y = grid->yorigin + c->number * grid->ysize;
+				result[k - 1].celly = (int) c->number;
+			}
+		}
+		pfree(crossings);
+		stknot_set(&result[k++], grid, inst2->t, p2.x, p2.y, p2.z);
+		inst1 = inst2;
+		p1 = p2;
+	}
+	*count = k;
+	return result;
+}
+
+static TemporalInst *
+stknot_instant(const STKnot *knot, const STKnot *value, int32 srid, bool hasz)
+{
+	LWPOINT *lwpoint = hasz ? 
+		lwpoint_make3dz(srid, value->x, value->y, value->z) :
+		lwpoint_make2d(srid, value->x, value->y);
+	Datum point = PointerGetDatum(geometry_serialize((LWGEOM *) lwpoint));
+	TemporalInst *result = temporalinst_make(point, knot->t, 
+		type_oid(T_GEOMETRY));
+	lwpoint_free(lwpoint);
+	pfree(DatumGetPointer(point));
+	return result;
+}
+
+static void
+stfragment_set(STFragment *fragment, int cellx, int celly, int64 tbucket,
+	int order, Temporal *temp)
+{
+	fragment->cellx = cellx;
+	fragment->celly = celly;
+	fragment->tbucket = tbucket;
+	fragment->order = order;
+	fragment->fragment = temp;
+}
+
+static int
+stknot_fragment(STFragment *fragments, int order, const STKnot *knot, 
+	int32 srid, bool hasz, bool linear)
+{
+	TemporalInst *inst = stknot_instant(knot, knot, srid, hasz);
+	TemporalSeq *seq = temporalseq_from_temporalinstarr(&inst, 1, true, true,
+		linear, false);
+	pfree(inst);
+	stfragment_set(&fragments[0], knot->cellx, knot->celly, knot->tbucket,
+		order, (Temporal *) seq);
+	return 1;
+}
+
+/*
+ * Split a sequence into fragments that are each contained in a single cell
+ * and bucket. Returns the number of fragments added.
+ */
+static int
+tpointseq_space_time_split(STFragment *fragments, int order, TemporalSeq *seq,
+	STKnot *knots, int nknots, const STGrid *grid, int32 srid, bool hasz)
+{
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	int count = 0;
+	if (nknots == 1)
+	{
+		return stknot_fragment(fragments, order, &knots[0], srid, hasz, linear);
+	}
+
+	/* Keys of the pieces between consecutive knots */
+	int *cellx = palloc(sizeof(int) * nknots);
+	int *celly = palloc(sizeof(int) * nknots);
+	int64 *tbucket = palloc(sizeof(int64) * nknots);
+	for (int i = 1; i < nknots; i++)
+	{
+		const STKnot *k1 = &knots[i - 1], *k2 = &knots[i];
+		double x = linear ? (k1->x + k2->x) / 2 : k1->x;
+		double y = linear ? (k1->y + k2->y) / 2 : k1->y;
+		cellx[i] = stgrid_cell(x, grid->xorigin, grid->xsize);
+		celly[i] = stgrid_cell(y, grid->yorigin, grid->ysize);
+		tbucket[i] = timestamp_bucket(k1->t + (k2->t - k1->t) / 2, 
+			grid->torigin, grid->width);
+	}
+
+	if (seq->period.lower_inc && 
+		! stknot_same_key(&knots[0], cellx[1], celly[1], tbucket[1]))
+		count += stknot_fragment(&fragments[count], order + count, &knots[0], 
+			srid, hasz, linear);
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * nknots);
+	int start = 0;
+	while (start < nknots - 1)
+	{
+		int cx = cellx[start + 1], cy = celly[start + 1];
+		int64 tb = tbucket[start + 1];
+		int end = start + 1;
+		while (end < nknots - 1 && stknot_same_key(&knots[end], cx, cy, tb) &&
+				cellx[end + 1] == cx && celly[end + 1] == cy && 
+				tbucket[end + 1] == tb)
+			end++;
+		bool lower_inc = (start > 0 || seq->period.lower_inc) &&
+			stknot_same_key(&knots[start], cx, cy, tb);
+		bool upper_inc = (end < nknots - 1 || seq->period.upper_inc) &&
+			stknot_same_key(&knots[end], cx, cy, tb);
+		int ninsts = 0;
+		for (int i = start; i <= end; i++)
+		{
+			/* A stepwise sequence keeps the previous value at an exclusive
+			 * upper bound */
+			const STKnot *value = (! linear && ! upper_inc && i == end) ?
+				&knots[i - 1] : &knots[i];
+			instants[ninsts++] = stknot_instant(&knots[i], value, srid, hasz);
+		}
+		TemporalSeq *fragment = temporalseq_from_temporalinstarr(instants, 
+			ninsts, lower_inc, upper_inc, linear, true);
+		for (int i = 0; i < ninsts; i++)
+			pfree(instants[i]);
+		stfragment_set(&fragments[count], cx, cy, tb, order + count, 
+			(Temporal *) fragment);
+		count++;
+		/* A knot belonging to neither of the adjacent fragments */
+		const STKnot *knot = &knots[end];
+		bool included = (end < nknots - 1) ? 
+			stknot_same_key(knot, cx, cy, tb) || 
+			stknot_same_key(knot, cellx[end + 1], celly[end + 1], 
+				tbucket[end + 1]) :
+			! seq->period.upper_inc || stknot_same_key(knot, cx, cy, tb);
+		if (! included)
+			count += stknot_fragment(&fragments[count], order + count, knot, 
+				srid, hasz, linear);
+		start = end;
+	}
+	pfree(instants);
+	pfree(cellx); pfree(celly); pfree(tbucket);
+	return count;
+}
+
+/*
+ * Split a temporal point into fragments by the cells of a grid and by time
+ * buckets. The fragments with the same cell and bucket are merged.
+ * Returns the number of fragments.
+ */
+static int
+tpoint_space_time_split_internal(Temporal *temp, const STGrid *grid,
+	STFragment **result)
+{
+	int32 srid = tpoint_srid_internal(temp);
+	bool hasz = MOBDB_FLAGS_GET_Z(temp->flags);
+	STFragment *fragments = NULL;
+	int count = 0;
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST || temp->duration == TEMPORALI)
+	{
+		int ninsts = (temp->duration == TEMPORALINST) ? 1 : 
+			((TemporalI *) temp)->count;
+		fragments = palloc(sizeof(STFragment) * ninsts);
+		for (int i = 0; i < ninsts; i++)
+		{
+			TemporalInst *inst = (temp->duration == TEMPORALINST) ?
+				(TemporalInst *) temp : temporali_inst_n((TemporalI *) temp, i);
+			POINT3DZ point = tpointinst_point3dz(inst, hasz);
+			STKnot knot;
+			stknot_set(&knot, grid, inst->t, point.x, point.y, point.z);
+			stfragment_set(&fragments[count++], knot.cellx, knot.celly, 
+				knot.tbucket, i, (Temporal *) temporalinst_copy(inst));
+		}
+	}
+	else
+	{
+		int nseqs = (temp->duration == TEMPORALSEQ) ? 1 : 
+			((TemporalS *) temp)->count;
+		int capacity = 0;
+		for (int i = 0; i < nseqs; i++)
+		{
+			TemporalSeq *seq = (temp->duration == TEMPORALSEQ) ?
+				(TemporalSeq *) temp : temporals_seq_n((TemporalS *) temp, i);
+			int nknots;
+			STKnot *knots = tpointseq_stknots(seq, grid, hasz, &nknots);
+			/* A sequence yields at most two fragments per knot */
+			if (count + 2 * nknots > capacity)
+			{
+				capacity = (count + 2 * nknots) * 2;
+				fragments = (fragments == NULL) ? 
+					palloc(sizeof(STFragment) * capacity) :
+					repalloc(fragments, sizeof(STFragment) * capacity);
+			}
+			count += tpointseq_space_time_split(&fragments[count], count, seq,
+				knots, nknots, grid, srid, hasz);
+			pfree(knots);
+		}
+	}
+
+	/* Merge the fragments with the same cell and bucket */
+	qsort(fragments, (size_t) count, sizeof(STFragment), &stfragment_cmp);
+	int k = 0, i = 0;
+	while (i < count)
+	{
+		int j = i + 1;
+		while (j < count && fragments[j].tbucket == fragments[i].tbucket &&
+				fragments[j].cellx == fragments[i].cellx &&
+				fragments[j].celly == fragments[i].celly)
+			j++;
+		Temporal *fragment = fragments[i].fragment;
+		if (j - i > 1)
+		{
+			Temporal **temporals = palloc(sizeof(Temporal *) * (j - i));
+			for (int l = i; l < j; l++)
+				temporals[l - i] = fragments[l].fragment;
+			if (fragment->duration == TEMPORALINST)
+				fragment = (Temporal *) temporali_from_temporalinstarr(
+					(TemporalInst **) temporals, j - i);
+			else
+				fragment = (Temporal *) temporals_from_temporalseqarr(
+					(TemporalSeq **) temporals, j - i, 
+					MOBDB_FLAGS_GET_LINEAR(temp->flags), true);
+			for (int l = 0; l < j - i; l++)
+				pfree(temporals[l]);
+			pfree(temporals);
+		}
+		fragments[k] = fragments[i];
+		fragments[k++].fragment = fragment;
+		i = j;
+	}
+	*result = fragments;
+	return k;
+}
+
+/* State of the set-returning function splitting a temporal point */
+
+typedef struct
+{
+	int i;
+	int count;
+	TimestampTz torigin;
+	int64 width;
+	STFragment *fragments;
+} STSplitState;
+
+PG_FUNCTION_INFO_V1(tpoint_space_time_split);
+/*
+ * Split the temporal point into fragments by the cells of a grid and by time
+ * buckets. Returns a set of (cell x, cell y, bucket start, fragment) tuples.
+ */
+PGDLLEXPORT Datum
+tpoint_space_time_split(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	if (SRF_IS_FIRSTCALL())
+	{
+		funcctx = SRF_FIRSTCALL_INIT();
+		MemoryContext oldcontext = 
+			MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+		Temporal *temp = PG_GETARG_TEMPORAL(0);
+		STGrid grid;
+		grid.xsize = PG_GETARG_FLOAT8(1);
+		grid.ysize = PG_GETARG_FLOAT8(2);
+		grid.width = interval_width(PG_GETARG_INTERVAL_P(3));
+		GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(4);
+		grid.torigin = PG_GETARG_TIMESTAMPTZ(5);
+		if (grid.xsize <= 0 || grid.ysize <= 0)
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+				errmsg("The cell size must be positive")));
+		ensure_point_type(gs);
+		ensure_non_empty(gs);
+		if (gserialized_get_srid(gs) != SRID_UNKNOWN)
+			ensure_same_srid_tpoint_gs(temp, gs);
+		POINT2D origin = gs_get_point2d(gs);
+		grid.xorigin = origin.x;
+		grid.yorigin = origin.y;
+
+		STSplitState *state = palloc0(sizeof(STSplitState));
+		state->torigin = grid.torigin;
+		state->width = grid.width;
+		state->count = tpoint_space_time_split_internal(temp, &grid, 
+			&state->fragments);
+		funcctx->user_fctx = state;
+		TupleDesc tupdesc;
+		if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				errmsg("Function returning record called in context that cannot accept type record")));
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	STSplitState *state = (STSplitState *) funcctx->user_fctx;
+	if (state->i == state->count)
+		SRF_RETURN_DONE(funcctx);
+	STFragment *fragment = &state->fragments[state->i++];
+	Datum values[4];
+	bool nulls[4] = {false, false, false, false};
+	values[0] = Int32GetDatum(fragment->cellx);
+	values[1] = Int32GetDatum(fragment->celly);
+	values[2] = TimestampTzGetDatum(state->torigin + 
+		fragment->tbucket * state->width);
+	values[3] = PointerGetDatum(fragment->fragment);
+	HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+	SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+}
+
 /*****************************************************************************
  * Restriction functions
  * N.B. In the current version of PostGIS (2.5) there is no true ST_Intersection
@@ -1738,6 +2534,14 @@ tpointseq_at_geometry1(TemporalInst *inst1, TemporalInst *inst2, bool linear,
 	return result;
 }
 
+/* Does the block bounding box overlap the box? */
+
+static bool
+stbox_overlaps_stbox(void *box, void *arg)
+{
+	return overlaps_stbox_stbox_internal((STBOX *) box, (STBOX *) arg);
+}
+
 TemporalSeq **
 tpointseq_at_geometry2(TemporalSeq *seq, Datum geom, int *count)
 {
@@ -1754,20 +2558,31 @@ tpointseq_at_geometry2(TemporalSeq *seq, Datum geom, int *count)
 
 	/* Temporal sequence has at least 2 instants */
 	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
-	TemporalSeq ***sequences = palloc(sizeof(TemporalSeq *) * (seq->count - 1));
+	/* palloc0 used since the segments of skipped blocks are not visited */
+	TemporalSeq ***sequences = palloc0(sizeof(TemporalSeq *) * (seq->count - 1));
 	int *countseqs = palloc0(sizeof(int) * (seq->count - 1));
 	int totalseqs = 0;
-	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
-	bool lower_inc = seq->period.lower_inc;
+	STBOX box;
+	memset(&box, 0, sizeof(STBOX));
+	bool blocks = MOBDB_FLAGS_GET_BLOCKS(seq->flags) &&
+		geo_to_stbox_internal(&box, (GSERIALIZED *) DatumGetPointer(geom));
 	for (int i = 0; i < seq->count - 1; i++)
 	{
+		/* Skip the blocks whose bounding box does not overlap the geometry */
+		int j = blocks ? 
+			temporalseq_block_skip(seq, i, &stbox_overlaps_stbox, &box) : i;
+		if (j != i)
+		{
+			i = j - 1;
+			continue;
+		}
+		TemporalInst *inst1 = temporalseq_inst_n(seq, i);
 		TemporalInst *inst2 = temporalseq_inst_n(seq, i + 1);
+		bool lower_inc = (i == 0) ? seq->period.lower_inc : true;
 		bool upper_inc = (i == seq->count - 2) ? seq->period.upper_inc : false;
 		sequences[i] = tpointseq_at_geometry1(inst1, inst2, linear,
 			lower_inc, upper_inc, geom, &countseqs[i]);
 		totalseqs += countseqs[i];
-		inst1 = inst2;
-		lower_inc = true;
 	}
 	if (totalseqs == 0)
 	{
@@ -2164,7 +2979,22 @@ NAI_tpointseq_geo1(TemporalInst *inst1, TemporalInst *inst2,
 
 	double fraction;
 	ensure_point_base_type(inst1->valuetypid);
-	if (inst1->valuetypid == type_oid(T_GEOMETRY))
+	if (inst1->valuetypid == type_oid(T_GEOMETRY) &&
+		gserialized_get_type((GSERIALIZED *) DatumGetPointer(geo)) == POINTTYPE)
+	{
+		/* Project the point on the segment */
+		POINT2D p1 = datum_get_point2d(value1);
+		POINT2D p2 = datum_get_point2d(value2);
+		POINT2D q = gs_get_point2d((GSERIALIZED *) DatumGetPointer(geo));
+		double dx = p2.x - p1.x, dy = p2.y - p1.y;
+		double denom = dx * dx + dy * dy;
+		/* A vertical segment of a 3D point projects to a single point */
+		fraction = 0;
+		if (denom > 0)
+			fraction = Max(0, Min(1, ((q.x - p1.x) * dx + (q.y - p1.y) * dy) /
+				denom));
+	}
+	else if (inst1->valuetypid == type_oid(T_GEOMETRY))
 	{
 		/* The trajectory is a line */
 		Datum traj = geompoint_trajectory(value1, value2);
@@ -2214,6 +3044,113 @@ NAI_tpointseq_geo1(TemporalInst *inst1, TemporalInst *inst2,
 	return temporalseq_value_at_timestamp1(inst1, inst2, true, *t);
 }
 
+/* 
+ * Is the 2D distance between the bounding box of a sequence and the bounding
+ * box of the geometry at most the current minimum distance? The 2D distance between
+ * the boxes is a lower bound of the 2D and 3D distances between their contents.
+ */
+
+typedef struct
+{
+	STBOX *box;
+	double *mindist;
+} stbox_dist_arg;
+
+static bool
+stbox_within_dist(void *box, void *arg)
+{
+	STBOX *box1 = (STBOX *) box;
+	STBOX *box2 = ((stbox_dist_arg *) arg)->box;
+	double dx = Max(0, Max(box1->xmin - box2->xmax, box2->xmin - box1->xmax));
+	double dy = Max(0, Max(box1->ymin - box2->ymax, box2->ymin - box1->ymax));
+	return sqrt(dx * dx + dy * dy) <= *((stbox_dist_arg *) arg)->mindist;
+}
+
+/*
+ * Segments of a temporal geometry point ordered by a lower bound of their
+ * distance to a geometry
+ */
+
+typedef struct
+{
+	double bound;
+	int i;
+} SegmentBound;
+
+static int
+segment_bound_cmp(const void *a, const void *b)
+{
+	const SegmentBound *sb1 = (const SegmentBound *) a;
+	const SegmentBound *sb2 = (const SegmentBound *) b;
+	if (sb1->bound != sb2->bound)
+		return (sb1->bound < sb2->bound) ? -1 : 1;
+	return (sb1->i < sb2->i) ? -1 : ((sb1->i > sb2->i) ? 1 : 0);
+}
+
+/*
+ * NAI between temporal sequence geometry point with linear interpolation and 
+ * a geometry. The segments are visited by increasing 2D distance between their
+ * bounding box and the one of the geometry, and the visit stops as soon as
+ * this lower bound exceeds the current minimum distance. Ties are broken by
+ * the earliest segment as in a sequential scan.
+ */
+static TemporalInst *
+NAI_tpointseq_geom(TemporalSeq *seq, Datum geo, Datum (*func)(Datum, Datum))
+{
+	STBOX box;
+	memset(&box, 0, sizeof(STBOX));
+	geo_to_stbox_internal(&box, (GSERIALIZED *) DatumGetPointer(geo));
+	int nsegs = seq->count - 1;
+	SegmentBound *bounds = palloc(sizeof(SegmentBound) * nsegs);
+	POINT2D p1 = datum_get_point2d(temporalinst_value(
+		temporalseq_inst_n(seq, 0)));
+	for (int i = 0; i < nsegs; i++)
+	{
+		POINT2D p2 = datum_get_point2d(temporalinst_value(
+			temporalseq_inst_n(seq, i + 1)));
+		double dx = Max(0, Max(Min(p1.x, p2.x) - box.xmax, 
+			box.xmin - Max(p1.x, p2.x)));
+		double dy = Max(0, Max(Min(p1.y, p2.y) - box.ymax, 
+			box.ymin - Max(p1.y, p2.y)));
+		bounds[i].bound = sqrt(dx * dx + dy * dy);
+		bounds[i].i = i;
+		p1 = p2;
+	}
+	qsort(bounds, (size_t) nsegs, sizeof(SegmentBound), &segment_bound_cmp);
+
+	double mindist = DBL_MAX;
+	int minseg = nsegs;
+	Datum minpoint = 0; /* keep compiler quiet */
+	TimestampTz tmin = 0; /* keep compiler quiet */
+	bool mintofree =  false; /* keep compiler quiet */
+	for (int k = 0; k < nsegs && bounds[k].bound <= mindist; k++)
+	{
+		int i = bounds[k].i;
+		TimestampTz t;
+		bool tofree;
+		Datum point = NAI_tpointseq_geo1(temporalseq_inst_n(seq, i),
+			temporalseq_inst_n(seq, i + 1), geo, &t, &tofree);
+		double dist = DatumGetFloat8(func(point, geo));
+		if (dist < mindist || (dist == mindist && i < minseg))
+		{
+			if (mintofree)
+				pfree(DatumGetPointer(minpoint));
+			mindist = dist;
+			minseg = i;
+			minpoint = point;
+			tmin = t;
+			mintofree = tofree;
+		}
+		else if (tofree)
+			pfree(DatumGetPointer(point));
+	}
+	pfree(bounds);
+	TemporalInst *result = temporalinst_make(minpoint, tmin, seq->valuetypid);
+	if (mintofree)
+		pfree(DatumGetPointer(minpoint));
+	return result;
+}
+
 static TemporalInst *
 NAI_tpointseq_geo(TemporalSeq *seq, Datum geo, Datum (*func)(Datum, Datum))
 {
@@ -2226,6 +3163,9 @@ NAI_tpointseq_geo(TemporalSeq *seq, Datum geo, Datum (*func)(Datum, Datum))
 		return NAI_tpointseq_stw_geo(seq, geo, func);
 
 	/* Linear interpolation */
+	if (seq->valuetypid == type_oid(T_GEOMETRY))
+		return NAI_tpointseq_geom(seq, geo, func);
+
 	double mindist = DBL_MAX;
 	Datum minpoint = 0; /* keep compiler quiet */
 	TimestampTz tmin = 0; /* keep compiler quiet */
@@ -2262,9 +3202,18 @@ NAI_tpoints_geo(TemporalS *ts, Datum geo, Datum (*func)(Datum, Datum))
 {
 	TemporalInst *result = NULL;
 	double mindist = DBL_MAX;
+	/* Sequences that cannot be nearer than the current minimum are skipped */
+	bool geom = ts->valuetypid == type_oid(T_GEOMETRY);
+	STBOX box;
+	memset(&box, 0, sizeof(STBOX));
+	if (geom)
+		geo_to_stbox_internal(&box, (GSERIALIZED *) DatumGetPointer(geo));
+	stbox_dist_arg arg = {&box, &mindist};
 	for (int i = 0; i < ts->count; i++)
 	{
 		TemporalSeq *seq = temporals_seq_n(ts, i);
+		if (geom && ! stbox_within_dist(temporalseq_bbox_ptr(seq), &arg))
+			continue;
 		TemporalInst *inst = NAI_tpointseq_geo(seq, geo, func);
 		Datum value = temporalinst_value(inst);
 		double dist = DatumGetFloat8(func(value, geo));
@@ -2481,6 +3430,172 @@ NAD_tpoint_geo(PG_FUNCTION_ARGS)
 
 /*****************************************************************************/
 
+/*
+ * Position of a temporal geometry point sequence with linear interpolation 
+ * at a timestamp of its i-th segment
+ */
+static POINT3DZ
+tpointseq_point3dz_at(TemporalSeq *seq, int i, TimestampTz t, bool hasz)
+{
+	TemporalInst *inst1 = temporalseq_inst_n(seq, i);
+	POINT3DZ p1 = tpointinst_point3dz(inst1, hasz);
+	if (t == inst1->t || i == seq->count - 1)
+		return p1;
+	TemporalInst *inst2 = temporalseq_inst_n(seq, i + 1);
+	POINT3DZ p2 = tpointinst_point3dz(inst2, hasz);
+	if (t == inst2->t)
+		return p2;
+	double ratio = (double) (t - inst1->t) / (double) (inst2->t - inst1->t);
+	p1.x += (p2.x - p1.x) * ratio;
+	p1.y += (p2.y - p1.y) * ratio;
+	p1.z += (p2.z - p1.z) * ratio;
+	return p1;
+}
+
+/*
+ * Minimum distance between two points moving linearly from p1 to p2 and
+ * from q1 to q2 during the same period. The difference of their positions
+ * moves linearly and the minimum of its norm has a closed form.
+ */
+double
+segments_min_dist(POINT3DZ p1, POINT3DZ p2, POINT3DZ q1, POINT3DZ q2)
+{
+	double dx = p1.x - q1.x, dy = p1.y - q1.y, dz = p1.z - q1.z;
+	double ddx = (p2.x - q2.x) - dx, ddy = (p2.y - q2.y) - dy, 
+		ddz = (p2.z - q2.z) - dz;
+	double denom = ddx * ddx + ddy * ddy + ddz * ddz;
+	double ratio = 0;
+	if (denom > 0)
+		ratio = Max(0, Min(1, - (dx * ddx + dy * ddy + dz * ddz) / denom));
+	dx += ddx * ratio;
+	dy += ddy * ratio;
+	dz += ddz * ratio;
+	return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/*
+ * Minimum distance between two temporal geometry point sequences with linear
+ * interpolation over their common time span, walking their synchronized 
+ * segment pairs. Returns mindist if it is not improved.
+ */
+static double
+NAD_tpointseq_tpointseq(TemporalSeq *seq1, TemporalSeq *seq2, bool hasz,
+	double mindist)
+{
+	TimestampTz lower = Max(seq1->period.lower, seq2->period.lower);
+	TimestampTz upper = Min(seq1->period.upper, seq2->period.upper);
+	if (lower > upper || (lower == upper && 
+		(! contains_period_timestamp_internal(&seq1->period, lower) || 
+		 ! contains_period_timestamp_internal(&seq2->period, lower))))
+		return mindist;
+	int i = 0, j = 0;
+	while (i < seq1->count - 2 && temporalseq_inst_n(seq1, i + 1)->t <= lower)
+		i++;
+	while (j < seq2->count - 2 && temporalseq_inst_n(seq2, j + 1)->t <= lower)
+		j++;
+	POINT3DZ p1 = tpointseq_point3dz_at(seq1, i, lower, hasz);
+	POINT3DZ q1 = tpointseq_point3dz_at(seq2, j, lower, hasz);
+	if (lower == upper)
+		return Min(mindist, segments_min_dist(p1, p1, q1, q1));
+	TimestampTz t = lower;
+	while (t < upper && mindist > 0)
+	{
+		TimestampTz t1 = temporalseq_inst_n(seq1, i + 1)->t;
+		TimestampTz t2 = temporalseq_inst_n(seq2, j + 1)->t;
+		TimestampTz next = Min(Min(t1, t2), upper);
+		POINT3DZ p2 = tpointseq_point3dz_at(seq1, i, next, hasz);
+		POINT3DZ q2 = tpointseq_point3dz_at(seq2, j, next, hasz);
+		mindist = Min(mindist, segments_min_dist(p1, p2, q1, q2));
+		if (t1 == next && i < seq1->count - 2)
+			i++;
+		if (t2 == next && j < seq2->count - 2)
+			j++;
+		t = next;
+		p1 = p2;
+		q1 = q2;
+	}
+	return mindist;
+}
+
+/* Pair of sequences of two temporal points overlapping in time */
+
+typedef struct
+{
+	double bound;
+	TemporalSeq *seq1;
+	TemporalSeq *seq2;
+} SeqPairBound;
+
+static int
+seqpair_bound_cmp(const void *a, const void *b)
+{
+	double bound1 = ((const SeqPairBound *) a)->bound;
+	double bound2 = ((const SeqPairBound *) b)->bound;
+	return (bound1 < bound2) ? -1 : ((bound1 > bound2) ? 1 : 0);
+}
+
+/*
+ * NAD between two temporal geometry points with linear interpolation. 
+ * The pairs of sequences overlapping in time are visited by increasing 
+ * distance between their bounding boxes and the visit stops as soon as 
+ * this lower bound reaches the current minimum distance. 
+ * Returns false if the temporal points do not intersect in time.
+ */
+static bool
+NAD_tpoint_tpoint_linear(Temporal *temp1, Temporal *temp2, double *result)
+{
+	bool hasz = MOBDB_FLAGS_GET_Z(temp1->flags);
+	int count1 = (temp1->duration == TEMPORALSEQ) ? 1 : 
+		((TemporalS *) temp1)->count;
+	int count2 = (temp2->duration == TEMPORALSEQ) ? 1 : 
+		((TemporalS *) temp2)->count;
+	SeqPairBound *pairs = palloc(sizeof(SeqPairBound) * (count1 + count2));
+	int npairs = 0, i = 0, j = 0;
+	while (i < count1 && j < count2)
+	{
+		TemporalSeq *seq1 = (temp1->duration == TEMPORALSEQ) ? 
+			(TemporalSeq *) temp1 : temporals_seq_n((TemporalS *) temp1, i);
+		TemporalSeq *seq2 = (temp2->duration == TEMPORALSEQ) ? 
+			(TemporalSeq *) temp2 : temporals_seq_n((TemporalS *) temp2, j);
+		if (overlaps_period_period_internal(&seq1->period, &seq2->period))
+		{
+			STBOX *box1 = temporalseq_bbox_ptr(seq1);
+			STBOX *box2 = temporalseq_bbox_ptr(seq2);
+			double dx = Max(0, Max(box1->xmin - box2->xmax, box2->xmin - box1->xmax));
+			double dy = Max(0, Max(box1->ymin - box2->ymax, box2->ymin - box1->ymax));
+			double dz = hasz ? 
+				Max(0, Max(box1->zmin - box2->zmax, box2->zmin - box1->zmax)) : 0;
+			pairs[npairs].bound = sqrt(dx * dx + dy * dy + dz * dz);
+			pairs[npairs].seq1 = seq1;
+			pairs[npairs++].seq2 = seq2;
+		}
+		int cmp = timestamp_cmp_internal(seq1->period.upper, seq2->period.upper);
+		if (cmp == 0 && seq1->period.upper_inc == seq2->period.upper_inc)
+		{
+			i++; j++;
+		}
+		else if (cmp < 0 || (cmp == 0 && ! seq1->period.upper_inc))
+			i++;
+		else
+			j++;
+	}
+	if (npairs == 0)
+	{
+		pfree(pairs);
+		return false;
+	}
+	qsort(pairs, (size_t) npairs, sizeof(SeqPairBound), &seqpair_bound_cmp);
+	double mindist = DBL_MAX;
+	for (int k = 0; k < npairs && pairs[k].bound < mindist; k++)
+		mindist = NAD_tpointseq_tpointseq(pairs[k].seq1, pairs[k].seq2, hasz,
+			mindist);
+	pfree(pairs);
+	if (mindist == DBL_MAX)
+		return false;
+	*result = mindist;
+	return true;
+}
+
 PG_FUNCTION_INFO_V1(NAD_tpoint_tpoint);
 
 PGDLLEXPORT Datum
@@ -2490,6 +3605,21 @@ NAD_tpoint_tpoint(PG_FUNCTION_ARGS)
 	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	ensure_same_srid_tpoint(temp1, temp2);
 	ensure_same_dimensionality_tpoint(temp1, temp2);
+	if (temp1->valuetypid == type_oid(T_GEOMETRY) &&
+		(temp1->duration == TEMPORALSEQ || temp1->duration == TEMPORALS) &&
+		(temp2->duration == TEMPORALSEQ || temp2->duration == TEMPORALS) &&
+		MOBDB_FLAGS_GET_LINEAR(temp1->flags) && 
+		MOBDB_FLAGS_GET_LINEAR(temp2->flags))
+	{
+		double mindist;
+		bool found = NAD_tpoint_tpoint_linear(temp1, temp2, &mindist);
+		PG_FREE_IF_COPY(temp1, 0);
+		PG_FREE_IF_COPY(temp2, 1);
+		if (! found)
+			PG_RETURN_NULL();
+		PG_RETURN_FLOAT8(mindist);
+	}
+
 	Temporal *dist = distance_tpoint_tpoint_internal(temp1, temp2);
 	if (dist == NULL)
 	{
@@ -25,6 +25,8 @@
 
 #include "tpoint_spatialrels.h"
 
+#include <math.h>
+
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
@@ -126,6 +128,27 @@ geom_dwithin3d(Datum geom1, Datum geom2, Datum dist)
 	return call_function3(LWGEOM_dwithin3d, geom1, geom2, dist);
 }
 
+/* Versions of dwithin for two geometry points without calling PostGIS */
+
+Datum
+geompoint_dwithin2d(Datum point1, Datum point2, Datum dist)
+{
+	POINT2D p1 = datum_get_point2d(point1);
+	POINT2D p2 = datum_get_point2d(point2);
+	double dx = p1.x - p2.x, dy = p1.y - p2.y;
+	return BoolGetDatum(sqrt(dx * dx + dy * dy) <= DatumGetFloat8(dist));
+}
+
+Datum
+geompoint_dwithin3d(Datum point1, Datum point2, Datum dist)
+{
+	POINT3DZ p1 = datum_get_point3dz(point1);
+	POINT3DZ p2 = datum_get_point3dz(point2);
+	double dx = p1.x - p2.x, dy = p1.y - p2.y, dz = p1.z - p2.z;
+	return BoolGetDatum(sqrt(dx * dx + dy * dy + dz * dz) <= 
+		DatumGetFloat8(dist));
+}
+
 Datum
 geom_relate(Datum geom1, Datum geom2)
 {
@@ -178,6 +201,17 @@ dwithin_tpointseq_tpointseq1(TemporalInst *start1, TemporalInst *end1, bool line
 	TemporalInst *start2, TemporalInst *end2, bool linear2, Datum param,
 	Datum (*func)(Datum, Datum, Datum))
 {
+	/* Geometry points: minimum distance over the segments in closed form */
+	if (start1->valuetypid == type_oid(T_GEOMETRY))
+	{
+		bool hasz = MOBDB_FLAGS_GET_Z(start1->flags);
+		POINT3DZ p1 = tpointinst_point3dz(start1, hasz);
+		POINT3DZ p2 = linear1 ? tpointinst_point3dz(end1, hasz) : p1;
+		POINT3DZ q1 = tpointinst_point3dz(start2, hasz);
+		POINT3DZ q2 = linear2 ? tpointinst_point3dz(end2, hasz) : q1;
+		return segments_min_dist(p1, p2, q1, q2) <= DatumGetFloat8(param);
+	}
+
 	Datum sv1 = temporalinst_value(start1);
 	Datum ev1 = temporalinst_value(end1);
 	Datum sv2 = temporalinst_value(start2);
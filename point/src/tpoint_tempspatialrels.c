@@ -20,6 +20,8 @@
 
 #include "tpoint_tempspatialrels.h"
 
+#include <math.h>
+#include <funcapi.h>
 #include <utils/timestamp.h>
 
 #include "period.h"
@@ -28,8 +30,10 @@
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_runs.h"
 #include "lifting.h"
 #include "tpoint.h"
+#include "tpoint_boxops.h"
 #include "tpoint_spatialfuncs.h"
 #include "tpoint_spatialrels.h"
 
@@ -145,31 +149,39 @@ tpointseq_intersection_instants(TemporalInst *inst1, TemporalInst *inst2,
  * The potential crossings between the two are considered.
  * The resulting sequence (set) has stepwise interpolan since it is a
  * temporal Boolean or a temporal text (for trelate).
+ * The result is accumulated as runs of constant value, which are merged
+ * while they are added, instead of constructing several sequences per
+ * segment and normalizing them afterwards.
  * These functions are not available for geographies since it calls the 
  * intersection function in PostGIS that is only available for geometries.
  *****************************************************************************/
 
-static TemporalSeq **
-tspatialrel_tpointseq_geo1(TemporalInst *inst1, TemporalInst *inst2, bool linear,
-	Datum geo, bool lower_inc, bool upper_inc, Datum (*func)(Datum, Datum), 
-	Oid valuetypid, int *count, bool invert)
+/* Append a run and free its value if it was merged with the last run */
+
+static void
+tspatialrel_runs_append(TemporalRuns *runs, Datum value, TimestampTz lower,
+	TimestampTz upper, bool lower_inc, bool upper_inc)
+{
+	int count = runs->count;
+	truns_append(runs, value, lower, upper, lower_inc, upper_inc);
+	if (runs->count == count)
+		FREE_DATUM(value, runs->valuetypid);
+}
+
+static void
+tspatialrel_tpointseq_geo1(TemporalRuns *runs, TemporalInst *inst1, 
+	TemporalInst *inst2, bool linear, Datum geo, bool lower_inc, 
+	bool upper_inc, Datum (*func)(Datum, Datum), bool invert)
 {
 	Datum value1 = temporalinst_value(inst1);
 	Datum value2 = temporalinst_value(inst2);
 	/* Constant segment or stepwise interpolation */
 	if (datum_point_eq(value1, value2) || ! linear)
 	{	
-		TemporalSeq **result = palloc(sizeof(TemporalSeq *));
-		TemporalInst *instants[2];
 		Datum value = invert ? func(geo, value1) : func(value1, geo);
-		instants[0] = temporalinst_make(value, inst1->t, valuetypid);
-		instants[1] = temporalinst_make(value, inst2->t, valuetypid);
-		result[0] = temporalseq_from_temporalinstarr(instants, 2,
-			lower_inc, upper_inc, false, false);
-		pfree(instants[0]); pfree(instants[1]);
-		FREE_DATUM(value, valuetypid); 
-		*count = 1;
-		return result;
+		tspatialrel_runs_append(runs, value, inst1->t, inst2->t, 
+			lower_inc, upper_inc);
+		return;
 	}
 	
 	/* Look for intersections */
@@ -177,18 +189,11 @@ tspatialrel_tpointseq_geo1(TemporalInst *inst1, TemporalInst *inst2, bool linear
 	Datum intersections = call_function2(intersection, line, geo);
 	if (call_function1(LWGEOM_isempty, intersections))
 	{	
-		TemporalSeq **result = palloc(sizeof(TemporalSeq *));
-		TemporalInst *instants[2];
 		Datum value = invert ? func(geo, value1) : func(value1, geo);
-		instants[0] = temporalinst_make(value, inst1->t, valuetypid);
-		instants[1] = temporalinst_make(value, inst2->t, valuetypid);
-		result[0] = temporalseq_from_temporalinstarr(instants, 2,
-			lower_inc, upper_inc, false, false);
+		tspatialrel_runs_append(runs, value, inst1->t, inst2->t, 
+			lower_inc, upper_inc);
 		pfree(DatumGetPointer(line)); pfree(DatumGetPointer(intersections)); 
-		pfree(instants[0]); pfree(instants[1]);
-		FREE_DATUM(value, valuetypid); 
-		*count = 1;
-		return result;
+		return;
 	}
 	
 	/* Look for instants of intersections */
@@ -207,51 +212,28 @@ tspatialrel_tpointseq_geo1(TemporalInst *inst1, TemporalInst *inst2, bool linear
 		Datum intvalue = temporalseq_value_at_timestamp1(inst1, inst2, linear, inttime);
 		Datum intvalue1 = invert ? func(geo, intvalue) :
 			func(intvalue, geo);
-		TemporalSeq **result = palloc(sizeof(TemporalSeq *));
-		TemporalInst *instants[2];
-		instants[0] = temporalinst_make(intvalue1, inst1->t, valuetypid);
-		instants[1] = temporalinst_make(intvalue1, inst2->t, valuetypid);
-		result[0] = temporalseq_from_temporalinstarr(instants, 2,
-			lower_inc, upper_inc, false, false);
-		pfree(instants[0]); pfree(instants[1]);
-		FREE_DATUM(intvalue, inst1->valuetypid); FREE_DATUM(intvalue1, valuetypid);
-		*count = 1;
-		return result;
+		tspatialrel_runs_append(runs, intvalue1, inst1->t, inst2->t, 
+			lower_inc, upper_inc);
+		FREE_DATUM(intvalue, inst1->valuetypid);
+		pfree(interinstants);
+		return;
 	}
 
-	/* Determine whether the period started before/after the first/last intersection */
-	bool before = (inst1->t != (interinstants[0])->t);
-	bool after = (inst2->t != (interinstants[countinst - 1])->t);
-
-	/* Compute the func */
-	int countseq = (2 * countinst) - 1;
-	if (before) countseq++;
-	if (after) countseq++;
-	TemporalSeq **result = palloc(sizeof(TemporalSeq *) * countseq);
-	TemporalInst *instants[2];
-	int k = 0;
-	if (before)
+	/* Compute the func before the first intersection, at each intersection, 
+	 * between consecutive intersections, and after the last intersection */
+	if (inst1->t != (interinstants[0])->t)
 	{
 		Datum value = invert ? func(geo, value1) : func(value1, geo);
-		instants[0] = temporalinst_make(value, inst1->t, valuetypid);
-		instants[1] = temporalinst_make(value, (interinstants[0])->t, 
-			valuetypid);
-		result[k++] = temporalseq_from_temporalinstarr(instants, 2,
-			lower_inc, false, false, false);
-		pfree(instants[0]); pfree(instants[1]);
-		FREE_DATUM(value, valuetypid); 
+		tspatialrel_runs_append(runs, value, inst1->t, (interinstants[0])->t, 
+			lower_inc, false);
 	}
 	for (int i = 0; i < countinst; i++) 
 	{
 		/* Compute the value at the intersection point */
 		Datum value = invert ? func(temporalinst_value(interinstants[i]), geo) :
 			func(geo, temporalinst_value(interinstants[i]));
-		instants[0] = temporalinst_make(value, (interinstants[i])->t, 
-			valuetypid);
-		result[k++] = temporalseq_from_temporalinstarr(instants, 1,
-			true, true, false, false);
-		FREE_DATUM(value, valuetypid); 
-		pfree(instants[0]);
+		tspatialrel_runs_append(runs, value, (interinstants[i])->t, 
+			(interinstants[i])->t, true, true);
 		if (i < countinst - 1)
 		{
 			/* Find the middle time between current instant and the next one 
@@ -262,80 +244,62 @@ tspatialrel_tpointseq_geo1(TemporalInst *inst1, TemporalInst *inst2, bool linear
 				linear, inttime);
 			Datum intvalue1 = invert ? func(geo, intvalue) :
 				func(intvalue, geo);
-			instants[0] = temporalinst_make(intvalue1, interinstants[i]->t, valuetypid);
-			instants[1] = temporalinst_make(intvalue1, interinstants[i + 1]->t, valuetypid);
-			result[k++] = temporalseq_from_temporalinstarr(instants, 2,
-				false, false, false, false);
-			pfree(instants[0]); pfree(instants[1]);
+			tspatialrel_runs_append(runs, intvalue1, interinstants[i]->t, 
+				interinstants[i + 1]->t, false, false);
 			pfree(DatumGetPointer(intvalue));
-			FREE_DATUM(intvalue1, valuetypid); 
 		}
 	}
-	if (after)
+	if (inst2->t != (interinstants[countinst - 1])->t)
 	{
 		Datum value = invert ? func(geo, value2) : func(value2, geo);
-		instants[0] = temporalinst_make(value, (interinstants[countinst - 1])->t, 
-			valuetypid);
-		instants[1] = temporalinst_make(value, inst2->t, valuetypid);
-		result[k++] = temporalseq_from_temporalinstarr(instants, 2,
-			false, upper_inc, false, false);
-		pfree(instants[0]); pfree(instants[1]);
-		FREE_DATUM(value, valuetypid); 
+		tspatialrel_runs_append(runs, value, (interinstants[countinst - 1])->t, 
+			inst2->t, false, upper_inc);
 	}
 
 	for (int i = 0; i < countinst; i++)
 		pfree(interinstants[i]);
 	pfree(interinstants);
-	
-	*count = k;
-	return result;
+	return;
 }
 
-static TemporalSeq **
-tspatialrel_tpointseq_geo2(TemporalSeq *seq, Datum geo, 
-	Datum (*func)(Datum, Datum), Oid valuetypid, int *count, bool invert)
+static void
+tspatialrel_tpointseq_geo2(TemporalRuns *runs, TemporalSeq *seq, Datum geo, 
+	Datum (*func)(Datum, Datum), bool invert)
 {
+	/* Instantaneous sequence */
 	if (seq->count == 1)
 	{
 		TemporalInst *inst = temporalseq_inst_n(seq, 0);
 		Datum value = invert ? func(geo, temporalinst_value(inst)) : 
 			func(temporalinst_value(inst), geo);
-		TemporalSeq **result = palloc(sizeof(TemporalSeq *));
-		TemporalInst *inst1 = temporalinst_make(value, inst->t, valuetypid);
-		result[0] = temporalseq_from_temporalinstarr(&inst1, 1,
-			true, true, false, false);
-		pfree(inst1);
-		*count = 1;
-		return result;		
+		tspatialrel_runs_append(runs, value, inst->t, inst->t, true, true);
+		return;		
 	}
 	
-	TemporalSeq ***sequences = palloc(sizeof(TemporalSeq *) * seq->count);
-	int *countseqs = palloc0(sizeof(int) * seq->count);
-	int totalseqs = 0;
 	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
 	bool lower_inc = seq->period.lower_inc;
-	for (int i = 0; i < seq->count - 1; i++)
+	for (int i = 1; i < seq->count; i++)
 	{
-		TemporalInst *inst2 = temporalseq_inst_n(seq, i + 1);
-		bool upper_inc = (i == seq->count - 2) ? seq->period.upper_inc : false;
-		sequences[i] = tspatialrel_tpointseq_geo1(inst1, inst2, 
-			MOBDB_FLAGS_GET_LINEAR(seq->flags), geo, 
-			lower_inc, upper_inc, func, valuetypid, &countseqs[i], invert);
-		totalseqs += countseqs[i];
+		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
+		bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
+		tspatialrel_tpointseq_geo1(runs, inst1, inst2, linear, geo, 
+			lower_inc, upper_inc, func, invert);
 		inst1 = inst2;
 		lower_inc = true;
 	}
-	TemporalSeq **result = palloc(sizeof(TemporalSeq *) * totalseqs);
-	int k = 0;
-	for (int i = 0; i < seq->count; i++)
-	{
-		for (int j = 0; j < countseqs[i]; j++)
-			result[k++] = sequences[i][j];
-		if (countseqs[i] != 0)
-			pfree(sequences[i]);
-	}
+	return;
+}
 
-	*count = totalseqs;
+/* Construct the result from the runs and free their values */
+
+static TemporalS *
+tspatialrel_runs_to_temporals(TemporalRuns *runs)
+{
+	TemporalS *result = truns_to_temporals(runs);
+	for (int i = 0; i < runs->count; i++)
+		FREE_DATUM(runs->runs[i].value, runs->valuetypid);
+	truns_free(runs);
 	return result;
 }
 
@@ -343,55 +307,24 @@ static TemporalS *
 tspatialrel_tpointseq_geo(TemporalSeq *seq, Datum geo, 
 	Datum (*func)(Datum, Datum), Oid valuetypid, bool invert)
 {
-	int count;
-	TemporalSeq **sequences = tspatialrel_tpointseq_geo2(seq, geo, 
-		func, valuetypid, &count, invert);
-	TemporalS *result = temporals_from_temporalseqarr(sequences, count, 
-		false, true);
-	
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
-		
-	return result;
+	TemporalRuns *runs = truns_make(valuetypid, seq->count * 3);
+	tspatialrel_tpointseq_geo2(runs, seq, geo, func, invert);
+	/* Result has stepwise interpolation */
+	return tspatialrel_runs_to_temporals(runs);
 }
 
 static TemporalS *
 tspatialrel_tpoints_geo(TemporalS *ts, Datum geo, 
 	Datum (*func)(Datum, Datum), Oid valuetypid, bool invert)
 {
-	/* Singleton sequence set */
-	if (ts->count == 1)
-		return tspatialrel_tpointseq_geo(temporals_seq_n(ts, 0), geo, 
-			func, valuetypid, invert);
-		
-	TemporalSeq ***sequences = palloc(sizeof(TemporalSeq *) * ts->count);
-	int *countseqs = palloc0(sizeof(int) * ts->count);
-	int totalseqs = 0;
+	TemporalRuns *runs = truns_make(valuetypid, ts->totalcount * 3);
 	for (int i = 0; i < ts->count; i++)
 	{
 		TemporalSeq *seq = temporals_seq_n(ts, i);
-		sequences[i] = tspatialrel_tpointseq_geo2(seq, geo, func,
-			valuetypid, &countseqs[i], invert);
-		totalseqs += countseqs[i];
-	}
-	TemporalSeq **allsequences = palloc(sizeof(TemporalSeq *) * totalseqs);
-	int k = 0;
-	for (int i = 0; i < ts->count; i++)
-	{
-		for (int j = 0; j < countseqs[i]; j++)
-			allsequences[k++] = sequences[i][j];
-		if (countseqs[i] != 0)
-			pfree(sequences[i]);
+		tspatialrel_tpointseq_geo2(runs, seq, geo, func, invert);
 	}
-	TemporalS *result = temporals_from_temporalseqarr(allsequences, totalseqs,
-		false, true);
-	
-	for (int i = 0; i < totalseqs; i++)
-		pfree(allsequences[i]);
-	pfree(allsequences); pfree(sequences); pfree(countseqs);
-
-	return result;
+	/* Result has stepwise interpolation */
+	return tspatialrel_runs_to_temporals(runs);
 }
 
 /*****************************************************************************/
@@ -653,6 +586,32 @@ tspatialrel3_tpoints_geo(TemporalS *ts, Datum geo, Datum param,
  * instantaneous sequences.
  *****************************************************************************/
 
+/*
+ * Periods during which a temporal sequence with at least two instants 
+ * intersects the geometry. Only the periods of the sequences restricted to 
+ * the geometry are kept. Return NULL if the sequence never intersects it.
+ */
+static Period **
+tpointseq_at_geometry_periods(TemporalSeq *seq, Datum geo, int *count)
+{
+	int count1;
+	TemporalSeq **atgeo = tpointseq_at_geometry2(seq, geo, &count1);
+	if (atgeo == NULL)
+	{
+		*count = 0;
+		return NULL;
+	}
+	Period **result = palloc(sizeof(Period *) * count1);
+	for (int i = 0; i < count1; i++)
+	{
+		result[i] = period_copy(&atgeo[i]->period);
+		pfree(atgeo[i]);
+	}
+	pfree(atgeo);
+	*count = count1;
+	return result;
+}
+
 static TemporalSeq **
 tdwithin_tpointseq_geo1(TemporalSeq *seq, Datum geo, Datum dist, int *count)
 {
@@ -675,10 +634,10 @@ tdwithin_tpointseq_geo1(TemporalSeq *seq, Datum geo, Datum dist, int *count)
 	TemporalInst *instants[2];
 	Datum geo_buffer = call_function2(buffer, geo, dist);
 	int count1;
-	TemporalSeq **atbuffer = tpointseq_at_geometry2(seq, geo_buffer, &count1);
+	Period **periods = tpointseq_at_geometry_periods(seq, geo_buffer, &count1);
 	Datum datum_true = BoolGetDatum(true);
 	Datum datum_false = BoolGetDatum(false);
-	if (atbuffer == NULL)
+	if (periods == NULL)
 	{
 		TemporalSeq **result = palloc(sizeof(TemporalSeq *));
 		instants[0] = temporalinst_make(datum_false, seq->period.lower, BOOLOID);
@@ -691,13 +650,10 @@ tdwithin_tpointseq_geo1(TemporalSeq *seq, Datum geo, Datum dist, int *count)
 	}
 	
 	/* Get the periods during which the value is true */
-	Period **periods = palloc(sizeof(Period *) * count1);
-	for (int i = 0; i < count1; i++)
-		periods[i] = &atbuffer[i]->period;
 	/* The period set must be normalized, i.e., last parameter must be true */
 	PeriodSet *ps = periodset_from_periodarr_internal(periods, count1, true);
 	for (int i = 0; i < count1; i++)
-		pfree(atbuffer[i]);
+		pfree(periods[i]);
 	pfree(periods);
 	/* Get the periods during which the value is false */
 	PeriodSet *minus = minus_period_periodset_internal(&seq->period, ps);
@@ -948,101 +904,61 @@ tgeompoint '[POINT(4 3)@2000-01-04, POINT(5 3)@2000-01-05]', 1)
  
  *****************************************************************************/
 
+/*
+ * Solve the quadratic equation giving the instants at which two points moving
+ * linearly from p1 to p2 and from p3 to p4 during [lower, upper] are at
+ * distance d. Returns -1 when the points move in parallel at the same speed,
+ * i.e., when their distance is constant.
+ */
 static int
-tdwithin_tpointseq_tpointseq1(Datum sv1, Datum ev1, Datum sv2, Datum ev2, 
-	TimestampTz lower, TimestampTz upper, double d, bool hasz,
-	Datum (*func)(Datum, Datum, Datum), TimestampTz *t1, TimestampTz *t2)
+tdwithin_segments(POINT3DZ p1, POINT3DZ p2, POINT3DZ p3, POINT3DZ p4, 
+	TimestampTz lower, TimestampTz upper, double d, TimestampTz *t1, 
+	TimestampTz *t2)
 {
 	/* To reduce problems related to floating point arithmetic, lower and upper
 	   are shifted, respectively, to 0 and 1 before computing the solutions
 	   of the quadratic equation */
 	double duration = upper - lower;
 	long double a, b, c;
-	if (hasz) /* 3D */
-	{
-		POINT3DZ p1 = datum_get_point3dz(sv1);
-		POINT3DZ p2 = datum_get_point3dz(ev1);
-		POINT3DZ p3 = datum_get_point3dz(sv2);
-		POINT3DZ p4 = datum_get_point3dz(ev2);
-
-		/* per1 functions
- 		* x(t) = a1 * t + c1
- 		* y(t) = a2 * t + c2
-		* z(t) = a3 * t + c3 */
-		double a1 = (p2.x - p1.x);
-		double c1 = p1.x;
-		double a2 = (p2.y - p1.y);
-		double c2 = p1.y;
-		double a3 = (p2.z - p1.z);
-		double c3 = p1.z;
-
-		/* per2 functions
-		 * x(t) = a4 * t + c4
-		 * y(t) = a5 * t + c5
-		 * z(t) = a6 * t + c6 */
-		double a4 = (p4.x - p3.x);
-		double c4 = p3.x;
-		double a5 = (p4.y - p3.y);
-		double c5 = p3.y;
-		double a6 = (p4.z - p3.z);
-		double c6 = p3.z;
-
-		/* compute the distance function */
-		double a_x = (a1 - a4) * (a1 - a4);
-		double a_y = (a2 - a5) * (a2 - a5);
-		double a_z = (a3 - a6) * (a3 - a6);
-		double b_x = 2 * (a1 - a4) * (c1 - c4);
-		double b_y = 2 * (a2 - a5) * (c2 - c5);
-		double b_z = 2 * (a3 - a6) * (c3 - c6);
-		double c_x = (c1 - c4) * (c1 - c4);
-		double c_y = (c2 - c5) * (c2 - c5);
-		double c_z = (c3 - c6) * (c3 - c6);
-		/* distance function = d */
-		a = a_x + a_y + a_z;
-		b = b_x + b_y + b_z;
-		c = c_x + c_y + c_z - (d * d);
-	}
-	else /* 2D */
-	{
-		POINT2D p1 = datum_get_point2d(sv1);
-		POINT2D p2 = datum_get_point2d(ev1);
-		POINT2D p3 = datum_get_point2d(sv2);
-		POINT2D p4 = datum_get_point2d(ev2);
-		/* per1 functions
-		 * x(t) = a1 * t + c1
-		 * y(t) = a2 * t + c2 */
-		double a1 = (p2.x - p1.x);
-		double c1 = p1.x;
-		double a2 = (p2.y - p1.y);
-		double c2 = p1.y;
-		/* per2 functions
-		 * x(t) = a3 * t + c3
-		 * y(t) = a4 * t + c4 */
-		double a3 = (p4.x - p3.x);
-		double c3 = p3.x;
-		double a4 = (p4.y - p3.y);
-		double c4 = p3.y;
-		/* compute the distance function */
-		double a_x = (a1 - a3) * (a1 - a3);
-		double a_y = (a2 - a4) * (a2 - a4);
-		double b_x = 2 * (a1 - a3) * (c1 - c3);
-		double b_y = 2 * (a2 - a4) * (c2 - c4);
-		double c_x = (c1 - c3) * (c1 - c3);
-		double c_y = (c2 - c4) * (c2 - c4);
-		/* distance function = d */
-		a = a_x + a_y;
-		b = b_x + b_y;
-		c = c_x + c_y - (d * d);
-	}
+	/* per1 functions
+	 * x(t) = a1 * t + c1
+	 * y(t) = a2 * t + c2
+	 * z(t) = a3 * t + c3 */
+	double a1 = (p2.x - p1.x);
+	double c1 = p1.x;
+	double a2 = (p2.y - p1.y);
+	double c2 = p1.y;
+	double a3 = (p2.z - p1.z);
+	double c3 = p1.z;
+
+	/* per2 functions
+	 * x(t) = a4 * t + c4
+	 * y(t) = a5 * t + c5
+	 * z(t) = a6 * t + c6 */
+	double a4 = (p4.x - p3.x);
+	double c4 = p3.x;
+	double a5 = (p4.y - p3.y);
+	double c5 = p3.y;
+	double a6 = (p4.z - p3.z);
+	double c6 = p3.z;
+
+	/* compute the distance function, the z terms are zero for 2D points */
+	double a_x = (a1 - a4) * (a1 - a4);
+	double a_y = (a2 - a5) * (a2 - a5);
+	double a_z = (a3 - a6) * (a3 - a6);
+	double b_x = 2 * (a1 - a4) * (c1 - c4);
+	double b_y = 2 * (a2 - a5) * (c2 - c5);
+	double b_z = 2 * (a3 - a6) * (c3 - c6);
+	double c_x = (c1 - c4) * (c1 - c4);
+	double c_y = (c2 - c5) * (c2 - c5);
+	double c_z = (c3 - c6) * (c3 - c6);
+	/* distance function = d */
+	a = a_x + a_y + a_z;
+	b = b_x + b_y + b_z;
+	c = c_x + c_y + c_z - (d * d);
 	/* They are parallel, moving in the same direction at the same speed */
 	if (a == 0)
-	{
-		if (!func(sv1, sv2, Float8GetDatum(d)))
-			return 0;
-		*t1 = lower;
-		*t2 = upper;
-		return 2;
-	}
+		return -1;
 	/* Solving the quadratic equation for distance = d */
 	long double discriminant = b * b - 4 * a * c;
 
@@ -1094,11 +1010,63 @@ tdwithin_tpointseq_tpointseq1(Datum sv1, Datum ev1, Datum sv2, Datum ev2,
 	}
 }
 
+static int
+tdwithin_tpointseq_tpointseq1(Datum sv1, Datum ev1, Datum sv2, Datum ev2, 
+	TimestampTz lower, TimestampTz upper, double d, bool hasz,
+	Datum (*func)(Datum, Datum, Datum), TimestampTz *t1, TimestampTz *t2)
+{
+	POINT3DZ p1, p2, p3, p4;
+	if (hasz) /* 3D */
+	{
+		p1 = datum_get_point3dz(sv1);
+		p2 = datum_get_point3dz(ev1);
+		p3 = datum_get_point3dz(sv2);
+		p4 = datum_get_point3dz(ev2);
+	}
+	else /* 2D */
+	{
+		POINT2D q1 = datum_get_point2d(sv1);
+		POINT2D q2 = datum_get_point2d(ev1);
+		POINT2D q3 = datum_get_point2d(sv2);
+		POINT2D q4 = datum_get_point2d(ev2);
+		p1.x = q1.x; p1.y = q1.y; p1.z = 0;
+		p2.x = q2.x; p2.y = q2.y; p2.z = 0;
+		p3.x = q3.x; p3.y = q3.y; p3.z = 0;
+		p4.x = q4.x; p4.y = q4.y; p4.z = 0;
+	}
+	int solutions = tdwithin_segments(p1, p2, p3, p4, lower, upper, d, t1, t2);
+	/* The distance is constant */
+	if (solutions == -1)
+	{
+		if (!func(sv1, sv2, Float8GetDatum(d)))
+			return 0;
+		*t1 = lower;
+		*t2 = upper;
+		return 2;
+	}
+	return solutions;
+}
+
+/*
+ * Add a constant piece that starts at or after the end of the previous one
+ * to the runs of the temporal boolean. Degenerate pieces are skipped and a
+ * piece with the same value as the previous one extends it, so that only 
+ * the value changes are kept.
+ */
+static void
+tdwithin_add(TemporalRuns *runs, bool value, TimestampTz lower,
+	TimestampTz upper, bool lower_inc, bool upper_inc)
+{
+	if (lower == upper && (! lower_inc || ! upper_inc))
+		return;
+	truns_append(runs, BoolGetDatum(value), lower, upper, lower_inc, upper_inc);
+}
+
 /* The following function supposes that the two temporal values are synchronized.
    This should be ensured by the calling function. */
 
-static int
-tdwithin_tpointseq_tpointseq2(TemporalSeq **result,
+static void
+tdwithin_tpointseq_tpointseq2(TemporalRuns *runs,
 	TemporalInst *start1, TemporalInst *end1, bool linear1,
 	TemporalInst *start2, TemporalInst *end2, bool linear2,
 	bool lower_inc, bool upper_inc, Datum d, 
@@ -1111,40 +1079,24 @@ tdwithin_tpointseq_tpointseq2(TemporalSeq **result,
 	Datum sv2 = temporalinst_value(start2);
 	Datum ev2 = temporalinst_value(end2);
 	bool hasz = MOBDB_FLAGS_GET_Z(start1->flags);
-	TemporalInst *instants[2];
-	Datum datum_true = BoolGetDatum(true);
-	Datum datum_false = BoolGetDatum(false);
 	
 	/* Both segments are constant */
 	if (datum_point_eq(sv1, ev1) && datum_point_eq(sv2, ev2))
 	{
-		Datum value = func(sv1, sv2, d);
-		instants[0] = temporalinst_make(value, lower, BOOLOID);
-		instants[1] = temporalinst_make(value, upper, BOOLOID);
-		result[0] = temporalseq_from_temporalinstarr(instants, 2,
-			lower_inc, upper_inc, false, false);
-		pfree(instants[0]); pfree(instants[1]);
-		return 1;
+		tdwithin_add(runs, DatumGetBool(func(sv1, sv2, d)), lower, 
+			upper, lower_inc, upper_inc);
+		return;
 	}
 
 	/* Both segments have stepwise interpolation */
 	if (! linear1 && ! linear2)
 	{
-		Datum value = func(sv1, sv2, d);
-		instants[0] = temporalinst_make(value, lower, BOOLOID);
-		instants[1] = temporalinst_make(value, upper, BOOLOID);
-		result[0] = temporalseq_from_temporalinstarr(instants, 2,
-			lower_inc, false, false, false);
-		pfree(instants[0]); pfree(instants[1]);
+		tdwithin_add(runs, DatumGetBool(func(sv1, sv2, d)), lower, 
+			upper, lower_inc, false);
 		if (upper_inc)
-		{
-			value = func(ev1, ev2, d);
-			instants[0] = temporalinst_make(value, upper, BOOLOID);
-			result[1] = temporalseq_from_temporalinstarr(instants, 1,
-				true, true, false, false);
-			pfree(instants[0]);
-		}
-		return upper_inc ? 2 : 1;
+			tdwithin_add(runs, DatumGetBool(func(ev1, ev2, d)), upper,
+				upper, true, true);
+		return;
 	}
 
 	/* Find the instants t1 and t2 (if any) during which the dwithin function is true */
@@ -1154,159 +1106,68 @@ tdwithin_tpointseq_tpointseq2(TemporalSeq **result,
 	int solutions = tdwithin_tpointseq_tpointseq1(sv1, sev1, sv2, sev2,
 		lower, upper, DatumGetFloat8(d), hasz, func, &t1, &t2);
 
-	/* No instant is returned */
-	int k;
 	bool upper_inc1 = linear1 && linear2 && upper_inc;
-	if (solutions == 0)
+	/* No instant is returned */
+	if (solutions == 0 || (solutions == 1 && 
+		((t1 == lower && !lower_inc) || (t1 == upper && !upper_inc))))
+		tdwithin_add(runs, false, lower, upper, lower_inc, upper_inc1);
+	/* A single instant is returned */
+	else if (solutions == 1 && t1 == lower) /* && lower_inc */
 	{
-		instants[0] = temporalinst_make(datum_false, lower, BOOLOID);
-		instants[1] = temporalinst_make(datum_false, upper, BOOLOID);
-		result[0] = temporalseq_from_temporalinstarr(instants, 2,
-			lower_inc, upper_inc1, false, false);			
-		pfree(instants[0]); pfree(instants[1]); 
-		k = 1;
+		tdwithin_add(runs, true, lower, lower, true, true);
+		tdwithin_add(runs, false, lower, upper, false, upper_inc1);
 	}
-	/* A single instant is returned */
-	else if (solutions == 1)
-	{	
-		if ((t1 == lower && !lower_inc) || (t1 == upper && !upper_inc))
-		{
-			instants[0] = temporalinst_make(datum_false, lower, BOOLOID);
-			instants[1] = temporalinst_make(datum_false, upper, BOOLOID);
-			result[0] = temporalseq_from_temporalinstarr(instants, 2,
-				lower_inc, upper_inc1, false, false);			
-			pfree(instants[0]); pfree(instants[1]); 
-			k = 1;
-		}		
-		else if (t1 == lower) /* && lower_inc */
-		{	
-			instants[0] = temporalinst_make(datum_true,	lower, BOOLOID);
-			result[0] = temporalseq_from_temporalinstarr(instants, 1,
-				true, true, false, false);
-			pfree(instants[0]);
-			instants[0] = temporalinst_make(datum_false, lower, BOOLOID);
-			instants[1] = temporalinst_make(datum_false, upper, BOOLOID);
-			result[1] = temporalseq_from_temporalinstarr(instants, 2,
-				false, upper_inc1, false, false);			
-			pfree(instants[0]); pfree(instants[1]); 
-			k = 2;
-		}
-		else if (t1 == upper) /* && upper_inc */
-		{	
-			instants[0] = temporalinst_make(datum_false, lower, BOOLOID);
-			instants[1] = temporalinst_make(upper_inc1 ? datum_true : 
-				datum_false, upper, BOOLOID);
-			result[0] = temporalseq_from_temporalinstarr(instants, 2,
-				lower_inc, upper_inc1, false, false);			
-			pfree(instants[0]); pfree(instants[1]);
-			k = 1;
-		}
-		else /* (t1 != lower && t1 != upper) */
-		{	
-			instants[0] = temporalinst_make(datum_false, lower, BOOLOID);
-			instants[1] = temporalinst_make(datum_false, t1, BOOLOID);
-			result[0] = temporalseq_from_temporalinstarr(instants, 2,
-				lower_inc, false, false, false);			
-			pfree(instants[0]); pfree(instants[1]);
-			instants[0] = temporalinst_make(datum_true, t1, BOOLOID);
-			result[1] = temporalseq_from_temporalinstarr(instants, 1,
-				true, true, false, false);
-			pfree(instants[0]); 
-			instants[0] = temporalinst_make(datum_false, t1, BOOLOID);
-			instants[1] = temporalinst_make(datum_false, upper, BOOLOID);
-			result[2] = temporalseq_from_temporalinstarr(instants, 2,
-				false, upper_inc1, false, false);			
-			pfree(instants[0]); pfree(instants[1]);
-			k = 3;
-		}		
+	else if (solutions == 1 && t1 == upper) /* && upper_inc */
+	{
+		tdwithin_add(runs, false, lower, upper, lower_inc, false);
+		if (upper_inc1)
+			tdwithin_add(runs, true, upper, upper, true, true);
+	}
+	else if (solutions == 1) /* (t1 != lower && t1 != upper) */
+	{
+		tdwithin_add(runs, false, lower, t1, lower_inc, false);
+		tdwithin_add(runs, true, t1, t1, true, true);
+		tdwithin_add(runs, false, t1, upper, false, upper_inc1);
 	}
 	/* solutions == 2, i.e., two instants are returned */
 	else if (lower == t1 && upper == t2)
-	{	
-		instants[0] = temporalinst_make(datum_true, lower, BOOLOID);
-		instants[1] = temporalinst_make(datum_true, upper, BOOLOID);
-		result[0] = temporalseq_from_temporalinstarr(instants, 2,
-			lower_inc, upper_inc1, false, false);
-		pfree(instants[0]); pfree(instants[1]);
-		k = 1;
-	}
+		tdwithin_add(runs, true, lower, upper, lower_inc, upper_inc1);
 	else if (lower != t1 && upper == t2)
-	{	
-		instants[0] = temporalinst_make(datum_false, lower, BOOLOID);
-		instants[1] = temporalinst_make(datum_false, t1, BOOLOID);
-		result[0] = temporalseq_from_temporalinstarr(instants, 2,
-			lower_inc, false, false, false);	
-		pfree(instants[0]); pfree(instants[1]);
-		instants[0] = temporalinst_make(datum_true, t1, BOOLOID);
-		instants[1] = temporalinst_make(datum_true, upper, BOOLOID);
-		result[1] = temporalseq_from_temporalinstarr(instants, 2,
-			true, upper_inc1, false, false);		
-		pfree(instants[0]); pfree(instants[1]);
-		k = 2;
+	{
+		tdwithin_add(runs, false, lower, t1, lower_inc, false);
+		tdwithin_add(runs, true, t1, upper, true, upper_inc1);
 	}
 	else if (lower == t1 && upper != t2)
-	{	
-		instants[0] = temporalinst_make(datum_true, lower, BOOLOID);
-		instants[1] = temporalinst_make(datum_true, t2, BOOLOID);
-		result[0] = temporalseq_from_temporalinstarr(instants, 2,
-			lower_inc, false, false, false);
-		pfree(instants[0]); pfree(instants[1]);
-		instants[0] = temporalinst_make(datum_false, t2, BOOLOID);
-		instants[1] = temporalinst_make(datum_false, upper, BOOLOID);
-		result[1] = temporalseq_from_temporalinstarr(instants, 2,
-			true, upper_inc1, false, false);		
-		pfree(instants[0]); pfree(instants[1]);
-		k = 2;
+	{
+		tdwithin_add(runs, true, lower, t2, lower_inc, true);
+		tdwithin_add(runs, false, t2, upper, false, upper_inc1);
 	}
 	else
-	{	
-		instants[0] = temporalinst_make(datum_false, lower, BOOLOID);
-		instants[1] = temporalinst_make(datum_false, t1, BOOLOID);
-		result[0] = temporalseq_from_temporalinstarr(instants, 2,
-			lower_inc, false, false, false);		
-		pfree(instants[0]); pfree(instants[1]);
-		instants[0] = temporalinst_make(datum_true, t1, BOOLOID);
-		instants[1] = temporalinst_make(datum_true, t2, BOOLOID);
-		result[1] = temporalseq_from_temporalinstarr(instants, 2,
-			true, true, false, false);
-		pfree(instants[0]); pfree(instants[1]);
-		instants[0] = temporalinst_make(datum_false, t2, BOOLOID);
-		instants[1] = temporalinst_make(datum_false, upper, BOOLOID);
-		result[2] = temporalseq_from_temporalinstarr(instants, 2,
-			false, upper_inc1, false, false);
-		pfree(instants[0]); pfree(instants[1]);
-		k = 3;
+	{
+		tdwithin_add(runs, false, lower, t1, lower_inc, false);
+		tdwithin_add(runs, true, t1, t2, true, true);
+		tdwithin_add(runs, false, t2, upper, false, upper_inc1);
 	}
 	/* Add extra final point if only one segment is linear */
 	if (upper_inc && (! linear1 || ! linear2))
-	{
-		Datum value = func(ev1, ev2, d);
-		instants[0] = temporalinst_make(value, upper, BOOLOID);
-		result[k++] = temporalseq_from_temporalinstarr(instants, 1,
-			true, true, false, false);
-		pfree(instants[0]);
-	}
-	return k;
+		tdwithin_add(runs, DatumGetBool(func(ev1, ev2, d)), upper, 
+			upper, true, true);
+	return;
 }
 
-static int
-tdwithin_tpointseq_tpointseq3(TemporalSeq **result, TemporalSeq *seq1, TemporalSeq *seq2,
-	Datum d, Datum (*func)(Datum, Datum, Datum))
+static void
+tdwithin_tpointseq_tpointseq3(TemporalRuns *runs, TemporalSeq *seq1, 
+	TemporalSeq *seq2, Datum d, Datum (*func)(Datum, Datum, Datum))
 {
 	if (seq1->count == 1)
 	{
 		TemporalInst *inst1 = temporalseq_inst_n(seq1, 0);
 		TemporalInst *inst2 = temporalseq_inst_n(seq2, 0);
-		TemporalInst *inst = temporalinst_make(
-			func(temporalinst_value(inst1), temporalinst_value(inst2), d),
-			inst1->t, BOOLOID);
-		result[0] = temporalseq_from_temporalinstarr(&inst, 1,
-			true, true, false, false);
-		pfree(inst);
-		return 1;
+		tdwithin_add(runs, DatumGetBool(func(temporalinst_value(inst1),
+			temporalinst_value(inst2), d)), inst1->t, inst1->t, true, true);
+		return;
 	}
 
-	int k = 0;
 	TemporalInst *start1 = temporalseq_inst_n(seq1, 0);
 	TemporalInst *start2 = temporalseq_inst_n(seq2, 0);
 	bool lower_inc = seq1->period.lower_inc;
@@ -1317,61 +1178,61 @@ tdwithin_tpointseq_tpointseq3(TemporalSeq **result, TemporalSeq *seq1, TemporalS
 		TemporalInst *end1 = temporalseq_inst_n(seq1, i);
 		TemporalInst *end2 = temporalseq_inst_n(seq2, i);
 		bool upper_inc = (i == seq1->count - 1) ? seq1->period.upper_inc : false;
-		/* The next step adds between one and three sequences */
-		k += tdwithin_tpointseq_tpointseq2(&result[k], start1, end1,
-			linear1, start2, end2, linear2, lower_inc, upper_inc, d, func);
+		tdwithin_tpointseq_tpointseq2(runs, start1, end1, linear1, 
+			start2, end2, linear2, lower_inc, upper_inc, d, func);
 		start1 = end1;
 		start2 = end2;
 		lower_inc = true;
 	}
-	return k;
 }
 
-static TemporalS *
-tdwithin_tpointseq_tpointseq(TemporalSeq *seq1, TemporalSeq *seq2, Datum param,
+/*
+ * Runs of the temporal boolean of the dwithin relationship between two
+ * temporal points. The temporal points are supposed to be synchronized.
+ */
+static TemporalRuns *
+tdwithin_tpoint_tpoint_runs(Temporal *sync1, Temporal *sync2, Datum d,
 	Datum (*func)(Datum, Datum, Datum))
 {
-	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * seq1->count * 4);
-	int count = tdwithin_tpointseq_tpointseq3(sequences, seq1, seq2, 
-		param, func);
-	TemporalS *result = temporals_from_temporalseqarr(sequences, count, 
-		false, true);
-	
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
-		
-	return result;
-}
-
-/* The following function supposes that the two temporal values are synchronized.
-   This should be ensured by the calling function. */
-
-static TemporalS *
-tdwithin_tpoints_tpoints(TemporalS *ts1, TemporalS *ts2, Datum d,
-	Datum (*func)(Datum, Datum, Datum))
-{
-	/* Singleton sequence set */
-	if (ts1->count == 1)
-		return tdwithin_tpointseq_tpointseq(temporals_seq_n(ts1, 0), 
-			temporals_seq_n(ts2, 0), d, func);
-
-	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts1->totalcount * 4);
-	int k = 0;
-	for (int i = 0; i < ts1->count; i++)
+	TemporalRuns *result;
+	ensure_valid_duration(sync1->duration);
+	if (sync1->duration == TEMPORALINST || sync1->duration == TEMPORALI)
 	{
-		TemporalSeq *seq1 = temporals_seq_n(ts1, i);
-		TemporalSeq *seq2 = temporals_seq_n(ts2, i);
-		k += tdwithin_tpointseq_tpointseq3(&sequences[k], seq1, seq2, d,
-			func);
+		int count = (sync1->duration == TEMPORALINST) ? 1 :
+			((TemporalI *) sync1)->count;
+		result = truns_make(BOOLOID, count);
+		for (int i = 0; i < count; i++)
+		{
+			TemporalInst *inst1, *inst2;
+			if (sync1->duration == TEMPORALINST)
+			{
+				inst1 = (TemporalInst *) sync1;
+				inst2 = (TemporalInst *) sync2;
+			}
+			else
+			{
+				inst1 = temporali_inst_n((TemporalI *) sync1, i);
+				inst2 = temporali_inst_n((TemporalI *) sync2, i);
+			}
+			tdwithin_add(result, DatumGetBool(func(temporalinst_value(inst1),
+				temporalinst_value(inst2), d)), inst1->t, inst1->t, true, true);
+		}
+	}
+	else if (sync1->duration == TEMPORALSEQ)
+	{
+		result = truns_make(BOOLOID, ((TemporalSeq *) sync1)->count);
+		tdwithin_tpointseq_tpointseq3(result, (TemporalSeq *) sync1,
+			(TemporalSeq *) sync2, d, func);
+	}
+	else /* sync1->duration == TEMPORALS */
+	{
+		TemporalS *ts1 = (TemporalS *) sync1;
+		TemporalS *ts2 = (TemporalS *) sync2;
+		result = truns_make(BOOLOID, ts1->totalcount);
+		for (int i = 0; i < ts1->count; i++)
+			tdwithin_tpointseq_tpointseq3(result, temporals_seq_n(ts1, i), 
+				temporals_seq_n(ts2, i), d, func);
 	}
-	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
-		false, true);
-
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
-	
 	return result;
 }
 
@@ -2119,9 +1980,9 @@ tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
 	if (temp1->valuetypid == type_oid(T_GEOMETRY))
 	{
 		if (MOBDB_FLAGS_GET_Z(temp1->flags))
-			func = &geom_dwithin3d;
+			func = &geompoint_dwithin3d;
 		else
-			func = &geom_dwithin2d;
+			func = &geompoint_dwithin2d;
 	}
 	else if (temp1->valuetypid == type_oid(T_GEOGRAPHY))
 		func = &geog_dwithin;
@@ -2136,19 +1997,730 @@ tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
 		result = (Temporal *)sync_tfunc3_temporali_temporali(
 			(TemporalI *)sync1, (TemporalI *)sync2, dist, func, 
 			BOOLOID);
-	else if (sync1->duration == TEMPORALSEQ)
-		result = (Temporal *)tdwithin_tpointseq_tpointseq(
-			(TemporalSeq *)sync1, (TemporalSeq *)sync2, dist, func);
-	else if (sync1->duration == TEMPORALS)
-		result = (Temporal *)tdwithin_tpoints_tpoints(
-			(TemporalS *)sync1, (TemporalS *)sync2, dist, func);
+	else if (sync1->duration == TEMPORALSEQ || sync1->duration == TEMPORALS)
+	{
+		TemporalRuns *runs = tdwithin_tpoint_tpoint_runs(sync1, sync2, dist,
+			func);
+		result = (Temporal *)truns_to_temporals(runs);
+		truns_free(runs);
+	}
+
+	pfree(sync1); pfree(sync2); 
+	PG_FREE_IF_COPY(temp1, 0);
+	PG_FREE_IF_COPY(temp2, 1);
+	PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************
+ * Time during which a temporal point intersects or is within a distance of
+ * a geometry or of another temporal point. Only the periods during which the
+ * relationship is true are computed, the temporal Boolean of the relationship
+ * is not constructed. The functions with a geometry are not available for 
+ * geographies since they are based on the tpointseq_at_geometry2 function.
+ *****************************************************************************/
+
+/* Relationship between a point and the geometry */
+
+static bool
+tpoint_when_geo1(Datum value, Datum geo, Datum dist, bool hasz, bool dwithin)
+{
+	if (dwithin)
+		return DatumGetBool(hasz ? geom_dwithin3d(value, geo, dist) :
+			geom_dwithin2d(value, geo, dist));
+	return DatumGetBool(hasz ? geom_intersects3d(value, geo) :
+		geom_intersects2d(value, geo));
+}
+
+/* 
+ * Periods of a temporal sequence. The argument atgeo is the geometry to 
+ * which the segments are restricted, i.e., the buffer of the geometry for
+ * dwithin, and box is its bounding box.
+ */
+static Period **
+tpointseq_when_geo(TemporalSeq *seq, Datum geo, Datum atgeo, STBOX *box,
+	Datum dist, bool dwithin, int *count)
+{
+	/* Instantaneous sequence */
+	if (seq->count == 1)
+	{
+		Datum value = temporalinst_value(temporalseq_inst_n(seq, 0));
+		if (! tpoint_when_geo1(value, geo, dist, 
+			MOBDB_FLAGS_GET_Z(seq->flags), dwithin))
+		{
+			*count = 0;
+			return NULL;
+		}
+		Period **result = palloc(sizeof(Period *));
+		result[0] = period_copy(&seq->period);
+		*count = 1;
+		return result;
+	}
+	/* Bounding box test */
+	if (! overlaps_stbox_stbox_internal(temporalseq_bbox_ptr(seq), box))
+	{
+		*count = 0;
+		return NULL;
+	}
+	return tpointseq_at_geometry_periods(seq, atgeo, count);
+}
+
+static PeriodSet *
+tpoint_when_geo_internal(Temporal *temp, Datum geo, Datum dist, bool dwithin)
+{
+	ensure_valid_duration(temp->duration);
+	bool hasz = MOBDB_FLAGS_GET_Z(temp->flags);
+	if (temp->duration == TEMPORALINST || temp->duration == TEMPORALI)
+	{
+		int count = (temp->duration == TEMPORALINST) ? 1 :
+			((TemporalI *) temp)->count;
+		Period **periods = palloc(sizeof(Period *) * count);
+		int k = 0;
+		for (int i = 0; i < count; i++)
+		{
+			TemporalInst *inst = (temp->duration == TEMPORALINST) ?
+				(TemporalInst *) temp : temporali_inst_n((TemporalI *) temp, i);
+			if (tpoint_when_geo1(temporalinst_value(inst), geo, dist, hasz,
+				dwithin))
+				periods[k++] = period_make(inst->t, inst->t, true, true);
+		}
+		PeriodSet *result = (k == 0) ? NULL :
+			periodset_from_periodarr_internal(periods, k, false);
+		for (int i = 0; i < k; i++)
+			pfree(periods[i]);
+		pfree(periods);
+		return result;
+	}
+
+	/* temp->duration == TEMPORALSEQ || temp->duration == TEMPORALS */
+	Datum atgeo = dwithin ? call_function2(buffer, geo, dist) : geo;
+	STBOX box;
+	memset(&box, 0, sizeof(STBOX));
+	geo_to_stbox_internal(&box, (GSERIALIZED *) DatumGetPointer(atgeo));
+	int count = (temp->duration == TEMPORALSEQ) ? 1 : ((TemporalS *) temp)->count;
+	Period ***periods = palloc(sizeof(Period **) * count);
+	int *countpers = palloc0(sizeof(int) * count);
+	int totalpers = 0;
+	for (int i = 0; i < count; i++)
+	{
+		TemporalSeq *seq = (temp->duration == TEMPORALSEQ) ? 
+			(TemporalSeq *) temp : temporals_seq_n((TemporalS *) temp, i);
+		periods[i] = tpointseq_when_geo(seq, geo, atgeo, &box, dist, dwithin,
+			&countpers[i]);
+		totalpers += countpers[i];
+	}
+	PeriodSet *result = NULL;
+	if (totalpers > 0)
+	{
+		Period **allperiods = palloc(sizeof(Period *) * totalpers);
+		int k = 0;
+		for (int i = 0; i < count; i++)
+		{
+			for (int j = 0; j < countpers[i]; j++)
+				allperiods[k++] = periods[i][j];
+			if (periods[i] != NULL)
+				pfree(periods[i]);
+		}
+		/* The periods of consecutive sequences may be adjacent */
+		result = periodset_from_periodarr_internal(allperiods, totalpers, true);
+		for (int i = 0; i < totalpers; i++)
+			pfree(allperiods[i]);
+		pfree(allperiods);
+	}
+	pfree(periods); pfree(countpers);
+	if (dwithin)
+		pfree(DatumGetPointer(atgeo));
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(when_intersects_geo_tpoint);
+
+PGDLLEXPORT Datum
+when_intersects_geo_tpoint(PG_FUNCTION_ARGS)
+{
+	GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
+	Temporal *temp = PG_GETARG_TEMPORAL(1);
+	ensure_same_srid_tpoint_gs(temp, gs);
+	ensure_same_dimensionality_tpoint_gs(temp, gs);
+	PeriodSet *result = gserialized_is_empty(gs) ? NULL :
+		tpoint_when_geo_internal(temp, PointerGetDatum(gs), 0, false);
+	PG_FREE_IF_COPY(gs, 0);
+	PG_FREE_IF_COPY(temp, 1);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(when_intersects_tpoint_geo);
+
+PGDLLEXPORT Datum
+when_intersects_tpoint_geo(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
+	ensure_same_srid_tpoint_gs(temp, gs);
+	ensure_same_dimensionality_tpoint_gs(temp, gs);
+	PeriodSet *result = gserialized_is_empty(gs) ? NULL :
+		tpoint_when_geo_internal(temp, PointerGetDatum(gs), 0, false);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_FREE_IF_COPY(gs, 1);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(when_dwithin_geo_tpoint);
+
+PGDLLEXPORT Datum
+when_dwithin_geo_tpoint(PG_FUNCTION_ARGS)
+{
+	GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
+	Temporal *temp = PG_GETARG_TEMPORAL(1);
+	Datum dist = PG_GETARG_DATUM(2);
+	ensure_same_srid_tpoint_gs(temp, gs);
+	ensure_same_dimensionality_tpoint_gs(temp, gs);
+	PeriodSet *result = gserialized_is_empty(gs) ? NULL :
+		tpoint_when_geo_internal(temp, PointerGetDatum(gs), dist, true);
+	PG_FREE_IF_COPY(gs, 0);
+	PG_FREE_IF_COPY(temp, 1);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(when_dwithin_tpoint_geo);
+
+PGDLLEXPORT Datum
+when_dwithin_tpoint_geo(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
+	Datum dist = PG_GETARG_DATUM(2);
+	ensure_same_srid_tpoint_gs(temp, gs);
+	ensure_same_dimensionality_tpoint_gs(temp, gs);
+	PeriodSet *result = gserialized_is_empty(gs) ? NULL :
+		tpoint_when_geo_internal(temp, PointerGetDatum(gs), dist, true);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_FREE_IF_COPY(gs, 1);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(when_dwithin_tpoint_tpoint);
 
+PGDLLEXPORT Datum
+when_dwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
+{
+	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
+	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
+	Datum dist = PG_GETARG_DATUM(2);
+	ensure_same_srid_tpoint(temp1, temp2);
+	ensure_same_dimensionality_tpoint(temp1, temp2);
+	Temporal *sync1, *sync2;
+	/* Return NULL if the temporal points do not intersect in time
+	   The last parameter crossing must be set to false  */
+	if (!synchronize_temporal_temporal(temp1, temp2, &sync1, &sync2, false))
+	{
+		PG_FREE_IF_COPY(temp1, 0);
+		PG_FREE_IF_COPY(temp2, 1);
+		PG_RETURN_NULL();
+	}
+
+	Datum (*func)(Datum, Datum, Datum) = NULL;
+	ensure_point_base_type(temp1->valuetypid);
+	if (temp1->valuetypid == type_oid(T_GEOMETRY))
+	{
+		if (MOBDB_FLAGS_GET_Z(temp1->flags))
+			func = &geompoint_dwithin3d;
+		else
+			func = &geompoint_dwithin2d;
+	}
+	else if (temp1->valuetypid == type_oid(T_GEOGRAPHY))
+		func = &geog_dwithin;
+	TemporalRuns *runs = tdwithin_tpoint_tpoint_runs(sync1, sync2, dist, func);
+	PeriodSet *result = truns_when_value(runs, BoolGetDatum(true));
+
+	truns_free(runs);
 	pfree(sync1); pfree(sync2); 
 	PG_FREE_IF_COPY(temp1, 0);
 	PG_FREE_IF_COPY(temp2, 1);
+	if (result == NULL)
+		PG_RETURN_NULL();
 	PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Spatiotemporal join of an array of temporal points with tdwithin
+ * The segments of all temporal points are swept by increasing start time. 
+ * The segments active at the sweep position are kept in a uniform spatial
+ * grid so that a new segment is only compared with the active segments of
+ * the same or neighbouring cells. The candidate pairs of segments are 
+ * solved with the same kernel as tdwithin.
+ *****************************************************************************/
+
+/* Segment of a temporal point sequence */
+
+typedef struct
+{
+	int number;			/* index of the temporal point in the array */
+	TemporalSeq *seq;
+	int i;				/* index of the start instant of the segment */
+	TimestampTz tmin;
+	TimestampTz tmax;
+	double xmin, ymin, zmin, xmax, ymax, zmax;
+} SweepSegment;
+
+/* Interval during which two temporal points are within the distance */
+
+typedef struct
+{
+	int number1;
+	int number2;
+	TimestampTz lower;
+	TimestampTz upper;
+	bool lower_inc;
+	bool upper_inc;
+} SweepPeriod;
+
+/* Entry of the spatial grid */
+
+typedef struct
+{
+	int segment;
+	int64 cellx;
+	int64 celly;
+	int next;
+} SweepCell;
+
+static int
+sweep_segment_cmp(const void *a, const void *b)
+{
+	TimestampTz t1 = ((const SweepSegment *) a)->tmin;
+	TimestampTz t2 = ((const SweepSegment *) b)->tmin;
+	return (t1 < t2) ? -1 : ((t1 > t2) ? 1 : 0);
+}
+
+static int
+sweep_period_cmp(const void *a, const void *b)
+{
+	const SweepPeriod *p1 = (const SweepPeriod *) a;
+	const SweepPeriod *p2 = (const SweepPeriod *) b;
+	if (p1->number1 != p2->number1)
+		return (p1->number1 < p2->number1) ? -1 : 1;
+	if (p1->number2 != p2->number2)
+		return (p1->number2 < p2->number2) ? -1 : 1;
+	if (p1->lower != p2->lower)
+		return (p1->lower < p2->lower) ? -1 : 1;
+	if (p1->lower_inc != p2->lower_inc)
+		return p1->lower_inc ? -1 : 1;
+	return 0;
+}
+
+static uint32
+sweep_cell_hash(int64 cellx, int64 celly, uint32 mask)
+{
+	return (((uint32) cellx * 73856093U) ^ ((uint32) celly * 19349663U)) & mask;
+}
+
+/* Position of the segment at a timestamp */
+static POINT3DZ
+sweep_segment_point(SweepSegment *seg, TimestampTz t, bool hasz)
+{
+	TemporalInst *inst1 = temporalseq_inst_n(seg->seq, seg->i);
+	POINT3DZ p1 = tpointinst_point3dz(inst1, hasz);
+	if (seg->tmin == seg->tmax || t == inst1->t)
+		return p1;
+	TemporalInst *inst2 = temporalseq_inst_n(seg->seq, seg->i + 1);
+	POINT3DZ p2 = tpointinst_point3dz(inst2, hasz);
+	if (t == inst2->t)
+		return p2;
+	double ratio = (double) (t - inst1->t) / (double) (inst2->t - inst1->t);
+	p1.x += (p2.x - p1.x) * ratio;
+	p1.y += (p2.y - p1.y) * ratio;
+	p1.z += (p2.z - p1.z) * ratio;
+	return p1;
+}
+
+/* Is the timestamp an exclusive bound of the sequence of the segment? */
+static bool
+sweep_segment_excludes(SweepSegment *seg, TimestampTz t)
+{
+	Period *p = &seg->seq->period;
+	return (t == p->lower && ! p->lower_inc) || (t == p->upper && ! p->upper_inc);
+}
+
+/* 
+ * Add the interval during which two segments of different temporal points
+ * are within the distance, if any 
+ */
+static int
+sweep_segment_pair(SweepPeriod *result, SweepSegment *seg1, 
+	SweepSegment *seg2, double d, bool hasz)
+{
+	TimestampTz lower = Max(seg1->tmin, seg2->tmin);
+	TimestampTz upper = Min(seg1->tmax, seg2->tmax);
+	POINT3DZ p1 = sweep_segment_point(seg1, lower, hasz);
+	POINT3DZ p3 = sweep_segment_point(seg2, lower, hasz);
+	TimestampTz t1, t2;
+	int solutions;
+	if (lower == upper)
+	{
+		solutions = (segments_min_dist(p1, p1, p3, p3) <= d) ? 1 : 0;
+		t1 = lower;
+	}
+	else
+	{
+		POINT3DZ p2 = sweep_segment_point(seg1, upper, hasz);
+		POINT3DZ p4 = sweep_segment_point(seg2, upper, hasz);
+		solutions = tdwithin_segments(p1, p2, p3, p4, lower, upper, d, 
+			&t1, &t2);
+		/* The distance is constant */
+		if (solutions == -1)
+		{
+			solutions = (segments_min_dist(p1, p1, p3, p3) <= d) ? 2 : 0;
+			t1 = lower;
+			t2 = upper;
+		}
+	}
+	if (solutions == 0)
+		return 0;
+	if (solutions == 1)
+		t2 = t1;
+	bool lower_inc = ! sweep_segment_excludes(seg1, t1) && 
+		! sweep_segment_excludes(seg2, t1);
+	bool upper_inc = ! sweep_segment_excludes(seg1, t2) && 
+		! sweep_segment_excludes(seg2, t2);
+	if (t1 == t2 && (! lower_inc || ! upper_inc))
+		return 0;
+	result->number1 = Min(seg1->number, seg2->number);
+	result->number2 = Max(seg1->number, seg2->number);
+	result->lower = t1;
+	result->upper = t2;
+	result->lower_inc = lower_inc;
+	result->upper_inc = upper_inc;
+	return 1;
+}
+
+/* 
+ * Collect the segments of the temporal points. Returns the number of 
+ * segments and the sum of their largest spatial extent.
+ */
+static int
+sweep_segments(Temporal **temps, int count, bool hasz, SweepSegment **result,
+	double *extent)
+{
+	int nsegs = 0;
+	for (int k = 0; k < count; k++)
+		nsegs += (temps[k]->duration == TEMPORALSEQ) ? 
+			((TemporalSeq *) temps[k])->count : 
+			((TemporalS *) temps[k])->totalcount;
+	SweepSegment *segs = palloc(sizeof(SweepSegment) * nsegs);
+	*extent = 0;
+	int n = 0;
+	for (int k = 0; k < count; k++)
+	{
+		int nseqs = (temps[k]->duration == TEMPORALSEQ) ? 1 : 
+			((TemporalS *) temps[k])->count;
+		for (int l = 0; l < nseqs; l++)
+		{
+			TemporalSeq *seq = (temps[k]->duration == TEMPORALSEQ) ? 
+				(TemporalSeq *) temps[k] : 
+				temporals_seq_n((TemporalS *) temps[k], l);
+			/* An instantaneous sequence is a segment of zero duration */
+			int last = Max(seq->count - 2, 0);
+			for (int i = 0; i <= last; i++)
+			{
+				TemporalInst *inst1 = temporalseq_inst_n(seq, i);
+				TemporalInst *inst2 = temporalseq_inst_n(seq, 
+					Min(i + 1, seq->count - 1));
+				POINT3DZ p1 = tpointinst_point3dz(inst1, hasz);
+				POINT3DZ p2 = tpointinst_point3dz(inst2, hasz);
+				SweepSegment *seg = &segs[n++];
+				seg->number = k;
+				seg->seq = seq;
+				seg->i = i;
+				seg->tmin = inst1->t;
+				seg->tmax = inst2->t;
+				seg->xmin = Min(p1.x, p2.x); seg->xmax = Max(p1.x, p2.x);
+				seg->ymin = Min(p1.y, p2.y); seg->ymax = Max(p1.y, p2.y);
+				seg->zmin = Min(p1.z, p2.z); seg->zmax = Max(p1.z, p2.z);
+				*extent += Max(seg->xmax - seg->xmin, seg->ymax - seg->ymin);
+			}
+		}
+	}
+	*result = segs;
+	return n;
+}
+
+/* 
+ * Maximum number of grid cells of a segment. Longer segments are kept in a
+ * separate list instead of being inserted in all the cells they span.
+ */
+#define SWEEP_MAX_CELLS 16
+
+/* Index of the grid cell of a coordinate, clamped to the extent of the grid */
+static int64
+sweep_cell_index(double value, double origin, double size, int64 ncells)
+{
+	double cell = floor((value - origin) / size);
+	if (cell <= 0)
+		return 0;
+	if (cell >= (double) ncells)
+		return ncells - 1;
+	return (int64) cell;
+}
+
+/* 
+ * Compare two segments whose bounding boxes may be within the distance and
+ * add the resulting period to the array
+ */
+static void
+sweep_compare(SweepSegment *other, SweepSegment *seg, double d, bool hasz,
+	SweepPeriod **periods, int *nperiods, int *periodcapacity)
+{
+	if (other->number == seg->number ||
+		other->xmin - seg->xmax > d || seg->xmin - other->xmax > d ||
+		other->ymin - seg->ymax > d || seg->ymin - other->ymax > d ||
+		(hasz && (other->zmin - seg->zmax > d || 
+			seg->zmin - other->zmax > d)))
+		return;
+	if (*nperiods == *periodcapacity)
+	{
+		*periodcapacity *= 2;
+		*periods = repalloc(*periods, sizeof(SweepPeriod) * (*periodcapacity));
+	}
+	*nperiods += sweep_segment_pair(&(*periods)[*nperiods], other, seg, d, 
+		hasz);
+}
+
+/*
+ * Compute the maximal periods during which two temporal points of the array
+ * are within the distance. Returns the number of periods.
+ */
+static int
+tdwithin_pairs_internal(Temporal **temps, int count, double d,
+	SweepPeriod **result)
+{
+	bool hasz = MOBDB_FLAGS_GET_Z(temps[0]->flags);
+	double extent;
+	SweepSegment *segs;
+	int nsegs = sweep_segments(temps, count, hasz, &segs, &extent);
+	qsort(segs, (size_t) nsegs, sizeof(SweepSegment), &sweep_segment_cmp);
+
+	/* The cells are as large as the distance or as the average segment */
+	double size = Max(d, extent / nsegs);
+	if (size <= 0)
+		size = 1;
+	/* The grid covers the extent of the segments */
+	double gxmin = segs[0].xmin, gxmax = segs[0].xmax,
+		gymin = segs[0].ymin, gymax = segs[0].ymax;
+	for (int k = 1; k < nsegs; k++)
+	{
+		gxmin = Min(gxmin, segs[k].xmin); gxmax = Max(gxmax, segs[k].xmax);
+		gymin = Min(gymin, segs[k].ymin); gymax = Max(gymax, segs[k].ymax);
+	}
+	int64 nx = (int64) Min(floor((gxmax - gxmin) / size) + 1, PG_INT32_MAX);
+	int64 ny = (int64) Min(floor((gymax - gymin) / size) + 1, PG_INT32_MAX);
+	uint32 nbuckets = 1;
+	while (nbuckets < (uint32) nsegs * 2)
+		nbuckets <<= 1;
+	int *buckets = palloc(sizeof(int) * nbuckets);
+	for (uint32 b = 0; b < nbuckets; b++)
+		buckets[b] = -1;
+	int ncells = 0, cellcapacity = nsegs * 4;
+	SweepCell *cells = palloc(sizeof(SweepCell) * cellcapacity);
+	int *seen = palloc(sizeof(int) * nsegs);
+	for (int k = 0; k < nsegs; k++)
+		seen[k] = -1;
+	int *overflow = palloc(sizeof(int) * nsegs);
+	int noverflow = 0;
+	int nperiods = 0, periodcapacity = 64;
+	SweepPeriod *periods = palloc(sizeof(SweepPeriod) * periodcapacity);
+
+	for (int k = 0; k < nsegs; k++)
+	{
+		SweepSegment *seg = &segs[k];
+		int64 minx = sweep_cell_index(seg->xmin, gxmin, size, nx);
+		int64 maxx = sweep_cell_index(seg->xmax, gxmin, size, nx);
+		int64 miny = sweep_cell_index(seg->ymin, gymin, size, ny);
+		int64 maxy = sweep_cell_index(seg->ymax, gymin, size, ny);
+		if ((maxx - minx + 1) * (maxy - miny + 1) > SWEEP_MAX_CELLS)
+		{
+			/* Compare a long segment with all the active segments */
+			for (int j = 0; j < k; j++)
+			{
+				if (segs[j].tmax >= seg->tmin)
+					sweep_compare(&segs[j], seg, d, hasz, &periods, &nperiods,
+						&periodcapacity);
+			}
+			overflow[noverflow++] = k;
+			continue;
+		}
+
+		/* Compare with the active segments in the cells of the expanded box */
+		int64 qminx = sweep_cell_index(seg->xmin - d, gxmin, size, nx);
+		int64 qmaxx = sweep_cell_index(seg->xmax + d, gxmin, size, nx);
+		int64 qminy = sweep_cell_index(seg->ymin - d, gymin, size, ny);
+		int64 qmaxy = sweep_cell_index(seg->ymax + d, gymin, size, ny);
+		for (int64 cx = qminx; cx <= qmaxx; cx++)
+		{
+			for (int64 cy = qminy; cy <= qmaxy; cy++)
+			{
+				int *prev = &buckets[sweep_cell_hash(cx, cy, nbuckets - 1)];
+				while (*prev != -1)
+				{
+					SweepCell *cell = &cells[*prev];
+					SweepSegment *other = &segs[cell->segment];
+					/* Segments ended before the sweep position are removed */
+					if (other->tmax < seg->tmin)
+					{
+						*prev = cell->next;
+						continue;
+					}
+					prev = &cell->next;
+					if (cell->cellx != cx || cell->celly != cy || 
+						seen[cell->segment] == k)
+						continue;
+					seen[cell->segment] = k;
+					sweep_compare(other, seg, d, hasz, &periods, &nperiods,
+						&periodcapacity);
+				}
+			}
+		}
+		/* Compare with the active long segments, removing the ended ones */
+		int l = 0;
+		for (int j = 0; j < noverflow; j++)
+		{
+			SweepSegment *other = &segs[overflow[j]];
+			if (other->tmax < seg->tmin)
+				continue;
+			overflow[l++] = overflow[j];
+			sweep_compare(other, seg, d, hasz, &periods, &nperiods,
+				&periodcapacity);
+		}
+		noverflow = l;
+
+		/* Insert the segment in the cells of its box */
+		for (int64 cx = minx; cx <= maxx; cx++)
+		{
+			for (int64 cy = miny; cy <= maxy; cy++)
+			{
+				if (ncells == cellcapacity)
+				{
+					cellcapacity *= 2;
+					cells = repalloc(cells, sizeof(SweepCell) * cellcapacity);
+				}
+				int *bucket = &buckets[sweep_cell_hash(cx, cy, nbuckets - 1)];
+				cells[ncells].segment = k;
+				cells[ncells].cellx = cx;
+				cells[ncells].celly = cy;
+				cells[ncells].next = *bucket;
+				*bucket = ncells++;
+			}
+		}
+	}
+	pfree(buckets); pfree(cells); pfree(seen); pfree(overflow); pfree(segs);
+
+	/* Merge the intervals of each pair of temporal points */
+	qsort(periods, (size_t) nperiods, sizeof(SweepPeriod), &sweep_period_cmp);
+	int k = 0;
+	for (int i = 0; i < nperiods; i++)
+	{
+		if (k > 0 && periods[k - 1].number1 == periods[i].number1 &&
+			periods[k - 1].number2 == periods[i].number2 &&
+			(periods[i].lower < periods[k - 1].upper ||
+			 (periods[i].lower == periods[k - 1].upper && 
+			  (periods[i].lower_inc || periods[k - 1].upper_inc))))
+		{
+			if (periods[i].upper > periods[k - 1].upper)
+			{
+				periods[k - 1].upper = periods[i].upper;
+				periods[k - 1].upper_inc = periods[i].upper_inc;
+			}
+			else if (periods[i].upper == periods[k - 1].upper)
+				periods[k - 1].upper_inc |= periods[i].upper_inc;
+		}
+		else
+			periods[k++] = periods[i];
+	}
+	*result = periods;
+	return k;
+}
+
+/* State of the set-returning function joining temporal points */
+
+typedef struct
+{
+	int i;
+	int count;
+	SweepPeriod *periods;
+} SweepState;
+
+PG_FUNCTION_INFO_V1(tdwithin_pairs);
+/*
+ * Return the pairs of temporal points of the array that are within the 
+ * distance together with the maximal periods during which they are.
+ * The temporal points are identified by their 1-based position in the array.
+ */
+PGDLLEXPORT Datum
+tdwithin_pairs(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	if (SRF_IS_FIRSTCALL())
+	{
+		funcctx = SRF_FIRSTCALL_INIT();
+		MemoryContext oldcontext = 
+			MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+		ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
+		double d = PG_GETARG_FLOAT8(1);
+		if (ARR_HASNULL(array))
+			ereport(ERROR, (errcode(ERRCODE_NULL_VALUE_NOT_ALLOWED),
+				errmsg("The array cannot contain null values")));
+		if (d < 0)
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				errmsg("The distance cannot be negative")));
+		int count = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+		SweepState *state = palloc0(sizeof(SweepState));
+		if (count > 0)
+		{
+			Temporal **temps = temporalarr_extract(array, &count);
+			for (int k = 0; k < count; k++)
+			{
+				if ((temps[k]->duration != TEMPORALSEQ && 
+					temps[k]->duration != TEMPORALS) ||
+					! MOBDB_FLAGS_GET_LINEAR(temps[k]->flags))
+					ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						errmsg("The temporal points must be sequences or sequence sets with linear interpolation")));
+				ensure_same_srid_tpoint(temps[0], temps[k]);
+				ensure_same_dimensionality_tpoint(temps[0], temps[k]);
+			}
+			state->count = tdwithin_pairs_internal(temps, count, d, 
+				&state->periods);
+		}
+		funcctx->user_fctx = state;
+		TupleDesc tupdesc;
+		if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				errmsg("Function returning record called in context that cannot accept type record")));
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	SweepState *state = (SweepState *) funcctx->user_fctx;
+	if (state->i == state->count)
+		SRF_RETURN_DONE(funcctx);
+	SweepPeriod *period = &state->periods[state->i++];
+	Datum values[3];
+	bool nulls[3] = {false, false, false};
+	values[0] = Int32GetDatum(period->number1 + 1);
+	values[1] = Int32GetDatum(period->number2 + 1);
+	values[2] = PointerGetDatum(period_make(period->lower, period->upper,
+		period->lower_inc, period->upper_inc));
+	HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+	SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+}
+
 /*****************************************************************************
  * Temporal relate
  *****************************************************************************/
@@ -0,0 +1,31 @@
+-------------------------------------------------------------------------------
+-- Extension installed in a schema that is not in the search path
+-------------------------------------------------------------------------------
+
+CREATE DATABASE mobilitydb_schema_test;
+\set QUIET on
+\c mobilitydb_schema_test
+\set QUIET off
+
+CREATE SCHEMA mdb;
+CREATE EXTENSION postgis SCHEMA mdb;
+CREATE EXTENSION mobilitydb SCHEMA mdb;
+SET search_path = public;
+
+SELECT mdb.tint '[1@2000-01-01, 2@2000-01-02]';
+SELECT mdb.asText(mdb.tgeompoint 'Point(1 1)@2000-01-01');
+
+CREATE TABLE tbl_tint_schema(k int, temp mdb.tint);
+INSERT INTO tbl_tint_schema
+SELECT k, mdb.tintinst(k, timestamptz '2000-01-01' + k * interval '1 day')
+FROM generate_series(1, 100) k;
+ANALYZE tbl_tint_schema;
+SELECT count(*) FROM tbl_tint_schema
+WHERE temp OPERATOR(mdb.&&) mdb.period '[2000-01-01, 2000-01-05]';
+
+\set QUIET on
+\c postgres
+\set QUIET off
+DROP DATABASE mobilitydb_schema_test;
+
+-------------------------------------------------------------------------------
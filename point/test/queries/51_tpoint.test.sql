@@ -958,6 +958,10 @@ SELECT st_astext(valueAtTimestamp(tgeogpoint '{Point(1.5 1.5)@2000-01-01, Point(
 SELECT st_astext(valueAtTimestamp(tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]', timestamptz '2000-01-01'));
 SELECT st_astext(valueAtTimestamp(tgeogpoint '{[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}', timestamptz '2000-01-01'));
 
+SELECT asText(valueAtTimestamps(tgeompoint '[Point(1 1)@2000-01-01, Point(3 3)@2000-01-03]', ARRAY[timestamptz '2000-01-01', '2000-01-02']));
+SELECT asText(valueAtTimestamps(tgeompoint '{[Point(1 1)@2000-01-01, Point(3 3)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', timestampset '{2000-01-02, 2000-01-05}'));
+SELECT asText(resample(tgeompoint '[Point(1 1)@2000-01-01, Point(3 3)@2000-01-03]', '1 day'));
+
 SELECT asText(minusTimestamp(tgeompoint 'Point(1 1)@2000-01-01', timestamptz '2000-01-01'));
 SELECT asText(minusTimestamp(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}', timestamptz '2000-01-01'));
 SELECT asText(minusTimestamp(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', timestamptz '2000-01-01'));
@@ -1162,6 +1166,9 @@ SELECT tgeompoint 'Point(1 1)@2000-01-01' >= tgeompoint '{[Point(1 1)@2000-01-01
 SELECT tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}' >= tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}';
 SELECT tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]' >= tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}';
 SELECT tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}' >= tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}';
+SELECT count(*) FROM (SELECT temp, lag(temp) OVER (ORDER BY temp) AS prev FROM (SELECT tgeompointinst(ST_MakePoint(i % 100, i % 7), timestamptz '2000-01-01' + (i % 11) * interval '1 hour') AS temp FROM generate_series(1, 20000) i) t1) t2 WHERE prev > temp;
+SELECT asText((array_agg(temp ORDER BY temp))[1]) FROM (SELECT tgeompointinst(ST_MakePoint(i % 100, i % 7), timestamptz '2000-01-01' + (i % 11) * interval '1 hour') AS temp FROM generate_series(1, 20000) i) t1;
+SELECT asText((array_agg(temp ORDER BY temp))[20000]) FROM (SELECT tgeompointinst(ST_MakePoint(i % 100, i % 7), timestamptz '2000-01-01' + (i % 11) * interval '1 hour') AS temp FROM generate_series(1, 20000) i) t1;
 
 SELECT tgeogpoint 'Point(1.5 1.5)@2000-01-01' = tgeogpoint 'Point(1.5 1.5)@2000-01-01';
 SELECT tgeogpoint '{Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03}' = tgeogpoint 'Point(1.5 1.5)@2000-01-01';
@@ -249,6 +249,13 @@ SELECT round(degrees(azimuth(tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000
 SELECT round(degrees(azimuth(tgeompoint '(Point(0 0)@2000-01-01, Point(1 1)@2000-01-02, Point(1 1)@2000-01-03, Point(0 0)@2000-01-04]')), 6);
 SELECT round(degrees(azimuth(tgeompoint '(Point(0 0)@2000-01-01, Point(1 1)@2000-01-02, Point(1 1)@2000-01-03, Point(0 0)@2000-01-04)')), 6);
 
+SELECT asText(simplify(tgeompoint '[Point(0 0)@2000-01-01, Point(1 0)@2000-01-02, Point(4 0)@2000-01-03]', 0.5));
+SELECT asText(simplify(tgeompoint '[Point(0 0)@2000-01-01, Point(1 0)@2000-01-02, Point(4 0)@2000-01-03]', 0.5, true));
+SELECT asText(simplify(tgeompoint '[Point(0 0)@2000-01-01, Point(1 0.1)@2000-01-02, Point(2 0)@2000-01-03]', 0.5, true, true));
+SELECT asText(simplify(tgeompoint '{[Point(0 0)@2000-01-01, Point(1 0.1)@2000-01-02, Point(2 0)@2000-01-03],[Point(3 3)@2000-01-04]}', 0.5));
+SELECT cellx, celly, tbucket, asText(fragment) FROM spaceTimeSplit(tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03]', 1, 1, '1 day', 'Point(0 0)', '2000-01-01');
+SELECT cellx, celly, tbucket, asText(fragment) FROM spaceTimeSplit(tgeompoint '{[Point(0.5 0.5)@2000-01-01, Point(0.5 0.5)@2000-01-01 12:00], [Point(0.2 0.2)@2000-01-01 18:00, Point(0.8 0.8)@2000-01-01 20:00]}', 1, 1, '1 day', 'Point(0 0)', '2000-01-01');
+
 --------------------------------------------------------
 
 -- 2D
@@ -330,6 +337,8 @@ SELECT asText(NearestApproachInstant(tgeompoint '[Point(1 1)@2000-01-01, Point(2
 SELECT asText(NearestApproachInstant(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', geometry 'Linestring(0 0,3 3)'));
 SELECT asText(NearestApproachInstant(tgeompoint 'Interp=Stepwise;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', geometry 'Linestring(0 0,3 3)'));
 SELECT asText(NearestApproachInstant(tgeompoint 'Interp=Stepwise;{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', geometry 'Linestring(0 0,3 3)'));
+SELECT asText(NearestApproachInstant(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05, Point(4 4)@2000-01-09]', geometry 'Point(3 1)'));
+SELECT asText(NearestApproachInstant(tgeompoint '[Point(1 1 1)@2000-01-01, Point(1 1 3)@2000-01-03]', geometry 'Point(0 0 0)'));
 SELECT asText(NearestApproachInstant(tgeompoint 'Point(1 1)@2000-01-01', geometry 'Linestring empty'));
 SELECT asText(NearestApproachInstant(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}', geometry 'Linestring empty'));
 SELECT asText(NearestApproachInstant(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', geometry 'Linestring empty'));
@@ -700,6 +709,7 @@ SELECT round((tgeompoint 'Point(1 1)@2000-01-01' |=| tgeompoint '{[Point(2 2)@20
 SELECT round((tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}' |=| tgeompoint '{[Point(2 2)@2000-01-01, Point(1 1)@2000-01-02, Point(2 2)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}')::numeric, 6);
 SELECT round((tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]' |=| tgeompoint '{[Point(2 2)@2000-01-01, Point(1 1)@2000-01-02, Point(2 2)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}')::numeric, 6);
 SELECT round((tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}' |=| tgeompoint '{[Point(2 2)@2000-01-01, Point(1 1)@2000-01-02, Point(2 2)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}')::numeric, 6);
+SELECT round((tgeompoint '{[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05],[Point(10 10)@2000-01-06, Point(10 10)@2000-01-07]}' |=| tgeompoint '[Point(4 1)@2000-01-01, Point(0 1)@2000-01-05, Point(10 11)@2000-01-07]')::numeric, 6);
 
 SELECT round((tgeompoint 'Point(1 1 1)@2000-01-01' |=| tgeompoint 'Point(2 2 2)@2000-01-01')::numeric, 6);
 SELECT round((tgeompoint '{Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03}' |=| tgeompoint 'Point(2 2 2)@2000-01-01')::numeric, 6);
@@ -976,3 +986,12 @@ POLYGON M((1 1 946681200,1 2 946681200,2 2 946681200,2 1 946681200,1 1 946681200
 
 -------------------------------------------------------------------------------
 
+/* Sequences with block bounding boxes */
+SELECT asText(NearestApproachInstant(temp, geometry 'Point(64 -1)')) FROM (SELECT tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(i, i % 2), timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(0, 199) i) t;
+SELECT asText(NearestApproachInstant(temp, geometry 'Point(199 5)')) FROM (SELECT tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(i, i % 2), timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(0, 199) i) t;
+SELECT NearestApproachInstant(temp, geometry 'Point(64 -1)') = NearestApproachInstant(atPeriod(temp, period '[2000-01-01 01:02:00, 2000-01-01 01:06:00]'), geometry 'Point(64 -1)') FROM (SELECT tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(i, i % 2), timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(0, 199) i) t;
+SELECT getTime(atGeometry(temp, geometry 'Polygon((63.5 -1,64.5 -1,64.5 2,63.5 2,63.5 -1))')) FROM (SELECT tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(i, i % 2), timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(0, 199) i) t;
+SELECT atGeometry(temp, geometry 'Polygon((63.5 -1,64.5 -1,64.5 2,63.5 2,63.5 -1))') = atGeometry(atPeriod(temp, period '[2000-01-01 01:02:00, 2000-01-01 01:06:00]'), geometry 'Polygon((63.5 -1,64.5 -1,64.5 2,63.5 2,63.5 -1))') FROM (SELECT tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(i, i % 2), timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(0, 199) i) t;
+
+-------------------------------------------------------------------------------
+
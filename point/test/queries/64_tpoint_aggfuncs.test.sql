@@ -8,6 +8,21 @@ SELECT asText(tcentroid(temp)) FROM (VALUES
   (tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02)'),
   (tgeompoint '[Point(3 3 3)@2000-01-03, Point(4 4 4)@2000-01-04)'),
   (tgeompoint '[Point(2 2 2)@2000-01-02, Point(3 3 3)@2000-01-03)')) t(temp);
+SELECT asText(tcentroid(temp)) FROM (VALUES 
+  (tgeompoint '{Point(1 1)@2000-01-01, Point(3 3)@2000-01-02}'),
+  (tgeompoint 'Point(3 3)@2000-01-01'),
+  (tgeompoint 'Point(4 4)@2000-01-03')) t(temp);
+
+SELECT asText(tcentroid(temp)) FROM (VALUES 
+  (tgeompoint '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-03]'),
+  (tgeompoint '[Point(2 0)@2000-01-01, Point(4 2)@2000-01-03]')) t(temp);
+SELECT asText(tcentroid(temp)) FROM (VALUES 
+  (tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03]'),
+  (tgeompoint '[Point(0 2)@2000-01-02, Point(2 2)@2000-01-04]')) t(temp);
+SELECT asText(tcentroid(temp)) FROM (VALUES 
+  (tgeompoint '[Point(0 0)@2000-01-01, Point(0 0)@2000-01-02]'),
+  (tgeompoint '[Point(4 4)@2000-01-03, Point(4 4)@2000-01-04]'),
+  (tgeompoint '[Point(2 2)@2000-01-01, Point(2 2)@2000-01-04]')) t(temp);
 
 /* Errors */
 SELECT asText(tcentroid(temp)) FROM (VALUES 
@@ -22,5 +37,33 @@ SELECT asText(tcentroid(temp)) FROM (VALUES
   (tgeompoint 'Point(0 0)@2000-01-01'),
   (tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02}'),
   ('Point(2 2 2)@2000-01-01')) t(temp);
+SELECT asText(tcentroid(temp)) FROM (VALUES 
+  (tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]'),
+  (tgeompoint 'SRID=5676;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]')) t(temp);
+SELECT asText(tcentroid(temp)) FROM (VALUES 
+  (tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]'),
+  (tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02]')) t(temp);
+SELECT asText(tcentroid(temp)) FROM (VALUES 
+  (tgeompoint '{[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]}'),
+  (tgeompoint '[Point(1 1 1)@2000-01-03, Point(2 2 2)@2000-01-04]')) t(temp);
+
+-------------------------------------------------------------------------------
+
+set parallel_tuple_cost=0;
+set parallel_setup_cost=0;
+set force_parallel_mode=regress;
+
+CREATE TABLE tbl_tcentroid AS SELECT k, tgeompointinst(ST_MakePoint(k, 0), timestamptz '2000-01-01' + (k % 2) * interval '1 day') AS inst, tgeompointseq(ARRAY[tgeompointinst(ST_MakePoint(0, (k % 2) * 2), timestamptz '2000-01-01' + (k % 2) * interval '1 day'), tgeompointinst(ST_MakePoint(2, (k % 2) * 2), timestamptz '2000-01-03' + (k % 2) * interval '1 day')]) AS seq, tgeompointseq(ARRAY[tgeompointinst(ST_MakePoint(k, 0), timestamptz '2000-01-01'), tgeompointinst(ST_MakePoint(k, 2), timestamptz '2000-01-03')]) AS seq2 FROM generate_series(1, 1000) k;
+ANALYZE tbl_tcentroid;
+
+SELECT asText(tcentroid(inst)) FROM tbl_tcentroid;
+SELECT asText(tcentroid(seq)) FROM tbl_tcentroid;
+SELECT asText(tcentroid(seq2)) FROM tbl_tcentroid;
+
+DROP TABLE tbl_tcentroid;
+
+set parallel_tuple_cost=100;
+set parallel_setup_cost=100;
+set force_parallel_mode=off;
 
 -------------------------------------------------------------------------------
@@ -1042,6 +1042,7 @@ SELECT tdwithin(tgeompoint '[Point(0 1)@2000-01-01, Point(0 0)@2000-01-02]', tge
 SELECT tdwithin(tgeompoint '[Point(1 1)@2000-01-01, Point(0 0)@2000-01-02]', tgeompoint '[Point(2 0)@2000-01-01, Point(1 1)@2000-01-02]', 1);
 SELECT tdwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]', tgeompoint '[Point(0 2)@2000-01-01, Point(1 3)@2000-01-02]', 1);
 SELECT tdwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]', tgeompoint '[Point(4 0)@2000-01-01, Point(3 1)@2000-01-02]', 0);
+SELECT tdwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03, Point(4 0)@2000-01-05]', tgeompoint '[Point(4 0)@2000-01-01, Point(2 0)@2000-01-03, Point(0 0)@2000-01-05]', 2);
 
 SELECT tdwithin(tgeompoint 'Point(1 1 1)@2000-01-01', tgeompoint 'Point(1 1 1)@2000-01-01', 2);
 SELECT tdwithin(tgeompoint '{Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03}', tgeompoint 'Point(1 1 1)@2000-01-01', 2);
@@ -1101,6 +1102,22 @@ SELECT tdwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-05]',
 SELECT tdwithin(tgeompoint '[Point(1 0)@2000-01-01, Point(1 4)@2000-01-05]', 
 	tgeompoint 'Interp=Stepwise;[Point(1 2)@2000-01-01, Point(1 3)@2000-01-05]', 1);
 
+SELECT * FROM tdwithin_pairs(ARRAY[tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03, Point(4 0)@2000-01-05]', '[Point(10 10)@2000-01-01, Point(10 10)@2000-01-05]', '[Point(4 0)@2000-01-01, Point(0 0)@2000-01-05]'], 2);
+SELECT * FROM tdwithin_pairs(ARRAY[tgeompoint '{[Point(0 0)@2000-01-01, Point(0 0)@2000-01-02), [Point(5 5)@2000-01-02, Point(5 5)@2000-01-03]}', '[Point(1 0)@2000-01-01, Point(5 4)@2000-01-03]'], 1);
+SELECT * FROM tdwithin_pairs(ARRAY[tgeompoint '[Point(0 0)@2000-01-01, Point(128 0)@2000-01-05]', '[Point(64 0)@2000-01-01, Point(64 0)@2000-01-05]'] || ARRAY(SELECT ('[Point(' || 5 * i || ' 50)@2000-01-01, Point(' || 5 * i || ' 50)@2000-01-05]')::tgeompoint FROM generate_series(1, 19) i), 2);
+SELECT whenIntersects(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]', geometry 'Polygon((1 -1,3 -1,3 1,1 1,1 -1))');
+SELECT whenIntersects(geometry 'Polygon((1 -1,3 -1,3 1,1 1,1 -1))', tgeompoint '{Point(0 0)@2000-01-01, Point(2 0)@2000-01-03}');
+SELECT whenDwithin(tgeompoint '{Point(1 1)@2000-01-01, Point(5 5)@2000-01-02}', geometry 'Point(1 1)', 1);
+SELECT whenDwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]', tgeompoint '[Point(4 0)@2000-01-01, Point(0 0)@2000-01-05]', 2);
+SELECT whenDwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03, Point(4 0)@2000-01-05]', tgeompoint '[Point(4 0)@2000-01-01, Point(2 0)@2000-01-03, Point(0 0)@2000-01-05]', 2);
+SELECT whenDwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-05]', tgeompoint 'Interp=Stepwise;[Point(0 1)@2000-01-01, Point(2 0)@2000-01-05]', 1);
+SELECT whenDwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(0 0)@2000-01-02]', tgeompoint '[Point(10 10)@2000-01-01, Point(10 10)@2000-01-02]', 1);
+SELECT whenDwithin(tgeompoint '[Point(5 -3)@2000-01-01, Point(5 5)@2000-01-05, Point(5 -3)@2000-01-09]', geometry 'Linestring(0 0,10 0)', 1);
+SELECT whenDwithin(geometry 'Linestring(0 0,10 0)', tgeompoint '[Point(5 -3)@2000-01-01, Point(5 5)@2000-01-05, Point(5 -3)@2000-01-09]', 1);
+SELECT whenDwithin(tgeompoint '{[Point(5 -3)@2000-01-01, Point(5 5)@2000-01-05], [Point(3 4)@2000-01-06, Point(3 -4)@2000-01-10]}', geometry 'Linestring(0 0,10 0)', 1);
+SELECT whenDwithin(tgeompoint '{[Point(5 -3)@2000-01-01, Point(5 1)@2000-01-03), [Point(5 1)@2000-01-03, Point(5 5)@2000-01-05]}', geometry 'Linestring(0 0,10 0)', 1);
+SELECT whenDwithin(tgeompoint '[Point(5 3)@2000-01-01, Point(6 3)@2000-01-02]', geometry 'Linestring(0 0,10 0)', 1);
+
 /* Errors */
 SELECT tdwithin(geometry 'SRID=5676;Point(1 1)', tgeompoint 'Point(1 1)@2000-01-01', 2);
 SELECT tdwithin(tgeompoint 'Point(1 1)@2000-01-01', geometry 'SRID=5676;Point(1 1)', 2);
@@ -1116,6 +1133,11 @@ SELECT tdwithin(geography 'Point(1 1 1)', tgeogpoint 'Point(1 1)@2000-01-01', 2)
 SELECT tdwithin(tgeogpoint 'Point(1 1 1)@2000-01-01', geography 'Point(1 1)', 2);
 SELECT tdwithin(tgeogpoint 'Point(1 1 1)@2000-01-01', tgeogpoint 'Point(1 1)@2000-01-01', 2);
 
+SELECT * FROM tdwithin_pairs(ARRAY[tgeompoint 'Interp=Stepwise;[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]', '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]'], 1);
+SELECT * FROM tdwithin_pairs(ARRAY[tgeompoint '{Point(0 0)@2000-01-01, Point(1 1)@2000-01-02}', '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]'], 1);
+SELECT * FROM tdwithin_pairs(ARRAY[tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]', NULL], 1);
+SELECT * FROM tdwithin_pairs(ARRAY[tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]', '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]'], -1);
+
 -------------------------------------------------------------------------------
 -- trelate (2 arguments returns text)
 -------------------------------------------------------------------------------
@@ -90,3 +90,75 @@ DROP INDEX IF EXISTS tbl_tgeompoint3D_big_spgist_idx;
 DROP INDEX IF EXISTS tbl_tgeogpoint3D_big_spgist_idx;
 
 -------------------------------------------------------------------------------
+
+
+CREATE INDEX tbl_tgeompoint3D_big_gist_2dt_idx ON tbl_tgeompoint3D_big USING GIST(temp gist_tgeompoint_2dt_ops);
+
+SET enable_seqscan = off;
+
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp && geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp @> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp <@ geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp ~= geometry 'Linestring(1 1 1,10 10 10)';
+
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp << geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp &< geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp >> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp &> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp <<| geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp &<| geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp |>> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp |&> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp <<# stbox 'STBOX T(( , , 2001-01-01), ( , , 2001-02-01))';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp &<# stbox 'STBOX T(( , , 2001-01-01), ( , , 2001-02-01))';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp #>> stbox 'STBOX T(( , , 2001-01-01), ( , , 2001-02-01))';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp #&> stbox 'STBOX T(( , , 2001-01-01), ( , , 2001-02-01))';
+
+RESET enable_seqscan;
+
+DROP INDEX IF EXISTS tbl_tgeompoint3D_big_gist_2dt_idx;
+
+-------------------------------------------------------------------------------
+
+CREATE TABLE tbl_tgeompoint_blocks AS SELECT k, tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(i, i % 2 + 10 * k), timestamptz '2000-01-01' + (k - 1) * interval '1 day' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(1, 10) k, generate_series(0, 199) i GROUP BY k;
+CREATE INDEX tbl_tgeompoint_blocks_gist_idx ON tbl_tgeompoint_blocks USING GIST(temp);
+
+SET enable_seqscan = off;
+
+SELECT count(*) FROM tbl_tgeompoint_blocks WHERE temp && geometry 'Polygon((0 25,10 25,10 45,0 45,0 25))';
+SELECT count(*) FROM tbl_tgeompoint_blocks WHERE temp @> geometry 'Point(100 50)';
+SELECT count(*) FROM tbl_tgeompoint_blocks WHERE temp <@ geometry 'Polygon((-1 0,200 0,200 25,-1 25,-1 0))';
+SELECT count(*) FROM tbl_tgeompoint_blocks WHERE temp |>> geometry 'Point(0 55)';
+SELECT count(*) FROM tbl_tgeompoint_blocks WHERE temp && stbox 'STBOX T((0, 60, 2000-01-06), (10, 80, 2000-01-08))';
+
+RESET enable_seqscan;
+
+DROP INDEX tbl_tgeompoint_blocks_gist_idx;
+
+CREATE INDEX tbl_tgeompoint_blocks_spgist_idx ON tbl_tgeompoint_blocks USING SPGIST(temp);
+
+SET enable_seqscan = off;
+
+SELECT count(*) FROM tbl_tgeompoint_blocks WHERE temp && geometry 'Polygon((0 25,10 25,10 45,0 45,0 25))';
+SELECT count(*) FROM tbl_tgeompoint_blocks WHERE temp @> geometry 'Point(100 50)';
+SELECT count(*) FROM tbl_tgeompoint_blocks WHERE temp <@ geometry 'Polygon((-1 0,200 0,200 25,-1 25,-1 0))';
+SELECT count(*) FROM tbl_tgeompoint_blocks WHERE temp |>> geometry 'Point(0 55)';
+SELECT count(*) FROM tbl_tgeompoint_blocks WHERE temp && stbox 'STBOX T((0, 60, 2000-01-06), (10, 80, 2000-01-08))';
+
+RESET enable_seqscan;
+
+DROP INDEX tbl_tgeompoint_blocks_spgist_idx;
+
+DROP TABLE tbl_tgeompoint_blocks;
+
+-------------------------------------------------------------------------------
+
+CREATE TABLE tbl_tgeompoint_stats AS SELECT k, CASE WHEN k % 4 = 0 THEN NULL ELSE tgeompointseq(ARRAY[tgeompointinst(ST_MakePoint(k, k), timestamptz '2000-01-01' + k * interval '1 day'), tgeompointinst(ST_MakePoint(k + 1, k + 1), timestamptz '2000-01-01' + (k + 1) * interval '1 day')]) END AS temp FROM generate_series(1, 100) k;
+ANALYZE tbl_tgeompoint_stats;
+
+SELECT null_frac FROM pg_stats WHERE tablename = 'tbl_tgeompoint_stats' AND attname = 'temp';
+SELECT 11 IN (stakind1, stakind2, stakind3, stakind4, stakind5) FROM pg_statistic WHERE starelid = 'tbl_tgeompoint_stats'::regclass AND staattnum = 2;
+
+DROP TABLE tbl_tgeompoint_stats;
+
+-------------------------------------------------------------------------------
\ No newline at end of file
@@ -19,3 +19,20 @@ foreach(file ${geom_testfiles})
 	set_tests_properties(${TESTNAME} PROPERTIES RESOURCE_LOCK DBLOCK)
 endforeach()
 
+
+# The tests below create the extension with CREATE EXTENSION and thus need
+# it to be installed, e.g., with make install, before running ctest
+option(WITH_INSTALLCHECK "Run the tests requiring the extension to be installed" OFF)
+if (WITH_INSTALLCHECK)
+	file(GLOB geom_installcheck_files "point/test/installcheck/queries/*.sql")
+	foreach(file ${geom_installcheck_files})
+		get_filename_component(TESTNAME ${file} NAME_WE)
+		add_test(
+			NAME ${TESTNAME} 
+			WORKING_DIRECTORY ${PROJECT_SOURCE_DIR}/test
+			COMMAND ${PROJECT_SOURCE_DIR}/test/scripts/test.sh run_compare ${CMAKE_BINARY_DIR} ${TESTNAME} ${file} 
+		)
+		set_tests_properties(${TESTNAME} PROPERTIES FIXTURES_REQUIRED DB)
+		set_tests_properties(${TESTNAME} PROPERTIES RESOURCE_LOCK DBLOCK)
+	endforeach()
+endif ()
@@ -70,6 +70,7 @@
 #include "timeops.h"
 #include "temporaltypes.h"
 #include "temporal_util.h"
+#include "temporal_runs.h"
 
 /*****************************************************************************
  * Functions where the argument is a temporal type. 
@@ -545,31 +546,23 @@ tfunc4_temporal_base(Temporal *temp, Datum value,
  * These functions suppose that the sequence has linear interpolation.
  *****************************************************************************/
 
-static int
-tfunc4_temporalseq_base_cross1(TemporalSeq **result, TemporalInst *start,
+static void
+tfunc4_temporalseq_base_cross1(TemporalRuns *runs, TemporalInst *start,
 	TemporalInst *end, bool lower_inc, bool upper_inc, Datum value, 
-	Datum (*func)(Datum, Datum, Oid, Oid), Oid datumtypid, 
-	Oid valuetypid, bool invert)
+	Datum (*func)(Datum, Datum, Oid, Oid), Oid datumtypid, bool invert)
 {
 	Datum startvalue = temporalinst_value(start);
 	Datum endvalue = temporalinst_value(end);
 	Datum startresult = invert ?
 		func(value, startvalue, datumtypid, start->valuetypid) :
 		func(startvalue, value, start->valuetypid, datumtypid);
-	TemporalInst *instants[2];
 	
 	/* If both segments are constant compute the function at the start and 
 	 * end instants */
 	if (datum_eq(startvalue, endvalue, start->valuetypid))
 	{
-		instants[0] = temporalinst_make(startresult, start->t, valuetypid);
-		instants[1] = temporalinst_make(startresult, end->t, valuetypid);
-		/* Result has stepwise interpolation */
-		result[0] = temporalseq_from_temporalinstarr(instants, 2, 
-			lower_inc, upper_inc, false, false);
-		FREE_DATUM(startresult, valuetypid);
-		pfree(instants[0]); pfree(instants[1]);
-		return 1;
+		truns_append(runs, startresult, start->t, end->t, lower_inc, upper_inc);
+		return;
 	}
 	
 	/* If either the start or the end value is equal to the value compute
@@ -577,16 +570,9 @@ tfunc4_temporalseq_base_cross1(TemporalSeq **result, TemporalInst *start,
 	if (datum_eq2(startvalue, value, start->valuetypid, datumtypid) ||
 		datum_eq2(endvalue, value, start->valuetypid, datumtypid))
 	{
-		int k = 0;
 		/* Compute the function at the start instant */
 		if (lower_inc)
-		{
-			instants[0] = temporalinst_make(startresult, start->t, valuetypid);
-			/* Result has stepwise interpolation */
-			result[k++] = temporalseq_from_temporalinstarr(instants, 1,
-				true, true, false, false);
-			pfree(instants[0]);
-		}
+			truns_append(runs, startresult, start->t, start->t, true, true);
 		/* Find the middle time between start and the end instant and compute
 		 * the function at that point */
 		TimestampTz inttime = start->t + ((end->t - start->t)/2);
@@ -595,28 +581,17 @@ tfunc4_temporalseq_base_cross1(TemporalSeq **result, TemporalInst *start,
 		Datum intresult = invert ?
 			func(value, intvalue, datumtypid, start->valuetypid) :
 			func(intvalue, value, start->valuetypid, datumtypid);
-		instants[0] = temporalinst_make(intresult, start->t, valuetypid);
-		instants[1] = temporalinst_make(intresult, end->t, valuetypid);
-		/* Result has stepwise interpolation */
-		result[k++] = temporalseq_from_temporalinstarr(instants, 2,
-			false, false, false, false);			
-		pfree(instants[0]); pfree(instants[1]);
-		FREE_DATUM(intvalue, start->valuetypid); FREE_DATUM(intresult, valuetypid);
+		truns_append(runs, intresult, start->t, end->t, false, false);
+		FREE_DATUM(intvalue, start->valuetypid);
 		/* Compute the function at the end instant */
 		if (upper_inc)
 		{
 			Datum endresult = invert ?
 				func(value, endvalue, datumtypid, start->valuetypid) :
 				func(endvalue, value, start->valuetypid, datumtypid);
-			instants[0] = temporalinst_make(endresult, end->t, valuetypid);
-			/* Result has stepwise interpolation */
-			result[k++] = temporalseq_from_temporalinstarr(instants, 1,
-				true, true, false, false);
-			pfree(instants[0]);
-			FREE_DATUM(endresult, valuetypid); 
+			truns_append(runs, endresult, end->t, end->t, true, true);
 		}
-		FREE_DATUM(startresult, valuetypid); 
-		return k;
+		return;
 	}
 	
 	/* Determine whether there is a crossing */
@@ -624,64 +599,41 @@ tfunc4_temporalseq_base_cross1(TemporalSeq **result, TemporalInst *start,
 	bool hascross = tlinearseq_timestamp_at_value(start, end, value, 
 		datumtypid, &crosstime);
 
-	/* If there is no crossing compute the function at the start and 
-	 * end instants */
+	/* If there is no crossing the function has the same value at the start
+	 * and end instants */
 	if (!hascross)
 	{
-		/* Compute the function at the start and end instants */
-		instants[0] = temporalinst_make(startresult, start->t, valuetypid);
-		instants[1] = temporalinst_make(startresult, end->t, valuetypid);
-		/* Result has stepwise interpolation */
-		result[0] = temporalseq_from_temporalinstarr(instants, 2,
-			lower_inc, upper_inc, false, false);
-		FREE_DATUM(startresult, valuetypid); 
-		pfree(instants[0]); pfree(instants[1]); 
-		return 1;
+		truns_append(runs, startresult, start->t, end->t, lower_inc, upper_inc);
+		return;
 	}
 
 	/* Since there is a crossing in the middle compute the function at the
 	 * start instant, at the crossing, and at the end instant */
-	instants[0] = temporalinst_make(startresult, start->t, valuetypid);
-	instants[1] = temporalinst_make(startresult, crosstime, valuetypid);
-	/* Result has stepwise interpolation */
-	result[0] = temporalseq_from_temporalinstarr(instants, 2, 
-		lower_inc, false, false, false);
-	FREE_DATUM(startresult, valuetypid);
-	pfree(instants[0]); pfree(instants[1]); 
+	truns_append(runs, startresult, start->t, crosstime, lower_inc, false);
 	/* Compute the function at the crossing. Due to floating point precision 
 	 * we cannot compute the function at the crosstime as follows
 			startresult = temporalseq_value_at_timestamp1(start, end, true, crosstime);
 	   Since this function is (currently) called only for tfloat then we 
 	   assume startresult = value */
 	Datum value2 = func(value, value, datumtypid, datumtypid);
-	instants[0] = temporalinst_make(value2, crosstime, valuetypid);
-	/* Result has stepwise interpolation */
-	result[1] = temporalseq_from_temporalinstarr(instants, 1, 
-		true, true, false, false);
-	FREE_DATUM(value2, valuetypid);
-	pfree(instants[0]); 
+	truns_append(runs, value2, crosstime, crosstime, true, true);
 	/* Find the middle time between start and the end instant and compute
 	 * the function at that point */
 	TimestampTz inttime = crosstime + ((end->t - crosstime)/2);
 	/* Linear interpolation */
-	startresult = temporalseq_value_at_timestamp1(start, end, true, inttime);
-	value2 = invert ?
-		func(value, startresult, datumtypid, start->valuetypid) :
-		func(startresult, value, start->valuetypid, datumtypid);
-	instants[0] = temporalinst_make(value2, crosstime, valuetypid);
-	instants[1] = temporalinst_make(value2, end->t, valuetypid);
-	/* Result has stepwise interpolation */
-	result[2] = temporalseq_from_temporalinstarr(instants, 2, 
-		false, upper_inc, false, false);
-	pfree(instants[0]); pfree(instants[1]);
-	FREE_DATUM(startresult, valuetypid); FREE_DATUM(value2, valuetypid); 
-	return 3;
+	Datum intvalue = temporalseq_value_at_timestamp1(start, end, true, inttime);
+	Datum intresult = invert ?
+		func(value, intvalue, datumtypid, start->valuetypid) :
+		func(intvalue, value, start->valuetypid, datumtypid);
+	truns_append(runs, intresult, crosstime, end->t, false, upper_inc);
+	FREE_DATUM(intvalue, start->valuetypid);
+	return;
 }
 
-static int
-tfunc4_temporalseq_base_cross2(TemporalSeq **result, TemporalSeq *seq,
+static void
+tfunc4_temporalseq_base_cross2(TemporalRuns *runs, TemporalSeq *seq,
 	Datum value, Datum (*func)(Datum, Datum, Oid, Oid), Oid datumtypid, 
-	Oid valuetypid, bool invert)
+	bool invert)
 {
 	/* Instantaneous sequence */
 	if (seq->count == 1)
@@ -690,46 +642,42 @@ tfunc4_temporalseq_base_cross2(TemporalSeq **result, TemporalSeq *seq,
 		Datum value1 = invert ?
 			func(value, temporalinst_value(inst), datumtypid, inst->valuetypid) :
 			func(temporalinst_value(inst), value, inst->valuetypid, datumtypid);
-		TemporalInst *inst1 = temporalinst_make(value1, inst->t, valuetypid);
-		/* Result has stepwise interpolation */
-		result[0] = temporalseq_from_temporalinstarr(&inst1, 1, 
-			true, true, false, false);
-		FREE_DATUM(value1, valuetypid);
-		return 1;
+		truns_append(runs, value1, inst->t, inst->t, true, true);
+		return;
 	}
 
-	int k = 0;
 	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
 	bool lower_inc = seq->period.lower_inc;
 	for (int i = 1; i < seq->count; i++)
 	{
 		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
 		bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
-		/* The next step adds between one and three sequences */
-		k += tfunc4_temporalseq_base_cross1(&result[k], inst1, inst2, 
-			lower_inc, upper_inc, value, func, datumtypid, valuetypid, invert);
+		/* The next step adds between one and three runs */
+		tfunc4_temporalseq_base_cross1(runs, inst1, inst2, lower_inc, 
+			upper_inc, value, func, datumtypid, invert);
 		inst1 = inst2;
 		lower_inc = true;
 	}	
-	return k;
+	return;
 }
 
+/* 
+ * The result is accumulated as runs of constant value, which are merged
+ * while they are added, instead of constructing up to three sequences per
+ * segment and normalizing them afterwards. The values of the runs are
+ * not freed since they are kept until the result is constructed.
+ */
 TemporalS *
 tfunc4_temporalseq_base_cross(TemporalSeq *seq, Datum value, 
 	Datum (*func)(Datum, Datum, Oid, Oid), Oid datumtypid, 
 	Oid valuetypid, bool invert)
 {
-	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * seq->count * 3);
-	int count = tfunc4_temporalseq_base_cross2(sequences, seq, value, 
-		func, datumtypid, valuetypid, invert);
+	TemporalRuns *runs = truns_make(valuetypid, seq->count * 3);
+	tfunc4_temporalseq_base_cross2(runs, seq, value, func, datumtypid, 
+		invert);
 	/* Result has stepwise interpolation */
-	TemporalS *result = temporals_from_temporalseqarr(sequences, count,
-		false, true);
-
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
-	
+	TemporalS *result = truns_to_temporals(runs);
+	truns_free(runs);
 	return result;
 }
 
@@ -738,22 +686,16 @@ tfunc4_temporals_base_cross(TemporalS *ts, Datum value,
 	Datum (*func)(Datum, Datum, Oid, Oid), Oid datumtypid, 
 	Oid valuetypid, bool invert)
 {
-	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->totalcount * 3);
-	int k = 0;
+	TemporalRuns *runs = truns_make(valuetypid, ts->totalcount * 3);
 	for (int i = 0; i < ts->count; i++)
 	{
 		TemporalSeq *seq = temporals_seq_n(ts, i);
-		k += tfunc4_temporalseq_base_cross2(&sequences[k], seq, value,
-			func, datumtypid, valuetypid, invert);
+		tfunc4_temporalseq_base_cross2(runs, seq, value, func, datumtypid, 
+			invert);
 	}
 	/* Result has stepwise interpolation */
-	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
-		false, true);
-
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
-	
+	TemporalS *result = truns_to_temporals(runs);
+	truns_free(runs);
 	return result;
 }
 
@@ -12,16 +12,25 @@
 
 #include "oidcache.h"
 
+#include <access/genam.h>
 #include <access/heapam.h>
 #include <access/htup_details.h>
+#include <catalog/indexing.h>
 #include <catalog/namespace.h>
+#include <catalog/pg_extension.h>
+#include <commands/extension.h>
+#include <utils/fmgroids.h>
+#include <utils/inval.h>
+#include <utils/lsyscache.h>
 #include <utils/rel.h>
+#include <utils/syscache.h>
 
 #include "temporaltypes.h"
 
 /*****************************************************************************
  * Global arrays for caching the OIDs in order to avoid (slow) lookups.
- * These arrays are initialized at the loading of the extension
+ * These arrays are initialized on first use and reset by the invalidation
+ * callbacks registered below
  *****************************************************************************/
 
 const char *_type_names[] = 
@@ -97,11 +106,16 @@ const char *_op_names[] =
 
 /* Global variables */
 
+#define NUM_CACHED_TYPES (sizeof(_type_names) / sizeof(char *))
+#define NUM_CACHED_OPS (sizeof(_op_names) / sizeof(char *))
+
 bool _ready = false;
-Oid _type_oids[sizeof(_type_names) / sizeof(char *)];
-Oid _op_oids[sizeof(_op_names) / sizeof(char *)]
-	[sizeof(_type_names) / sizeof(char *)]
-	[sizeof(_type_names) / sizeof(char *)];
+bool _op_ready = false;
+bool _callbacks_registered = false;
+Oid _type_oids[NUM_CACHED_TYPES];
+uint32 _type_hashes[NUM_CACHED_TYPES];
+Oid _opcache_relid = InvalidOid;
+Oid _op_oids[NUM_CACHED_OPS][NUM_CACHED_TYPES][NUM_CACHED_TYPES];
 
 /* Fetch in the cache the oid of a type */
 
@@ -120,69 +134,203 @@ oper_oid(CachedOp op, CachedType lt, CachedType rt)
 {
 	if (!_ready)
 		populate_oidcache();
+	if (!_op_ready)
+		populate_opcache();
 	return _op_oids[op][lt][rt];
 }
 
+/*
+ * Invalidation callbacks. The cache is reset when one of the cached types
+ * changes (e.g., DROP EXTENSION or ALTER EXTENSION SET SCHEMA) or when the
+ * operator cache table is dropped or rebuilt. Since every CREATE TABLE 
+ * creates a row type, the hash value of the invalidated tuple is compared 
+ * to those of the cached types to avoid needless resets.
+ */
+
+static void
+type_inval_callback(Datum arg, int cacheid, uint32 hashvalue)
+{
+	if (!_ready)
+		return;
+	if (hashvalue != 0)
+	{
+		bool found = false;
+		for (int i = 0; i < (int) NUM_CACHED_TYPES; i++)
+		{
+			if (_type_hashes[i] == hashvalue)
+			{
+				found = true;
+				break;
+			}
+		}
+		if (!found)
+			return;
+	}
+	_ready = false;
+	_op_ready = false;
+}
+
+static void
+opcache_inval_callback(Datum arg, Oid relid)
+{
+	if (relid == InvalidOid || relid == _opcache_relid)
+		_op_ready = false;
+}
+
+static void
+register_callbacks()
+{
+	if (_callbacks_registered)
+		return;
+	CacheRegisterSyscacheCallback(TYPEOID, type_inval_callback, (Datum) 0);
+	CacheRegisterRelcacheCallback(opcache_inval_callback, (Datum) 0);
+	_callbacks_registered = true;
+}
+
+/*
+ * Get the schema in which the extension is installed. During CREATE 
+ * EXTENSION the extension is not yet visible by name but its Oid is 
+ * available in CurrentExtensionObject.
+ * The function get_extension_schema is not exported before PostgreSQL 16,
+ * the schema is read from pg_extension as done in PostGIS.
+ */
+
+static Oid
+extension_namespace(const char *extname)
+{
+	Oid extoid = get_extension_oid(extname, true);
+	if (!OidIsValid(extoid) && creating_extension)
+		extoid = CurrentExtensionObject;
+	if (!OidIsValid(extoid))
+		return InvalidOid;
+
+	Oid result = InvalidOid;
+	ScanKeyData entry[1];
+	Relation rel = heap_open(ExtensionRelationId, AccessShareLock);
+	ScanKeyInit(&entry[0], ObjectIdAttributeNumber, BTEqualStrategyNumber,
+		F_OIDEQ, ObjectIdGetDatum(extoid));
+	SysScanDesc scandesc = systable_beginscan(rel, ExtensionOidIndexId, true,
+		NULL, 1, entry);
+	HeapTuple tuple = systable_getnext(scandesc);
+	if (HeapTupleIsValid(tuple))
+		result = ((Form_pg_extension) GETSTRUCT(tuple))->extnamespace;
+	systable_endscan(scandesc);
+	heap_close(rel, AccessShareLock);
+	return result;
+}
+
+/*
+ * Types of the core distribution have fixed Oids and do not need a lookup.
+ * The remaining types are searched in the schema of the extension that
+ * defines them and, as a last resort, in the search path.
+ */
+
+static Oid
+builtin_type_oid(CachedType t)
+{
+	switch (t)
+	{
+		case T_BOOL:
+			return BOOLOID;
+		case T_FLOAT8:
+			return FLOAT8OID;
+		case T_INT4:
+			return INT4OID;
+		case T_TEXT:
+			return TEXTOID;
+		case T_TIMESTAMPTZ:
+			return TIMESTAMPTZOID;
+		case T_TSTZRANGE:
+			return TSTZRANGEOID;
+		default:
+			return InvalidOid;
+	}
+}
+
+static Oid
+lookup_type(const char *name, Oid namespaceId)
+{
+	if (!OidIsValid(namespaceId))
+		return InvalidOid;
+	return GetSysCacheOid2(TYPENAMENSP, PointerGetDatum(name),
+		ObjectIdGetDatum(namespaceId));
+}
+
 /* Populate the oid cache */
 
 static void 
 populate_types()
 {
-	int n = sizeof(_type_names) / sizeof(char *);
+	Oid nsp = extension_namespace(EXTENSION_NAME);
+#ifdef WITH_POSTGIS
+	Oid postgis_nsp = extension_namespace("postgis");
+#endif
+	int n = NUM_CACHED_TYPES;
 	for (int i = 0; i < n; i++)
 	{
-		_type_oids[i] = TypenameGetTypid(_type_names[i]);
-		if (!_type_oids[i])
+		Oid typid = builtin_type_oid((CachedType) i);
+		if (!OidIsValid(typid))
+			typid = lookup_type(_type_names[i], nsp);
+#ifdef WITH_POSTGIS
+		if (!OidIsValid(typid))
+			typid = lookup_type(_type_names[i], postgis_nsp);
+#endif
+		if (!OidIsValid(typid))
+			typid = TypenameGetTypid(_type_names[i]);
+		if (!OidIsValid(typid))
 			ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
 					errmsg("No Oid for type %s", _type_names[i])));
+		_type_oids[i] = typid;
+		_type_hashes[i] = GetSysCacheHashValue1(TYPEOID, ObjectIdGetDatum(typid));
 	}
 }
 
 void 
 populate_oidcache() 
 {
-	Oid namespaceId = LookupNamespaceNoError("public") ;
-	OverrideSearchPath* overridePath = GetOverrideSearchPath(CurrentMemoryContext);
-	overridePath->schemas = lcons_oid(namespaceId, overridePath->schemas);
-	PushOverrideSearchPath(overridePath);
+	register_callbacks();
+	populate_types();
+	_ready = true;
+}
 
-	PG_TRY();
-	{
+/*
+ * Populate the operator cache. This fetches the pre-computed operator cache
+ * from the catalog where it is stored in a table (see the fill_opcache 
+ * function below). Since only the selectivity functions need the operator
+ * Oids, the table is only read the first time an operator is requested.
+ */
 
-		populate_types();
-		bzero(_op_oids, sizeof(_op_oids));
-
-		/*
-		 * This fetches the pre-computed operator cache from the catalog where
-		 * it is stored in a table. See the fill_opcache function below.
-		 */
-		Oid catalog = RelnameGetRelid("pg_temporal_opcache");
-		Relation rel = heap_open(catalog, AccessShareLock);
-		TupleDesc tupDesc = rel->rd_att;
-		ScanKeyData scandata;
-		HeapScanDesc scan = heap_beginscan_catalog(rel, 0, &scandata);
-		HeapTuple tuple = heap_getnext(scan, ForwardScanDirection);
-		while (HeapTupleIsValid(tuple))
-		{
-			bool isnull = false;
-			int32 i = DatumGetInt32(heap_getattr(tuple, 1, tupDesc, &isnull));
-			int32 j = DatumGetInt32(heap_getattr(tuple, 2, tupDesc, &isnull));
-			int32 k = DatumGetInt32(heap_getattr(tuple, 3, tupDesc, &isnull));
-			_op_oids[i][j][k] = DatumGetObjectId(heap_getattr(tuple, 4, tupDesc, &isnull));
-			tuple = heap_getnext(scan, ForwardScanDirection);
-		}
-		heap_endscan(scan);
-		heap_close(rel, AccessShareLock);
-		_ready = true;
+void
+populate_opcache()
+{
+	Oid nsp = extension_namespace(EXTENSION_NAME);
+	Oid catalog = OidIsValid(nsp) ? 
+		get_relname_relid("pg_temporal_opcache", nsp) : InvalidOid;
+	if (!OidIsValid(catalog))
+		catalog = RelnameGetRelid("pg_temporal_opcache");
+	if (!OidIsValid(catalog))
+		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+				errmsg("No operator cache table pg_temporal_opcache")));
 
-		PopOverrideSearchPath() ;
-	}
-	PG_CATCH();
+	bzero(_op_oids, sizeof(_op_oids));
+	Relation rel = heap_open(catalog, AccessShareLock);
+	TupleDesc tupDesc = rel->rd_att;
+	ScanKeyData scandata;
+	HeapScanDesc scan = heap_beginscan_catalog(rel, 0, &scandata);
+	HeapTuple tuple = heap_getnext(scan, ForwardScanDirection);
+	while (HeapTupleIsValid(tuple))
 	{
-		PopOverrideSearchPath() ;
-		PG_RE_THROW();
+		bool isnull = false;
+		int32 i = DatumGetInt32(heap_getattr(tuple, 1, tupDesc, &isnull));
+		int32 j = DatumGetInt32(heap_getattr(tuple, 2, tupDesc, &isnull));
+		int32 k = DatumGetInt32(heap_getattr(tuple, 3, tupDesc, &isnull));
+		_op_oids[i][j][k] = DatumGetObjectId(heap_getattr(tuple, 4, tupDesc, &isnull));
+		tuple = heap_getnext(scan, ForwardScanDirection);
 	}
-	PG_END_TRY();
+	heap_endscan(scan);
+	heap_close(rel, AccessShareLock);
+	_opcache_relid = catalog;
+	_op_ready = true;
 }
 
 /*
@@ -194,7 +342,11 @@ PG_FUNCTION_INFO_V1(fill_opcache);
 PGDLLEXPORT Datum 
 fill_opcache(PG_FUNCTION_ARGS) 
 {
-	Oid catalog = RelnameGetRelid("pg_temporal_opcache");
+	Oid nsp = extension_namespace(EXTENSION_NAME);
+	Oid catalog = OidIsValid(nsp) ? 
+		get_relname_relid("pg_temporal_opcache", nsp) : InvalidOid;
+	if (!OidIsValid(catalog))
+		catalog = RelnameGetRelid("pg_temporal_opcache");
 	Relation rel = heap_open(catalog, AccessExclusiveLock);
 	TupleDesc tupDesc = rel->rd_att;
 
@@ -705,6 +705,31 @@ period_cmp(PG_FUNCTION_ARGS)
 	PG_RETURN_INT32(period_cmp_internal(p1, p2));	
 }
 
+/* Sort support: periods are abbreviated by their lower bound */
+
+static int
+period_sort_cmp(Datum x, Datum y, SortSupport ssup)
+{
+	return period_cmp_internal(DatumGetPeriod(x), DatumGetPeriod(y));
+}
+
+static Datum
+period_abbrev_convert(Datum original, SortSupport ssup)
+{
+	Period *p = DatumGetPeriod(original);
+	return sortsupport_abbrev_key((int64) p->lower, ssup);
+}
+
+PG_FUNCTION_INFO_V1(period_sortsupport);
+
+PGDLLEXPORT Datum
+period_sortsupport(PG_FUNCTION_ARGS)
+{
+	SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+	sortsupport_abbrev_init(ssup, period_sort_cmp, period_abbrev_convert);
+	PG_RETURN_VOID();
+}
+
 /* inequality operators using the period_cmp function */
 bool
 period_lt_internal(Period *p1, Period *p2)
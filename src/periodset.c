@@ -745,6 +745,36 @@ periodset_cmp(PG_FUNCTION_ARGS)
 	PG_RETURN_INT32(cmp);
 }
 
+/* 
+ * Sort support: period sets are abbreviated by the lower bound of their
+ * first period
+ */
+
+static int
+periodset_sort_cmp(Datum x, Datum y, SortSupport ssup)
+{
+	return periodset_cmp_internal(DatumGetPeriodSet(x), DatumGetPeriodSet(y));
+}
+
+static Datum
+periodset_abbrev_convert(Datum original, SortSupport ssup)
+{
+	PeriodSet *ps = DatumGetPeriodSet(original);
+	Period *p = periodset_per_n(ps, 0);
+	return sortsupport_abbrev_key((int64) p->lower, ssup);
+}
+
+PG_FUNCTION_INFO_V1(periodset_sortsupport);
+
+PGDLLEXPORT Datum
+periodset_sortsupport(PG_FUNCTION_ARGS)
+{
+	SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+	sortsupport_abbrev_init(ssup, periodset_sort_cmp, 
+		periodset_abbrev_convert);
+	PG_RETURN_VOID();
+}
+
 /* 
  * Equality operator
  * The internal B-tree comparator is not used to increase efficiency 
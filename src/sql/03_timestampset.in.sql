@@ -147,6 +147,11 @@ CREATE FUNCTION timestampset_cmp(timestampset, timestampset)
 	AS 'MODULE_PATHNAME', 'timestampset_cmp'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION timestampset_sortsupport(internal)
+	RETURNS void
+	AS 'MODULE_PATHNAME', 'timestampset_sortsupport'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE OPERATOR = (
 	LEFTARG = timestampset, RIGHTARG = timestampset,
 	PROCEDURE = timestampset_eq,
@@ -191,6 +196,7 @@ CREATE OPERATOR CLASS timestampset_ops
 		OPERATOR	3	=,
 		OPERATOR	4	>=,
 		OPERATOR	5	>,
-		FUNCTION	1	timestampset_cmp(timestampset, timestampset);
+		FUNCTION	1	timestampset_cmp(timestampset, timestampset),
+		FUNCTION	2	timestampset_sortsupport(internal);
 
 /******************************************************************************/
@@ -190,6 +190,11 @@ CREATE FUNCTION periodset_cmp(periodset, periodset)
 	AS 'MODULE_PATHNAME', 'periodset_cmp'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION periodset_sortsupport(internal)
+	RETURNS void
+	AS 'MODULE_PATHNAME', 'periodset_sortsupport'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE OPERATOR = (
 	LEFTARG = periodset, RIGHTARG = periodset,
 	PROCEDURE = periodset_eq,
@@ -234,6 +239,7 @@ CREATE OPERATOR CLASS periodset_ops
 		OPERATOR	3	=,
 		OPERATOR	4	>=,
 		OPERATOR	5	>,
-		FUNCTION	1	periodset_cmp(periodset, periodset);
+		FUNCTION	1	periodset_cmp(periodset, periodset),
+		FUNCTION	2	periodset_sortsupport(internal);
 
 /******************************************************************************/
@@ -191,3 +191,25 @@ CREATE OPERATOR CLASS gist_periodset_ops
 	FUNCTION	7	gist_period_same(period, period, internal);
 
 /******************************************************************************/
+
+/******************************************************************************
+ * Hilbert keys: sorting the rows on these keys before CREATE INDEX packs
+ * values close in time in the same index pages, e.g.,
+ *   CREATE TABLE t1 AS SELECT * FROM t ORDER BY hilbertKey(p,
+ *     (SELECT period(min(lower(p)), max(upper(p)), true, true) FROM t));
+ ******************************************************************************/
+
+CREATE FUNCTION hilbertKey(timestampset, period)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'timestampset_hilbert_key'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION hilbertKey(period, period)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'period_hilbert_key'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION hilbertKey(periodset, period)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'periodset_hilbert_key'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/******************************************************************************/
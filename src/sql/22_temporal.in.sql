@@ -899,6 +899,45 @@ CREATE FUNCTION shift(ttext, interval)
 	AS 'MODULE_PATHNAME', 'temporal_shift'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION resample(tbool, interval)
+	RETURNS tbool
+	AS 'MODULE_PATHNAME', 'temporal_resample'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION resample(tint, interval)
+	RETURNS tint
+	AS 'MODULE_PATHNAME', 'temporal_resample'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION resample(tfloat, interval)
+	RETURNS tfloat
+	AS 'MODULE_PATHNAME', 'temporal_resample'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION resample(ttext, interval)
+	RETURNS ttext
+	AS 'MODULE_PATHNAME', 'temporal_resample'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION timeSplit(tbool, interval, timestamptz DEFAULT '2000-01-03')
+	RETURNS TABLE(tbucket timestamptz, fragment tbool)
+	AS 'MODULE_PATHNAME', 'temporal_time_split'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION timeSplit(tint, interval, timestamptz DEFAULT '2000-01-03')
+	RETURNS TABLE(tbucket timestamptz, fragment tint)
+	AS 'MODULE_PATHNAME', 'temporal_time_split'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION timeSplit(tfloat, interval, timestamptz DEFAULT '2000-01-03')
+	RETURNS TABLE(tbucket timestamptz, fragment tfloat)
+	AS 'MODULE_PATHNAME', 'temporal_time_split'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION timeSplit(ttext, interval, timestamptz DEFAULT '2000-01-03')
+	RETURNS TABLE(tbucket timestamptz, fragment ttext)
+	AS 'MODULE_PATHNAME', 'temporal_time_split'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION simplify(tfloat, epsilon float, streaming boolean DEFAULT false)
+	RETURNS tfloat
+	AS 'MODULE_PATHNAME', 'tfloat_simplify'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 -------------------------------------------------------------------------------
 -- Restriction functions
 -------------------------------------------------------------------------------
@@ -1546,6 +1585,39 @@ CREATE FUNCTION valueAtTimestamp(ttext, timestamptz)
 	AS 'MODULE_PATHNAME', 'temporal_value_at_timestamp'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION valueAtTimestamps(tbool, timestamptz[])
+	RETURNS bool[]
+	AS 'MODULE_PATHNAME', 'temporal_values_at_timestamps'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION valueAtTimestamps(tint, timestamptz[])
+	RETURNS integer[]
+	AS 'MODULE_PATHNAME', 'temporal_values_at_timestamps'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION valueAtTimestamps(tfloat, timestamptz[])
+	RETURNS float[]
+	AS 'MODULE_PATHNAME', 'temporal_values_at_timestamps'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION valueAtTimestamps(ttext, timestamptz[])
+	RETURNS text[]
+	AS 'MODULE_PATHNAME', 'temporal_values_at_timestamps'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION valueAtTimestamps(tbool, timestampset)
+	RETURNS bool[]
+	AS 'MODULE_PATHNAME', 'temporal_values_at_timestampset'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION valueAtTimestamps(tint, timestampset)
+	RETURNS integer[]
+	AS 'MODULE_PATHNAME', 'temporal_values_at_timestampset'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION valueAtTimestamps(tfloat, timestampset)
+	RETURNS float[]
+	AS 'MODULE_PATHNAME', 'temporal_values_at_timestampset'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION valueAtTimestamps(ttext, timestampset)
+	RETURNS text[]
+	AS 'MODULE_PATHNAME', 'temporal_values_at_timestampset'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION atTimestampSet(tbool, timestampset)
 	RETURNS tbool
 	AS 'MODULE_PATHNAME', 'temporal_at_timestampset'
@@ -1767,6 +1839,11 @@ CREATE FUNCTION tbool_cmp(tbool, tbool)
 	AS 'MODULE_PATHNAME', 'temporal_cmp'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION tbool_sortsupport(internal)
+	RETURNS void
+	AS 'MODULE_PATHNAME', 'temporal_sortsupport'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE OPERATOR < (
 	LEFTARG = tbool, RIGHTARG = tbool,
 	PROCEDURE = tbool_lt,
@@ -1817,7 +1894,8 @@ CREATE OPERATOR CLASS tbool_ops
 		OPERATOR	3	=,
 		OPERATOR	4	>=,
 		OPERATOR	5	>,
-		FUNCTION	1	tbool_cmp(tbool, tbool);
+		FUNCTION	1	tbool_cmp(tbool, tbool),
+		FUNCTION	2	tbool_sortsupport(internal);
 
 /*****************************************************************************/
 
@@ -1850,6 +1928,11 @@ CREATE FUNCTION tint_cmp(tint, tint)
 	AS 'MODULE_PATHNAME', 'temporal_cmp'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION tint_sortsupport(internal)
+	RETURNS void
+	AS 'MODULE_PATHNAME', 'temporal_sortsupport'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE OPERATOR < (
 	LEFTARG = tint, RIGHTARG = tint,
 	PROCEDURE = tint_lt,
@@ -1900,7 +1983,8 @@ CREATE OPERATOR CLASS tint_ops
 		OPERATOR	3	=,
 		OPERATOR	4	>=,
 		OPERATOR	5	>,
-		FUNCTION	1	tint_cmp(tint, tint);
+		FUNCTION	1	tint_cmp(tint, tint),
+		FUNCTION	2	tint_sortsupport(internal);
 
 /*****************************************************************************/
 
@@ -1933,6 +2017,11 @@ CREATE FUNCTION tfloat_cmp(tfloat, tfloat)
 	AS 'MODULE_PATHNAME', 'temporal_cmp'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION tfloat_sortsupport(internal)
+	RETURNS void
+	AS 'MODULE_PATHNAME', 'temporal_sortsupport'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE OPERATOR < (
 	LEFTARG = tfloat, RIGHTARG = tfloat,
 	PROCEDURE = tfloat_lt,
@@ -1983,7 +2072,8 @@ CREATE OPERATOR CLASS tfloat_ops
 		OPERATOR	3	=,
 		OPERATOR	4	>=,
 		OPERATOR	5	>,
-		FUNCTION	1	tfloat_cmp(tfloat, tfloat);
+		FUNCTION	1	tfloat_cmp(tfloat, tfloat),
+		FUNCTION	2	tfloat_sortsupport(internal);
 		
 /******************************************************************************/
 
@@ -2016,6 +2106,11 @@ CREATE FUNCTION ttext_cmp(ttext, ttext)
 	AS 'MODULE_PATHNAME', 'temporal_cmp'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION ttext_sortsupport(internal)
+	RETURNS void
+	AS 'MODULE_PATHNAME', 'temporal_sortsupport'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE OPERATOR < (
 	LEFTARG = ttext, RIGHTARG = ttext,
 	PROCEDURE = ttext_lt,
@@ -2066,7 +2161,8 @@ CREATE OPERATOR CLASS ttext_ops
 		OPERATOR	3	=,
 		OPERATOR	4	>=,
 		OPERATOR	5	>,
-		FUNCTION	1	ttext_cmp(ttext, ttext);
+		FUNCTION	1	ttext_cmp(ttext, ttext),
+		FUNCTION	2	ttext_sortsupport(internal);
 
 /******************************************************************************/
 
@@ -2074,34 +2170,54 @@ CREATE FUNCTION tbool_hash(tbool)
 	RETURNS integer
 	AS 'MODULE_PATHNAME', 'temporal_hash'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tbool_hash_extended(tbool, bigint)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'temporal_hash_extended'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION tint_hash(tint)
 	RETURNS integer
 	AS 'MODULE_PATHNAME', 'temporal_hash'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tint_hash_extended(tint, bigint)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'temporal_hash_extended'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION tfloat_hash(tfloat)
 	RETURNS integer
 	AS 'MODULE_PATHNAME', 'temporal_hash'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tfloat_hash_extended(tfloat, bigint)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'temporal_hash_extended'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION ttext_hash(ttext)
 	RETURNS integer
 	AS 'MODULE_PATHNAME', 'temporal_hash'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ttext_hash_extended(ttext, bigint)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'temporal_hash_extended'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR CLASS hash_tbool_ops
 	DEFAULT FOR TYPE tbool USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   tbool_hash(tbool);
+    FUNCTION    1   tbool_hash(tbool),
+    FUNCTION    2   tbool_hash_extended(tbool, bigint);
 CREATE OPERATOR CLASS hash_tint_ops
 	DEFAULT FOR TYPE tint USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   tint_hash(tint);
+    FUNCTION    1   tint_hash(tint),
+    FUNCTION    2   tint_hash_extended(tint, bigint);
 CREATE OPERATOR CLASS hash_tfloat_ops
 	DEFAULT FOR TYPE tfloat USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   tfloat_hash(tfloat);
+    FUNCTION    1   tfloat_hash(tfloat),
+    FUNCTION    2   tfloat_hash_extended(tfloat, bigint);
 CREATE OPERATOR CLASS hash_ttext_ops
 	DEFAULT FOR TYPE ttext USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   ttext_hash(ttext);
+    FUNCTION    1   ttext_hash(ttext),
+    FUNCTION    2   ttext_hash_extended(ttext, bigint);
 
 /******************************************************************************/
@@ -451,6 +451,19 @@ CREATE OPERATOR / (
 
 /******************************************************************************/
 
+/* Evaluation of an expression over several temporal floats in one pass */
+
+CREATE FUNCTION teval(text, VARIADIC tfloat[])
+	RETURNS tfloat
+	AS 'MODULE_PATHNAME', 'tnumber_eval'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tevalBool(text, VARIADIC tfloat[])
+	RETURNS tbool
+	AS 'MODULE_PATHNAME', 'tnumber_eval_bool'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/******************************************************************************/
+
 
 /* tfloat round */
 
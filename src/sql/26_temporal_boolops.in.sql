@@ -89,4 +89,13 @@ CREATE OPERATOR ~ (
 	PROCEDURE = temporal_not, RIGHTARG = tbool
 );
 
-/*****************************************************************************/
\ No newline at end of file
+/*****************************************************************************
+ * Time when the temporal Boolean is true
+ *****************************************************************************/
+
+CREATE FUNCTION whenTrue(tbool)
+	RETURNS periodset
+	AS 'MODULE_PATHNAME', 'tbool_when_true'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/*****************************************************************************/
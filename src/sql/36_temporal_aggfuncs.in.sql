@@ -363,3 +363,127 @@ CREATE AGGREGATE tcount(ttext) (
 );
 
 /*****************************************************************************/
+
+CREATE FUNCTION tcount_bins_transfn(internal, tbool, timestamptz, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_bins_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_bins_transfn(internal, tint, timestamptz, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_bins_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_bins_transfn(internal, tfloat, timestamptz, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_bins_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_bins_transfn(internal, ttext, timestamptz, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_bins_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tsum_bins_transfn(internal, tint, timestamptz, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'tnumber_tsum_bins_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tsum_bins_transfn(internal, tfloat, timestamptz, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'tnumber_tsum_bins_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tbins_combinefn(internal, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_bins_combinefn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tbins_serialize(internal)
+	RETURNS bytea
+	AS 'MODULE_PATHNAME', 'temporal_bins_serialize'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tbins_deserialize(bytea, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_bins_deserialize'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tcount_bins_finalfn(internal)
+	RETURNS tint
+	AS 'MODULE_PATHNAME', 'temporal_tcount_bins_finalfn'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tsum_bins_finalfn(internal)
+	RETURNS tfloat
+	AS 'MODULE_PATHNAME', 'tnumber_tsum_bins_finalfn'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tavg_bins_finalfn(internal)
+	RETURNS tfloat
+	AS 'MODULE_PATHNAME', 'tnumber_tavg_bins_finalfn'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE AGGREGATE tcount_bins(tbool, timestamptz, interval) (
+	SFUNC = tcount_bins_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbins_combinefn,
+	FINALFUNC = tcount_bins_finalfn,
+	SERIALFUNC = tbins_serialize,
+	DESERIALFUNC = tbins_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tcount_bins(tint, timestamptz, interval) (
+	SFUNC = tcount_bins_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbins_combinefn,
+	FINALFUNC = tcount_bins_finalfn,
+	SERIALFUNC = tbins_serialize,
+	DESERIALFUNC = tbins_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tcount_bins(tfloat, timestamptz, interval) (
+	SFUNC = tcount_bins_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbins_combinefn,
+	FINALFUNC = tcount_bins_finalfn,
+	SERIALFUNC = tbins_serialize,
+	DESERIALFUNC = tbins_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tcount_bins(ttext, timestamptz, interval) (
+	SFUNC = tcount_bins_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbins_combinefn,
+	FINALFUNC = tcount_bins_finalfn,
+	SERIALFUNC = tbins_serialize,
+	DESERIALFUNC = tbins_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tsum_bins(tint, timestamptz, interval) (
+	SFUNC = tsum_bins_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbins_combinefn,
+	FINALFUNC = tsum_bins_finalfn,
+	SERIALFUNC = tbins_serialize,
+	DESERIALFUNC = tbins_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tsum_bins(tfloat, timestamptz, interval) (
+	SFUNC = tsum_bins_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbins_combinefn,
+	FINALFUNC = tsum_bins_finalfn,
+	SERIALFUNC = tbins_serialize,
+	DESERIALFUNC = tbins_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tavg_bins(tint, timestamptz, interval) (
+	SFUNC = tsum_bins_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbins_combinefn,
+	FINALFUNC = tavg_bins_finalfn,
+	SERIALFUNC = tbins_serialize,
+	DESERIALFUNC = tbins_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tavg_bins(tfloat, timestamptz, interval) (
+	SFUNC = tsum_bins_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbins_combinefn,
+	FINALFUNC = tavg_bins_finalfn,
+	SERIALFUNC = tbins_serialize,
+	DESERIALFUNC = tbins_deserialize,
+	PARALLEL = SAFE
+);
+
+/*****************************************************************************/
@@ -274,3 +274,32 @@ CREATE OPERATOR CLASS gist_ttext_ops
 	FUNCTION	7	gist_period_same(period, period, internal);
 
 /******************************************************************************/
+
+/******************************************************************************
+ * Hilbert keys for sorting the rows before CREATE INDEX, e.g.,
+ *   CREATE TABLE t1 AS SELECT * FROM t ORDER BY
+ *     hilbertKey(temp, (SELECT extent(temp) FROM t));
+ ******************************************************************************/
+
+CREATE FUNCTION hilbertKey(tbool, period)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'temporal_hilbert_key'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION hilbertKey(ttext, period)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'temporal_hilbert_key'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION hilbertKey(tbox, tbox)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'tbox_hilbert_key'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION hilbertKey(tint, tbox)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'tnumber_hilbert_key'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION hilbertKey(tfloat, tbox)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'tnumber_hilbert_key'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/******************************************************************************/
@@ -17,6 +17,7 @@
 #include <access/htup_details.h>
 #include <access/tuptoaster.h>
 #include <catalog/namespace.h>
+#include <funcapi.h>
 #include <libpq/pqformat.h>
 #include <utils/builtins.h>
 #include <utils/fmgroids.h>
@@ -24,9 +25,13 @@
 #include <utils/rel.h>
 #include <utils/timestamp.h>
 
+#include "period.h"
+#include "timestampset.h"
+#include "timeops.h"
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_runs.h"
 #include "temporal_boxops.h"
 #include "temporal_parser.h"
 #include "rangetypes_ext.h"
@@ -1499,6 +1504,235 @@ temporal_bbox(void *box, const Temporal *temp)
 		temporals_bbox(box, (TemporalS *)temp);
 }
 
+/*****************************************************************************
+ * Partial detoasting
+ * Temporal values stored out of line without compression are read by
+ * slices. The header, the offsets and the precomputed bounding box answer
+ * the bounding box tests and locate the sequences needed by a time
+ * restriction without fetching the whole value.
+ *****************************************************************************/
+
+/*
+ * Copy into the first argument length bytes of the value starting at the
+ * position offset, counted from the beginning of the struct. The slices
+ * are counted from the end of the varlena header, which is not stored in
+ * the toast table. The bytes of the header that are requested are zeroed,
+ * the caller sets the header if needed.
+ */
+static void
+temporal_read_slice(void *dest, Datum value, size_t offset, size_t length)
+{
+	size_t skip = 0;
+	if (offset < VARHDRSZ)
+	{
+		skip = Min(VARHDRSZ - offset, length);
+		memset(dest, 0, skip);
+		if (skip == length)
+			return;
+	}
+	struct varlena *slice = PG_DETOAST_DATUM_SLICE(value,
+		Max(offset, VARHDRSZ) - VARHDRSZ, length - skip);
+	memcpy((char *) dest + skip, VARDATA(slice), 
+		Min(length - skip, VARSIZE(slice) - VARHDRSZ));
+	pfree(slice);
+}
+
+/*
+ * Read the fixed-size header of the value. Returns false when the value is
+ * not stored out of line without compression, or when it is an instant,
+ * in which case the whole value must be detoasted.
+ * The header is read into a TemporalSeq, whose fields before the offsets
+ * array include those of the headers of the other durations.
+ */
+static bool
+temporal_slice_header(TemporalSeq *hdr, Datum value)
+{
+	struct varlena *attr = (struct varlena *) DatumGetPointer(value);
+	struct varatt_external toast_pointer;
+	if (!VARATT_IS_EXTERNAL_ONDISK(attr))
+		return false;
+	VARATT_EXTERNAL_GET_POINTER(toast_pointer, attr);
+	if (VARATT_EXTERNAL_IS_COMPRESSED(toast_pointer))
+		return false;
+	temporal_read_slice(hdr, value, 0, offsetof(TemporalSeq, offsets));
+	SET_VARSIZE(hdr, toast_pointer.va_rawsize);
+	return hdr->duration != TEMPORALINST;
+}
+
+/* Position of the offsets array */
+
+static size_t
+temporal_offsets_pos(int16 duration)
+{
+	if (duration == TEMPORALI)
+		return offsetof(TemporalI, offsets);
+	else if (duration == TEMPORALSEQ)
+		return offsetof(TemporalSeq, offsets);
+	else
+		return offsetof(TemporalS, offsets);
+}
+
+/* Position of the beginning of the variable-length data */
+
+static size_t
+temporal_data_pos(int16 duration, int count)
+{
+	/* Sequences have an additional offset for the trajectory */
+	int noffsets = (duration == TEMPORALSEQ) ? count + 2 : count + 1;
+	return temporal_offsets_pos(duration) + noffsets * sizeof(size_t);
+}
+
+/* Position of the n-th element of the variable-length data */
+
+static size_t
+temporal_elem_pos(Datum value, int16 duration, int count, int n)
+{
+	size_t offset;
+	temporal_read_slice(&offset, value,
+		temporal_offsets_pos(duration) + n * sizeof(size_t), sizeof(size_t));
+	return temporal_data_pos(duration, count) + offset;
+}
+
+/* Period of a value from its header and its first and last elements */
+
+static void
+temporal_period_slice1(Period *p, Datum value, TemporalSeq *hdr)
+{
+	if (hdr->duration == TEMPORALI)
+	{
+		TimestampTz t1, t2;
+		temporal_read_slice(&t1, value, temporal_elem_pos(value, 
+			TEMPORALI, hdr->count, 0) + offsetof(TemporalInst, t),
+			sizeof(TimestampTz));
+		temporal_read_slice(&t2, value, temporal_elem_pos(value, 
+			TEMPORALI, hdr->count, hdr->count - 1) + offsetof(TemporalInst, t),
+			sizeof(TimestampTz));
+		period_set(p, t1, t2, true, true);
+	}
+	else if (hdr->duration == TEMPORALSEQ)
+		period_set(p, hdr->period.lower, hdr->period.upper,
+			hdr->period.lower_inc, hdr->period.upper_inc);
+	else
+	{
+		Period p1, p2;
+		temporal_read_slice(&p1, value, temporal_elem_pos(value, 
+			TEMPORALS, hdr->count, 0) + offsetof(TemporalSeq, period),
+			sizeof(Period));
+		temporal_read_slice(&p2, value, temporal_elem_pos(value, 
+			TEMPORALS, hdr->count, hdr->count - 1) + offsetof(TemporalSeq, period),
+			sizeof(Period));
+		period_set(p, p1.lower, p2.upper, p1.lower_inc, p2.upper_inc);
+	}
+}
+
+/**
+ * @brief Set the first argument to the bounding box of the temporal value
+ *		reading only the slices needed
+ */
+void
+temporal_bbox_slice(void *box, Datum value)
+{
+	TemporalSeq hdr;
+	if (!temporal_slice_header(&hdr, value))
+	{
+		Temporal *temp = (Temporal *) PG_DETOAST_DATUM(value);
+		temporal_bbox(box, temp);
+		POSTGIS_FREE_IF_COPY_P(temp, DatumGetPointer(value));
+		return;
+	}
+	temporal_read_slice(box, value, temporal_elem_pos(value, hdr.duration,
+		hdr.count, hdr.count), temporal_bbox_size(hdr.valuetypid));
+}
+
+/**
+ * @brief Set the first argument to the bounding period of the temporal 
+ *		value reading only the slices needed
+ */
+void
+temporal_period_slice(Period *p, Datum value)
+{
+	TemporalSeq hdr;
+	if (!temporal_slice_header(&hdr, value))
+	{
+		Temporal *temp = (Temporal *) PG_DETOAST_DATUM(value);
+		temporal_period(p, temp);
+		POSTGIS_FREE_IF_COPY_P(temp, DatumGetPointer(value));
+		return;
+	}
+	temporal_period_slice1(p, value, &hdr);
+}
+
+/**
+ * @brief Returns the part of the temporal value needed to restrict it to
+ *		the period, or NULL if the value does not intersect the period.
+ *		For sequence sets whose slices can be read, the sequences 
+ *		overlapping the period are located by a binary search over the
+ *		offsets and are the only ones fetched. Otherwise the whole value
+ *		is detoasted.
+ */
+Temporal *
+temporal_detoast_period(Datum value, Period *p)
+{
+	TemporalSeq hdr;
+	if (!temporal_slice_header(&hdr, value))
+		return (Temporal *) PG_DETOAST_DATUM(value);
+	Period p1;
+	temporal_period_slice1(&p1, value, &hdr);
+	if (!overlaps_period_period_internal(&p1, p))
+		return NULL;
+	if (hdr.duration != TEMPORALS)
+		return (Temporal *) PG_DETOAST_DATUM(value);
+
+	int count = hdr.count;
+	size_t *offsets = palloc(sizeof(size_t) * (count + 1));
+	temporal_read_slice(offsets, value, offsetof(TemporalS, offsets),
+		sizeof(size_t) * (count + 1));
+	size_t data = temporal_data_pos(TEMPORALS, count);
+	/* First sequence that is not before the period */
+	int first = 0, last = count;
+	while (first < last)
+	{
+		int middle = (first + last) / 2;
+		temporal_read_slice(&p1, value, data + offsets[middle] + 
+			offsetof(TemporalSeq, period), sizeof(Period));
+		if (before_period_period_internal(&p1, p))
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	/* First sequence that is after the period */
+	int lower = first;
+	last = count;
+	while (lower < last)
+	{
+		int middle = (lower + last) / 2;
+		temporal_read_slice(&p1, value, data + offsets[middle] + 
+			offsetof(TemporalSeq, period), sizeof(Period));
+		if (after_period_period_internal(&p1, p))
+			last = middle;
+		else
+			lower = middle + 1;
+	}
+	if (first == last)
+	{
+		pfree(offsets);
+		return NULL;
+	}
+
+	/* The sequences are contiguous and the bounding box follows the last one */
+	size_t length = offsets[last] - offsets[first];
+	char *buffer = palloc(length);
+	temporal_read_slice(buffer, value, data + offsets[first], length);
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * (last - first));
+	for (int i = first; i < last; i++)
+		sequences[i - first] = (TemporalSeq *) (buffer + offsets[i] - 
+			offsets[first]);
+	TemporalS *result = temporals_from_temporalseqarr(sequences, last - first,
+		MOBDB_FLAGS_GET_LINEAR(hdr.flags), false);
+	pfree(sequences); pfree(buffer); pfree(offsets);
+	return (Temporal *) result;
+}
+
 PG_FUNCTION_INFO_V1(tnumber_to_tbox);
 /**
  * @brief Returns the bounding box of the temporal value
@@ -2118,6 +2352,214 @@ temporal_shift(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
+PG_FUNCTION_INFO_V1(temporal_resample);
+/**
+ * @brief Sample the temporal value every time interval starting from its 
+ *		start timestamp
+ */
+PGDLLEXPORT Datum
+temporal_resample(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	int64 step = interval_width(PG_GETARG_INTERVAL_P(1));
+	Temporal *result = NULL;
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST) 
+		result = (Temporal *)temporalinst_copy((TemporalInst *)temp);
+	else if (temp->duration == TEMPORALI) 
+		result = (Temporal *)temporali_resample((TemporalI *)temp, 
+			temporali_inst_n((TemporalI *)temp, 0)->t, step);
+	else if (temp->duration == TEMPORALSEQ) 
+		result = (Temporal *)temporalseq_resample((TemporalSeq *)temp, 
+			((TemporalSeq *)temp)->period.lower, step);
+	else if (temp->duration == TEMPORALS) 
+		result = (Temporal *)temporals_resample((TemporalS *)temp, 
+			temporals_seq_n((TemporalS *)temp, 0)->period.lower, step);
+	PG_FREE_IF_COPY(temp, 0);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
+/**
+ * @brief Add to the array the indexes of the buckets overlapping the period
+ *		that are after the last bucket of the array
+ */
+static void
+time_split_add_buckets(const Period *p, TimestampTz origin, int64 width,
+	int64 **buckets, int *count, int *maxcount)
+{
+	int64 first = timestamp_bucket(p->lower, origin, width);
+	int64 last = timestamp_bucket(p->upper, origin, width);
+	/* An exclusive upper bound starting a bucket does not overlap it */
+	if (! p->upper_inc && p->upper == origin + last * width && last > first)
+		last--;
+	/* The periods are ordered so the buckets already added come first */
+	if (*count > 0 && first <= (*buckets)[*count - 1])
+		first = (*buckets)[*count - 1] + 1;
+	for (int64 i = first; i <= last; i++)
+	{
+		if (*count == *maxcount)
+		{
+			*maxcount *= 2;
+			*buckets = repalloc(*buckets, sizeof(int64) * (*maxcount));
+		}
+		(*buckets)[(*count)++] = i;
+	}
+}
+
+/**
+ * @brief Split the temporal value into fragments by time buckets of the 
+ *		given width starting at the origin (internal function)
+ *		Returns the number of fragments and sets the start of their buckets.
+ *		Only the buckets overlapping the instants or the sequences of the
+ *		temporal value are considered, which avoids restricting the value
+ *		to the empty buckets between them.
+ */
+int
+temporal_time_split_internal(Temporal *temp, TimestampTz origin, int64 width,
+	Temporal ***fragments, TimestampTz **buckets)
+{
+	int count = 0, maxcount = 64;
+	int64 *indexes = palloc(sizeof(int64) * maxcount);
+	Period p;
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST)
+	{
+		TimestampTz t = ((TemporalInst *)temp)->t;
+		period_set(&p, t, t, true, true);
+		time_split_add_buckets(&p, origin, width, &indexes, &count, &maxcount);
+	}
+	else if (temp->duration == TEMPORALI)
+	{
+		TemporalI *ti = (TemporalI *)temp;
+		for (int i = 0; i < ti->count; i++)
+		{
+			TimestampTz t = temporali_inst_n(ti, i)->t;
+			period_set(&p, t, t, true, true);
+			time_split_add_buckets(&p, origin, width, &indexes, &count,
+				&maxcount);
+		}
+	}
+	else if (temp->duration == TEMPORALSEQ)
+		time_split_add_buckets(&((TemporalSeq *)temp)->period, origin, width,
+			&indexes, &count, &maxcount);
+	else /* temp->duration == TEMPORALS */
+	{
+		TemporalS *ts = (TemporalS *)temp;
+		for (int i = 0; i < ts->count; i++)
+			time_split_add_buckets(&temporals_seq_n(ts, i)->period, origin,
+				width, &indexes, &count, &maxcount);
+	}
+
+	*fragments = palloc(sizeof(Temporal *) * count);
+	*buckets = palloc(sizeof(TimestampTz) * count);
+	int k = 0;
+	for (int i = 0; i < count; i++)
+	{
+		TimestampTz lower = origin + indexes[i] * width;
+		Period bucket;
+		period_set(&bucket, lower, lower + width, true, false);
+		Temporal *fragment = temporal_at_period_internal(temp, &bucket);
+		if (fragment == NULL)
+			continue;
+		(*buckets)[k] = lower;
+		(*fragments)[k++] = fragment;
+	}
+	pfree(indexes);
+	return k;
+}
+
+/* State of the set-returning function splitting a temporal value */
+
+typedef struct
+{
+	int i;
+	int count;
+	TimestampTz *buckets;
+	Temporal **fragments;
+} TemporalSplitState;
+
+PG_FUNCTION_INFO_V1(temporal_time_split);
+/**
+ * @brief Split the temporal value into fragments by time buckets
+ *		Returns a set of (bucket start, fragment) pairs.
+ */
+PGDLLEXPORT Datum
+temporal_time_split(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	if (SRF_IS_FIRSTCALL())
+	{
+		funcctx = SRF_FIRSTCALL_INIT();
+		MemoryContext oldcontext = 
+			MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+		Temporal *temp = PG_GETARG_TEMPORAL(0);
+		int64 width = interval_width(PG_GETARG_INTERVAL_P(1));
+		TimestampTz origin = PG_GETARG_TIMESTAMPTZ(2);
+		TemporalSplitState *state = palloc0(sizeof(TemporalSplitState));
+		state->count = temporal_time_split_internal(temp, origin, width, 
+			&state->fragments, &state->buckets);
+		funcctx->user_fctx = state;
+		TupleDesc tupdesc;
+		if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				errmsg("Function returning record called in context that cannot accept type record")));
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	TemporalSplitState *state = (TemporalSplitState *) funcctx->user_fctx;
+	if (state->i == state->count)
+		SRF_RETURN_DONE(funcctx);
+	Datum values[2];
+	bool nulls[2] = {false, false};
+	values[0] = TimestampTzGetDatum(state->buckets[state->i]);
+	values[1] = PointerGetDatum(state->fragments[state->i]);
+	state->i++;
+	HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+	SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+}
+
+/**
+ * @brief Simplify the temporal value with a tolerance (internal function)
+ *		Instants and instant sets are returned unchanged.
+ */
+Temporal *
+temporal_simplify_internal(Temporal *temp, double eps, bool synchronized,
+	bool streaming)
+{
+	Temporal *result = NULL;
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST || temp->duration == TEMPORALI) 
+		result = temporal_copy(temp);
+	else if (temp->duration == TEMPORALSEQ) 
+		result = (Temporal *)temporalseq_simplify((TemporalSeq *)temp, eps,
+			synchronized, streaming);
+	else if (temp->duration == TEMPORALS) 
+		result = (Temporal *)temporals_simplify((TemporalS *)temp, eps,
+			synchronized, streaming);
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(tfloat_simplify);
+/**
+ * @brief Simplify the temporal float keeping the distance between the 
+ *		removed instants and the simplified value at their timestamps 
+ *		below a tolerance
+ */
+PGDLLEXPORT Datum
+tfloat_simplify(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	double eps = PG_GETARG_FLOAT8(1);
+	bool streaming = PG_GETARG_BOOL(2);
+	Temporal *result = temporal_simplify_internal(temp, eps, true, streaming);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_POINTER(result);
+}
+
 /*****************************************************************************
  * Ever/always comparison operators
  *****************************************************************************/
@@ -2433,6 +2875,20 @@ temporal_always_ge(PG_FUNCTION_ARGS)
  *****************************************************************************/
 
 
+/**
+ * @brief Restricts a temporal sequence (set) with stepwise interpolation
+ * to a value by filtering its runs of constant value
+ */
+static TemporalS *
+temporal_at_value_stepwise(Temporal *temp, Datum value)
+{
+	TemporalRuns *runs = truns_from_temporal(temp);
+	TemporalRuns *atruns = truns_at_value(runs, value);
+	TemporalS *result = truns_to_temporals(atruns);
+	truns_free(runs); truns_free(atruns);
+	return result;
+}
+
 PG_FUNCTION_INFO_V1(temporal_at_value);
 /**
  * @brief Restricts the temporal value to a value
@@ -2451,6 +2907,8 @@ temporal_at_value(PG_FUNCTION_ARGS)
 	else if (temp->duration == TEMPORALI) 
 		result = (Temporal *)temporali_at_value(
 			(TemporalI *)temp, value);
+	else if (! MOBDB_FLAGS_GET_LINEAR(temp->flags))
+		result = (Temporal *)temporal_at_value_stepwise(temp, value);
 	else if (temp->duration == TEMPORALSEQ) 
 		result = (Temporal *)temporalseq_at_value(
 			(TemporalSeq *)temp, value);
@@ -2873,8 +3331,12 @@ PG_FUNCTION_INFO_V1(temporal_at_timestamp);
 PGDLLEXPORT Datum
 temporal_at_timestamp(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+	Period p;
+	period_set(&p, t, t, true, true);
+	Temporal *temp = temporal_detoast_period(PG_GETARG_DATUM(0), &p);
+	if (temp == NULL)
+		PG_RETURN_NULL();
 	TemporalInst *result = temporal_at_timestamp_internal(temp, t);
 	PG_FREE_IF_COPY(temp, 0);
 	if (result == NULL)
@@ -2914,8 +3376,12 @@ PG_FUNCTION_INFO_V1(temporal_value_at_timestamp);
 PGDLLEXPORT Datum
 temporal_value_at_timestamp(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+	Period p;
+	period_set(&p, t, t, true, true);
+	Temporal *temp = temporal_detoast_period(PG_GETARG_DATUM(0), &p);
+	if (temp == NULL)
+		PG_RETURN_NULL();
 	bool found = false;
 	Datum result = 0;
 	ensure_valid_duration(temp->duration);
@@ -2933,6 +3399,115 @@ temporal_value_at_timestamp(PG_FUNCTION_ARGS)
 	PG_RETURN_DATUM(result);
 }
 
+/*
+ * Returns the array of values taken by the temporal value at the timestamps,
+ * which are assumed to be in increasing order. The array has a NULL for the
+ * timestamps at which the temporal value is not defined, including all of
+ * them when the temporal value is NULL.
+ */
+static ArrayType *
+temporal_values_at_timestamps_internal(Temporal *temp, Oid valuetypid,
+	TimestampTz *times, int count)
+{
+	if (count == 0)
+		return construct_empty_array(valuetypid);
+	Datum *values = palloc(sizeof(Datum) * count);
+	bool *nulls = palloc(sizeof(bool) * count);
+	if (temp == NULL)
+	{
+		for (int i = 0; i < count; i++)
+			nulls[i] = true;
+	}
+	else 
+	{
+		ensure_valid_duration(temp->duration);
+		if (temp->duration == TEMPORALINST) 
+			temporalinst_values_at_timestamps((TemporalInst *)temp, times, count,
+				values, nulls);
+		else if (temp->duration == TEMPORALI) 
+			temporali_values_at_timestamps((TemporalI *)temp, times, count,
+				values, nulls);
+		else if (temp->duration == TEMPORALSEQ) 
+			temporalseq_values_at_timestamps((TemporalSeq *)temp, times, count,
+				values, nulls);
+		else if (temp->duration == TEMPORALS) 
+			temporals_values_at_timestamps((TemporalS *)temp, times, count,
+				values, nulls);
+	}
+	int16 elmlen;
+	bool elmbyval;
+	char elmalign;
+	get_typlenbyvalalign(valuetypid, &elmlen, &elmbyval, &elmalign);
+	int dims[1] = {count};
+	int lbs[1] = {1};
+	ArrayType *result = construct_md_array(values, nulls, 1, dims, lbs, 
+		valuetypid, elmlen, elmbyval, elmalign);
+	if (!elmbyval)
+	{
+		for (int i = 0; i < count; i++)
+			if (!nulls[i])
+				pfree(DatumGetPointer(values[i]));
+	}
+	pfree(values); pfree(nulls);
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(temporal_values_at_timestamps);
+/**
+ * @brief Returns the values taken by the temporal value at an array of 
+ *		timestamps in increasing order
+ */
+PGDLLEXPORT Datum
+temporal_values_at_timestamps(PG_FUNCTION_ARGS)
+{
+	ArrayType *array = PG_GETARG_ARRAYTYPE_P(1);
+	int count;
+	TimestampTz *times = timestamparr_extract(array, &count);
+	for (int i = 1; i < count; i++)
+	{
+		if (timestamp_cmp_internal(times[i - 1], times[i]) > 0)
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+				errmsg("The timestamps must be in increasing order")));
+	}
+	/* The element type of the result is needed when the value is not read */
+	Oid valuetypid = get_element_type(get_fn_expr_rettype(fcinfo->flinfo));
+	Temporal *temp = NULL;
+	if (count > 0)
+	{
+		Period p;
+		period_set(&p, times[0], times[count - 1], true, true);
+		temp = temporal_detoast_period(PG_GETARG_DATUM(0), &p);
+	}
+	ArrayType *result = temporal_values_at_timestamps_internal(temp, 
+		valuetypid, times, count);
+	if (temp != NULL)
+		PG_FREE_IF_COPY(temp, 0);
+	pfree(times);
+	PG_FREE_IF_COPY(array, 1);
+	PG_RETURN_ARRAYTYPE_P(result);
+}
+
+PG_FUNCTION_INFO_V1(temporal_values_at_timestampset);
+/**
+ * @brief Returns the values taken by the temporal value at a timestamp set
+ */
+PGDLLEXPORT Datum
+temporal_values_at_timestampset(PG_FUNCTION_ARGS)
+{
+	TimestampSet *ts = PG_GETARG_TIMESTAMPSET(1);
+	Oid valuetypid = get_element_type(get_fn_expr_rettype(fcinfo->flinfo));
+	Temporal *temp = temporal_detoast_period(PG_GETARG_DATUM(0), 
+		timestampset_bbox(ts));
+	TimestampTz *times = timestampset_timestamps_internal(ts);
+	ArrayType *result = temporal_values_at_timestamps_internal(temp, 
+		valuetypid, times, ts->count);
+	if (temp != NULL)
+		PG_FREE_IF_COPY(temp, 0);
+	pfree(times);
+	PG_FREE_IF_COPY(ts, 1);
+	PG_RETURN_ARRAYTYPE_P(result);
+}
+
 PG_FUNCTION_INFO_V1(temporal_at_timestampset);
 /**
  * @brief Restricts the temporal value to a timestamp set
@@ -2993,15 +3568,13 @@ temporal_minus_timestampset(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
-PG_FUNCTION_INFO_V1(temporal_at_period);
 /**
  * @brief Restricts the temporal value to a period
+ *		(dispatch function)
  */
-PGDLLEXPORT Datum
-temporal_at_period(PG_FUNCTION_ARGS)
+Temporal *
+temporal_at_period_internal(Temporal *temp, Period *p)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	Period *p = PG_GETARG_PERIOD(1);
 	Temporal *result = NULL;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST) 
@@ -3016,6 +3589,21 @@ temporal_at_period(PG_FUNCTION_ARGS)
 	else if (temp->duration == TEMPORALS) 
 		result = (Temporal *)temporals_at_period(
 			(TemporalS *)temp, p);
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(temporal_at_period);
+/**
+ * @brief Restricts the temporal value to a period
+ */
+PGDLLEXPORT Datum
+temporal_at_period(PG_FUNCTION_ARGS)
+{
+	Period *p = PG_GETARG_PERIOD(1);
+	Temporal *temp = temporal_detoast_period(PG_GETARG_DATUM(0), p);
+	if (temp == NULL)
+		PG_RETURN_NULL();
+	Temporal *result = temporal_at_period_internal(temp, p);
 	PG_FREE_IF_COPY(temp, 0);
 	if (result == NULL)
 		PG_RETURN_NULL();	
@@ -3358,6 +3946,64 @@ temporal_cmp(PG_FUNCTION_ARGS)
 	PG_RETURN_INT32(result);
 }
 
+/**
+ * @brief Full comparison function used by the sort support
+ */
+static int
+temporal_sort_cmp(Datum x, Datum y, SortSupport ssup)
+{
+	Temporal *t1 = DatumGetTemporal(x);
+	Temporal *t2 = DatumGetTemporal(y);
+	int result = temporal_cmp_internal(t1, t2);
+	if ((Pointer) t1 != DatumGetPointer(x))
+		pfree(t1);
+	if ((Pointer) t2 != DatumGetPointer(y))
+		pfree(t2);
+	return result;
+}
+
+/**
+ * @brief Returns the abbreviated key of a temporal value, that is, the 
+ *		first component of its bounding box used by the comparison: the 
+ *		lower timestamp for temporal Booleans and texts and the minimum 
+ *		value for the other temporal types
+ */
+static Datum
+temporal_abbrev_convert(Datum original, SortSupport ssup)
+{
+	Temporal *temp = DatumGetTemporal(original);
+	union bboxunion box;
+	memset(&box, 0, sizeof(bboxunion));
+	temporal_bbox(&box, temp);
+	int64 key = 0;
+	if (temp->valuetypid == BOOLOID || temp->valuetypid == TEXTOID)
+		key = (int64) box.p.lower;
+	else if (temp->valuetypid == INT4OID || temp->valuetypid == FLOAT8OID)
+		key = double_abbrev_key(box.b.xmin);
+#ifdef WITH_POSTGIS
+	else if (temp->valuetypid == type_oid(T_GEOGRAPHY) || 
+		temp->valuetypid == type_oid(T_GEOMETRY))
+		key = double_abbrev_key(box.g.xmin);
+#endif
+	if ((Pointer) temp != DatumGetPointer(original))
+		pfree(temp);
+	return sortsupport_abbrev_key(key, ssup);
+}
+
+PG_FUNCTION_INFO_V1(temporal_sortsupport);
+/**
+ * @brief Sort support for the B-tree operator classes of temporal types.
+ *		The leading component of the bounding box is used as abbreviated 
+ *		key so that most comparisons avoid detoasting both values.
+ */
+PGDLLEXPORT Datum
+temporal_sortsupport(PG_FUNCTION_ARGS)
+{
+	SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+	sortsupport_abbrev_init(ssup, temporal_sort_cmp, temporal_abbrev_convert);
+	PG_RETURN_VOID();
+}
+
 /**
  * @brief Returns true if the two temporal values are equal 
  *		(internal function). The internal B-tree comparator 
@@ -3579,23 +4225,37 @@ temporal_gt(PG_FUNCTION_ARGS)
  *****************************************************************************/
 
 /**
- * @brief Returns the hash value of the temporal value
+ * @brief Returns the 64-bit hash value of the temporal value using a seed
  *		(dispatch function)
+ * @note The hash only depends on the sequence of instants and on the bounds 
+ *		of the non-instantaneous sequences so that values of different 
+ *		duration that are equal have the same hash value
  */
-uint32 
-temporal_hash_internal(const Temporal *temp)
+uint64 
+temporal_hash_extended_internal(const Temporal *temp, uint64 seed)
 {
-	uint32 result = 0;
+	uint64 state = hash64_init(seed);
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST)
-		result = temporalinst_hash((TemporalInst *)temp);
+		state = temporalinst_hash_update(state, (TemporalInst *)temp);
 	else if (temp->duration == TEMPORALI)
-		result = temporali_hash((TemporalI *)temp);
+		state = temporali_hash_update(state, (TemporalI *)temp);
 	else if (temp->duration == TEMPORALSEQ)
-		result = temporalseq_hash((TemporalSeq *)temp);
+		state = temporalseq_hash_update(state, (TemporalSeq *)temp);
 	else if (temp->duration == TEMPORALS)
-		result = temporals_hash((TemporalS *)temp);
-	return result;
+		state = temporals_hash_update(state, (TemporalS *)temp);
+	return hash64_finish(state);
+}
+
+/**
+ * @brief Returns the hash value of the temporal value. The value is the 
+ *		lower 32 bits of the extended hash value with seed 0, as required 
+ *		by PostgreSQL.
+ */
+uint32 
+temporal_hash_internal(const Temporal *temp)
+{
+	return (uint32) temporal_hash_extended_internal(temp, 0);
 }
 
 PG_FUNCTION_INFO_V1(temporal_hash);
@@ -3611,4 +4271,18 @@ temporal_hash(PG_FUNCTION_ARGS)
 	PG_RETURN_UINT32(result);
 }
 
+PG_FUNCTION_INFO_V1(temporal_hash_extended);
+/**
+ * @brief Returns the 64-bit hash value of the temporal value using a seed
+ */
+PGDLLEXPORT Datum 
+temporal_hash_extended(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	uint64 seed = PG_GETARG_INT64(1);
+	uint64 result = temporal_hash_extended_internal(temp, seed);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_UINT64(result);
+}
+
 /*****************************************************************************/
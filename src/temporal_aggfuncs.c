@@ -15,8 +15,13 @@
 #include <assert.h>
 #include <math.h>
 #include <strings.h>
+#include <access/xact.h>
 #include <catalog/pg_collation.h>
+#include <commands/tablespace.h>
+#include <lib/binaryheap.h>
 #include <libpq/pqformat.h>
+#include <miscadmin.h>
+#include <utils/memutils.h>
 #include <utils/timestamp.h>
 #include <executor/spi.h>
 
@@ -201,32 +206,39 @@ random_level()
 	return ffsl(~(random() & ((1l << SKIPLIST_MAXLEVEL) - 1)));
 }
 
-SkipList *
-skiplist_make(FunctionCallInfo fcinfo, Temporal **values, int count)
+/*
+ * Initialize the skip list with the values. The fields keeping the spilled
+ * runs and the extra data are preserved.
+ */
+static void
+skiplist_init(SkipList *list, Temporal **values, int count)
 {
 	assert(count > 0);
 	//FIXME: tail should be a constant (e.g. 1) but is not, for ease of construction
 
-	MemoryContext oldctx = set_aggregation_context(fcinfo);
 	int capacity = SKIPLIST_INITIAL_CAPACITY;
 	count += 2; /* Account for head and tail */
 	while (capacity <= count)
 		capacity <<= 1;
-	SkipList *result = palloc0(sizeof(SkipList));
-	result->elems = palloc0(sizeof(Elem) * capacity);
+	list->elems = palloc0(sizeof(Elem) * capacity);
 	int height = (int) ceil(log2(count - 1));
-	result->capacity = capacity;
-	result->next = count;
-	result->length = count - 2;
-	result->extra = NULL;
-	result->extrasize = 0;
+	list->capacity = capacity;
+	list->next = count;
+	list->length = count - 2;
+	list->freed = NULL;
+	list->freecount = 0;
+	list->freecap = 0;
+	list->memsize = 0;
 
 	/* Fill values first */
-	result->elems[0].value = NULL;
+	list->elems[0].value = NULL;
 	for (int i = 0; i < count - 2; i ++)
-		result->elems[i + 1].value = temporal_copy(values[i]);
-	result->elems[count - 1].value = NULL;
-	result->tail = count - 1;
+	{
+		list->elems[i + 1].value = temporal_copy(values[i]);
+		list->memsize += VARSIZE(values[i]);
+	}
+	list->elems[count - 1].value = NULL;
+	list->tail = count - 1;
 
 	/* Link the list in a balanced fashion */
 	for (int level = 0; level < height; level ++)
@@ -237,16 +249,27 @@ skiplist_make(FunctionCallInfo fcinfo, Temporal **values, int count)
 			int next = i + step < count ? i + step : count - 1;
 			if (i != count - 1)
 			{
-				result->elems[i].next[level] = next;
-				result->elems[i].height = level + 1;
+				list->elems[i].next[level] = next;
+				list->elems[i].height = level + 1;
 			}
 			else
 			{
-				result->elems[i].next[level] = - 1;
-				result->elems[i].height = height;
+				list->elems[i].next[level] = - 1;
+				list->elems[i].height = height;
 			}
 		}
 	}
+}
+
+SkipList *
+skiplist_make(FunctionCallInfo fcinfo, Temporal **values, int count)
+{
+	MemoryContext oldctx = set_aggregation_context(fcinfo);
+	SkipList *result = palloc0(sizeof(SkipList));
+	result->extra = NULL;
+	result->extrasize = 0;
+	result->spill = NULL;
+	skiplist_init(result, values, count);
 	unset_aggregation_context(oldctx);
 	return result;
 }
@@ -285,10 +308,153 @@ skiplist_values(SkipList *list)
 	return result;
 }
 
+/*****************************************************************************
+ * Spilling of skip lists to disk
+ *
+ * When the memory used by the skip list exceeds work_mem, its values, which
+ * are ordered and disjoint, are written as a run to a temporary file and the
+ * list restarts from the new values. Combining two states moves the runs of
+ * one state to the other without reading them. When the state is finalized
+ * or serialized, the runs and the values of the list are merged in a single
+ * pass directly into the resulting array. Since the result of the 
+ * aggregation is a single temporal value it must fit in memory, but neither
+ * the transition state nor the merge need more memory than the budget in
+ * addition to the result.
+ *
+ * The runs are not consumed by the merge. A window aggregate, whose final
+ * function is called for every row, reads the runs again at every call but
+ * never writes a value more than once.
+ *****************************************************************************/
+
+static size_t
+skiplist_memsize(SkipList *list)
+{
+	return list->memsize + sizeof(Elem) * list->length;
+}
+
+static void
+skiplist_file_write(BufFile *file, void *ptr, size_t size)
+{
+	if (BufFileWrite(file, ptr, size) != size)
+		ereport(ERROR, (errcode_for_file_access(),
+			errmsg("could not write to temporal aggregate temporary file: %m")));
+}
+
+static void
+skiplist_file_read(BufFile *file, void *ptr, size_t size)
+{
+	if (BufFileRead(file, ptr, size) != size)
+		ereport(ERROR, (errcode_for_file_access(),
+			errmsg("could not read from temporal aggregate temporary file: %m")));
+}
+
+/* Read a temporal value written with its varlena header */
+
+static Temporal *
+skiplist_file_read_value(BufFile *file)
+{
+	uint32 header;
+	skiplist_file_read(file, &header, sizeof(uint32));
+	size_t size = VARSIZE(&header);
+	Temporal *result = palloc(size);
+	memcpy(result, &header, sizeof(uint32));
+	skiplist_file_read(file, ((char *) result) + sizeof(uint32), 
+		size - sizeof(uint32));
+	return result;
+}
+
+/*
+ * Close the temporary file when the aggregation context is reset. This is
+ * needed for the states that are discarded without being finalized,
+ * serialized or combined, e.g., when the query is interrupted by a LIMIT.
+ * When the transaction is aborting the file has already been closed by the
+ * resource owner and must not be closed again.
+ */
+static void
+skiplist_spill_close(void *arg)
+{
+	SkipListSpill *spill = (SkipListSpill *) arg;
+	if (IsTransactionState())
+	{
+		for (int i = 0; i < spill->count; i++)
+			BufFileClose(spill->files[i]);
+	}
+	spill->count = 0;
+}
+
+/* Make the spill of a list, which must be in the aggregation context */
+
+static SkipListSpill *
+skiplist_spill_make(void)
+{
+	SkipListSpill *result = palloc(sizeof(SkipListSpill));
+	result->maxcount = 8;
+	result->count = 0;
+	result->files = palloc(sizeof(BufFile *) * result->maxcount);
+	result->lengths = palloc(sizeof(int) * result->maxcount);
+	result->callback.func = skiplist_spill_close;
+	result->callback.arg = result;
+	MemoryContextRegisterResetCallback(CurrentMemoryContext, 
+		&result->callback);
+	return result;
+}
+
+static void
+skiplist_spill_add(SkipListSpill *spill, BufFile *file, int length)
+{
+	if (spill->count == spill->maxcount)
+	{
+		spill->maxcount *= 2;
+		spill->files = repalloc(spill->files, 
+			sizeof(BufFile *) * spill->maxcount);
+		spill->lengths = repalloc(spill->lengths, 
+			sizeof(int) * spill->maxcount);
+	}
+	spill->files[spill->count] = file;
+	spill->lengths[spill->count++] = length;
+}
+
+/* Write the values of the list as a run and restart it from the new values */
+
+static void
+skiplist_spill(FunctionCallInfo fcinfo, SkipList *list, Temporal **values, 
+	int count)
+{
+	MemoryContext ctx = set_aggregation_context(fcinfo);
+	if (list->spill == NULL)
+		list->spill = skiplist_spill_make();
+	/* Honor temp_tablespaces as the executor does for its own files */
+	PrepareTempTablespaces();
+	BufFile *file = BufFileCreateTemp(false);
+	skiplist_spill_add(list->spill, file, list->length);
+	int cur = list->elems[0].next[0];
+	while (cur != list->tail)
+	{
+		Temporal *value = list->elems[cur].value;
+		skiplist_file_write(file, value, VARSIZE(value));
+		pfree(value);
+		cur = list->elems[cur].next[0];
+	}
+	pfree(list->elems);
+	if (list->freed)
+		pfree(list->freed);
+	skiplist_init(list, values, count);
+	unset_aggregation_context(ctx);
+}
+
 void
 skiplist_splice(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
 	int count, Datum (*func)(Datum, Datum), bool crossings)
 {
+	list->func = func;
+	list->crossings = crossings;
+	/* Spill the list to disk when it exceeds the memory budget */
+	if (skiplist_memsize(list) > (size_t) work_mem * 1024L)
+	{
+		skiplist_spill(fcinfo, list, values, count);
+		return;
+	}
+
 	/*
 	 * O(count*log(n)) average (unless I'm mistaken)
 	 * O(n+count*log(n)) worst case (when period spans the whole list so everything has to be deleted) 
@@ -381,7 +547,10 @@ skiplist_splice(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
 		count = newcount;
 		/* We need to delete the spliced-out temporal values */
 		for (int i = 0; i < spliced_count; i ++)
+		{
+			list->memsize -= VARSIZE(spliced[i]);
 			pfree(spliced[i]);
+		}
 		pfree(spliced);
 	}
 
@@ -402,6 +571,7 @@ skiplist_splice(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
 		MemoryContext ctx = set_aggregation_context(fcinfo);
 		newelm->value = temporal_copy(values[i]);
 		unset_aggregation_context(ctx);
+		list->memsize += VARSIZE(newelm->value);
 		newelm->height = rheight;
 
 		for (int level = 0; level < rheight; level ++)
@@ -426,6 +596,210 @@ skiplist_splice(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
 	}
 }
 
+/*
+ * Move the runs spilled to disk by the source list to the destination list
+ * without reading them. The runs are only merged when the destination list
+ * is finalized or serialized.
+ */
+static void
+skiplist_move_spill(FunctionCallInfo fcinfo, SkipList *dest, SkipList *src)
+{
+	SkipListSpill *spill = src->spill;
+	if (spill == NULL || spill->count == 0)
+		return;
+	MemoryContext ctx = set_aggregation_context(fcinfo);
+	if (dest->spill == NULL)
+		dest->spill = skiplist_spill_make();
+	for (int i = 0; i < spill->count; i++)
+		skiplist_spill_add(dest->spill, spill->files[i], spill->lengths[i]);
+	/* The files are now closed by the destination list */
+	spill->count = 0;
+	unset_aggregation_context(ctx);
+}
+
+/* Cursor over a run spilled to disk or over the values of the list */
+
+typedef struct
+{
+	SkipList *list;
+	BufFile *file;				/* NULL for the values of the list */
+	int remaining;				/* number of values not yet read */
+	int cur;					/* next element of the list */
+	Temporal *value;			/* current value */
+} SkipListCursor;
+
+static bool
+skiplist_cursor_next(SkipListCursor *cursor)
+{
+	if (cursor->remaining == 0)
+		return false;
+	cursor->remaining--;
+	if (cursor->file != NULL)
+		cursor->value = skiplist_file_read_value(cursor->file);
+	else
+	{
+		SkipList *list = cursor->list;
+		cursor->value = temporal_copy(list->elems[cursor->cur].value);
+		cursor->cur = list->elems[cursor->cur].next[0];
+	}
+	return true;
+}
+
+/* Compare the start of two values, which have the same duration */
+
+static int
+skiplist_value_cmp(Temporal *value1, Temporal *value2)
+{
+	if (value1->duration == TEMPORALINST)
+		return timestamp_cmp_internal(((TemporalInst *)value1)->t,
+			((TemporalInst *)value2)->t);
+	Period *p1 = &((TemporalSeq *)value1)->period;
+	Period *p2 = &((TemporalSeq *)value2)->period;
+	return period_cmp_bounds(p1->lower, p2->lower, true, true,
+		p1->lower_inc, p2->lower_inc);
+}
+
+/* The binary heap keeps the largest element first, hence the inversion */
+
+static int
+skiplist_cursor_cmp(Datum a, Datum b, void *arg)
+{
+	SkipListCursor *cursor1 = (SkipListCursor *) DatumGetPointer(a);
+	SkipListCursor *cursor2 = (SkipListCursor *) DatumGetPointer(b);
+	return skiplist_value_cmp(cursor2->value, cursor1->value);
+}
+
+/* Determine whether the first value ends before the start of the second */
+
+static bool
+skiplist_value_before(Temporal *value1, Temporal *value2)
+{
+	if (value1->duration == TEMPORALINST)
+		return timestamp_cmp_internal(((TemporalInst *)value1)->t,
+			((TemporalInst *)value2)->t) < 0;
+	Period *p1 = &((TemporalSeq *)value1)->period;
+	Period *p2 = &((TemporalSeq *)value2)->period;
+	return period_cmp_bounds(p1->upper, p2->lower, false, true,
+		p1->upper_inc, p2->lower_inc) < 0;
+}
+
+static void
+skiplist_result_append(Temporal ***result, int *count, int *maxcount,
+	Temporal *value)
+{
+	if (*count == *maxcount)
+	{
+		*maxcount *= 2;
+		*result = repalloc(*result, sizeof(Temporal *) * *maxcount);
+	}
+	(*result)[(*count)++] = value;
+}
+
+/*
+ * Return the ordered and disjoint values of the list and of the runs it
+ * spilled to disk. The runs, which are ordered by time, are merged in a
+ * single pass directly into the resulting array. Only the current value of
+ * each run and the aggregated values that may overlap the values still to
+ * be read are kept outside of the result. The runs are left untouched, so
+ * that the transition function may still be called after the final
+ * function in a window aggregate. The values must not be freed 
+ * individually by the calling function.
+ */
+static Temporal **
+skiplist_merge(SkipList *list, int *count)
+{
+	SkipListSpill *spill = list->spill;
+	if (spill == NULL || spill->count == 0)
+	{
+		*count = list->length;
+		return skiplist_values(list);
+	}
+
+	int ncursors = spill->count + 1;
+	SkipListCursor *cursors = palloc(sizeof(SkipListCursor) * ncursors);
+	binaryheap *heap = binaryheap_allocate(ncursors, skiplist_cursor_cmp, NULL);
+	int total = list->length;
+	for (int i = 0; i < ncursors; i++)
+	{
+		SkipListCursor *cursor = &cursors[i];
+		cursor->list = list;
+		if (i < spill->count)
+		{
+			cursor->file = spill->files[i];
+			cursor->remaining = spill->lengths[i];
+			total += spill->lengths[i];
+			if (BufFileSeek(cursor->file, 0, 0L, SEEK_SET) != 0)
+				ereport(ERROR, (errcode_for_file_access(),
+					errmsg("could not rewind temporal aggregate temporary file: %m")));
+		}
+		else
+		{
+			cursor->file = NULL;
+			cursor->remaining = list->length;
+			cursor->cur = list->elems[0].next[0];
+		}
+		if (skiplist_cursor_next(cursor))
+			binaryheap_add_unordered(heap, PointerGetDatum(cursor));
+	}
+	binaryheap_build(heap);
+
+	int maxcount = total;
+	Temporal **result = palloc(sizeof(Temporal *) * maxcount);
+	int maxpending = 64;
+	Temporal **pending = palloc(sizeof(Temporal *) * maxpending);
+	int npending = 0;
+	*count = 0;
+	while (!binaryheap_empty(heap))
+	{
+		SkipListCursor *cursor = (SkipListCursor *) 
+			DatumGetPointer(binaryheap_first(heap));
+		Temporal *value = cursor->value;
+		if (skiplist_cursor_next(cursor))
+			binaryheap_replace_first(heap, PointerGetDatum(cursor));
+		else
+			binaryheap_remove_first(heap);
+
+		/* The pending values before the current one are final */
+		int i = 0;
+		while (i < npending && skiplist_value_before(pending[i], value))
+			skiplist_result_append(&result, count, &maxcount, pending[i++]);
+		npending -= i;
+		memmove(pending, &pending[i], sizeof(Temporal *) * npending);
+
+		if (npending == 0)
+		{
+			pending[npending++] = value;
+			continue;
+		}
+		int newcount;
+		Temporal **newpending;
+		if (value->duration == TEMPORALINST)
+			newpending = (Temporal **)temporalinst_tagg((TemporalInst **)pending,
+				npending, (TemporalInst **)&value, 1, list->func, &newcount);
+		else
+			newpending = (Temporal **)temporalseq_tagg((TemporalSeq **)pending,
+				npending, (TemporalSeq **)&value, 1, list->func, list->crossings,
+				&newcount);
+		for (int j = 0; j < npending; j++)
+			pfree(pending[j]);
+		pfree(value);
+		if (newcount > maxpending)
+		{
+			maxpending = newcount * 2;
+			pending = repalloc(pending, sizeof(Temporal *) * maxpending);
+		}
+		memcpy(pending, newpending, sizeof(Temporal *) * newcount);
+		npending = newcount;
+		pfree(newpending);
+	}
+	for (int i = 0; i < npending; i++)
+		skiplist_result_append(&result, count, &maxcount, pending[i]);
+	pfree(pending);
+	binaryheap_free(heap);
+	pfree(cursors);
+	return result;
+}
+
 PG_FUNCTION_INFO_V1(sl_test);
 PGDLLEXPORT Datum
 sl_test(PG_FUNCTION_ARGS)
@@ -526,15 +900,16 @@ datum_sum_double4(Datum l, Datum r)
  *****************************************************************************/
 
 static void 
-aggstate_write(SkipList *state, StringInfo buf)
+aggstate_write(FunctionCallInfo fcinfo, SkipList *state, StringInfo buf)
 {
-	Temporal **values = skiplist_values(state);
-	pq_sendint32(buf, (uint32) state->length);
+	int count;
+	Temporal **values = skiplist_merge(state, &count);
+	pq_sendint32(buf, (uint32) count);
 	Oid valuetypid = InvalidOid;
-	if (state->length > 0)
+	if (count > 0)
 		valuetypid = values[0]->valuetypid;
 	pq_sendint32(buf, valuetypid);
-	for (int i = 0; i < state->length; i ++)
+	for (int i = 0; i < count; i ++)
 	{
 		SPI_connect();
 		temporal_write(values[i], buf);
@@ -551,18 +926,41 @@ aggstate_read(FunctionCallInfo fcinfo, StringInfo buf)
 {
 	int size = pq_getmsgint(buf, 4);
 	Oid valuetypid = pq_getmsgint(buf, 4);
+	/*
+	 * The values are read in chunks bounded by work_mem. Since they are 
+	 * ordered and disjoint, every chunk is spliced after the end of the list,
+	 * which spills to disk when it exceeds the memory budget.
+	 */
+	size_t budget = (size_t) work_mem * 1024L;
 	Temporal **values = palloc0(sizeof(Temporal *) * size);
+	SkipList *result = NULL;
+	int count = 0;
+	size_t chunksize = 0;
 	for (int i = 0; i < size; i ++)
-		values[i] = temporal_read(buf, valuetypid);
-	SkipList *result = skiplist_make(fcinfo, values, size);
+	{
+		values[count] = temporal_read(buf, valuetypid);
+		chunksize += VARSIZE(values[count++]);
+		if (i == size - 1 || chunksize >= budget)
+		{
+			if (result == NULL)
+				result = skiplist_make(fcinfo, values, count);
+			else
+				skiplist_splice(fcinfo, result, values, count, result->func,
+					result->crossings);
+			for (int j = 0; j < count; j ++)
+				pfree(values[j]);
+			count = 0;
+			chunksize = 0;
+		}
+	}
+	if (result == NULL)
+		result = skiplist_make(fcinfo, values, 0);
 	size_t extrasize = (size_t) pq_getmsgint64(buf);
 	if (extrasize)
 	{
 		const char *extra = pq_getmsgbytes(buf, (int) extrasize);
 		aggstate_set_extra(fcinfo, result, (void *)extra, extrasize);
 	}
-	for (int i = 0; i < size; i ++)
-		pfree(values[i]);
 	pfree(values);
 	return result;
 }
@@ -588,7 +986,7 @@ temporal_tagg_serialize(PG_FUNCTION_ARGS)
 	SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
 	StringInfoData buf;
 	pq_begintypsend(&buf);
-	aggstate_write(state, &buf);
+	aggstate_write(fcinfo, state, &buf);
 	PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
 }
 
@@ -1201,6 +1599,7 @@ temporal_tagg_combinefn(FunctionCallInfo fcinfo, SkipList *state1,
 	Temporal **values2 = skiplist_values(state2);
 	skiplist_splice(fcinfo, state1, values2, count2, func, crossings);
 	pfree(values2);
+	skiplist_move_spill(fcinfo, state1, state2);
 	return state1;
 }
 
@@ -1797,16 +2196,17 @@ temporal_tagg_finalfn(PG_FUNCTION_ARGS)
 	if (state->length == 0)
 		PG_RETURN_NULL();
 
-	Temporal **values = skiplist_values(state);
+	int count;
+	Temporal **values = skiplist_merge(state, &count);
 	Temporal *result = NULL;
 	assert(values[0]->duration == TEMPORALINST ||
 		values[0]->duration == TEMPORALSEQ);
 	if (values[0]->duration == TEMPORALINST)
 		result = (Temporal *)temporali_from_temporalinstarr(
-			(TemporalInst **)values, state->length);
+			(TemporalInst **)values, count);
 	else if (values[0]->duration == TEMPORALSEQ)
 		result = (Temporal *)temporals_from_temporalseqarr(
-			(TemporalSeq **)values, state->length,
+			(TemporalSeq **)values, count,
 			MOBDB_FLAGS_GET_LINEAR(values[0]->flags), true);
 	pfree(values);
 	PG_RETURN_POINTER(result);
@@ -1941,18 +2341,453 @@ tnumber_tavg_finalfn(PG_FUNCTION_ARGS)
 	if (state->length == 0)
 		PG_RETURN_NULL();
 
-	Temporal **values = skiplist_values(state);
+	int count;
+	Temporal **values = skiplist_merge(state, &count);
 	Temporal *result = NULL;
 	assert(values[0]->duration == TEMPORALINST || 
 		values[0]->duration == TEMPORALSEQ);
 	if (values[0]->duration == TEMPORALINST)
 		result = (Temporal *)temporalinst_tavg_finalfn(
-			(TemporalInst **)values, state->length);
+			(TemporalInst **)values, count);
 	else if (values[0]->duration == TEMPORALSEQ)
 		result = (Temporal *)temporalseq_tavg_finalfn(
-			(TemporalSeq **)values, state->length);
+			(TemporalSeq **)values, count);
 	pfree(values);
 	PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Binned aggregate functions
+ *
+ * The time line is split into buckets of a fixed width starting at an 
+ * origin, bucket i covering [origin + i * width, origin + (i + 1) * width).
+ * The state is a dense array with one entry per bucket between the first
+ * and the last bucket touched, so that every value is aggregated in time
+ * proportional to its number of instants and of buckets it overlaps.
+ * For each bucket, the count is the number of values overlapping it and 
+ * the sum is the sum over these values of their time-weighted average in 
+ * the bucket.
+ *****************************************************************************/
+
+#define BINAGG_INITIAL_CAPACITY 64
+#define BINAGG_MAX_BUCKETS ((int) (MaxAllocSize / sizeof(BinAggBucket)))
+
+typedef struct
+{
+	double sum;
+	int64 count;
+} BinAggBucket;
+
+typedef struct
+{
+	TimestampTz origin;
+	int64 width;
+	int64 first;			/* number of the first bucket of the array */
+	int count;				/* number of buckets of the array */
+	int capacity;
+	BinAggBucket *buckets;
+} BinAggState;
+
+/* Contribution of the current value to the bucket being scanned */
+typedef struct
+{
+	bool active;
+	int64 bucket;
+	double integral;
+	double duration;
+	double instsum;
+	int instcount;
+} BinAggAccum;
+
+/* Number of the bucket containing the timestamp */
+static int64
+binagg_bucket(BinAggState *state, TimestampTz t)
+{
+	return timestamp_bucket(t, state->origin, state->width);
+}
+
+static TimestampTz
+binagg_bucket_start(BinAggState *state, int64 bucket)
+{
+	return state->origin + bucket * state->width;
+}
+
+static BinAggState *
+binagg_state_make(FunctionCallInfo fcinfo, TimestampTz origin, int64 width, 
+	int capacity)
+{
+	MemoryContext ctx;
+	if (!AggCheckCallContext(fcinfo, &ctx))
+		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+				errmsg("Operation not supported")));
+	BinAggState *result = MemoryContextAllocZero(ctx, sizeof(BinAggState));
+	result->origin = origin;
+	result->width = width;
+	result->capacity = Max(capacity, BINAGG_INITIAL_CAPACITY);
+	result->buckets = MemoryContextAllocZero(ctx, 
+		sizeof(BinAggBucket) * result->capacity);
+	return result;
+}
+
+/* Extend the array of the state so that it contains the given buckets */
+static void
+binagg_state_extend(BinAggState *state, int64 lower, int64 upper)
+{
+	if (state->count == 0)
+		state->first = lower;
+	int64 first = Min(lower, state->first);
+	int64 last = Max(upper, state->first + state->count - 1);
+	if (last - first + 1 > BINAGG_MAX_BUCKETS)
+		ereport(ERROR, (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+			errmsg("Too many buckets for the binned aggregation")));
+	int count = (int) (last - first + 1);
+	if (count > state->capacity)
+	{
+		while (count > state->capacity)
+			state->capacity = (int) Min((int64) state->capacity * 2, 
+				BINAGG_MAX_BUCKETS);
+		/* repalloc keeps the chunk in the aggregate context */
+		state->buckets = repalloc(state->buckets, 
+			sizeof(BinAggBucket) * state->capacity);
+	}
+	int shift = (int) (state->first - first);
+	if (shift > 0 && state->count > 0)
+		memmove(&state->buckets[shift], state->buckets, 
+			sizeof(BinAggBucket) * state->count);
+	memset(state->buckets, 0, sizeof(BinAggBucket) * shift);
+	memset(&state->buckets[shift + state->count], 0, 
+		sizeof(BinAggBucket) * (count - shift - state->count));
+	state->first = first;
+	state->count = count;
+}
+
+/* Add the contribution of the current value to the bucket being scanned */
+static void
+binagg_flush(BinAggState *state, BinAggAccum *accum)
+{
+	if (! accum->active)
+		return;
+	binagg_state_extend(state, accum->bucket, accum->bucket);
+	BinAggBucket *bucket = &state->buckets[accum->bucket - state->first];
+	bucket->count++;
+	if (accum->duration > 0)
+		bucket->sum += accum->integral / accum->duration;
+	else if (accum->instcount > 0)
+		bucket->sum += accum->instsum / accum->instcount;
+	memset(accum, 0, sizeof(BinAggAccum));
+}
+
+static void
+binagg_touch(BinAggState *state, BinAggAccum *accum, int64 bucket)
+{
+	if (accum->active && accum->bucket == bucket)
+		return;
+	binagg_flush(state, accum);
+	accum->active = true;
+	accum->bucket = bucket;
+}
+
+static void
+temporalinst_binagg(BinAggState *state, BinAggAccum *accum, 
+	TemporalInst *inst, bool values)
+{
+	binagg_touch(state, accum, binagg_bucket(state, inst->t));
+	if (values)
+	{
+		accum->instsum += datum_double(temporalinst_value(inst), 
+			inst->valuetypid);
+		accum->instcount++;
+	}
+}
+
+static void
+temporalseq_binagg(BinAggState *state, BinAggAccum *accum, 
+	TemporalSeq *seq, bool values)
+{
+	if (seq->count == 1)
+	{
+		temporalinst_binagg(state, accum, temporalseq_inst_n(seq, 0), values);
+		return;
+	}
+
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
+	double value1 = values ? 
+		datum_double(temporalinst_value(inst1), inst1->valuetypid) : 0;
+	for (int i = 1; i < seq->count; i++)
+	{
+		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
+		double value2 = values ? 
+			datum_double(temporalinst_value(inst2), inst2->valuetypid) : 0;
+		double duration = (double) (inst2->t - inst1->t);
+		/* Split the segment at the bucket boundaries */
+		int64 bucket = binagg_bucket(state, inst1->t);
+		TimestampTz lower = inst1->t;
+		while (true)
+		{
+			TimestampTz end = binagg_bucket_start(state, bucket + 1);
+			TimestampTz upper = Min(end, inst2->t);
+			binagg_touch(state, accum, bucket);
+			if (values)
+			{
+				double length = (double) (upper - lower);
+				if (linear)
+				{
+					double lowervalue = value1 + (value2 - value1) * 
+						((double) (lower - inst1->t) / duration);
+					double uppervalue = value1 + (value2 - value1) * 
+						((double) (upper - inst1->t) / duration);
+					accum->integral += (lowervalue + uppervalue) / 2 * length;
+				}
+				else
+					accum->integral += value1 * length;
+				accum->duration += length;
+			}
+			if (inst2->t <= end)
+				break;
+			lower = end;
+			bucket++;
+		}
+		inst1 = inst2;
+		value1 = value2;
+	}
+	/* An inclusive upper bound starting a bucket overlaps it in an instant */
+	if (seq->period.upper_inc && 
+		binagg_bucket_start(state, binagg_bucket(state, seq->period.upper)) ==
+			seq->period.upper)
+	{
+		binagg_touch(state, accum, binagg_bucket(state, seq->period.upper));
+		if (values)
+		{
+			accum->instsum += value1;
+			accum->instcount++;
+		}
+	}
+}
+
+/* Add a temporal value to the state */
+static void
+temporal_binagg(BinAggState *state, Temporal *temp, bool values)
+{
+	BinAggAccum accum;
+	memset(&accum, 0, sizeof(BinAggAccum));
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST) 
+		temporalinst_binagg(state, &accum, (TemporalInst *)temp, values);
+	else if (temp->duration == TEMPORALI) 
+	{
+		TemporalI *ti = (TemporalI *)temp;
+		for (int i = 0; i < ti->count; i++)
+			temporalinst_binagg(state, &accum, temporali_inst_n(ti, i), values);
+	}
+	else if (temp->duration == TEMPORALSEQ) 
+		temporalseq_binagg(state, &accum, (TemporalSeq *)temp, values);
+	else if (temp->duration == TEMPORALS) 
+	{
+		TemporalS *ts = (TemporalS *)temp;
+		for (int i = 0; i < ts->count; i++)
+			temporalseq_binagg(state, &accum, temporals_seq_n(ts, i), values);
+	}
+	binagg_flush(state, &accum);
+}
+
+static Datum
+temporal_bins_transfn1(FunctionCallInfo fcinfo, bool values)
+{
+	BinAggState *state = PG_ARGISNULL(0) ? NULL : 
+		(BinAggState *) PG_GETARG_POINTER(0);
+	if (PG_ARGISNULL(1) || PG_ARGISNULL(2) || PG_ARGISNULL(3))
+	{
+		if (state)
+			PG_RETURN_POINTER(state);
+		else
+			PG_RETURN_NULL();
+	}
+	Temporal *temp = PG_GETARG_TEMPORAL(1);
+	TimestampTz origin = PG_GETARG_TIMESTAMPTZ(2);
+	int64 width = interval_width(PG_GETARG_INTERVAL_P(3));
+	if (! state)
+		state = binagg_state_make(fcinfo, origin, width, 0);
+	else if (state->origin != origin || state->width != width)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The origin and the interval must be the same for all values of the aggregation")));
+	temporal_binagg(state, temp, values);
+	PG_FREE_IF_COPY(temp, 1);
+	PG_RETURN_POINTER(state);
+}
+
+PG_FUNCTION_INFO_V1(temporal_tcount_bins_transfn);
+
+PGDLLEXPORT Datum
+temporal_tcount_bins_transfn(PG_FUNCTION_ARGS)
+{
+	return temporal_bins_transfn1(fcinfo, false);
+}
+
+PG_FUNCTION_INFO_V1(tnumber_tsum_bins_transfn);
+
+PGDLLEXPORT Datum
+tnumber_tsum_bins_transfn(PG_FUNCTION_ARGS)
+{
+	return temporal_bins_transfn1(fcinfo, true);
+}
+
+PG_FUNCTION_INFO_V1(temporal_bins_combinefn);
+
+PGDLLEXPORT Datum
+temporal_bins_combinefn(PG_FUNCTION_ARGS)
+{
+	BinAggState *state1 = PG_ARGISNULL(0) ? NULL : 
+		(BinAggState *) PG_GETARG_POINTER(0);
+	BinAggState *state2 = PG_ARGISNULL(1) ? NULL :
+		(BinAggState *) PG_GETARG_POINTER(1);
+	if (! state1 && ! state2)
+		PG_RETURN_NULL();
+	if (! state2 || state2->count == 0)
+		PG_RETURN_POINTER(state1);
+	if (! state1 || state1->count == 0)
+		PG_RETURN_POINTER(state2);
+	if (state1->origin != state2->origin || state1->width != state2->width)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The origin and the interval must be the same for all values of the aggregation")));
+
+	binagg_state_extend(state1, state2->first, 
+		state2->first + state2->count - 1);
+	BinAggBucket *buckets = &state1->buckets[state2->first - state1->first];
+	for (int i = 0; i < state2->count; i++)
+	{
+		buckets[i].sum += state2->buckets[i].sum;
+		buckets[i].count += state2->buckets[i].count;
+	}
+	PG_RETURN_POINTER(state1);
+}
+
+PG_FUNCTION_INFO_V1(temporal_bins_serialize);
+
+PGDLLEXPORT Datum
+temporal_bins_serialize(PG_FUNCTION_ARGS)
+{
+	BinAggState *state = (BinAggState *) PG_GETARG_POINTER(0);
+	StringInfoData buf;
+	pq_begintypsend(&buf);
+	pq_sendint64(&buf, (uint64) state->origin);
+	pq_sendint64(&buf, (uint64) state->width);
+	pq_sendint64(&buf, (uint64) state->first);
+	pq_sendint32(&buf, (uint32) state->count);
+	for (int i = 0; i < state->count; i++)
+	{
+		pq_sendfloat8(&buf, state->buckets[i].sum);
+		pq_sendint64(&buf, (uint64) state->buckets[i].count);
+	}
+	PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
+}
+
+PG_FUNCTION_INFO_V1(temporal_bins_deserialize);
+
+PGDLLEXPORT Datum
+temporal_bins_deserialize(PG_FUNCTION_ARGS)
+{
+	bytea *data = PG_GETARG_BYTEA_P(0);
+	StringInfoData buf =
+	{
+		.cursor = 0,
+		.data = VARDATA(data),
+		.len = VARSIZE(data) - VARHDRSZ,
+		.maxlen = VARSIZE(data) - VARHDRSZ
+	};
+	TimestampTz origin = (TimestampTz) pq_getmsgint64(&buf);
+	int64 width = pq_getmsgint64(&buf);
+	int64 first = pq_getmsgint64(&buf);
+	int count = pq_getmsgint(&buf, 4);
+	BinAggState *result = binagg_state_make(fcinfo, origin, width, count);
+	result->first = first;
+	result->count = count;
+	for (int i = 0; i < count; i++)
+	{
+		result->buckets[i].sum = pq_getmsgfloat8(&buf);
+		result->buckets[i].count = pq_getmsgint64(&buf);
+	}
+	pq_getmsgend(&buf);
+	PG_RETURN_POINTER(result);
+}
+
+typedef enum
+{
+	BINAGG_COUNT,
+	BINAGG_SUM,
+	BINAGG_AVG
+} BinAggKind;
+
+/* 
+ * Returns a temporal instant set with one instant at the start of each 
+ * bucket overlapped by at least one value, or NULL if there is none
+ */
+static TemporalI *
+temporal_bins_finalfn1(BinAggState *state, BinAggKind kind)
+{
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * state->count);
+	int count = 0;
+	for (int i = 0; i < state->count; i++)
+	{
+		BinAggBucket *bucket = &state->buckets[i];
+		if (bucket->count == 0)
+			continue;
+		TimestampTz t = binagg_bucket_start(state, state->first + i);
+		if (kind == BINAGG_COUNT)
+			instants[count++] = temporalinst_make(
+				Int32GetDatum((int32) bucket->count), t, INT4OID);
+		else
+		{
+			double value = (kind == BINAGG_SUM) ? bucket->sum : 
+				bucket->sum / bucket->count;
+			instants[count++] = temporalinst_make(Float8GetDatum(value), t,
+				FLOAT8OID);
+		}
+	}
+	TemporalI *result = NULL;
+	if (count > 0)
+		result = temporali_from_temporalinstarr(instants, count);
+	for (int i = 0; i < count; i++)
+		pfree(instants[i]);
+	pfree(instants);
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(temporal_tcount_bins_finalfn);
+
+PGDLLEXPORT Datum
+temporal_tcount_bins_finalfn(PG_FUNCTION_ARGS)
+{
+	/* The final function is strict, we do not need to test for null values */
+	BinAggState *state = (BinAggState *) PG_GETARG_POINTER(0);
+	TemporalI *result = temporal_bins_finalfn1(state, BINAGG_COUNT);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(tnumber_tsum_bins_finalfn);
+
+PGDLLEXPORT Datum
+tnumber_tsum_bins_finalfn(PG_FUNCTION_ARGS)
+{
+	BinAggState *state = (BinAggState *) PG_GETARG_POINTER(0);
+	TemporalI *result = temporal_bins_finalfn1(state, BINAGG_SUM);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(tnumber_tavg_bins_finalfn);
+
+PGDLLEXPORT Datum
+tnumber_tavg_bins_finalfn(PG_FUNCTION_ARGS)
+{
+	BinAggState *state = (BinAggState *) PG_GETARG_POINTER(0);
+	TemporalI *result = temporal_bins_finalfn1(state, BINAGG_AVG);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
 /*****************************************************************************/
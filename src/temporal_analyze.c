@@ -62,6 +62,12 @@
  * 		- stavalues stores the length of the histogram of periods for the time dimension.
  * 		- numvalues contains the number of buckets in the histogram.
  *
+ * - Slot 5
+ * 		- stakind contains the type of statistics which is STATISTIC_KIND_TBOX_HISTOGRAM.
+ * 		- stanumbers stores the two-dimensional histogram of the bounding 
+ * 		  boxes of the values, which captures the correlation between the 
+ * 		  value and the time dimensions (see TBOX_STATS in temporal_analyze.h).
+ *
  * Notice that some statistics may not be collected, for example, since there
  * are no most common values. In that case, the next statistics collected is
  * stored in the next available slot.
@@ -1062,6 +1068,117 @@ range_compute_stats(VacAttrStats *stats, int non_null_cnt, int *slot_idx,
 	MemoryContextSwitchTo(old_cxt);
 }
 
+/*
+ * Set in the array fracs the proportion of the interval [lower, upper] that 
+ * overlaps each of the size cells partitioning the extent [min, max], and 
+ * set the range of cells overlapped in first and last. Degenerate intervals
+ * are entirely assigned to the cell containing them.
+ */
+static void
+tbox_stats_fractions(double lower, double upper, double min, double max,
+	int size, double *fracs, int *first, int *last)
+{
+	double width = (max - min) / size;
+	int i;
+
+	if (size == 1)
+	{
+		fracs[0] = 1.0;
+		*first = *last = 0;
+		return;
+	}
+	*first = Max(Min((int) floor((lower - min) / width), size - 1), 0);
+	*last = Max(Min((int) floor((upper - min) / width), size - 1), 0);
+	if (upper <= lower)
+	{
+		fracs[*first] = 1.0;
+		*last = *first;
+		return;
+	}
+	for (i = *first; i <= *last; i++)
+	{
+		double cmin = min + i * width, cmax = cmin + width;
+		double overlap = Min(upper, cmax) - Max(lower, cmin);
+		fracs[i] = (overlap > 0.0) ? overlap / (upper - lower) : 0.0;
+	}
+}
+
+/* 
+ * Compute the two-dimensional histogram of the value and time dimensions 
+ * for temporal numbers from the bounding boxes of the sample
+ */
+static void
+tbox_compute_stats(VacAttrStats *stats, int non_null_cnt, int *slot_idx,
+	TBOX *boxes)
+{
+	int num_bins = Min(stats->attr->attstattarget, TBOX_STATS_MAX_BINS),
+		xsize, tsize, ncells, xfirst, xlast, tfirst, tlast, i, j, k;
+	double xmin, xmax, tmin, tmax;
+	double *xfracs, *tfracs;
+	TBOX_STATS *hist;
+	size_t hist_size;
+	MemoryContext old_cxt;
+
+	/* There must be a free slot and at least two values */
+	if (*slot_idx >= STATISTIC_NUM_SLOTS || non_null_cnt < 2)
+		return;
+
+	/* Compute the extent of the sample */
+	xmin = boxes[0].xmin; xmax = boxes[0].xmax;
+	tmin = STATS_TIMESTAMP(boxes[0].tmin); tmax = STATS_TIMESTAMP(boxes[0].tmax);
+	for (i = 1; i < non_null_cnt; i++)
+	{
+		xmin = Min(xmin, boxes[i].xmin);
+		xmax = Max(xmax, boxes[i].xmax);
+		tmin = Min(tmin, STATS_TIMESTAMP(boxes[i].tmin));
+		tmax = Max(tmax, STATS_TIMESTAMP(boxes[i].tmax));
+	}
+
+	/* A dimension without extent is represented by a single cell */
+	xsize = (xmax > xmin) ? num_bins : 1;
+	tsize = (tmax > tmin) ? num_bins : 1;
+	ncells = xsize * tsize;
+
+	/* Must copy the histogram into anl_context */
+	old_cxt = MemoryContextSwitchTo(stats->anl_context);
+	hist_size = sizeof(TBOX_STATS) + (ncells - 1) * sizeof(float4);
+	hist = palloc0(hist_size);
+	MemoryContextSwitchTo(old_cxt);
+
+	hist->xsize = (float4) xsize;
+	hist->tsize = (float4) tsize;
+	hist->xmin = (float4) xmin;
+	hist->xmax = (float4) xmax;
+	hist->tmin = (float4) tmin;
+	hist->tmax = (float4) tmax;
+	hist->features = (float4) non_null_cnt;
+
+	/* Pro-rate each box among the cells it overlaps */
+	xfracs = palloc(sizeof(double) * xsize);
+	tfracs = palloc(sizeof(double) * tsize);
+	for (k = 0; k < non_null_cnt; k++)
+	{
+		/* Give backend a chance of interrupting us */
+		vacuum_delay_point();
+
+		tbox_stats_fractions(boxes[k].xmin, boxes[k].xmax, xmin, xmax, 
+			xsize, xfracs, &xfirst, &xlast);
+		tbox_stats_fractions(STATS_TIMESTAMP(boxes[k].tmin), 
+			STATS_TIMESTAMP(boxes[k].tmax), tmin, tmax, tsize, tfracs, 
+			&tfirst, &tlast);
+		for (j = tfirst; j <= tlast; j++)
+			for (i = xfirst; i <= xlast; i++)
+				hist->value[j * xsize + i] += (float4) (xfracs[i] * tfracs[j]);
+	}
+	pfree(xfracs); pfree(tfracs);
+
+	stats->stakind[*slot_idx] = STATISTIC_KIND_TBOX_HISTOGRAM;
+	stats->staop[*slot_idx] = InvalidOid;
+	stats->stanumbers[*slot_idx] = (float4 *) hist;
+	stats->numnumbers[*slot_idx] = (int) (hist_size / sizeof(float4));
+	(*slot_idx)++;
+}
+
 /* 
  * Compute statistics for all durations distinct from TemporalInst.
  * Function derived from compute_range_stats of file rangetypes_typanalyze.c 
@@ -1080,6 +1197,7 @@ temps_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 		   *value_uppers;
 	PeriodBound *time_lowers,
 		   *time_uppers;
+	TBOX *boxes;
 	double total_width = 0;
 	Oid 	rangetypid = 0; /* make compiler quiet */
 	TypeCacheEntry *typcache;
@@ -1098,6 +1216,7 @@ temps_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 		value_lowers = (RangeBound *) palloc(sizeof(RangeBound) * samplerows);
 		value_uppers = (RangeBound *) palloc(sizeof(RangeBound) * samplerows);
 		value_lengths = (float8 *) palloc(sizeof(float8) * samplerows);
+		boxes = (TBOX *) palloc(sizeof(TBOX) * samplerows);
 	}
 	time_lowers = (PeriodBound *) palloc(sizeof(PeriodBound) * samplerows);
 	time_uppers = (PeriodBound *) palloc(sizeof(PeriodBound) * samplerows);
@@ -1146,6 +1265,10 @@ temps_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 			else if (temporal_extra_data->value_type_id == FLOAT8OID)
 				value_lengths[non_null_cnt] = DatumGetFloat8(range_upper.val) -
 					DatumGetFloat8(range_lower.val);
+
+			/* Remember the bounding box for the joint histogram */
+			memset(&boxes[non_null_cnt], 0, sizeof(TBOX));
+			temporal_bbox(&boxes[non_null_cnt], temp);
 		}
 		temporal_period(&period, temp);
 		period_deserialize(&period, &period_lower, &period_upper);
@@ -1176,6 +1299,9 @@ temps_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 
 		period_compute_stats1(stats, non_null_cnt, &slot_idx,
 			time_lowers, time_uppers, time_lengths);
+
+		if (valuestats)
+			tbox_compute_stats(stats, non_null_cnt, &slot_idx, boxes);
 	}
 	else if (null_cnt > 0)
 	{
@@ -1194,6 +1320,7 @@ temps_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 	if (valuestats)
 	{
 		pfree(value_lowers); pfree(value_uppers); pfree(value_lengths);
+		pfree(boxes);
 	}
 	pfree(time_lowers); pfree(time_uppers); pfree(time_lengths);
 }
@@ -13,6 +13,7 @@
 #include "temporal_boolops.h"
 
 #include "temporaltypes.h"
+#include "temporal_runs.h"
 #include "lifting.h"
 
 /*****************************************************************************
@@ -35,6 +36,35 @@ datum_or(Datum l, Datum r)
 	return BoolGetDatum(DatumGetBool(l) || DatumGetBool(r));
 }
 
+/*****************************************************************************
+ * Generic functions
+ *****************************************************************************/
+
+/*
+ * Apply a Boolean operator to two temporal Booleans. When both values are
+ * sequences or sequence sets, they are synchronized on their runs of
+ * constant value and the result is constructed once at the end.
+ */
+static Temporal *
+tbool_tbool_op(Temporal *temp1, Temporal *temp2, Datum (*func)(Datum, Datum))
+{
+	if (temp1->duration != TEMPORALSEQ && temp1->duration != TEMPORALS)
+		return sync_tfunc2_temporal_temporal(temp1, temp2, func, BOOLOID,
+			false, NULL);
+	if (temp2->duration != TEMPORALSEQ && temp2->duration != TEMPORALS)
+		return sync_tfunc2_temporal_temporal(temp1, temp2, func, BOOLOID,
+			false, NULL);
+
+	TemporalRuns *runs1 = truns_from_temporal(temp1);
+	TemporalRuns *runs2 = truns_from_temporal(temp2);
+	TemporalRuns *runs = truns_sync(runs1, runs2, func, BOOLOID);
+	Temporal *result = (temp1->duration == TEMPORALSEQ && 
+		temp2->duration == TEMPORALSEQ) ?
+		truns_to_temporal(runs) : (Temporal *)truns_to_temporals(runs);
+	truns_free(runs1); truns_free(runs2); truns_free(runs);
+	return result;
+}
+
 /*****************************************************************************
  * Temporal and
  *****************************************************************************/
@@ -72,8 +102,7 @@ tand_tbool_tbool(PG_FUNCTION_ARGS)
 {
 	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
 	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
-	Temporal *result = sync_tfunc2_temporal_temporal(temp1, temp2, 
-		&datum_and, BOOLOID, false, NULL);
+	Temporal *result = tbool_tbool_op(temp1, temp2, &datum_and);
 	PG_FREE_IF_COPY(temp1, 0);
 	PG_FREE_IF_COPY(temp2, 1);
 	if (result == NULL)
@@ -118,8 +147,7 @@ tor_tbool_tbool(PG_FUNCTION_ARGS)
 {
 	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
 	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
-	Temporal *result = sync_tfunc2_temporal_temporal(temp1, temp2, 
-		&datum_or, BOOLOID, false, NULL);
+	Temporal *result = tbool_tbool_op(temp1, temp2, &datum_or);
 	PG_FREE_IF_COPY(temp1, 0);
 	PG_FREE_IF_COPY(temp2, 1);
 	if (result == NULL)
@@ -204,5 +232,24 @@ tnot_tbool(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Time when the temporal Boolean is true
+ *****************************************************************************/
+
+PG_FUNCTION_INFO_V1(tbool_when_true);
+
+PGDLLEXPORT Datum
+tbool_when_true(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	TemporalRuns *runs = truns_from_temporal(temp);
+	PeriodSet *result = truns_when_value(runs, BoolGetDatum(true));
+	truns_free(runs);
+	PG_FREE_IF_COPY(temp, 0);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
 /*****************************************************************************/
 
@@ -909,11 +909,9 @@ PGDLLEXPORT Datum
 contains_bbox_period_temporal(PG_FUNCTION_ARGS) 
 {
 	Period *p = PG_GETARG_PERIOD(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Period p1;
-	temporal_period(&p1, temp);
+	temporal_period_slice(&p1, PG_GETARG_DATUM(1));
 	bool result = contains_period_period_internal(p, &p1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -922,12 +920,10 @@ PG_FUNCTION_INFO_V1(contains_bbox_temporal_period);
 PGDLLEXPORT Datum
 contains_bbox_temporal_period(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Period *p = PG_GETARG_PERIOD(1);
 	Period p1;
-	temporal_period(&p1, temp);
+	temporal_period_slice(&p1, PG_GETARG_DATUM(0));
 	bool result = contains_period_period_internal(&p1, p);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -936,14 +932,10 @@ PG_FUNCTION_INFO_V1(contains_bbox_temporal_temporal);
 PGDLLEXPORT Datum
 contains_bbox_temporal_temporal(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	Period p1, p2;
-	temporal_period(&p1, temp1);
-	temporal_period(&p2, temp2);
+	temporal_period_slice(&p1, PG_GETARG_DATUM(0));
+	temporal_period_slice(&p2, PG_GETARG_DATUM(1));
 	bool result = contains_period_period_internal(&p1, &p2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -955,11 +947,9 @@ PGDLLEXPORT Datum
 contained_bbox_period_temporal(PG_FUNCTION_ARGS) 
 {
 	Period *p = PG_GETARG_PERIOD(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Period p1;
-	temporal_period(&p1, temp);
+	temporal_period_slice(&p1, PG_GETARG_DATUM(1));
 	bool result = contains_period_period_internal(&p1, p);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -968,12 +958,10 @@ PG_FUNCTION_INFO_V1(contained_bbox_temporal_period);
 PGDLLEXPORT Datum
 contained_bbox_temporal_period(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Period *p = PG_GETARG_PERIOD(1);
 	Period p1;
-	temporal_period(&p1, temp);
+	temporal_period_slice(&p1, PG_GETARG_DATUM(0));
 	bool result = contains_period_period_internal(p, &p1);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -982,14 +970,10 @@ PG_FUNCTION_INFO_V1(contained_bbox_temporal_temporal);
 PGDLLEXPORT Datum
 contained_bbox_temporal_temporal(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	Period p1, p2;
-	temporal_period(&p1, temp1);
-	temporal_period(&p2, temp2);
+	temporal_period_slice(&p1, PG_GETARG_DATUM(0));
+	temporal_period_slice(&p2, PG_GETARG_DATUM(1));
 	bool result = contains_period_period_internal(&p2, &p1);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1001,11 +985,9 @@ PGDLLEXPORT Datum
 overlaps_bbox_period_temporal(PG_FUNCTION_ARGS) 
 {
 	Period *p = PG_GETARG_PERIOD(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Period p1;
-	temporal_period(&p1, temp);
+	temporal_period_slice(&p1, PG_GETARG_DATUM(1));
 	bool result = overlaps_period_period_internal(p, &p1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1014,12 +996,10 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_temporal_period);
 PGDLLEXPORT Datum
 overlaps_bbox_temporal_period(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Period *p = PG_GETARG_PERIOD(1);
 	Period p1;
-	temporal_period(&p1, temp);
+	temporal_period_slice(&p1, PG_GETARG_DATUM(0));
 	bool result = overlaps_period_period_internal(&p1, p);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1028,14 +1008,10 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_temporal_temporal);
 PGDLLEXPORT Datum
 overlaps_bbox_temporal_temporal(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	Period p1, p2;
-	temporal_period(&p1, temp1);
-	temporal_period(&p2, temp2);
+	temporal_period_slice(&p1, PG_GETARG_DATUM(0));
+	temporal_period_slice(&p2, PG_GETARG_DATUM(1));
 	bool result = overlaps_period_period_internal(&p1, &p2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1047,11 +1023,9 @@ PGDLLEXPORT Datum
 same_bbox_period_temporal(PG_FUNCTION_ARGS) 
 {
 	Period *p = PG_GETARG_PERIOD(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Period p1;
-	temporal_period(&p1, temp);
+	temporal_period_slice(&p1, PG_GETARG_DATUM(1));
 	bool result = period_eq_internal(p, &p1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1060,12 +1034,10 @@ PG_FUNCTION_INFO_V1(same_bbox_temporal_period);
 PGDLLEXPORT Datum
 same_bbox_temporal_period(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Period *p = PG_GETARG_PERIOD(1);
 	Period p1;
-	temporal_period(&p1, temp);
+	temporal_period_slice(&p1, PG_GETARG_DATUM(0));
 	bool result = period_eq_internal(&p1, p);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1074,14 +1046,10 @@ PG_FUNCTION_INFO_V1(same_bbox_temporal_temporal);
 PGDLLEXPORT Datum
 same_bbox_temporal_temporal(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	Period p1, p2;
-	temporal_period(&p1, temp1);
-	temporal_period(&p2, temp2);
+	temporal_period_slice(&p1, PG_GETARG_DATUM(0));
+	temporal_period_slice(&p2, PG_GETARG_DATUM(1));
 	bool result = period_eq_internal(&p1, &p2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1095,15 +1063,13 @@ PGDLLEXPORT Datum
 contains_bbox_range_tnumber(PG_FUNCTION_ARGS)
 {
 	RangeType *range = PG_GETARG_RANGE_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
 	range_to_tbox_internal(&box1, range);
-	temporal_bbox(&box2, temp);
+	temporal_bbox_slice(&box2, PG_GETARG_DATUM(1));
 	bool result = contains_tbox_tbox_internal(&box1, &box2);
 	PG_FREE_IF_COPY(range, 0);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1112,15 +1078,13 @@ PG_FUNCTION_INFO_V1(contains_bbox_tnumber_range);
 PGDLLEXPORT Datum
 contains_bbox_tnumber_range(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	RangeType *range = PG_GETARG_RANGE_P(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
 	range_to_tbox_internal(&box2, range);
 	bool result = contains_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(range, 1);
 	PG_RETURN_BOOL(result);
 }
@@ -1131,12 +1095,10 @@ PGDLLEXPORT Datum
 contains_bbox_tbox_tnumber(PG_FUNCTION_ARGS) 
 {
 	TBOX *box = PG_GETARG_TBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(1));
 	bool result = contains_tbox_tbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1145,13 +1107,11 @@ PG_FUNCTION_INFO_V1(contains_bbox_tnumber_tbox);
 PGDLLEXPORT Datum
 contains_bbox_tnumber_tbox(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TBOX *box = PG_GETARG_TBOX_P(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
 	bool result = contains_tbox_tbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1160,16 +1120,12 @@ PG_FUNCTION_INFO_V1(contains_bbox_tnumber_tnumber);
 PGDLLEXPORT Datum
 contains_bbox_tnumber_tnumber(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_slice(&box2, PG_GETARG_DATUM(1));
 	bool result = contains_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 	
@@ -1181,15 +1137,13 @@ PGDLLEXPORT Datum
 contained_bbox_range_tnumber(PG_FUNCTION_ARGS)
 {
 	RangeType *range = PG_GETARG_RANGE_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
 	range_to_tbox_internal(&box1, range);
-	temporal_bbox(&box2, temp);
+	temporal_bbox_slice(&box2, PG_GETARG_DATUM(1));
 	bool result = contained_tbox_tbox_internal(&box1, &box2);
 	PG_FREE_IF_COPY(range, 0);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1198,15 +1152,13 @@ PG_FUNCTION_INFO_V1(contained_bbox_tnumber_range);
 PGDLLEXPORT Datum
 contained_bbox_tnumber_range(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	RangeType *range = PG_GETARG_RANGE_P(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
 	range_to_tbox_internal(&box2, range);
 	bool result = contained_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(range, 1);
 	PG_RETURN_BOOL(result);
 }
@@ -1217,12 +1169,10 @@ PGDLLEXPORT Datum
 contained_bbox_tbox_tnumber(PG_FUNCTION_ARGS) 
 {
 	TBOX *box = PG_GETARG_TBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(1));
 	bool result = contained_tbox_tbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1231,13 +1181,11 @@ PG_FUNCTION_INFO_V1(contained_bbox_tnumber_tbox);
 PGDLLEXPORT Datum
 contained_bbox_tnumber_tbox(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TBOX *box = PG_GETARG_TBOX_P(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
 	bool result = contained_tbox_tbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1246,16 +1194,12 @@ PG_FUNCTION_INFO_V1(contained_bbox_tnumber_tnumber);
 PGDLLEXPORT Datum
 contained_bbox_tnumber_tnumber(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_slice(&box2, PG_GETARG_DATUM(1));
 	bool result = contained_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 	
@@ -1267,15 +1211,13 @@ PGDLLEXPORT Datum
 overlaps_bbox_range_tnumber(PG_FUNCTION_ARGS)
 {
 	RangeType *range = PG_GETARG_RANGE_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
 	range_to_tbox_internal(&box1, range);
-	temporal_bbox(&box2, temp);
+	temporal_bbox_slice(&box2, PG_GETARG_DATUM(1));
 	bool result = overlaps_tbox_tbox_internal(&box1, &box2);
 	PG_FREE_IF_COPY(range, 0);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1284,15 +1226,13 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_tnumber_range);
 PGDLLEXPORT Datum
 overlaps_bbox_tnumber_range(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	RangeType *range = PG_GETARG_RANGE_P(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
 	range_to_tbox_internal(&box2, range);
 	bool result = overlaps_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(range, 1);
 	PG_RETURN_BOOL(result);
 }
@@ -1303,12 +1243,10 @@ PGDLLEXPORT Datum
 overlaps_bbox_tbox_tnumber(PG_FUNCTION_ARGS) 
 {
 	TBOX *box = PG_GETARG_TBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(1));
 	bool result = overlaps_tbox_tbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1317,13 +1255,11 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_tnumber_tbox);
 PGDLLEXPORT Datum
 overlaps_bbox_tnumber_tbox(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TBOX *box = PG_GETARG_TBOX_P(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
 	bool result = overlaps_tbox_tbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1332,16 +1268,12 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_tnumber_tnumber);
 PGDLLEXPORT Datum
 overlaps_bbox_tnumber_tnumber(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_slice(&box2, PG_GETARG_DATUM(1));
 	bool result = overlaps_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 	
@@ -1352,15 +1284,13 @@ PG_FUNCTION_INFO_V1(same_bbox_tnumber_range);
 PGDLLEXPORT Datum
 same_bbox_tnumber_range(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	RangeType *range = PG_GETARG_RANGE_P(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
 	range_to_tbox_internal(&box2, range);
 	bool result = same_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(range, 1);
 	PG_RETURN_BOOL(result);
 }
@@ -1371,15 +1301,13 @@ PGDLLEXPORT Datum
 same_bbox_range_tnumber(PG_FUNCTION_ARGS)
 {
 	RangeType *range = PG_GETARG_RANGE_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
 	range_to_tbox_internal(&box1, range);
-	temporal_bbox(&box2, temp);
+	temporal_bbox_slice(&box2, PG_GETARG_DATUM(1));
 	bool result = same_tbox_tbox_internal(&box1, &box2);
 	PG_FREE_IF_COPY(range, 0);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1389,12 +1317,10 @@ PGDLLEXPORT Datum
 same_bbox_tbox_tnumber(PG_FUNCTION_ARGS) 
 {
 	TBOX *box = PG_GETARG_TBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(1));
 	bool result = same_tbox_tbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1403,13 +1329,11 @@ PG_FUNCTION_INFO_V1(same_bbox_tnumber_tbox);
 PGDLLEXPORT Datum
 same_bbox_tnumber_tbox(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TBOX *box = PG_GETARG_TBOX_P(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
 	bool result = same_tbox_tbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1418,16 +1342,12 @@ PG_FUNCTION_INFO_V1(same_bbox_tnumber_tnumber);
 PGDLLEXPORT Datum
 same_bbox_tnumber_tnumber(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_slice(&box2, PG_GETARG_DATUM(1));
 	bool result = same_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 	
@@ -95,4 +95,21 @@ gist_temporal_compress(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(entry);
 }
 
-/*****************************************************************************/
\ No newline at end of file
+/*****************************************************************************
+ * Hilbert key for temporal Boolean and temporal text
+ *****************************************************************************/
+
+PG_FUNCTION_INFO_V1(temporal_hilbert_key);
+
+PGDLLEXPORT Datum
+temporal_hilbert_key(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	Period *extent = PG_GETARG_PERIOD(1);
+	Period p;
+	temporal_bbox(&p, temp);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_INT64((int64) period_hilbert_key_internal(&p, extent));
+}
+
+/*****************************************************************************/
@@ -0,0 +1,340 @@
+/*****************************************************************************
+ *
+ * temporal_runs.c
+ *	  Run-length representation of temporal values with stepwise
+ *	  interpolation.
+ *
+ * A stepwise temporal value is represented as an array of runs, each run
+ * being the maximal period during which the value is constant. Operations
+ * such as the temporal comparisons, the temporal Boolean operators, or the
+ * restriction to a value produce and consume runs without constructing a
+ * temporal instant for each change point. The normalized temporal value is
+ * only constructed at the end, in a single pass, where each run contributes
+ * a single instant.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "temporal_runs.h"
+
+#include <assert.h>
+
+#include "period.h"
+#include "periodset.h"
+#include "temporaltypes.h"
+#include "temporal_util.h"
+
+/*****************************************************************************
+ * Constructors
+ *****************************************************************************/
+
+TemporalRuns *
+truns_make(Oid valuetypid, int maxcount)
+{
+	TemporalRuns *result = palloc(sizeof(TemporalRuns));
+	result->valuetypid = valuetypid;
+	result->count = 0;
+	result->maxcount = Max(maxcount, 1);
+	result->runs = palloc(sizeof(TemporalRun) * result->maxcount);
+	return result;
+}
+
+void
+truns_free(TemporalRuns *runs)
+{
+	pfree(runs->runs);
+	pfree(runs);
+}
+
+/*
+ * Append a run at the end. The run is merged with the last one if they
+ * are adjacent and have the same value.
+ */
+void
+truns_append(TemporalRuns *runs, Datum value, TimestampTz lower,
+	TimestampTz upper, bool lower_inc, bool upper_inc)
+{
+	if (runs->count > 0)
+	{
+		TemporalRun *last = &runs->runs[runs->count - 1];
+		assert(last->period.upper <= lower);
+		if (last->period.upper == lower &&
+			(last->period.upper_inc || lower_inc) &&
+			datum_eq(last->value, value, runs->valuetypid))
+		{
+			last->period.upper = upper;
+			last->period.upper_inc = upper_inc;
+			return;
+		}
+	}
+	if (runs->count == runs->maxcount)
+	{
+		runs->maxcount *= 2;
+		runs->runs = repalloc(runs->runs, sizeof(TemporalRun) * runs->maxcount);
+	}
+	TemporalRun *run = &runs->runs[runs->count++];
+	period_set(&run->period, lower, upper, lower_inc, upper_inc);
+	run->value = value;
+}
+
+static void
+truns_append_seq(TemporalRuns *runs, TemporalSeq *seq)
+{
+	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
+	if (seq->count == 1)
+	{
+		truns_append(runs, temporalinst_value(inst1), inst1->t, inst1->t,
+			true, true);
+		return;
+	}
+	bool lower_inc = seq->period.lower_inc;
+	for (int i = 1; i < seq->count; i++)
+	{
+		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
+		truns_append(runs, temporalinst_value(inst1), inst1->t, inst2->t,
+			lower_inc, false);
+		inst1 = inst2;
+		lower_inc = true;
+	}
+	if (seq->period.upper_inc)
+		truns_append(runs, temporalinst_value(inst1), inst1->t, inst1->t,
+			true, true);
+}
+
+/*
+ * Runs of a temporal value with stepwise interpolation. The values of the
+ * runs point to the temporal value, which must not be freed before the runs.
+ */
+TemporalRuns *
+truns_from_temporal(Temporal *temp)
+{
+	TemporalRuns *result;
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST)
+	{
+		TemporalInst *inst = (TemporalInst *) temp;
+		result = truns_make(temp->valuetypid, 1);
+		truns_append(result, temporalinst_value(inst), inst->t, inst->t,
+			true, true);
+	}
+	else if (temp->duration == TEMPORALI)
+	{
+		TemporalI *ti = (TemporalI *) temp;
+		result = truns_make(temp->valuetypid, ti->count);
+		for (int i = 0; i < ti->count; i++)
+		{
+			TemporalInst *inst = temporali_inst_n(ti, i);
+			truns_append(result, temporalinst_value(inst), inst->t, inst->t,
+				true, true);
+		}
+	}
+	else if (temp->duration == TEMPORALSEQ)
+	{
+		assert(! MOBDB_FLAGS_GET_LINEAR(temp->flags));
+		TemporalSeq *seq = (TemporalSeq *) temp;
+		result = truns_make(temp->valuetypid, seq->count);
+		truns_append_seq(result, seq);
+	}
+	else /* temp->duration == TEMPORALS */
+	{
+		assert(! MOBDB_FLAGS_GET_LINEAR(temp->flags));
+		TemporalS *ts = (TemporalS *) temp;
+		result = truns_make(temp->valuetypid, ts->totalcount);
+		for (int i = 0; i < ts->count; i++)
+			truns_append_seq(result, temporals_seq_n(ts, i));
+	}
+	return result;
+}
+
+/*****************************************************************************
+ * Conversion into temporal values
+ *****************************************************************************/
+
+/*
+ * Construct the sequences of the runs. A new sequence is started after a
+ * gap and after a run that includes its upper bound, since the next run,
+ * which has a different value, cannot share the instant with it.
+ */
+static TemporalSeq **
+truns_to_seqarr(TemporalRuns *runs, int *count)
+{
+	TemporalSeq **result = palloc(sizeof(TemporalSeq *) * runs->count);
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * (runs->count + 1));
+	int k = 0, l = 0;
+	bool lower_inc = false;
+	for (int i = 0; i < runs->count; i++)
+	{
+		TemporalRun *run = &runs->runs[i];
+		if (l == 0)
+			lower_inc = run->period.lower_inc;
+		instants[l++] = temporalinst_make(run->value, run->period.lower,
+			runs->valuetypid);
+		TemporalRun *next = (i == runs->count - 1) ? NULL : &runs->runs[i + 1];
+		if (next != NULL && next->period.lower == run->period.upper &&
+			! run->period.upper_inc && next->period.lower_inc)
+			continue;
+		/* End of the sequence */
+		if (run->period.upper > run->period.lower)
+			instants[l++] = temporalinst_make(run->value, run->period.upper,
+				runs->valuetypid);
+		result[k++] = temporalseq_from_temporalinstarr(instants, l,
+			lower_inc, run->period.upper_inc, false, false);
+		for (int j = 0; j < l; j++)
+			pfree(instants[j]);
+		l = 0;
+	}
+	pfree(instants);
+	*count = k;
+	return result;
+}
+
+/* Temporal sequence set of the runs, NULL if there are no runs */
+
+TemporalS *
+truns_to_temporals(TemporalRuns *runs)
+{
+	if (runs->count == 0)
+		return NULL;
+	int count;
+	TemporalSeq **sequences = truns_to_seqarr(runs, &count);
+	/* The runs are already normalized */
+	TemporalS *result = temporals_from_temporalseqarr(sequences, count,
+		false, false);
+	for (int i = 0; i < count; i++)
+		pfree(sequences[i]);
+	pfree(sequences);
+	return result;
+}
+
+/* Temporal sequence if the runs are contiguous, sequence set otherwise */
+
+Temporal *
+truns_to_temporal(TemporalRuns *runs)
+{
+	if (runs->count == 0)
+		return NULL;
+	int count;
+	TemporalSeq **sequences = truns_to_seqarr(runs, &count);
+	Temporal *result;
+	if (count == 1)
+		result = (Temporal *) sequences[0];
+	else
+	{
+		result = (Temporal *) temporals_from_temporalseqarr(sequences, count,
+			false, false);
+		for (int i = 0; i < count; i++)
+			pfree(sequences[i]);
+	}
+	pfree(sequences);
+	return result;
+}
+
+/*****************************************************************************
+ * Operations
+ *****************************************************************************/
+
+/*
+ * Apply a function to the values of two runs during their common time.
+ * Both arrays are traversed in a single pass.
+ */
+TemporalRuns *
+truns_sync(TemporalRuns *runs1, TemporalRuns *runs2,
+	Datum (*func)(Datum, Datum), Oid valuetypid)
+{
+	TemporalRuns *result = truns_make(valuetypid, runs1->count + runs2->count);
+	int i = 0, j = 0;
+	while (i < runs1->count && j < runs2->count)
+	{
+		Period *p1 = &runs1->runs[i].period;
+		Period *p2 = &runs2->runs[j].period;
+		TimestampTz lower, upper;
+		bool lower_inc, upper_inc;
+		if (p1->lower == p2->lower)
+		{
+			lower = p1->lower;
+			lower_inc = p1->lower_inc && p2->lower_inc;
+		}
+		else if (p1->lower > p2->lower)
+		{
+			lower = p1->lower;
+			lower_inc = p1->lower_inc;
+		}
+		else
+		{
+			lower = p2->lower;
+			lower_inc = p2->lower_inc;
+		}
+		int cmp = timestamp_cmp_internal(p1->upper, p2->upper);
+		if (cmp == 0)
+		{
+			upper = p1->upper;
+			upper_inc = p1->upper_inc && p2->upper_inc;
+			if (p1->upper_inc != p2->upper_inc)
+				cmp = p1->upper_inc ? 1 : -1;
+		}
+		else if (cmp < 0)
+		{
+			upper = p1->upper;
+			upper_inc = p1->upper_inc;
+		}
+		else
+		{
+			upper = p2->upper;
+			upper_inc = p2->upper_inc;
+		}
+		if (lower < upper || (lower == upper && lower_inc && upper_inc))
+			truns_append(result, func(runs1->runs[i].value,
+				runs2->runs[j].value), lower, upper, lower_inc, upper_inc);
+		if (cmp == 0)
+		{
+			i++; j++;
+		}
+		else if (cmp < 0)
+			i++;
+		else
+			j++;
+	}
+	return result;
+}
+
+/* Runs during which the value is equal to the given one */
+
+TemporalRuns *
+truns_at_value(TemporalRuns *runs, Datum value)
+{
+	TemporalRuns *result = truns_make(runs->valuetypid, runs->count);
+	for (int i = 0; i < runs->count; i++)
+	{
+		TemporalRun *run = &runs->runs[i];
+		if (datum_eq(run->value, value, runs->valuetypid))
+			truns_append(result, run->value, run->period.lower,
+				run->period.upper, run->period.lower_inc, run->period.upper_inc);
+	}
+	return result;
+}
+
+/* Time during which the value is equal to the given one, NULL if never */
+
+PeriodSet *
+truns_when_value(TemporalRuns *runs, Datum value)
+{
+	Period **periods = palloc(sizeof(Period *) * runs->count);
+	int k = 0;
+	for (int i = 0; i < runs->count; i++)
+	{
+		TemporalRun *run = &runs->runs[i];
+		if (datum_eq(run->value, value, runs->valuetypid))
+			periods[k++] = &run->period;
+	}
+	/* Runs with the same value are never adjacent */
+	PeriodSet *result = (k == 0) ? NULL :
+		periodset_from_periodarr_internal(periods, k, false);
+	pfree(periods);
+	return result;
+}
+
+/*****************************************************************************/
@@ -13,7 +13,10 @@
 #include "temporal_util.h"
 
 #include <assert.h>
+#include <math.h>
+#include <access/hash.h>
 #include <catalog/pg_collation.h>
+#include <lib/hyperloglog.h>
 #include <utils/builtins.h>
 #include <utils/lsyscache.h>
 #include <utils/timestamp.h>
@@ -742,3 +745,370 @@ datum2_ge2(Datum l, Datum r, Oid typel, Oid typer)
 
 /*****************************************************************************/
 
+
+/*****************************************************************************
+ * Space-filling curve functions
+ *****************************************************************************/
+
+/*
+ * Map a coordinate in [min, max] to a cell number on a grid of 2^bits cells.
+ * Values outside the range are clamped to the first or last cell.
+ */
+uint32
+hilbert_coord(double value, double min, double max, int bits)
+{
+	double ncells = (double) ((uint64) 1 << bits);
+	double cell;
+	if (max <= min || isnan(value))
+		return 0;
+	cell = floor((value - min) / (max - min) * ncells);
+	if (cell < 0.0)
+		return 0;
+	if (cell >= ncells)
+		return (uint32) (ncells - 1.0);
+	return (uint32) cell;
+}
+
+/*
+ * Position of a grid cell along the Hilbert curve filling a grid of ndims
+ * dimensions with 2^bits cells per dimension, where ndims * bits <= 63.
+ * The coordinates are transposed in place following J. Skilling,
+ * "Programming the Hilbert curve", AIP Conf. Proc. 707, 2004, and their
+ * bits are then interleaved, most significant first.
+ */
+uint64
+hilbert_index(uint32 *coords, int ndims, int bits)
+{
+	uint32 m = (uint32) 1 << (bits - 1), p, q, t;
+	uint64 result = 0;
+	int i, b;
+
+	assert(ndims > 0 && bits > 0 && ndims * bits <= 63);
+	/* Inverse undo */
+	for (q = m; q > 1; q >>= 1)
+	{
+		p = q - 1;
+		for (i = 0; i < ndims; i++)
+		{
+			if (coords[i] & q)
+				coords[0] ^= p;
+			else
+			{
+				t = (coords[0] ^ coords[i]) & p;
+				coords[0] ^= t;
+				coords[i] ^= t;
+			}
+		}
+	}
+	/* Gray encode */
+	for (i = 1; i < ndims; i++)
+		coords[i] ^= coords[i - 1];
+	t = 0;
+	for (q = m; q > 1; q >>= 1)
+	{
+		if (coords[ndims - 1] & q)
+			t ^= q - 1;
+	}
+	for (i = 0; i < ndims; i++)
+		coords[i] ^= t;
+	/* Interleave */
+	for (b = bits - 1; b >= 0; b--)
+	{
+		for (i = 0; i < ndims; i++)
+			result = (result << 1) | ((coords[i] >> b) & 1);
+	}
+	return result;
+}
+
+/*****************************************************************************
+ * Bucket functions
+ *****************************************************************************/
+
+/*
+ * Width in microseconds of the buckets defined by an interval, which must be
+ * positive and cannot have months since their length is not fixed
+ */
+int64
+interval_width(Interval *interval)
+{
+	if (interval->month != 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("The interval cannot have months or years")));
+	int64 result = interval->time + (int64) interval->day * USECS_PER_DAY;
+	if (result <= 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("The interval must be positive")));
+	return result;
+}
+
+/*
+ * Number of the bucket containing the timestamp, bucket i covering
+ * [origin + i * width, origin + (i + 1) * width)
+ */
+int64
+timestamp_bucket(TimestampTz t, TimestampTz origin, int64 width)
+{
+	int64 delta = t - origin;
+	int64 result = delta / width;
+	if (delta % width < 0)
+		result--;
+	return result;
+}
+
+/*****************************************************************************/
+
+/*****************************************************************************
+ * Sort support functions
+ * Abbreviated keys are 64-bit integers that preserve the ordering of the
+ * leading component of the full comparison, e.g., the lower bound of a 
+ * period or the minimum value of a bounding box. Abbreviation is only
+ * enabled when a Datum can hold an int64 by value.
+ *****************************************************************************/
+
+/* State of the abbreviation, kept in ssup->ssup_extra */
+
+typedef struct
+{
+	int64 input_count;				/* number of abbreviated keys */
+	bool estimating;				/* still estimating the cardinality? */
+	hyperLogLogState abbr_card;		/* cardinality estimator */
+} AbbrevState;
+
+/* Comparison of two abbreviated keys */
+
+static int
+int64_abbrev_cmp(Datum x, Datum y, SortSupport ssup)
+{
+	int64 a = DatumGetInt64(x);
+	int64 b = DatumGetInt64(y);
+	if (a < b)
+		return -1;
+	if (a > b)
+		return 1;
+	return 0;
+}
+
+/*
+ * Abort the abbreviation when the keys are not distinct enough to pay for
+ * the conversion. This follows the heuristic used by PostgreSQL for the 
+ * uuid and numeric types.
+ */
+static bool
+int64_abbrev_abort(int memtupcount, SortSupport ssup)
+{
+	AbbrevState *state = (AbbrevState *) ssup->ssup_extra;
+	if (memtupcount < 10000 || state->input_count < 10000 || 
+		!state->estimating)
+		return false;
+
+	double abbr_card = estimateHyperLogLog(&state->abbr_card);
+	/* Enough distinct keys: stop estimating to save cycles */
+	if (abbr_card > 100000.0)
+	{
+		state->estimating = false;
+		return false;
+	}
+	/* Abort if less than one distinct key every 2000 values */
+	if (abbr_card < state->input_count / 2000.0 + 0.5)
+		return true;
+	return false;
+}
+
+/*
+ * Set up the sort support for a type given its full comparator and its
+ * abbreviated key converter
+ */
+void
+sortsupport_abbrev_init(SortSupport ssup, 
+	int (*comparator)(Datum, Datum, SortSupport), 
+	Datum (*converter)(Datum, SortSupport))
+{
+	ssup->comparator = comparator;
+#if SIZEOF_DATUM >= 8
+	if (ssup->abbreviate)
+	{
+		MemoryContext oldcontext = MemoryContextSwitchTo(ssup->ssup_cxt);
+		AbbrevState *state = palloc0(sizeof(AbbrevState));
+		state->estimating = true;
+		initHyperLogLog(&state->abbr_card, 10);
+		MemoryContextSwitchTo(oldcontext);
+		ssup->ssup_extra = state;
+		ssup->abbrev_full_comparator = comparator;
+		ssup->comparator = int64_abbrev_cmp;
+		ssup->abbrev_converter = converter;
+		ssup->abbrev_abort = int64_abbrev_abort;
+	}
+#endif
+}
+
+/*
+ * Return the abbreviated key as a Datum and feed it to the cardinality
+ * estimator
+ */
+Datum
+sortsupport_abbrev_key(int64 key, SortSupport ssup)
+{
+	AbbrevState *state = (AbbrevState *) ssup->ssup_extra;
+	state->input_count++;
+	if (state->estimating)
+	{
+		uint32 tmp = (uint32) key ^ (uint32) ((uint64) key >> 32);
+		addHyperLogLog(&state->abbr_card, DatumGetUInt32(hash_uint32(tmp)));
+	}
+	return Int64GetDatum(key);
+}
+
+/*
+ * Map a double to an int64 whose signed ordering is the one of the double.
+ * Negative values have all bits but the sign flipped. Both zeros are mapped 
+ * to the same key since they are equal for the full comparison.
+ */
+int64
+double_abbrev_key(double d)
+{
+	if (d == 0.0)
+		d = 0.0;
+	int64 bits;
+	memcpy(&bits, &d, sizeof(int64));
+	if (bits < 0)
+		bits ^= INT64CONST(0x7FFFFFFFFFFFFFFF);
+	return bits;
+}
+
+/*****************************************************************************/
+
+/*****************************************************************************
+ * Hash functions
+ * Streaming 64-bit hash based on the round and avalanche functions of 
+ * xxHash64. Values are fed as 64-bit words or byte arrays into a state 
+ * which is finalized once at the end. The functions avoid the fmgr calls 
+ * of the type-specific hash functions of PostgreSQL.
+ *****************************************************************************/
+
+#define HASH64_PRIME1 UINT64CONST(0x9E3779B185EBCA87)
+#define HASH64_PRIME2 UINT64CONST(0xC2B2AE3D27D4EB4F)
+#define HASH64_PRIME3 UINT64CONST(0x165667B19E3779F9)
+#define HASH64_PRIME5 UINT64CONST(0x27D4EB2F165667C5)
+
+#define HASH64_ROTL(x, r) (((x) << (r)) | ((x) >> (64 - (r))))
+
+/* Initialize the hash state from a seed */
+
+uint64
+hash64_init(uint64 seed)
+{
+	return seed + HASH64_PRIME5;
+}
+
+/* Add a 64-bit word to the hash state */
+
+uint64
+hash64_word(uint64 state, uint64 word)
+{
+	word *= HASH64_PRIME2;
+	word = HASH64_ROTL(word, 31);
+	word *= HASH64_PRIME1;
+	state ^= word;
+	return HASH64_ROTL(state, 27) * HASH64_PRIME1 + HASH64_PRIME3;
+}
+
+/* Add an array of bytes to the hash state, consumed in blocks of 8 bytes */
+
+uint64
+hash64_bytes(uint64 state, const void *data, size_t len)
+{
+	const char *p = (const char *) data;
+	while (len >= 8)
+	{
+		uint64 word;
+		memcpy(&word, p, 8);
+		state = hash64_word(state, word);
+		p += 8;
+		len -= 8;
+	}
+	if (len > 0)
+	{
+		uint64 word = 0;
+		memcpy(&word, p, len);
+		state = hash64_word(state, word ^ ((uint64) len << 56));
+	}
+	return state;
+}
+
+/* Finalize the hash state */
+
+uint64
+hash64_finish(uint64 state)
+{
+	state ^= state >> 33;
+	state *= HASH64_PRIME2;
+	state ^= state >> 29;
+	state *= HASH64_PRIME3;
+	state ^= state >> 32;
+	return state;
+}
+
+/* Add a double to the hash state, both zeros hashing to the same value */
+
+static uint64
+hash64_double(uint64 state, double d)
+{
+	uint64 word;
+	if (d == 0.0)
+		d = 0.0;
+	memcpy(&word, &d, sizeof(uint64));
+	return hash64_word(state, word);
+}
+
+/*
+ * Add a value of a temporal base type to the hash state. Values that are 
+ * equal for datum_eq must produce the same state.
+ */
+uint64
+datum_hash_update(uint64 state, Datum value, Oid type)
+{
+	ensure_temporal_base_type(type);
+	if (type == BOOLOID)
+		state = hash64_word(state, (uint64) DatumGetBool(value));
+	else if (type == INT4OID)
+		state = hash64_word(state, (uint64) (uint32) DatumGetInt32(value));
+	else if (type == FLOAT8OID)
+	{
+		/* datum_eq compares float values bitwise */
+		double d = DatumGetFloat8(value);
+		uint64 word;
+		memcpy(&word, &d, sizeof(uint64));
+		state = hash64_word(state, word);
+	}
+	else if (type == TEXTOID)
+	{
+		/* Nonidentical strings are never equal for text_cmp */
+		text *txt = DatumGetTextPP(value);
+		state = hash64_bytes(state, VARDATA_ANY(txt), VARSIZE_ANY_EXHDR(txt));
+		if ((Pointer) txt != DatumGetPointer(value))
+			pfree(txt);
+	}
+#ifdef WITH_POSTGIS
+	else if (type == type_oid(T_GEOMETRY) || type == type_oid(T_GEOGRAPHY))
+	{
+		/* datum_point_eq compares the coordinates of the points */
+		GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(value);
+		if (FLAGS_GET_Z(gs->flags))
+		{
+			POINT3DZ point = gs_get_point3dz(gs);
+			state = hash64_double(state, point.x);
+			state = hash64_double(state, point.y);
+			state = hash64_double(state, point.z);
+		}
+		else
+		{
+			POINT2D point = gs_get_point2d(gs);
+			state = hash64_double(state, point.x);
+			state = hash64_double(state, point.y);
+		}
+	}
+#endif
+	return state;
+}
+
+/*****************************************************************************/
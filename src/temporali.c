@@ -295,6 +295,15 @@ temporali_find_timestamp(TemporalI *ti, TimestampTz t, int *pos)
 	return false;
 }
 
+/* Is the i-th instant of the TemporalI before the timestamp? 
+ * This function is used for galloping search with time_gallop. */
+
+static bool
+temporali_inst_before(void *ti, int i, TimestampTz t)
+{
+	return timestamp_cmp_internal(temporali_inst_n((TemporalI *) ti, i)->t, t) < 0;
+}
+
 /*****************************************************************************
  * Intersection functions
  *****************************************************************************/
@@ -746,6 +755,30 @@ temporali_shift(TemporalI *ti, Interval *interval)
 	return result;
 }
 
+/* 
+ * Sample the temporal value at the timestamps origin + k * step.
+ * Since the value is only defined at its instants, these are kept when
+ * they fall on a sampling timestamp.
+ */
+
+TemporalI *
+temporali_resample(TemporalI *ti, TimestampTz origin, int64 step)
+{
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
+	int k = 0;
+	for (int i = 0; i < ti->count; i++)
+	{
+		TemporalInst *inst = temporali_inst_n(ti, i);
+		if ((inst->t - origin) % step == 0)
+			instants[k++] = inst;
+	}
+	TemporalI *result = NULL;
+	if (k > 0)
+		result = temporali_from_temporalinstarr(instants, k);
+	pfree(instants);
+	return result;
+}
+
 /*****************************************************************************
  * Ever/always comparison operators
  *****************************************************************************/
@@ -1331,6 +1364,28 @@ temporali_value_at_timestamp(TemporalI *ti, TimestampTz t, Datum *result)
 	return true;
 }
 
+/*
+ * Values at the timestamps, which are assumed to be in increasing order.
+ * The instants and the timestamps are merged in a single pass.
+ */
+
+void
+temporali_values_at_timestamps(TemporalI *ti, TimestampTz *times, int count,
+	Datum *values, bool *nulls)
+{
+	int j = 0;
+	for (int i = 0; i < count; i++)
+	{
+		while (j < ti->count && timestamp_cmp_internal(
+			temporali_inst_n(ti, j)->t, times[i]) < 0)
+			j++;
+		nulls[i] = (j == ti->count || timestamp_cmp_internal(
+			temporali_inst_n(ti, j)->t, times[i]) != 0);
+		if (! nulls[i])
+			values[i] = temporalinst_value_copy(temporali_inst_n(ti, j));
+	}
+}
+
 /* Restriction to the complement of a timestamptz */
 
 TemporalI *
@@ -1388,22 +1443,24 @@ temporali_at_timestampset(TemporalI *ti, TimestampSet *ts)
 	}
 
 	/* General case */
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ts->count);
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * 
+		Min(ts->count, ti->count));
 	int count = 0;
 	int i = 0, j = 0;
 	while (i < ts->count && j < ti->count) 
 	{
 		TemporalInst *inst = temporali_inst_n(ti, j);
 		TimestampTz t = timestampset_time_n(ts, i);
-		if (timestamp_cmp_internal(t, inst->t) == 0)
+		int cmp = timestamp_cmp_internal(t, inst->t);
+		if (cmp == 0)
 		{
 			instants[count++] = inst;
-			i++;
+			i++; j++;
 		}
-		if (timestamp_cmp_internal(t, inst->t) < 0)
-			i++;
-		if (timestamp_cmp_internal(t, inst->t) > 0)
-			j++;
+		else if (cmp < 0)
+			i = time_gallop(ts, i + 1, ts->count, inst->t, &timestampset_time_before);
+		else
+			j = time_gallop(ti, j + 1, ti->count, t, &temporali_inst_before);
 	}	
 	TemporalI *result = (count == 0) ? NULL :
 		temporali_from_temporalinstarr(instants, count);
@@ -1440,18 +1497,14 @@ temporali_minus_timestampset(TemporalI *ti, TimestampSet *ts)
 	/* General case */
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
 	int count = 0;
-	int i = 0, j = 0;
-	while (i < ts->count && j < ti->count)
+	int j = 0;
+	for (int i = 0; i < ti->count; i++)
 	{
-		TemporalInst *inst = temporali_inst_n(ti, j);
-		TimestampTz t = timestampset_time_n(ts, i);
-		if (timestamp_cmp_internal(t, inst->t) <= 0)
-			i++;
-		else /* (timestamp_cmp_internal(t, inst->t) > 0) */
-		{
+		TemporalInst *inst = temporali_inst_n(ti, i);
+		j = time_gallop(ts, j, ts->count, inst->t, &timestampset_time_before);
+		if (j == ts->count || 
+			timestamp_cmp_internal(timestampset_time_n(ts, j), inst->t) != 0)
 			instants[count++] = inst;
-			j++;
-		}
 	}
 	TemporalI *result = (count == 0) ? NULL :
 		temporali_from_temporalinstarr(instants, count);
@@ -1477,11 +1530,15 @@ temporali_at_period(TemporalI *ti, Period *period)
 	/* General case */
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
 	int count = 0;
-	for (int i = 0; i < ti->count; i++)
+	int first = time_gallop(ti, 0, ti->count, period->lower, 
+		&temporali_inst_before);
+	for (int i = first; i < ti->count; i++)
 	{
 		TemporalInst *inst = temporali_inst_n(ti, i);
 		if (contains_period_timestamp_internal(period, inst->t))
 			instants[count++] = inst;
+		else if (timestamp_cmp_internal(period->upper, inst->t) <= 0)
+			break;
 	}
 	TemporalI *result = (count == 0) ? NULL :
 		temporali_from_temporalinstarr(instants, count);
@@ -1550,11 +1607,20 @@ temporali_at_periodset(TemporalI *ti, PeriodSet *ps)
 	/* General case */
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
 	int count = 0;
-	for (int i = 0; i < ti->count; i++)
+	int i = 0, j = 0;
+	while (i < ti->count && j < ps->count)
 	{
 		TemporalInst *inst = temporali_inst_n(ti, i);
-		if (contains_periodset_timestamp_internal(ps, inst->t))
+		Period *p = periodset_per_n(ps, j);
+		if (contains_period_timestamp_internal(p, inst->t))
+		{
 			instants[count++] = inst;
+			i++;
+		}
+		else if (timestamp_cmp_internal(inst->t, p->lower) <= 0)
+			i = time_gallop(ti, i + 1, ti->count, p->lower, &temporali_inst_before);
+		else
+			j = time_gallop(ps, j + 1, ps->count, inst->t, &periodset_per_before);
 	}
 	TemporalI *result = (count == 0) ? NULL :
 		temporali_from_temporalinstarr(instants, count);
@@ -1593,10 +1659,13 @@ temporali_minus_periodset(TemporalI *ti, PeriodSet *ps)
 	/* General case */
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
 	int count = 0;
+	int j = 0;
 	for (int i = 0; i < ti->count; i++)
 	{
 		TemporalInst *inst = temporali_inst_n(ti, i);
-		if (!contains_periodset_timestamp_internal(ps, inst->t))
+		j = time_gallop(ps, j, ps->count, inst->t, &periodset_per_before);
+		if (j == ps->count || 
+			! contains_period_timestamp_internal(periodset_per_n(ps, j), inst->t))
 			instants[count++] = inst;
 	}
 	TemporalI *result = (count == 0) ? NULL :
@@ -1623,9 +1692,19 @@ temporali_intersects_timestamp(TemporalI *ti, TimestampTz t)
 bool
 temporali_intersects_timestampset(TemporalI *ti, TimestampSet *ts)
 {
-	for (int i = 0; i < ts->count; i++)
-		if (temporali_intersects_timestamp(ti, timestampset_time_n(ts, i)))
+	int i = 0, j = 0;
+	while (i < ts->count && j < ti->count) 
+	{
+		TimestampTz t = timestampset_time_n(ts, i);
+		TemporalInst *inst = temporali_inst_n(ti, j);
+		int cmp = timestamp_cmp_internal(t, inst->t);
+		if (cmp == 0)
 			return true;
+		if (cmp < 0)
+			i = time_gallop(ts, i + 1, ts->count, inst->t, &timestampset_time_before);
+		else
+			j = time_gallop(ti, j + 1, ti->count, t, &temporali_inst_before);
+	}
 	return false;
 }
 
@@ -1634,11 +1713,15 @@ temporali_intersects_timestampset(TemporalI *ti, TimestampSet *ts)
 bool
 temporali_intersects_period(TemporalI *ti, Period *period)
 {
-	for (int i = 0; i < ti->count; i++)
+	int first = time_gallop(ti, 0, ti->count, period->lower, 
+		&temporali_inst_before);
+	for (int i = first; i < ti->count; i++)
 	{
 		TemporalInst *inst = temporali_inst_n(ti, i);
 		if (contains_period_timestamp_internal(period, inst->t))
 			return true;
+		if (timestamp_cmp_internal(period->upper, inst->t) <= 0)
+			break;
 	}
 	return false;
 }
@@ -1648,9 +1731,18 @@ temporali_intersects_period(TemporalI *ti, Period *period)
 bool
 temporali_intersects_periodset(TemporalI *ti, PeriodSet *ps)
 {
-	for (int i = 0; i < ps->count; i++)
-		if (temporali_intersects_period(ti, periodset_per_n(ps, i))) 
+	int i = 0, j = 0;
+	while (i < ti->count && j < ps->count)
+	{
+		TemporalInst *inst = temporali_inst_n(ti, i);
+		Period *p = periodset_per_n(ps, j);
+		if (contains_period_timestamp_internal(p, inst->t))
 			return true;
+		if (timestamp_cmp_internal(inst->t, p->lower) <= 0)
+			i = time_gallop(ti, i + 1, ti->count, p->lower, &temporali_inst_before);
+		else
+			j = time_gallop(ps, j + 1, ps->count, inst->t, &periodset_per_before);
+	}
 	return false;
 }
 
@@ -1741,21 +1833,15 @@ temporali_cmp(TemporalI *ti1, TemporalI *ti2)
 
 /*****************************************************************************
  * Function for defining hash index
- * The function reuses the approach for array types for combining the hash of  
- * the elements.
+ * The instants are added in order to the hash state
  *****************************************************************************/
 
-uint32
-temporali_hash(TemporalI *ti)
+uint64
+temporali_hash_update(uint64 state, TemporalI *ti)
 {
-	uint32 result = 1;
 	for (int i = 0; i < ti->count; i++)
-	{
-		TemporalInst *inst = temporali_inst_n(ti, i);
-		uint32 inst_hash = temporalinst_hash(inst);
-		result = (result << 5) - result + inst_hash;
-	}
-	return result;
+		state = temporalinst_hash_update(state, temporali_inst_n(ti, i));
+	return state;
 }
 
 /*****************************************************************************/
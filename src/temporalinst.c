@@ -581,6 +581,19 @@ temporalinst_value_at_timestamp(TemporalInst *inst, TimestampTz t, Datum *result
 	return true;
 }
 
+/*
+ * Values at the timestamps, which are assumed to be in increasing order.
+ * The null flag of a timestamp is set when the value is not defined at it.
+ */
+
+void
+temporalinst_values_at_timestamps(TemporalInst *inst, TimestampTz *times, 
+	int count, Datum *values, bool *nulls)
+{
+	for (int i = 0; i < count; i++)
+		nulls[i] = ! temporalinst_value_at_timestamp(inst, times[i], &values[i]);
+}
+
 /* Restriction to the complement of a timestamptz */
 
 TemporalInst *
@@ -749,42 +762,15 @@ temporalinst_cmp(TemporalInst *inst1, TemporalInst *inst2)
 
 /*****************************************************************************
  * Function for defining hash index
- * The function reuses the approach for range types for combining the hash of  
- * the lower and upper bounds.
+ * The timestamp and the value are added to the 64-bit hash state, which 
+ * allows the instants of the other durations to be hashed in a single pass.
  *****************************************************************************/
 
-uint32
-temporalinst_hash(TemporalInst *inst)
+uint64
+temporalinst_hash_update(uint64 state, TemporalInst *inst)
 {
-	uint32		result;
-	uint32		time_hash;
-
-	Datum value = temporalinst_value(inst);
-	/* Apply the hash function according to the subtype */
-	uint32 value_hash = 0; 
-	ensure_temporal_base_type(inst->valuetypid);
-	if (inst->valuetypid == BOOLOID)
-		value_hash = DatumGetUInt32(call_function1(hashchar, value));
-	else if (inst->valuetypid == INT4OID)
-		value_hash = DatumGetUInt32(call_function1(hashint4, value));
-	else if (inst->valuetypid == FLOAT8OID)
-		value_hash = DatumGetUInt32(call_function1(hashfloat8, value));
-	else if (inst->valuetypid == TEXTOID)
-		value_hash = DatumGetUInt32(call_function1(hashtext, value));
-#ifdef WITH_POSTGIS
-	else if (inst->valuetypid == type_oid(T_GEOMETRY) || 
-		inst->valuetypid == type_oid(T_GEOGRAPHY))
-		value_hash = DatumGetUInt32(call_function1(lwgeom_hash, value));
-#endif
-	/* Apply the hash function according to the timestamp */
-	time_hash = DatumGetUInt32(call_function1(hashint8, TimestampTzGetDatum(inst->t)));
-
-	/* Merge hashes of value and timestamp */
-	result = value_hash;
-	result = (result << 1) | (result >> 31);
-	result ^= time_hash;
-
-	return result;
+	state = hash64_word(state, (uint64) inst->t);
+	return datum_hash_update(state, temporalinst_value(inst), inst->valuetypid);
 }
 
 /*****************************************************************************/
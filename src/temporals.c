@@ -297,6 +297,17 @@ temporals_find_timestamp(TemporalS *ts, TimestampTz t, int *pos)
 	return false;
 }
 
+/* Is the i-th sequence of the TemporalS before the timestamp? 
+ * This function is used for galloping search with time_gallop. */
+
+static bool
+temporals_seq_before(void *ts, int i, TimestampTz t)
+{
+	Period *p = &temporals_seq_n((TemporalS *) ts, i)->period;
+	int cmp = timestamp_cmp_internal(p->upper, t);
+	return cmp < 0 || (cmp == 0 && ! p->upper_inc);
+}
+
 /*****************************************************************************
  * Intersection functions
  *****************************************************************************/
@@ -1252,7 +1263,7 @@ temporals_shift(TemporalS *ts, Interval *interval)
 		/* Shift bounding box */
 		void *bbox = temporalseq_bbox_ptr(seq); 
 		shift_bbox(bbox, seq->valuetypid, interval);
-	
+		temporalseq_shift_blocks(seq, interval);
 	}
 	/* Shift bounding box */
 	void *bbox = temporals_bbox_ptr(result); 
@@ -1262,6 +1273,54 @@ temporals_shift(TemporalS *ts, Interval *interval)
 	return result;
 }
 
+/* 
+ * Sample the temporal value at the timestamps origin + k * step.
+ * Each sequence is sampled independently on the same grid.
+ */
+
+TemporalS *
+temporals_resample(TemporalS *ts, TimestampTz origin, int64 step)
+{
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->count);
+	int k = 0;
+	for (int i = 0; i < ts->count; i++)
+	{
+		TemporalSeq *seq = temporalseq_resample(temporals_seq_n(ts, i), 
+			origin, step);
+		if (seq != NULL)
+			sequences[k++] = seq;
+	}
+	if (k == 0)
+	{
+		pfree(sequences);
+		return NULL;
+	}
+	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
+		MOBDB_FLAGS_GET_LINEAR(ts->flags), false);
+	for (int i = 0; i < k; i++)
+		pfree(sequences[i]);
+	pfree(sequences);
+	return result;
+}
+
+/* Simplify each sequence of the temporal value with a tolerance */
+
+TemporalS *
+temporals_simplify(TemporalS *ts, double eps, bool synchronized, 
+	bool streaming)
+{
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->count);
+	for (int i = 0; i < ts->count; i++)
+		sequences[i] = temporalseq_simplify(temporals_seq_n(ts, i), eps, 
+			synchronized, streaming);
+	TemporalS *result = temporals_from_temporalseqarr(sequences, ts->count,
+		MOBDB_FLAGS_GET_LINEAR(ts->flags), false);
+	for (int i = 0; i < ts->count; i++)
+		pfree(sequences[i]);
+	pfree(sequences);
+	return result;
+}
+
 /*****************************************************************************
  * Ever/always comparison operators
  *****************************************************************************/
@@ -1893,6 +1952,29 @@ temporals_value_at_timestamp(TemporalS *ts, TimestampTz t, Datum *result)
 	return temporalseq_value_at_timestamp(temporals_seq_n(ts, n), t, result);
 }
 
+/*
+ * Values at the timestamps, which are assumed to be in increasing order.
+ * Each sequence evaluates in one pass the run of timestamps that are not 
+ * after it.
+ */
+void
+temporals_values_at_timestamps(TemporalS *ts, TimestampTz *times, int count,
+	Datum *values, bool *nulls)
+{
+	int i = 0;
+	for (int j = 0; j < ts->count && i < count; j++)
+	{
+		int l = i;
+		while (l < count && ! temporals_seq_before(ts, j, times[l]))
+			l++;
+		temporalseq_values_at_timestamps(temporals_seq_n(ts, j), &times[i], 
+			l - i, &values[i], &nulls[i]);
+		i = l;
+	}
+	for (; i < count; i++)
+		nulls[i] = true;
+}
+
 /*
  * Restriction to a timestampset.
  */
@@ -1923,13 +2005,11 @@ temporals_at_timestampset(TemporalS *ts1, TimestampSet *ts2)
 			instants[count++] = temporalseq_at_timestamp(seq, t);
 			i++;
 		}
+		else if (timestamp_cmp_internal(t, seq->period.lower) <= 0)
+			i = time_gallop(ts2, i + 1, ts2->count, seq->period.lower, 
+				&timestampset_time_before);
 		else
-		{
-			if (timestamp_cmp_internal(t, seq->period.lower) <= 0)
-				i++;
-			if (timestamp_cmp_internal(t, seq->period.upper) >= 0)
-				j++;
-		}
+			j = time_gallop(ts1, j + 1, ts1->count, t, &temporals_seq_before);
 	}
 	if (count == 0)
 	{
@@ -1964,12 +2044,18 @@ temporals_minus_timestampset(TemporalS *ts1, TimestampSet *ts2)
 	/* General case */
 	/* Each timestamp will split at most one composing sequence into two */
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * (ts1->count + ts2->count + 1));
-	int k = 0;
+	int j = 0, k = 0;
 	for (int i = 0; i < ts1->count; i++)
 	{
 		TemporalSeq *seq = temporals_seq_n(ts1, i);
-		int count = temporalseq_minus_timestampset1(&sequences[k], seq, ts2);
-		k += count;
+		/* Copy the sequence if no timestamp falls within its period */
+		j = time_gallop(ts2, j, ts2->count, seq->period.lower, 
+			&timestampset_time_before);
+		if (j == ts2->count || timestamp_cmp_internal(
+				timestampset_time_n(ts2, j), seq->period.upper) > 0)
+			sequences[k++] = temporalseq_copy(seq);
+		else
+			k += temporalseq_minus_timestampset1(&sequences[k], seq, ts2);
 	}
 	if (k == 0)
 	{
@@ -2099,6 +2185,18 @@ temporals_at_periodset(TemporalS *ts, PeriodSet *ps)
 	{
 		TemporalSeq *seq = temporals_seq_n(ts, i);
 		Period *p = periodset_per_n(ps, j);
+		/* Gallop over the sequences or the periods that are before the other */
+		if (before_period_period_internal(&seq->period, p))
+		{
+			i = time_gallop(ts, i + 1, ts->count, p->lower, &temporals_seq_before);
+			continue;
+		}
+		if (before_period_period_internal(p, &seq->period))
+		{
+			j = time_gallop(ps, j + 1, ps->count, seq->period.lower, 
+				&periodset_per_before);
+			continue;
+		}
 		TemporalSeq *seq1 = temporalseq_at_period(seq, p);
 		if (seq1 != NULL)
 			sequences[k++] = seq1;
@@ -2148,12 +2246,15 @@ temporals_minus_periodset(TemporalS *ts, PeriodSet *ps)
 	/* General case */
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * (ts->count + ps->count));
 	int i = 0, j = 0, k = 0;
-	while (i < ts->count && j < ps->count)
+	while (i < ts->count)
 	{
 		TemporalSeq *seq = temporals_seq_n(ts, i);
-		p2 = periodset_per_n(ps, j);
+		/* Skip the periods that are before the sequence */
+		j = time_gallop(ps, j, ps->count, seq->period.lower, &periodset_per_before);
+		if (j < ps->count)
+			p2 = periodset_per_n(ps, j);
 		/* The sequence and the period do not overlap, copy the sequence */
-		if (!overlaps_period_period_internal(&seq->period, p2))
+		if (j == ps->count || !overlaps_period_period_internal(&seq->period, p2))
 		{
 			sequences[k++] = temporalseq_copy(seq);
 			i++;
@@ -2173,12 +2274,12 @@ temporals_minus_periodset(TemporalS *ts, PeriodSet *ps)
 				if (!overlaps_period_period_internal(&seq->period, p3))
 					break;
 			}
-			int count = l - j;
 			/* Compute the difference of the overlapping periods */
 			k += temporalseq_minus_periodset1(&sequences[k], seq,
-				ps, j, count);
+				ps, j, l);
 			i++;
-			j = l;
+			/* The last overlapping period may also overlap the next sequence */
+			j = l - 1;
 		}
 	}
 	if (k == 0)
@@ -2206,9 +2307,7 @@ bool
 temporals_intersects_timestamp(TemporalS *ts, TimestampTz t)
 {
 	int n;
-	if (temporals_find_timestamp(ts, t, &n))
-		return false;
-	return true;
+	return temporals_find_timestamp(ts, t, &n);
 }
 
 /* Does the temporal value intersect the timestamp set? */
@@ -2216,9 +2315,19 @@ temporals_intersects_timestamp(TemporalS *ts, TimestampTz t)
 bool
 temporals_intersects_timestampset(TemporalS *ts, TimestampSet *ts1)
 {
-	for (int i = 0; i < ts1->count; i++)
-		if (temporals_intersects_timestamp(ts, timestampset_time_n(ts1, i))) 
+	int i = 0, j = 0;
+	while (i < ts1->count && j < ts->count)
+	{
+		TemporalSeq *seq = temporals_seq_n(ts, j);
+		TimestampTz t = timestampset_time_n(ts1, i);
+		if (contains_period_timestamp_internal(&seq->period, t))
 			return true;
+		if (timestamp_cmp_internal(t, seq->period.lower) <= 0)
+			i = time_gallop(ts1, i + 1, ts1->count, seq->period.lower, 
+				&timestampset_time_before);
+		else
+			j = time_gallop(ts, j + 1, ts->count, t, &temporals_seq_before);
+	}
 	return false;
 }
 
@@ -2249,9 +2358,19 @@ temporals_intersects_period(TemporalS *ts, Period *p)
 bool
 temporals_intersects_periodset(TemporalS *ts, PeriodSet *ps)
 {
-	for (int i = 0; i < ps->count; i++)
-		if (temporals_intersects_period(ts, periodset_per_n(ps, i))) 
+	int i = 0, j = 0;
+	while (i < ts->count && j < ps->count)
+	{
+		TemporalSeq *seq = temporals_seq_n(ts, i);
+		Period *p = periodset_per_n(ps, j);
+		if (overlaps_period_period_internal(&seq->period, p))
 			return true;
+		if (before_period_period_internal(&seq->period, p))
+			i = time_gallop(ts, i + 1, ts->count, p->lower, &temporals_seq_before);
+		else
+			j = time_gallop(ps, j + 1, ps->count, seq->period.lower, 
+				&periodset_per_before);
+	}
 	return false;
 }
 
@@ -2362,21 +2481,15 @@ temporals_cmp(TemporalS *ts1, TemporalS *ts2)
 
 /*****************************************************************************
  * Function for defining hash index
- * The function reuses the approach for array types for combining the hash of  
- * the elements.
+ * The sequences are added in order to the hash state
  *****************************************************************************/
 
-uint32
-temporals_hash(TemporalS *ts)
+uint64
+temporals_hash_update(uint64 state, TemporalS *ts)
 {
-	uint32 result = 1;
 	for (int i = 0; i < ts->count; i++)
-	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		uint32 seq_hash = temporalseq_hash(seq);
-		result = (result << 5) - result + seq_hash;
-	}
-	return result;
+		state = temporalseq_hash_update(state, temporals_seq_n(ts, i));
+	return state;
 }
 
 /*****************************************************************************/
@@ -13,6 +13,8 @@
 #include "temporalseq.h"
 
 #include <assert.h>
+#include <float.h>
+#include <math.h>
 #include <access/hash.h>
 #include <libpq/pqformat.h>
 #include <utils/builtins.h>
@@ -30,6 +32,7 @@
 #include "rangetypes_ext.h"
 
 #ifdef WITH_POSTGIS
+#include "postgis.h"
 #include "tpoint.h"
 #include "tpoint_boxops.h"
 #include "tpoint_spatialfuncs.h"
@@ -56,6 +59,15 @@
  * bounding box and offset_3 is the offset for the precomputed trajectory. 
  * Precomputed trajectories are only kept for temporal points of sequence 
  * duration.
+ *
+ * BLOCK BOUNDING BOXES
+ * Temporal numbers and temporal geometric points with more than 
+ * TEMPORALSEQ_BLOCK_SIZE segments additionally keep at the end of the value 
+ * the bounding boxes of consecutive blocks of TEMPORALSEQ_BLOCK_SIZE segments,
+ * which is signaled by the BLOCKS flag. Block k covers the instants 
+ * k * TEMPORALSEQ_BLOCK_SIZE to (k + 1) * TEMPORALSEQ_BLOCK_SIZE, so that
+ * consecutive blocks share one instant. These boxes allow the restriction
+ * and spatial functions to skip the blocks that cannot satisfy a condition.
  */
 
 /* N-th TemporalInst of a TemporalSeq */
@@ -87,6 +99,56 @@ temporalseq_bbox(void *box, TemporalSeq *seq)
 	memcpy(box, box1, bboxsize);
 }
 
+/* Number of block bounding boxes of a TemporalSeq */
+
+int
+temporalseq_block_count(TemporalSeq *seq)
+{
+	if (! MOBDB_FLAGS_GET_BLOCKS(seq->flags))
+		return 0;
+	return (seq->count - 2) / TEMPORALSEQ_BLOCK_SIZE + 1;
+}
+
+/* Pointer to the k-th block bounding box of a TemporalSeq */
+
+void *
+temporalseq_block_bbox_ptr(TemporalSeq *seq, int k)
+{
+	size_t bboxsize = double_pad(temporal_bbox_size(seq->valuetypid));
+	int nblocks = temporalseq_block_count(seq);
+	return (char *)seq + VARSIZE(seq) - (nblocks - k) * bboxsize;
+}
+
+/*
+ * Index of the next segment (or instant) to visit when iterating over a
+ * TemporalSeq from the i-th one. When i starts a block whose bounding box 
+ * does not satisfy the predicate, the block is skipped and the index of its 
+ * last instant is returned, otherwise i is returned.
+ */
+int
+temporalseq_block_skip(TemporalSeq *seq, int i, 
+	bool (*pred)(void *, void *), void *arg)
+{
+	if (! MOBDB_FLAGS_GET_BLOCKS(seq->flags) || 
+		i % TEMPORALSEQ_BLOCK_SIZE != 0 || i >= seq->count - 1)
+		return i;
+	void *box = temporalseq_block_bbox_ptr(seq, i / TEMPORALSEQ_BLOCK_SIZE);
+	if (pred(box, arg))
+		return i;
+	return Min(i + TEMPORALSEQ_BLOCK_SIZE, seq->count - 1);
+}
+
+/* Shift the block bounding boxes of a TemporalSeq by an interval */
+
+void
+temporalseq_shift_blocks(TemporalSeq *seq, Interval *interval)
+{
+	int nblocks = temporalseq_block_count(seq);
+	for (int k = 0; k < nblocks; k++)
+		shift_bbox(temporalseq_block_bbox_ptr(seq, k), seq->valuetypid, 
+			interval);
+}
+
 /* 
  * Are the three temporal instant values collinear?
  * These functions supposes that the segments are not constant.
@@ -643,6 +705,15 @@ temporalseq_from_temporalinstarr(TemporalInst **instants, int count,
 		}
 	}
 #endif
+	/* Add the size of the block bounding boxes */
+	bool blocks = newcount - 1 > TEMPORALSEQ_BLOCK_SIZE &&
+		(valuetypid == INT4OID || valuetypid == FLOAT8OID);
+#ifdef WITH_POSTGIS
+	blocks |= newcount - 1 > TEMPORALSEQ_BLOCK_SIZE &&
+		valuetypid == type_oid(T_GEOMETRY);
+#endif
+	int nblocks = blocks ? (newcount - 2) / TEMPORALSEQ_BLOCK_SIZE + 1 : 0;
+	memsize += nblocks * double_pad(bboxsize);
 	/* Add the size of the struct and the offset array 
 	 * Notice that the first offset is already declared in the struct */
 	size_t pdata = double_pad(sizeof(TemporalSeq)) + (newcount + 1) * sizeof(size_t);
@@ -655,6 +726,7 @@ temporalseq_from_temporalinstarr(TemporalInst **instants, int count,
 	period_set(&result->period, newinstants[0]->t, newinstants[newcount - 1]->t,
 		lower_inc, upper_inc);
 	MOBDB_FLAGS_SET_LINEAR(result->flags, linear);
+	MOBDB_FLAGS_SET_BLOCKS(result->flags, blocks);
 #ifdef WITH_POSTGIS
 	if (isgeo)
 	{
@@ -705,6 +777,14 @@ temporalseq_from_temporalinstarr(TemporalInst **instants, int count,
 		pfree(DatumGetPointer(traj));
 	}
 #endif
+	/* Compute the block bounding boxes */
+	for (int k = 0; k < nblocks; k++)
+	{
+		int first = k * TEMPORALSEQ_BLOCK_SIZE;
+		int last = Min(first + TEMPORALSEQ_BLOCK_SIZE, newcount - 1);
+		temporali_make_bbox(temporalseq_block_bbox_ptr(result, k), 
+			&newinstants[first], last - first + 1);
+	}
 
 	if (normalize && count > 2)
 		pfree(newinstants);
@@ -1291,19 +1371,21 @@ temporalseq_intersect_at_timestamp(TemporalInst *start1, TemporalInst *end1, boo
 		Datum line2 = geogpoint_trajectory(temporalinst_value(start2), 
 			temporalinst_value(end2));
 		Datum bestsrid = call_function2(geography_bestsrid, line1, line2);
-		TemporalInst *start1geom1 = tgeogpointinst_to_tgeompointinst(start1);
-		TemporalInst *end1geom1 = tgeogpointinst_to_tgeompointinst(end1);
-		TemporalInst *start2geom1 = tgeogpointinst_to_tgeompointinst(start2);
-		TemporalInst *end2geom1 = tgeogpointinst_to_tgeompointinst(end2);
-		TemporalInst *start1geom2 = tgeompointinst_transform(start1, bestsrid);
-		TemporalInst *end1geom2 = tgeompointinst_transform(start1, bestsrid);
-		TemporalInst *start2geom2 = tgeompointinst_transform(start2, bestsrid);
-		TemporalInst *end2geom2 = tgeompointinst_transform(start2, bestsrid);
-		result = tpointseq_intersect_at_timestamp(start1geom2, end1geom2, linear1,
-			start2geom2, end2geom2, linear2, inter);
+		TemporalInst *insts[4] = { start1, end1, start2, end2 };
+		TemporalInst *geoms[4];
+		for (int i = 0; i < 4; i++)
+		{
+			TemporalInst *inst = tgeogpointinst_to_tgeompointinst(insts[i]);
+			Datum value = call_function2(transform, temporalinst_value(inst),
+				bestsrid);
+			geoms[i] = temporalinst_make(value, inst->t, type_oid(T_GEOMETRY));
+			pfree(DatumGetPointer(value)); pfree(inst);
+		}
+		result = tpointseq_intersect_at_timestamp(geoms[0], geoms[1], linear1,
+			geoms[2], geoms[3], linear2, inter);
 		pfree(DatumGetPointer(line1)); pfree(DatumGetPointer(line2)); 
-		pfree(start1geom1); pfree(end1geom1); pfree(start2geom1); pfree(end2geom1);
-		pfree(start1geom2); pfree(end1geom2); pfree(start2geom2); pfree(end2geom2);
+		for (int i = 0; i < 4; i++)
+			pfree(geoms[i]);
 	}
 #endif
 	return result;
@@ -1423,6 +1505,8 @@ tfloatseq_to_tintseq(TemporalSeq *seq)
 	TemporalSeq *result = temporalseq_copy(seq);
 	result->valuetypid = INT4OID;
 	MOBDB_FLAGS_SET_LINEAR(result->flags, false);
+	/* Truncating the values may invalidate the block bounding boxes */
+	MOBDB_FLAGS_SET_BLOCKS(result->flags, false);
 	for (int i = 0; i < seq->count; i++)
 	{
 		TemporalInst *inst = temporalseq_inst_n(result, i);
@@ -1782,10 +1866,288 @@ temporalseq_shift(TemporalSeq *seq, Interval *interval)
 	/* Shift bounding box */
 	void *bbox = temporalseq_bbox_ptr(result); 
 	shift_bbox(bbox, seq->valuetypid, interval);
+	temporalseq_shift_blocks(result, interval);
 	pfree(instants);
 	return result;
 }
 
+/*
+ * Sample the temporal value at the timestamps origin + k * step that belong
+ * to its period. The origin must not be after the start of the period.
+ * The result keeps the interpolation of the sequence and has inclusive 
+ * bounds, or is NULL if no sampling timestamp belongs to the period.
+ */
+
+TemporalSeq *
+temporalseq_resample(TemporalSeq *seq, TimestampTz origin, int64 step)
+{
+	assert(origin <= seq->period.lower);
+	TimestampTz lower = seq->period.lower, upper = seq->period.upper;
+	TimestampTz start = origin + ((lower - origin + step - 1) / step) * step;
+	if (start == lower && ! seq->period.lower_inc)
+		start += step;
+	if (start > upper)
+		return NULL;
+	int count = (int) ((upper - start) / step) + 1;
+	if (start + (count - 1) * step == upper && ! seq->period.upper_inc)
+		count--;
+	if (count == 0)
+		return NULL;
+
+	TimestampTz *times = palloc(sizeof(TimestampTz) * count);
+	for (int i = 0; i < count; i++)
+		times[i] = start + i * step;
+	Datum *values = palloc(sizeof(Datum) * count);
+	bool *nulls = palloc(sizeof(bool) * count);
+	temporalseq_values_at_timestamps(seq, times, count, values, nulls);
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
+	for (int i = 0; i < count; i++)
+	{
+		instants[i] = temporalinst_make(values[i], times[i], seq->valuetypid);
+		FREE_DATUM(values[i], seq->valuetypid);
+	}
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, count,
+		true, true, MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
+	for (int i = 0; i < count; i++)
+		pfree(instants[i]);
+	pfree(instants); pfree(values); pfree(nulls); pfree(times);
+	return result;
+}
+
+/*****************************************************************************
+ * Simplification
+ * The instants of a sequence are seen as vectors of coordinates, that is,
+ * the value of a temporal float or the coordinates of a temporal point.
+ * An instant can be removed when its distance to the segment joining the
+ * instants that are kept before and after it is at most the tolerance.
+ * This distance is either the distance to the value interpolated at the
+ * timestamp of the instant (synchronized distance) or the distance to the
+ * segment in the value space (spatial distance).
+ *****************************************************************************/
+
+#define SIMPLIFY_MAXDIMS 3
+
+/* Coordinates of the instants of the sequence. Returns the dimensions. */
+
+static int
+temporalseq_coords(TemporalSeq *seq, double *coords)
+{
+	int dims = 1;
+#ifdef WITH_POSTGIS
+	bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
+	if (seq->valuetypid == type_oid(T_GEOMETRY))
+		dims = hasz ? 3 : 2;
+#endif
+	for (int i = 0; i < seq->count; i++)
+	{
+		Datum value = temporalinst_value(temporalseq_inst_n(seq, i));
+		double *c = &coords[i * dims];
+		if (seq->valuetypid == FLOAT8OID)
+			c[0] = DatumGetFloat8(value);
+#ifdef WITH_POSTGIS
+		else if (hasz)
+		{
+			POINT3DZ p = datum_get_point3dz(value);
+			c[0] = p.x; c[1] = p.y; c[2] = p.z;
+		}
+		else
+		{
+			POINT2D p = datum_get_point2d(value);
+			c[0] = p.x; c[1] = p.y;
+		}
+#endif
+	}
+	return dims;
+}
+
+/* 
+ * Distance from the i-th instant to the segment between the a-th and the 
+ * b-th instants
+ */
+
+static double
+simplify_dist(double *coords, TimestampTz *times, int dims, int i, int a, 
+	int b, bool linear, bool synchronized)
+{
+	double *ci = &coords[i * dims], *ca = &coords[a * dims], 
+		*cb = &coords[b * dims];
+	double ratio;
+	if (! linear)
+		ratio = 0.0;
+	else if (synchronized)
+		ratio = (double) (times[i] - times[a]) / (double) (times[b] - times[a]);
+	else
+	{
+		/* Projection of the instant on the segment */
+		double dot = 0.0, len = 0.0;
+		for (int d = 0; d < dims; d++)
+		{
+			dot += (ci[d] - ca[d]) * (cb[d] - ca[d]);
+			len += (cb[d] - ca[d]) * (cb[d] - ca[d]);
+		}
+		ratio = (len == 0.0) ? 0.0 : Max(0.0, Min(1.0, dot / len));
+	}
+	double result = 0.0;
+	for (int d = 0; d < dims; d++)
+	{
+		double diff = ci[d] - (ca[d] + (cb[d] - ca[d]) * ratio);
+		result += diff * diff;
+	}
+	return sqrt(result);
+}
+
+/* 
+ * Douglas-Peucker simplification. The recursion is replaced by a stack of 
+ * segments so that long sequences do not exhaust the C stack.
+ */
+
+static int
+simplify_dp(bool *keep, double *coords, TimestampTz *times, int dims, 
+	int count, double eps, bool linear, bool synchronized)
+{
+	int *stack = palloc(sizeof(int) * 2 * count);
+	int top = 0, result = 2;
+	stack[top++] = 0; stack[top++] = count - 1;
+	while (top > 0)
+	{
+		int b = stack[--top], a = stack[--top];
+		double maxdist = -1.0;
+		int split = -1;
+		for (int i = a + 1; i < b; i++)
+		{
+			double dist = simplify_dist(coords, times, dims, i, a, b, linear, 
+				synchronized);
+			if (dist > maxdist)
+			{
+				maxdist = dist;
+				split = i;
+			}
+		}
+		if (split >= 0 && maxdist > eps)
+		{
+			keep[split] = true;
+			result++;
+			stack[top++] = a; stack[top++] = split;
+			stack[top++] = split; stack[top++] = b;
+		}
+	}
+	pfree(stack);
+	return result;
+}
+
+/*
+ * One-pass simplification. For linear interpolation the slopes in each
+ * dimension of the segments starting at the last kept instant that satisfy 
+ * the tolerance for all the instants seen since then form a cone that is 
+ * narrowed by each new instant. An instant is kept when the segment to the 
+ * next one leaves the cone. The tolerance is divided among the dimensions 
+ * so that the synchronized distance, and thus the spatial distance, of the 
+ * removed instants is at most the tolerance. For stepwise interpolation an 
+ * instant is kept when its value is farther than the tolerance from the 
+ * value of the last kept instant.
+ */
+
+static int
+simplify_stream(bool *keep, double *coords, TimestampTz *times, int dims, 
+	int count, double eps, bool linear)
+{
+	double lo[SIMPLIFY_MAXDIMS], hi[SIMPLIFY_MAXDIMS];
+	double tol = eps / sqrt((double) dims);
+	int a = 0, result = 2;
+	for (int d = 0; d < dims; d++)
+	{
+		lo[d] = -DBL_MAX;
+		hi[d] = DBL_MAX;
+	}
+	for (int k = 1; k < count - 1; k++)
+	{
+		double *ca = &coords[a * dims], *ck = &coords[k * dims];
+		if (! linear)
+		{
+			double dist = 0.0;
+			for (int d = 0; d < dims; d++)
+				dist += (ck[d] - ca[d]) * (ck[d] - ca[d]);
+			if (sqrt(dist) > eps)
+			{
+				keep[k] = true;
+				result++;
+				a = k;
+			}
+			continue;
+		}
+		/* Narrow the cone with the current instant */
+		double dt = (double) (times[k] - times[a]);
+		for (int d = 0; d < dims; d++)
+		{
+			lo[d] = Max(lo[d], (ck[d] - tol - ca[d]) / dt);
+			hi[d] = Min(hi[d], (ck[d] + tol - ca[d]) / dt);
+		}
+		/* The current instant is removed if the segment to the next one 
+		 * is inside the cone */
+		double *cn = &coords[(k + 1) * dims];
+		dt = (double) (times[k + 1] - times[a]);
+		bool inside = true;
+		for (int d = 0; d < dims && inside; d++)
+		{
+			double slope = (cn[d] - ca[d]) / dt;
+			if (slope < lo[d] || slope > hi[d])
+				inside = false;
+		}
+		if (! inside)
+		{
+			keep[k] = true;
+			result++;
+			a = k;
+			for (int d = 0; d < dims; d++)
+			{
+				lo[d] = -DBL_MAX;
+				hi[d] = DBL_MAX;
+			}
+		}
+	}
+	return result;
+}
+
+/*
+ * Simplify the temporal sequence with a tolerance. The first and the last 
+ * instants are always kept. When streaming is true the instants are 
+ * decided in a single pass in linear time, otherwise the Douglas-Peucker 
+ * algorithm is used, which may keep fewer instants.
+ */
+
+TemporalSeq *
+temporalseq_simplify(TemporalSeq *seq, double eps, bool synchronized, 
+	bool streaming)
+{
+	if (seq->count <= 2)
+		return temporalseq_copy(seq);
+
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	double *coords = palloc(sizeof(double) * SIMPLIFY_MAXDIMS * seq->count);
+	int dims = temporalseq_coords(seq, coords);
+	TimestampTz *times = palloc(sizeof(TimestampTz) * seq->count);
+	bool *keep = palloc0(sizeof(bool) * seq->count);
+	for (int i = 0; i < seq->count; i++)
+		times[i] = temporalseq_inst_n(seq, i)->t;
+	keep[0] = keep[seq->count - 1] = true;
+	int count = streaming ?
+		simplify_stream(keep, coords, times, dims, seq->count, eps, linear) :
+		simplify_dp(keep, coords, times, dims, seq->count, eps, linear, 
+			synchronized);
+
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
+	int k = 0;
+	for (int i = 0; i < seq->count; i++)
+	{
+		if (keep[i])
+			instants[k++] = temporalseq_inst_n(seq, i);
+	}
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, count,
+		seq->period.lower_inc, seq->period.upper_inc, linear, false);
+	pfree(instants); pfree(keep); pfree(times); pfree(coords);
+	return result;
+}
+
 /*****************************************************************************
  * Ever/always comparison operators
  * The functions assume that the temporal value and the datum value are of
@@ -1820,16 +2182,26 @@ tlinearseq_ever_eq1(TemporalInst *inst1, TemporalInst *inst2,
 	return tlinearseq_timestamp_at_value(inst1, inst2, value, valuetypid, &t);
 }
 
+/* Do the values of the block bounding box contain the value? */
+
+static bool
+tbox_contains_value(void *box, void *arg)
+{
+	double d = *((double *) arg);
+	return ((TBOX *) box)->xmin <= d && d <= ((TBOX *) box)->xmax;
+}
+
 bool
 temporalseq_ever_eq(TemporalSeq *seq, Datum value)
 {
 	/* Bounding box test */
-	if (seq->valuetypid == INT4OID || seq->valuetypid == FLOAT8OID)
+	bool tnumber = seq->valuetypid == INT4OID || seq->valuetypid == FLOAT8OID;
+	double d = tnumber ? datum_double(value, seq->valuetypid) : 0;
+	if (tnumber)
 	{
 		TBOX box;
 		memset(&box, 0, sizeof(TBOX));
 		temporalseq_bbox(&box, seq);
-		double d = datum_double(value, seq->valuetypid);
 		if (d < box.xmin || box.xmax < d)
 			return false;
 	}
@@ -1838,6 +2210,14 @@ temporalseq_ever_eq(TemporalSeq *seq, Datum value)
 	{
 		for (int i = 0; i < seq->count; i++) 
 		{
+			/* Skip the blocks whose values do not contain the value */
+			int j = tnumber ? 
+				temporalseq_block_skip(seq, i, &tbox_contains_value, &d) : i;
+			if (j != i)
+			{
+				i = j - 1;
+				continue;
+			}
 			Datum valueinst = temporalinst_value(temporalseq_inst_n(seq, i));
 			if (datum_eq(valueinst, value, seq->valuetypid))
 				return true;
@@ -1846,16 +2226,22 @@ temporalseq_ever_eq(TemporalSeq *seq, Datum value)
 	}
 	
 	/* Continuous base type */
-	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
-	bool lower_inc = seq->period.lower_inc;
-	for (int i = 1; i < seq->count; i++)
+	for (int i = 0; i < seq->count - 1; i++)
 	{
-		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
-		bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
+		/* Skip the blocks whose values do not contain the value */
+		int j = tnumber ? 
+			temporalseq_block_skip(seq, i, &tbox_contains_value, &d) : i;
+		if (j != i)
+		{
+			i = j - 1;
+			continue;
+		}
+		TemporalInst *inst1 = temporalseq_inst_n(seq, i);
+		TemporalInst *inst2 = temporalseq_inst_n(seq, i + 1);
+		bool lower_inc = (i == 0) ? seq->period.lower_inc : true;
+		bool upper_inc = (i == seq->count - 2) ? seq->period.upper_inc : false;
 		if (tlinearseq_ever_eq1(inst1, inst2, lower_inc, upper_inc, value))
 			return true;
-		inst1 = inst2;
-		lower_inc = true;
 	}
 	return false;
 }
@@ -2763,6 +3149,14 @@ tnumberseq_at_range1(TemporalInst *inst1, TemporalInst *inst2,
 	return result;
 }
 
+/* Does the block bounding box overlap the box? */
+
+static bool
+tbox_overlaps_tbox(void *box, void *arg)
+{
+	return overlaps_tbox_tbox_internal((TBOX *) box, (TBOX *) arg);
+}
+
 /*
  * Restriction to the range.
  * This function is called for each sequence of a TemporalS.
@@ -2787,19 +3181,24 @@ tnumberseq_at_range2(TemporalSeq **result, TemporalSeq *seq, RangeType *range)
 	}
 
 	/* General case */
-	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
-	bool lower_inc = seq->period.lower_inc;
 	int k = 0;
-	for (int i = 1; i < seq->count; i++)
+	for (int i = 0; i < seq->count - 1; i++)
 	{
-		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
-		bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
+		/* Skip the blocks whose values do not overlap the range */
+		int j = temporalseq_block_skip(seq, i, &tbox_overlaps_tbox, &box2);
+		if (j != i)
+		{
+			i = j - 1;
+			continue;
+		}
+		TemporalInst *inst1 = temporalseq_inst_n(seq, i);
+		TemporalInst *inst2 = temporalseq_inst_n(seq, i + 1);
+		bool lower_inc = (i == 0) ? seq->period.lower_inc : true;
+		bool upper_inc = (i == seq->count - 2) ? seq->period.upper_inc : false;
 		TemporalSeq *seq1 = tnumberseq_at_range1(inst1, inst2, 
 			lower_inc, upper_inc, MOBDB_FLAGS_GET_LINEAR(seq->flags), range);
 		if (seq1 != NULL) 
 			result[k++] = seq1;
-		inst1 = inst2;
-		lower_inc = true;
 	}
 	return k;
 }
@@ -3224,6 +3623,36 @@ temporalseq_value_at_timestamp(TemporalSeq *seq, TimestampTz t, Datum *result)
 	return true;
 }
 
+/*
+ * Values at the timestamps, which are assumed to be in increasing order.
+ * The segments and the timestamps are merged in a single pass instead of
+ * searching the segment of each timestamp.
+ */
+void
+temporalseq_values_at_timestamps(TemporalSeq *seq, TimestampTz *times, 
+	int count, Datum *values, bool *nulls)
+{
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	int j = 0;
+	for (int i = 0; i < count; i++)
+	{
+		nulls[i] = ! contains_period_timestamp_internal(&seq->period, times[i]);
+		if (nulls[i])
+			continue;
+		if (seq->count == 1)
+		{
+			values[i] = temporalinst_value_copy(temporalseq_inst_n(seq, 0));
+			continue;
+		}
+		/* Advance to the segment containing the timestamp */
+		while (j < seq->count - 2 && timestamp_cmp_internal(
+			temporalseq_inst_n(seq, j + 1)->t, times[i]) <= 0)
+			j++;
+		values[i] = temporalseq_value_at_timestamp1(temporalseq_inst_n(seq, j),
+			temporalseq_inst_n(seq, j + 1), linear, times[i]);
+	}
+}
+
 /* 
  * Restriction to a timestamp.
  * The function supposes that the timestamp t is between inst1->t and inst2->t
@@ -3384,6 +3813,8 @@ temporalseq_at_timestampset(TemporalSeq *seq, TimestampSet *ts)
 	for (int i = n; i < ts->count; i++) 
 	{
 		t = timestampset_time_n(ts, i);
+		if (timestamp_cmp_internal(t, seq->period.upper) > 0)
+			break;
 		inst = temporalseq_at_timestamp(seq, t);
 		if (inst != NULL)
 			instants[k++] = inst;
@@ -3431,9 +3862,13 @@ temporalseq_minus_timestampset1(TemporalSeq **result, TemporalSeq *seq,
 	/* General case */
 	TemporalSeq *tail = temporalseq_copy(seq);
 	int k = 0;
-	for (int i = 0; i < ts->count; i++)
+	int first = time_gallop(ts, 0, ts->count, seq->period.lower, 
+		&timestampset_time_before);
+	for (int i = first; i < ts->count; i++)
 	{
 		TimestampTz t = timestampset_time_n(ts, i);
+		if (timestamp_cmp_internal(t, seq->period.upper) > 0)
+			break;
 		if (contains_period_timestamp_internal(&tail->period, t))
 		{
 			int count = temporalseq_minus_timestamp1(&result[k], tail, t);
@@ -3848,8 +4283,12 @@ tnumberseq_twavg(TemporalSeq *seq)
 bool
 temporalseq_eq(TemporalSeq *seq1, TemporalSeq *seq2)
 {
+	/* The block bounding boxes do not change the value */
+	int16 flags1 = seq1->flags, flags2 = seq2->flags;
+	MOBDB_FLAGS_SET_BLOCKS(flags1, false);
+	MOBDB_FLAGS_SET_BLOCKS(flags2, false);
 	/* If number of sequences, flags, or periods are not equal */
-	if (seq1->count != seq2->count || seq1->flags != seq2->flags ||
+	if (seq1->count != seq2->count || flags1 != flags2 ||
 			! period_eq_internal(&seq1->period, &seq2->period)) 
 		return false;
 
@@ -3898,10 +4337,13 @@ temporalseq_cmp(TemporalSeq *seq1, TemporalSeq *seq2)
 		return -1;
 	else if (seq2->count < seq1->count) /* seq2 has less instants than seq1 */
 		return 1;
-	/* Compare flags */
-	if (seq1->flags < seq2->flags)
+	/* Compare flags ignoring the block bounding boxes */
+	int16 flags1 = seq1->flags, flags2 = seq2->flags;
+	MOBDB_FLAGS_SET_BLOCKS(flags1, false);
+	MOBDB_FLAGS_SET_BLOCKS(flags2, false);
+	if (flags1 < flags2)
 		return -1;
-	if (seq1->flags > seq2->flags)
+	if (flags1 > flags2)
 		return 1;
 	/* The two values are equal */
 	return 0;
@@ -3909,31 +4351,24 @@ temporalseq_cmp(TemporalSeq *seq1, TemporalSeq *seq2)
 
 /*****************************************************************************
  * Function for defining hash index
- * The function reuses the approach for array types for combining the hash of  
- * the elements and the approach for range types for combining the period 
- * bounds.
+ * The bounds are only added for sequences with more than one instant, since
+ * an instantaneous sequence is equal to the corresponding instant.
  *****************************************************************************/
 
-uint32
-temporalseq_hash(TemporalSeq *seq)
+uint64
+temporalseq_hash_update(uint64 state, TemporalSeq *seq)
 {
-	uint32		result;
-	char		flags = '\0';
-
-	/* Create flags from the lower_inc and upper_inc values */
-	if (seq->period.lower_inc)
-		flags |= 0x01;
-	if (seq->period.upper_inc)
-		flags |= 0x02;
-	result = DatumGetUInt32(hash_uint32((uint32) flags));
-	
-	/* Merge with hash of instants */
-	for (int i = 0; i < seq->count; i++)
+	if (seq->count > 1)
 	{
-		TemporalInst *inst = temporalseq_inst_n(seq, i);
-		uint32 inst_hash = temporalinst_hash(inst);
-		result = (result << 5) - result + inst_hash;
+		uint64 flags = 0;
+		if (seq->period.lower_inc)
+			flags |= 0x01;
+		if (seq->period.upper_inc)
+			flags |= 0x02;
+		state = hash64_word(state, flags);
 	}
-	return result;
+	for (int i = 0; i < seq->count; i++)
+		state = temporalinst_hash_update(state, temporalseq_inst_n(seq, i));
+	return state;
 }
 /*****************************************************************************/
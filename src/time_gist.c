@@ -23,6 +23,7 @@
 #include "timeops.h"
 #include "temporal.h"
 #include "oidcache.h"
+#include "temporal_util.h"
 
 /*****************************************************************************/
 
@@ -855,4 +856,59 @@ gist_period_fetch(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(entry);
 }
 
-/*****************************************************************************/
\ No newline at end of file
+/*****************************************************************************
+ * Hilbert keys for time types
+ *****************************************************************************/
+
+/*
+ * Position of the period along the Hilbert curve filling the (lower, upper)
+ * plane of the extent. Loading the rows in the order of this key before
+ * building an index places periods close in time in the same index pages.
+ */
+uint64
+period_hilbert_key_internal(const Period *p, const Period *extent)
+{
+	double min = (double) extent->lower, max = (double) extent->upper;
+	uint32 coords[2];
+	coords[0] = hilbert_coord((double) p->lower, min, max, HILBERT_MAX_BITS);
+	coords[1] = hilbert_coord((double) p->upper, min, max, HILBERT_MAX_BITS);
+	return hilbert_index(coords, 2, HILBERT_MAX_BITS);
+}
+
+PG_FUNCTION_INFO_V1(timestampset_hilbert_key);
+
+PGDLLEXPORT Datum
+timestampset_hilbert_key(PG_FUNCTION_ARGS)
+{
+	TimestampSet *ts = PG_GETARG_TIMESTAMPSET(0);
+	Period *extent = PG_GETARG_PERIOD(1);
+	Period p;
+	timestampset_to_period_internal(&p, ts);
+	PG_FREE_IF_COPY(ts, 0);
+	PG_RETURN_INT64((int64) period_hilbert_key_internal(&p, extent));
+}
+
+PG_FUNCTION_INFO_V1(period_hilbert_key);
+
+PGDLLEXPORT Datum
+period_hilbert_key(PG_FUNCTION_ARGS)
+{
+	Period *p = PG_GETARG_PERIOD(0);
+	Period *extent = PG_GETARG_PERIOD(1);
+	PG_RETURN_INT64((int64) period_hilbert_key_internal(p, extent));
+}
+
+PG_FUNCTION_INFO_V1(periodset_hilbert_key);
+
+PGDLLEXPORT Datum
+periodset_hilbert_key(PG_FUNCTION_ARGS)
+{
+	PeriodSet *ps = PG_GETARG_PERIODSET(0);
+	Period *extent = PG_GETARG_PERIOD(1);
+	Period p;
+	periodset_to_period_internal(&p, ps);
+	PG_FREE_IF_COPY(ps, 0);
+	PG_RETURN_INT64((int64) period_hilbert_key_internal(&p, extent));
+}
+
+/*****************************************************************************/
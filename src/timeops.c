@@ -33,6 +33,59 @@ time_type_oid(Oid timetypid)
 		timetypid == type_oid(T_PERIOD) || timetypid == type_oid(T_PERIODSET));
 }
 
+/*
+ * Galloping search in an ordered set of time values.
+ * Returns the first position in [from, count) whose element is not before
+ * the timestamp according to the function before, or count if there is no
+ * such position. The positions from, from + 1, from + 3, from + 7, ... are
+ * probed before a binary search, so that the cost is logarithmic in the
+ * distance between from and the result. Merging two sets with this function
+ * costs O(m log(n/m)) where m and n are the sizes of the smaller and the
+ * larger set.
+ */
+int
+time_gallop(void *set, int from, int count, TimestampTz t, 
+	bool (*before)(void *, int, TimestampTz))
+{
+	int first = from, last = from, step = 1;
+	while (last < count && before(set, last, t))
+	{
+		first = last + 1;
+		last += step;
+		step <<= 1;
+	}
+	if (last > count)
+		last = count;
+	/* All elements before first are before t, the one at last is not */
+	while (first < last)
+	{
+		int middle = first + (last - first) / 2;
+		if (before(set, middle, t))
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	return first;
+}
+
+/* Is the i-th timestamp of the timestamp set before the timestamp? */
+
+bool
+timestampset_time_before(void *ts, int i, TimestampTz t)
+{
+	return timestamp_cmp_internal(timestampset_time_n((TimestampSet *) ts, i), t) < 0;
+}
+
+/* Is the i-th period of the period set before the timestamp? */
+
+bool
+periodset_per_before(void *ps, int i, TimestampTz t)
+{
+	Period *p = periodset_per_n((PeriodSet *) ps, i);
+	int cmp = timestamp_cmp_internal(p->upper, t);
+	return cmp < 0 || (cmp == 0 && ! p->upper_inc);
+}
+
 /*****************************************************************************/
 /* contains? */
 
@@ -69,20 +122,15 @@ contains_timestampset_timestampset_internal(TimestampSet *ts1, TimestampSet *ts2
 	if (!contains_period_period_internal(p1, p2))
 		return false;
 
-	int i = 0, j = 0;
-	while (j < ts2->count)
+	int i = 0;
+	for (int j = 0; j < ts2->count; j++)
 	{
-		TimestampTz t1 = timestampset_time_n(ts1, i);
-		TimestampTz t2 = timestampset_time_n(ts2, j);
-		int cmp = timestamp_cmp_internal(t1, t2);
-		if (cmp == 0)
-		{
-			i++; j++;
-		}
-		else if (cmp < 0)
-			i++;
-		else
+		TimestampTz t = timestampset_time_n(ts2, j);
+		i = time_gallop(ts1, i, ts1->count, t, &timestampset_time_before);
+		if (i == ts1->count || 
+			timestamp_cmp_internal(timestampset_time_n(ts1, i), t) != 0)
 			return false;
+		i++;
 	}
 	return true;
 }
@@ -205,20 +253,14 @@ contains_periodset_timestampset_internal(PeriodSet *ps, TimestampSet *ts)
 	if (!contains_period_period_internal(p1, p2))
 		return false;
 
-	int i = 0, j = 0;
-	while (j < ts->count)
+	int i = 0;
+	for (int j = 0; j < ts->count; j++)
 	{
-		Period *p = periodset_per_n(ps, i);
 		TimestampTz t = timestampset_time_n(ts, j);
-		if (contains_period_timestamp_internal(p, t))
-			j++;
-		else
-		{
-			if (timestamp_cmp_internal(t, p->upper) > 0)
-				i++;
-			else
-				return false;
-		}
+		i = time_gallop(ps, i, ps->count, t, &periodset_per_before);
+		if (i == ps->count || 
+			! contains_period_timestamp_internal(periodset_per_n(ps, i), t))
+			return false;
 	}
 	return true;
 }
@@ -472,12 +514,13 @@ overlaps_timestampset_timestampset_internal(TimestampSet *ts1, TimestampSet *ts2
 	{
 		TimestampTz t1 = timestampset_time_n(ts1, i);
 		TimestampTz t2 = timestampset_time_n(ts2, j);
-		if (timestamp_cmp_internal(t1, t2) == 0)
+		int cmp = timestamp_cmp_internal(t1, t2);
+		if (cmp == 0)
 			return true;
-		if (timestamp_cmp_internal(t1, t2) < 0)
-			i++;
+		if (cmp < 0)
+			i = time_gallop(ts1, i + 1, ts1->count, t2, &timestampset_time_before);
 		else
-			j++;
+			j = time_gallop(ts2, j + 1, ts2->count, t1, &timestampset_time_before);
 	}
 	return false;
 }
@@ -540,10 +583,10 @@ overlaps_timestampset_periodset_internal(TimestampSet *ts, PeriodSet *ps)
 		Period *p = periodset_per_n(ps, j);
 		if (contains_period_timestamp_internal(p, t))
 			return true;
-		else if (timestamp_cmp_internal(t, p->upper) > 0)
-			j++;
+		else if (timestamp_cmp_internal(t, p->upper) >= 0)
+			j = time_gallop(ps, j + 1, ps->count, t, &periodset_per_before);
 		else
-			i++;
+			i = time_gallop(ts, i + 1, ts->count, p->lower, &timestampset_time_before);
 	}
 	return false;
 }
@@ -2861,21 +2904,22 @@ intersection_timestampset_timestampset_internal(TimestampSet *ts1, TimestampSet
 	if (!overlaps_period_period_internal(p1, p2))
 		return NULL;
 
-	TimestampTz *times = palloc(sizeof(TimestampTz) * (ts1->count + ts2->count));
+	TimestampTz *times = palloc(sizeof(TimestampTz) * Min(ts1->count, ts2->count));
 	int i = 0, j = 0, k = 0;
 	while (i < ts1->count && j < ts2->count)
 	{
 		TimestampTz t1 = timestampset_time_n(ts1, i);
 		TimestampTz t2 = timestampset_time_n(ts2, j);
-		if (timestamp_cmp_internal(t1, t2) == 0)
+		int cmp = timestamp_cmp_internal(t1, t2);
+		if (cmp == 0)
 		{
 			times[k++] = t1;
 			i++; j++;
 		}
-		else if (timestamp_cmp_internal(t1, t2) < 0)
-			i++;
+		else if (cmp < 0)
+			i = time_gallop(ts1, i + 1, ts1->count, t2, &timestampset_time_before);
 		else
-			j++;
+			j = time_gallop(ts2, j + 1, ts2->count, t1, &timestampset_time_before);
 	}
 	if (k == 0)
 	{
@@ -2954,38 +2998,20 @@ intersection_timestampset_periodset_internal(TimestampSet *ts, PeriodSet *ps)
 		return NULL;
 
 	TimestampTz *times = palloc(sizeof(TimestampTz) * ts->count);
-	TimestampTz t = timestampset_time_n(ts, 0);
-	Period *p = periodset_per_n(ps, 0);
 	int i = 0, j = 0, k = 0;
 	while (i < ts->count && j < ps->count)
 	{
-		if (timestamp_cmp_internal(t, p->lower) < 0)
+		TimestampTz t = timestampset_time_n(ts, i);
+		Period *p = periodset_per_n(ps, j);
+		if (contains_period_timestamp_internal(p, t))
 		{
 			times[k++] = t;
 			i++;
-			if (i == ts->count)
-				break;
-			else
-				t = timestampset_time_n(ts, i);
-		}
-		else if (timestamp_cmp_internal(t, p->upper) > 0)
-		{
-			j++;
-			if (j == ps->count)
-				break;
-			else
-				p = periodset_per_n(ps, j);
 		}
+		else if (timestamp_cmp_internal(t, p->lower) <= 0)
+			i = time_gallop(ts, i + 1, ts->count, p->lower, &timestampset_time_before);
 		else
-		{
-			if (contains_period_timestamp_internal(p, t))
-				times[k++] = t;
-			i++;
-			if (i == ts->count)
-				break;
-			else
-				t = timestampset_time_n(ts, i);
-		}
+			j = time_gallop(ps, j + 1, ps->count, t, &periodset_per_before);
 	}
 	if (k == 0)
 	{
@@ -3369,22 +3395,14 @@ minus_timestampset_timestampset_internal(TimestampSet *ts1, TimestampSet *ts2)
 		return timestampset_copy(ts1);
 
 	TimestampTz *times = palloc(sizeof(TimestampTz) * ts1->count);
-	int i = 0, j = 0, k = 0;
-	while (i < ts1->count && j < ts2->count)
+	int j = 0, k = 0;
+	for (int i = 0; i < ts1->count; i++)
 	{
-		TimestampTz t1 = timestampset_time_n(ts1, i);
-		TimestampTz t2 = timestampset_time_n(ts2, j);
-		if (timestamp_cmp_internal(t1, t2) == 0)
-		{
-			i++; j++;
-		}
-		if (timestamp_cmp_internal(t1, t2) < 0)
-		{
-			times[k++] = t1;
-			i++;
-		}
-		else
-			j++;
+		TimestampTz t = timestampset_time_n(ts1, i);
+		j = time_gallop(ts2, j, ts2->count, t, &timestampset_time_before);
+		if (j == ts2->count || 
+			timestamp_cmp_internal(timestampset_time_n(ts2, j), t) != 0)
+			times[k++] = t;
 	}
 	if (k == 0)
 	{
@@ -3480,7 +3498,7 @@ minus_timestampset_periodset_internal(TimestampSet *ts, PeriodSet *ps)
 		}
 		else if (timestamp_cmp_internal(t, p->upper) > 0)
 		{
-			j++;
+			j = time_gallop(ps, j + 1, ps->count, t, &periodset_per_before);
 			if (j == ps->count)
 				break;
 			else
@@ -499,6 +499,33 @@ timestampset_cmp(PG_FUNCTION_ARGS)
 	PG_RETURN_INT32(cmp);
 }
 
+/* Sort support: timestamp sets are abbreviated by their first timestamp */
+
+static int
+timestampset_sort_cmp(Datum x, Datum y, SortSupport ssup)
+{
+	return timestampset_cmp_internal(DatumGetTimestampSet(x), 
+		DatumGetTimestampSet(y));
+}
+
+static Datum
+timestampset_abbrev_convert(Datum original, SortSupport ssup)
+{
+	TimestampSet *ts = DatumGetTimestampSet(original);
+	return sortsupport_abbrev_key((int64) timestampset_time_n(ts, 0), ssup);
+}
+
+PG_FUNCTION_INFO_V1(timestampset_sortsupport);
+
+PGDLLEXPORT Datum
+timestampset_sortsupport(PG_FUNCTION_ARGS)
+{
+	SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+	sortsupport_abbrev_init(ssup, timestampset_sort_cmp, 
+		timestampset_abbrev_convert);
+	PG_RETURN_VOID();
+}
+
 /* 
  * Equality operator
  * The internal B-tree comparator is not used to increase efficiency 
@@ -0,0 +1,1120 @@
+/*****************************************************************************
+ *
+ * tnumber_eval.c
+ *	Fused evaluation of arithmetic expressions over temporal floats.
+ *
+ * An expression such as '(a - b) * c > 0' is parsed once into a small tree
+ * and evaluated in a single synchronized pass over the timelines of all its
+ * arguments, instead of applying the lifted operators one after the other
+ * and materializing each intermediate temporal value. Between two
+ * consecutive instants of the arguments every subexpression is a rational
+ * function of the time, which allows the turning points and the crossings
+ * of the whole expression to be computed once on the exact function.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "tnumber_eval.h"
+
+#include <ctype.h>
+#include <float.h>
+#include <math.h>
+#include <utils/array.h>
+#include <utils/builtins.h>
+#include <utils/timestamp.h>
+
+#include "period.h"
+#include "periodset.h"
+#include "timeops.h"
+#include "temporaltypes.h"
+#include "temporal_util.h"
+
+/*****************************************************************************
+ * Expression trees
+ *****************************************************************************/
+
+#define EVAL_MAXNODES	64
+#define EVAL_MAXDEG		16
+
+typedef enum
+{
+	EVAL_CONST,
+	EVAL_VAR,
+	EVAL_NEG,
+	EVAL_ADD,
+	EVAL_SUB,
+	EVAL_MULT,
+	EVAL_DIV,
+	EVAL_LT,
+	EVAL_LE,
+	EVAL_GT,
+	EVAL_GE,
+	EVAL_EQ,
+	EVAL_NE
+} EvalOp;
+
+#define EVAL_IS_COMPARISON(op) ((op) >= EVAL_LT)
+
+typedef struct
+{
+	EvalOp op;
+	int left;			/* Index of the left or only operand */
+	int right;			/* Index of the right operand */
+	int var;			/* Argument number, 'a' being 0, for variables */
+	double value;		/* Value for constants */
+} EvalNode;
+
+typedef struct
+{
+	EvalNode nodes[EVAL_MAXNODES];
+	int count;
+	int root;
+	int nvars;			/* Number of arguments referenced */
+} EvalExpr;
+
+typedef struct
+{
+	const char *str;	/* Whole expression, for the error messages */
+	const char *pos;	/* Current position */
+	EvalExpr *expr;
+} EvalParser;
+
+/*****************************************************************************
+ * Parser
+ * The grammar is the usual one for arithmetic expressions, the variables
+ * a, b, c, ... denoting the arguments in the order of the call. A single
+ * comparison is allowed at the top of the expression.
+ *   expr    := sum [ ( < | <= | > | >= | = | <> | != ) sum ]
+ *   sum     := term { ( + | - ) term }
+ *   term    := primary { ( * | / ) primary }
+ *   primary := number | variable | - primary | ( sum )
+ *****************************************************************************/
+
+static void
+eval_error(EvalParser *parser, const char *msg)
+{
+	ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+		errmsg("Invalid expression \"%s\": %s at position %d", parser->str,
+			msg, (int) (parser->pos - parser->str) + 1)));
+}
+
+static void
+eval_skip_spaces(EvalParser *parser)
+{
+	while (isspace((unsigned char) *parser->pos))
+		parser->pos++;
+}
+
+static int
+eval_new_node(EvalParser *parser, EvalOp op, int left, int right)
+{
+	EvalExpr *expr = parser->expr;
+	if (expr->count == EVAL_MAXNODES)
+		eval_error(parser, "too many operators");
+	EvalNode *node = &expr->nodes[expr->count];
+	node->op = op;
+	node->left = left;
+	node->right = right;
+	node->var = -1;
+	node->value = 0.0;
+	return expr->count++;
+}
+
+static int eval_parse_sum(EvalParser *parser);
+
+static int
+eval_parse_primary(EvalParser *parser)
+{
+	eval_skip_spaces(parser);
+	char c = *parser->pos;
+	int result;
+	if (c == '(')
+	{
+		parser->pos++;
+		result = eval_parse_sum(parser);
+		eval_skip_spaces(parser);
+		if (*parser->pos != ')')
+			eval_error(parser, "missing closing parenthesis");
+		parser->pos++;
+	}
+	else if (c == '-')
+	{
+		parser->pos++;
+		int operand = eval_parse_primary(parser);
+		result = eval_new_node(parser, EVAL_NEG, operand, -1);
+	}
+	else if (isdigit((unsigned char) c) || c == '.')
+	{
+		char *end;
+		double value = strtod(parser->pos, &end);
+		if (end == parser->pos)
+			eval_error(parser, "invalid number");
+		parser->pos = end;
+		result = eval_new_node(parser, EVAL_CONST, -1, -1);
+		parser->expr->nodes[result].value = value;
+	}
+	else if (c >= 'a' && c <= 'z' &&
+		! isalnum((unsigned char) parser->pos[1]) && parser->pos[1] != '_')
+	{
+		parser->pos++;
+		result = eval_new_node(parser, EVAL_VAR, -1, -1);
+		parser->expr->nodes[result].var = c - 'a';
+		if (c - 'a' + 1 > parser->expr->nvars)
+			parser->expr->nvars = c - 'a' + 1;
+	}
+	else
+	{
+		eval_error(parser, "operand expected");
+		result = -1; /* make compiler quiet */
+	}
+	return result;
+}
+
+static int
+eval_parse_term(EvalParser *parser)
+{
+	int result = eval_parse_primary(parser);
+	while (true)
+	{
+		eval_skip_spaces(parser);
+		char c = *parser->pos;
+		if (c != '*' && c != '/')
+			break;
+		parser->pos++;
+		int right = eval_parse_primary(parser);
+		result = eval_new_node(parser, c == '*' ? EVAL_MULT : EVAL_DIV,
+			result, right);
+	}
+	return result;
+}
+
+static int
+eval_parse_sum(EvalParser *parser)
+{
+	int result = eval_parse_term(parser);
+	while (true)
+	{
+		eval_skip_spaces(parser);
+		char c = *parser->pos;
+		if (c != '+' && c != '-')
+			break;
+		parser->pos++;
+		int right = eval_parse_term(parser);
+		result = eval_new_node(parser, c == '+' ? EVAL_ADD : EVAL_SUB,
+			result, right);
+	}
+	return result;
+}
+
+static void
+eval_parse(const char *str, EvalExpr *expr)
+{
+	EvalParser parser;
+	parser.str = str;
+	parser.pos = str;
+	parser.expr = expr;
+	expr->count = 0;
+	expr->nvars = 0;
+
+	int result = eval_parse_sum(&parser);
+	eval_skip_spaces(&parser);
+	const char *s = parser.pos;
+	EvalOp op = EVAL_CONST;
+	int len = 0;
+	if (strncmp(s, "<=", 2) == 0)
+	{
+		op = EVAL_LE; len = 2;
+	}
+	else if (strncmp(s, ">=", 2) == 0)
+	{
+		op = EVAL_GE; len = 2;
+	}
+	else if (strncmp(s, "<>", 2) == 0 || strncmp(s, "!=", 2) == 0)
+	{
+		op = EVAL_NE; len = 2;
+	}
+	else if (*s == '<')
+	{
+		op = EVAL_LT; len = 1;
+	}
+	else if (*s == '>')
+	{
+		op = EVAL_GT; len = 1;
+	}
+	else if (*s == '=')
+	{
+		op = EVAL_EQ; len = 1;
+	}
+	if (len > 0)
+	{
+		parser.pos += len;
+		int right = eval_parse_sum(&parser);
+		result = eval_new_node(&parser, op, result, right);
+		eval_skip_spaces(&parser);
+	}
+	if (*parser.pos != '\0')
+		eval_error(&parser, "unexpected character");
+	if (expr->nvars == 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("Invalid expression \"%s\": no argument is referenced", str)));
+	expr->root = result;
+}
+
+/*****************************************************************************
+ * Polynomials and rational functions on the unit interval
+ * The variable s in [0, 1] is the fraction of the current segment.
+ *****************************************************************************/
+
+#define POLY_EPSILON	1.0E-12
+
+typedef struct
+{
+	int deg;
+	double coeff[EVAL_MAXDEG + 1];
+} Poly;
+
+typedef struct
+{
+	Poly num;
+	Poly den;
+} Rational;
+
+static void
+poly_set(Poly *p, double c0, double c1)
+{
+	p->coeff[0] = c0;
+	p->coeff[1] = c1;
+	p->deg = (c1 == 0.0) ? 0 : 1;
+}
+
+static double
+poly_eval(const Poly *p, double s)
+{
+	double result = p->coeff[p->deg];
+	for (int i = p->deg - 1; i >= 0; i--)
+		result = result * s + p->coeff[i];
+	return result;
+}
+
+static void
+poly_mult(Poly *result, const Poly *p, const Poly *q)
+{
+	if (p->deg + q->deg > EVAL_MAXDEG)
+		ereport(ERROR, (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+			errmsg("Expression is too complex to be evaluated")));
+	Poly r;
+	r.deg = p->deg + q->deg;
+	for (int i = 0; i <= r.deg; i++)
+		r.coeff[i] = 0.0;
+	for (int i = 0; i <= p->deg; i++)
+		for (int j = 0; j <= q->deg; j++)
+			r.coeff[i + j] += p->coeff[i] * q->coeff[j];
+	*result = r;
+}
+
+/* Computes p + sign * q */
+
+static void
+poly_add(Poly *result, const Poly *p, const Poly *q, double sign)
+{
+	Poly r;
+	r.deg = Max(p->deg, q->deg);
+	for (int i = 0; i <= r.deg; i++)
+		r.coeff[i] = (i <= p->deg ? p->coeff[i] : 0.0) +
+			(i <= q->deg ? sign * q->coeff[i] : 0.0);
+	*result = r;
+}
+
+static void
+poly_deriv(Poly *result, const Poly *p)
+{
+	if (p->deg == 0)
+	{
+		poly_set(result, 0.0, 0.0);
+		return;
+	}
+	result->deg = p->deg - 1;
+	for (int i = 1; i <= p->deg; i++)
+		result->coeff[i - 1] = i * p->coeff[i];
+}
+
+/*
+ * Roots of the polynomial in the open interval (0, 1) in increasing order.
+ * The roots of the derivative split the interval into monotone pieces, each
+ * of which contains at most one root found by bisection. Roots at a local
+ * extremum, e.g., tangencies, are also returned.
+ */
+static int
+poly_roots(const Poly *p, double *roots)
+{
+	double scale = 0.0;
+	for (int i = 0; i <= p->deg; i++)
+		scale = Max(scale, fabs(p->coeff[i]));
+	if (scale == 0.0)
+		return 0;
+	Poly q = *p;
+	while (q.deg > 0 && fabs(q.coeff[q.deg]) <= scale * POLY_EPSILON)
+		q.deg--;
+	if (q.deg == 0)
+		return 0;
+	if (q.deg == 1)
+	{
+		double root = - q.coeff[0] / q.coeff[1];
+		if (root > 0.0 && root < 1.0)
+		{
+			roots[0] = root;
+			return 1;
+		}
+		return 0;
+	}
+
+	Poly dq;
+	poly_deriv(&dq, &q);
+	double bounds[EVAL_MAXDEG + 2];
+	bounds[0] = 0.0;
+	int nbounds = 1 + poly_roots(&dq, &bounds[1]);
+	bounds[nbounds++] = 1.0;
+	int count = 0;
+	for (int i = 0; i < nbounds - 1; i++)
+	{
+		double a = bounds[i], b = bounds[i + 1];
+		double fa = poly_eval(&q, a), fb = poly_eval(&q, b);
+		if (i > 0 && fabs(fa) <= scale * POLY_EPSILON)
+		{
+			roots[count++] = a;
+			continue;
+		}
+		if (fabs(fb) <= scale * POLY_EPSILON || (fa < 0) == (fb < 0))
+			continue;
+		double mid = a;
+		for (int j = 0; j < 100 && b - a > DBL_EPSILON; j++)
+		{
+			mid = a + (b - a) / 2;
+			double fmid = poly_eval(&q, mid);
+			if (fmid == 0.0)
+				break;
+			if ((fmid < 0) == (fa < 0))
+			{
+				a = mid;
+				fa = fmid;
+			}
+			else
+				b = mid;
+		}
+		roots[count++] = mid;
+	}
+	return count;
+}
+
+static double
+rational_eval(const Rational *r, double s)
+{
+	return poly_eval(&r->num, s) / poly_eval(&r->den, s);
+}
+
+/* Divide the numerator by a constant denominator to keep the degrees low */
+
+static void
+rational_normalize(Rational *r)
+{
+	if (r->den.deg == 0 && r->den.coeff[0] != 1.0)
+	{
+		for (int i = 0; i <= r->num.deg; i++)
+			r->num.coeff[i] /= r->den.coeff[0];
+		poly_set(&r->den, 1.0, 0.0);
+	}
+}
+
+/* Does the rational function take the value 0 in the closed interval [0, 1]? */
+
+static bool
+rational_has_zero(const Rational *r)
+{
+	double roots[EVAL_MAXDEG];
+	return poly_eval(&r->num, 0.0) == 0.0 || poly_eval(&r->num, 1.0) == 0.0 ||
+		poly_roots(&r->num, roots) > 0;
+}
+
+/*
+ * Evaluate a node of the expression on the current segment given the
+ * rational functions of the arguments. For a comparison, the result is
+ * the difference of its operands.
+ */
+static void
+eval_node(const EvalExpr *expr, int n, const Rational *vars, Rational *result)
+{
+	const EvalNode *node = &expr->nodes[n];
+	Rational left, right;
+	switch (node->op)
+	{
+		case EVAL_CONST:
+			poly_set(&result->num, node->value, 0.0);
+			poly_set(&result->den, 1.0, 0.0);
+			return;
+		case EVAL_VAR:
+			*result = vars[node->var];
+			return;
+		case EVAL_NEG:
+			eval_node(expr, node->left, vars, result);
+			for (int i = 0; i <= result->num.deg; i++)
+				result->num.coeff[i] = - result->num.coeff[i];
+			return;
+		default:
+			break;
+	}
+	eval_node(expr, node->left, vars, &left);
+	eval_node(expr, node->right, vars, &right);
+	if (node->op == EVAL_MULT)
+	{
+		poly_mult(&result->num, &left.num, &right.num);
+		poly_mult(&result->den, &left.den, &right.den);
+	}
+	else if (node->op == EVAL_DIV)
+	{
+		if (rational_has_zero(&right))
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				errmsg("Division by zero")));
+		poly_mult(&result->num, &left.num, &right.den);
+		poly_mult(&result->den, &left.den, &right.num);
+	}
+	else
+	{
+		/* Addition, subtraction, and comparisons */
+		double sign = (node->op == EVAL_ADD) ? 1.0 : -1.0;
+		Poly p1, p2;
+		poly_mult(&p1, &left.num, &right.den);
+		poly_mult(&p2, &right.num, &left.den);
+		poly_add(&result->num, &p1, &p2, sign);
+		poly_mult(&result->den, &left.den, &right.den);
+	}
+	rational_normalize(result);
+}
+
+/* Value of a comparison given the difference of its operands */
+
+static bool
+eval_compare(EvalOp op, double diff)
+{
+	switch (op)
+	{
+		case EVAL_LT:
+			return diff < 0;
+		case EVAL_LE:
+			return diff <= 0;
+		case EVAL_GT:
+			return diff > 0;
+		case EVAL_GE:
+			return diff >= 0;
+		case EVAL_EQ:
+			return diff == 0;
+		default:
+			return diff != 0;
+	}
+}
+
+/*****************************************************************************
+ * Builders of the result
+ *****************************************************************************/
+
+typedef void (*EvalSegmentFn)(void *state, const Rational *r,
+	TimestampTz t1, TimestampTz t2, bool first);
+
+static TimestampTz
+segment_timestamp(TimestampTz t1, TimestampTz t2, double s)
+{
+	return t1 + (TimestampTz) ((double) (t2 - t1) * s);
+}
+
+/* State for building the temporal float of one period */
+
+typedef struct
+{
+	bool linear;
+	TemporalInst **instants;
+	int count;
+	int maxcount;
+} EvalFloatState;
+
+static void
+eval_float_add(EvalFloatState *state, TimestampTz t, double value)
+{
+	if (state->count == state->maxcount)
+	{
+		state->maxcount *= 2;
+		state->instants = repalloc(state->instants,
+			sizeof(TemporalInst *) * state->maxcount);
+	}
+	state->instants[state->count++] = temporalinst_make(Float8GetDatum(value),
+		t, FLOAT8OID);
+}
+
+/*
+ * For linear interpolation the instants are the bounds of the segments and
+ * the turning points of the function, that is, the roots of N'D - ND'.
+ * For stepwise interpolation the function is constant on each segment.
+ */
+static void
+eval_float_segment(void *st, const Rational *r, TimestampTz t1,
+	TimestampTz t2, bool first)
+{
+	EvalFloatState *state = (EvalFloatState *) st;
+	TimestampTz last = state->count > 0 ?
+		state->instants[state->count - 1]->t : DT_NOBEGIN;
+	if (! state->linear)
+	{
+		if (first || t1 > last)
+			eval_float_add(state, t1, rational_eval(r, 0.0));
+		return;
+	}
+	if (first || t1 > last)
+	{
+		eval_float_add(state, t1, rational_eval(r, 0.0));
+		last = t1;
+	}
+	if (t1 == t2)
+		return;
+	if (r->num.deg > 1 || r->den.deg > 0)
+	{
+		Poly dnum, dden, p1, p2, p;
+		poly_deriv(&dnum, &r->num);
+		poly_deriv(&dden, &r->den);
+		poly_mult(&p1, &dnum, &r->den);
+		poly_mult(&p2, &r->num, &dden);
+		poly_add(&p, &p1, &p2, -1.0);
+		double roots[EVAL_MAXDEG];
+		int count = poly_roots(&p, roots);
+		for (int i = 0; i < count; i++)
+		{
+			TimestampTz t = segment_timestamp(t1, t2, roots[i]);
+			if (t > last && t < t2)
+			{
+				eval_float_add(state, t, rational_eval(r, roots[i]));
+				last = t;
+			}
+		}
+	}
+	eval_float_add(state, t2, rational_eval(r, 1.0));
+}
+
+/*
+ * State for building the temporal Boolean. The result is built as runs of
+ * constant value, each run becoming a stepwise sequence.
+ */
+typedef struct
+{
+	EvalOp op;
+	const Period *period;
+	TemporalSeq **sequences;
+	int count;
+	int maxcount;
+	bool active;		/* Is there a current run? */
+	bool value;
+	TimestampTz start;
+	bool start_inc;
+	TimestampTz end;
+	bool end_inc;
+} EvalBoolState;
+
+static void
+eval_bool_close(EvalBoolState *state)
+{
+	if (! state->active)
+		return;
+	TemporalInst *instants[2];
+	instants[0] = temporalinst_make(BoolGetDatum(state->value), state->start,
+		BOOLOID);
+	int count = 1;
+	if (state->end > state->start)
+		instants[count++] = temporalinst_make(BoolGetDatum(state->value),
+			state->end, BOOLOID);
+	if (state->count == state->maxcount)
+	{
+		state->maxcount *= 2;
+		state->sequences = repalloc(state->sequences,
+			sizeof(TemporalSeq *) * state->maxcount);
+	}
+	state->sequences[state->count++] = temporalseq_from_temporalinstarr(
+		instants, count, state->start_inc, state->end_inc, false, false);
+	for (int i = 0; i < count; i++)
+		pfree(instants[i]);
+	state->active = false;
+}
+
+/* Add a piece, which is either an instant or an open interval */
+
+static void
+eval_bool_push(EvalBoolState *state, bool value, TimestampTz t1, bool t1_inc,
+	TimestampTz t2, bool t2_inc)
+{
+	if (state->active && state->value == value && state->end == t1 &&
+		(state->end_inc || t1_inc))
+	{
+		state->end = t2;
+		state->end_inc = t2_inc;
+		return;
+	}
+	eval_bool_close(state);
+	state->active = true;
+	state->value = value;
+	state->start = t1;
+	state->start_inc = t1_inc;
+	state->end = t2;
+	state->end_inc = t2_inc;
+}
+
+static void
+eval_bool_segment(void *st, const Rational *r, TimestampTz t1,
+	TimestampTz t2, bool first)
+{
+	EvalBoolState *state = (EvalBoolState *) st;
+	bool value = eval_compare(state->op, rational_eval(r, 0.0));
+	/* Final instant of the period */
+	if (t1 == t2)
+	{
+		if (state->period->upper_inc)
+			eval_bool_push(state, value, t1, true, t1, true);
+		return;
+	}
+	if (! first || state->period->lower_inc)
+		eval_bool_push(state, value, t1, true, t1, true);
+	/* Split the segment at the crossings */
+	double roots[EVAL_MAXDEG];
+	int count = poly_roots(&r->num, roots);
+	double s = 0.0;
+	TimestampTz t = t1;
+	for (int i = 0; i < count; i++)
+	{
+		TimestampTz troot = segment_timestamp(t1, t2, roots[i]);
+		if (troot <= t || troot >= t2)
+			continue;
+		value = eval_compare(state->op, rational_eval(r, (s + roots[i]) / 2));
+		eval_bool_push(state, value, t, false, troot, false);
+		eval_bool_push(state, eval_compare(state->op, 0.0), troot, true,
+			troot, true);
+		s = roots[i];
+		t = troot;
+	}
+	value = eval_compare(state->op, rational_eval(r, (s + 1.0) / 2));
+	eval_bool_push(state, value, t, false, t2, false);
+}
+
+/*****************************************************************************
+ * Synchronized traversal of the arguments
+ *****************************************************************************/
+
+/* Index of the segment of the sequence that starts at or before t */
+
+static int
+eval_segment_start(const TemporalSeq *seq, TimestampTz t)
+{
+	int first = 0, last = seq->count - 2, result = 0;
+	while (first <= last)
+	{
+		int middle = (first + last) / 2;
+		if (temporalseq_inst_n((TemporalSeq *) seq, middle)->t <= t)
+		{
+			result = middle;
+			first = middle + 1;
+		}
+		else
+			last = middle - 1;
+	}
+	return result;
+}
+
+static void
+rational_const(Rational *r, double value)
+{
+	poly_set(&r->num, value, 0.0);
+	poly_set(&r->den, 1.0, 0.0);
+}
+
+/* Value of an argument at a timestamp, false if it is not defined there */
+
+static bool
+eval_value_at_timestamp(Temporal *temp, TimestampTz t, double *result)
+{
+	Datum value;
+	bool found;
+	if (temp->duration == TEMPORALINST)
+		found = temporalinst_value_at_timestamp((TemporalInst *) temp, t, &value);
+	else if (temp->duration == TEMPORALI)
+		found = temporali_value_at_timestamp((TemporalI *) temp, t, &value);
+	else if (temp->duration == TEMPORALSEQ)
+		found = temporalseq_value_at_timestamp((TemporalSeq *) temp, t, &value);
+	else
+		found = temporals_value_at_timestamp((TemporalS *) temp, t, &value);
+	if (found)
+		*result = DatumGetFloat8(value);
+	return found;
+}
+
+/* Periods of the sequences of an argument */
+
+static Period **
+eval_temporal_periods(Temporal *temp, int *count)
+{
+	Period **result;
+	if (temp->duration == TEMPORALSEQ)
+	{
+		result = palloc(sizeof(Period *));
+		result[0] = period_copy(&((TemporalSeq *) temp)->period);
+		*count = 1;
+		return result;
+	}
+	TemporalS *ts = (TemporalS *) temp;
+	result = palloc(sizeof(Period *) * ts->count);
+	for (int i = 0; i < ts->count; i++)
+		result[i] = period_copy(&temporals_seq_n(ts, i)->period);
+	*count = ts->count;
+	return result;
+}
+
+/*
+ * Intersection of two ordered arrays of periods. Contrary to the
+ * intersection of period sets, adjacent periods are not merged.
+ */
+static Period **
+eval_periods_intersection(Period **periods1, int count1, Period **periods2,
+	int count2, int *count)
+{
+	Period **result = palloc(sizeof(Period *) * (count1 + count2));
+	int i = 0, j = 0, k = 0;
+	while (i < count1 && j < count2)
+	{
+		Period *inter = intersection_period_period_internal(periods1[i],
+			periods2[j]);
+		if (inter != NULL)
+			result[k++] = inter;
+		int cmp = period_cmp_bounds(periods1[i]->upper, periods2[j]->upper,
+			false, false, periods1[i]->upper_inc, periods2[j]->upper_inc);
+		if (cmp <= 0)
+			i++;
+		if (cmp >= 0)
+			j++;
+	}
+	*count = k;
+	return result;
+}
+
+/*
+ * Periods of the common timespan of the arguments. They are split at the
+ * bounds of the sequences of every argument so that each period is covered
+ * by a single sequence of each argument.
+ */
+static Period **
+eval_periods(Temporal **temps, int nvars, int *count)
+{
+	Period **result = eval_temporal_periods(temps[0], count);
+	for (int k = 1; k < nvars && *count > 0; k++)
+	{
+		int count1, count2;
+		Period **periods1 = eval_temporal_periods(temps[k], &count1);
+		Period **periods2 = eval_periods_intersection(result, *count,
+			periods1, count1, &count2);
+		for (int i = 0; i < *count; i++)
+			pfree(result[i]);
+		for (int i = 0; i < count1; i++)
+			pfree(periods1[i]);
+		pfree(result); pfree(periods1);
+		result = periods2;
+		*count = count2;
+	}
+	return result;
+}
+
+/*
+ * Walk the segments of a period of the common timespan of the arguments.
+ * A segment ends at the next instant of any argument so that all the
+ * arguments are linear (or constant) on it. The function is called for
+ * each segment and a last time for the upper bound of the period.
+ */
+static void
+eval_period(const EvalExpr *expr, Temporal **temps, const Period *p,
+	bool linear, EvalSegmentFn func, void *state)
+{
+	int nvars = expr->nvars;
+	TemporalSeq **seqs = palloc(sizeof(TemporalSeq *) * nvars);
+	int *idx = palloc(sizeof(int) * nvars);
+	Rational *vars = palloc(sizeof(Rational) * nvars);
+	Rational r;
+	TimestampTz tmid = p->lower + (p->upper - p->lower) / 2;
+	for (int k = 0; k < nvars; k++)
+	{
+		if (temps[k]->duration == TEMPORALSEQ)
+			seqs[k] = (TemporalSeq *) temps[k];
+		else
+		{
+			/* The period is covered by the sequence containing its middle */
+			int pos;
+			temporals_find_timestamp((TemporalS *) temps[k], tmid, &pos);
+			seqs[k] = temporals_seq_n((TemporalS *) temps[k], pos);
+		}
+		idx[k] = eval_segment_start(seqs[k], p->lower);
+	}
+
+	TimestampTz t1 = p->lower;
+	bool first = true;
+	while (t1 < p->upper)
+	{
+		TimestampTz t2 = p->upper;
+		for (int k = 0; k < nvars; k++)
+		{
+			if (idx[k] < seqs[k]->count - 1)
+			{
+				TimestampTz t = temporalseq_inst_n(seqs[k], idx[k] + 1)->t;
+				if (t < t2)
+					t2 = t;
+			}
+		}
+		for (int k = 0; k < nvars; k++)
+		{
+			TemporalInst *inst1 = temporalseq_inst_n(seqs[k], idx[k]);
+			double v1 = DatumGetFloat8(temporalinst_value(inst1));
+			if (! linear || seqs[k]->count == 1)
+			{
+				rational_const(&vars[k], v1);
+				continue;
+			}
+			TemporalInst *inst2 = temporalseq_inst_n(seqs[k], idx[k] + 1);
+			double v2 = DatumGetFloat8(temporalinst_value(inst2));
+			double duration = (double) (inst2->t - inst1->t);
+			double start = v1 + (v2 - v1) * (double) (t1 - inst1->t) / duration;
+			double end = v1 + (v2 - v1) * (double) (t2 - inst1->t) / duration;
+			poly_set(&vars[k].num, start, end - start);
+			poly_set(&vars[k].den, 1.0, 0.0);
+		}
+		eval_node(expr, expr->root, vars, &r);
+		func(state, &r, t1, t2, first);
+		first = false;
+		for (int k = 0; k < nvars; k++)
+			while (idx[k] < seqs[k]->count - 2 &&
+				temporalseq_inst_n(seqs[k], idx[k] + 1)->t <= t2)
+				idx[k]++;
+		t1 = t2;
+	}
+
+	/* Upper bound of the period */
+	if (first || (! linear && p->upper_inc))
+	{
+		for (int k = 0; k < nvars; k++)
+		{
+			double value = 0.0;
+			eval_value_at_timestamp((Temporal *) seqs[k], p->upper, &value);
+			rational_const(&vars[k], value);
+		}
+		eval_node(expr, expr->root, vars, &r);
+	}
+	else
+	{
+		/* Limit of the last segment */
+		double num = poly_eval(&r.num, 1.0), den = poly_eval(&r.den, 1.0);
+		poly_set(&r.num, num, 0.0);
+		poly_set(&r.den, den, 0.0);
+	}
+	func(state, &r, p->upper, p->upper, first);
+	pfree(seqs); pfree(idx); pfree(vars);
+}
+
+/*
+ * Evaluation when one of the arguments is an instant or an instant set.
+ * The result is defined at the timestamps of that argument at which all
+ * the other arguments are defined.
+ */
+static Temporal *
+eval_discrete(const EvalExpr *expr, Temporal **temps, int disc, bool boolean)
+{
+	Temporal *temp = temps[disc];
+	int count = (temp->duration == TEMPORALINST) ? 1 : ((TemporalI *) temp)->count;
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
+	Rational *vars = palloc(sizeof(Rational) * expr->nvars);
+	const EvalNode *root = &expr->nodes[expr->root];
+	int k = 0;
+	for (int i = 0; i < count; i++)
+	{
+		TimestampTz t = (temp->duration == TEMPORALINST) ?
+			((TemporalInst *) temp)->t : temporali_inst_n((TemporalI *) temp, i)->t;
+		bool found = true;
+		for (int j = 0; j < expr->nvars && found; j++)
+		{
+			double value;
+			found = eval_value_at_timestamp(temps[j], t, &value);
+			if (found)
+				rational_const(&vars[j], value);
+		}
+		if (! found)
+			continue;
+		Rational r;
+		eval_node(expr, expr->root, vars, &r);
+		double value = rational_eval(&r, 0.0);
+		instants[k++] = boolean ?
+			temporalinst_make(BoolGetDatum(eval_compare(root->op, value)), t, BOOLOID) :
+			temporalinst_make(Float8GetDatum(value), t, FLOAT8OID);
+	}
+	pfree(vars);
+	Temporal *result = NULL;
+	if (k > 0)
+		result = (temp->duration == TEMPORALINST) ? (Temporal *) instants[0] :
+			(Temporal *) temporali_from_temporalinstarr(instants, k);
+	if (temp->duration != TEMPORALINST)
+		for (int i = 0; i < k; i++)
+			pfree(instants[i]);
+	pfree(instants);
+	return result;
+}
+
+/*
+ * Evaluate the expression over its arguments. Returns a temporal float or,
+ * if the root of the expression is a comparison, a temporal Boolean.
+ */
+static Temporal *
+tnumber_eval_internal(const EvalExpr *expr, Temporal **temps, bool boolean)
+{
+	/* Discrete evaluation if an argument is an instant or an instant set */
+	int disc = -1, ncont = 0;
+	bool linear = false;
+	for (int k = 0; k < expr->nvars; k++)
+	{
+		ensure_valid_duration(temps[k]->duration);
+		if (temps[k]->duration == TEMPORALINST || temps[k]->duration == TEMPORALI)
+		{
+			if (disc < 0)
+				disc = k;
+			continue;
+		}
+		bool linear1 = MOBDB_FLAGS_GET_LINEAR(temps[k]->flags);
+		if (ncont++ == 0)
+			linear = linear1;
+		else if (linear != linear1)
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				errmsg("The temporal values must have the same interpolation")));
+	}
+	if (disc >= 0)
+		return eval_discrete(expr, temps, disc, boolean);
+
+	/* Common timespan of the arguments */
+	int count;
+	Period **periods = eval_periods(temps, expr->nvars, &count);
+	if (count == 0)
+	{
+		pfree(periods);
+		return NULL;
+	}
+
+	Temporal *result;
+	if (boolean)
+	{
+		EvalBoolState state;
+		memset(&state, 0, sizeof(EvalBoolState));
+		state.op = expr->nodes[expr->root].op;
+		state.maxcount = count * 2;
+		state.sequences = palloc(sizeof(TemporalSeq *) * state.maxcount);
+		for (int i = 0; i < count; i++)
+		{
+			state.period = periods[i];
+			eval_period(expr, temps, state.period, linear, &eval_bool_segment,
+				&state);
+		}
+		eval_bool_close(&state);
+		result = (state.count == 1) ? (Temporal *) state.sequences[0] :
+			(Temporal *) temporals_from_temporalseqarr(state.sequences,
+				state.count, false, true);
+		if (state.count > 1)
+			for (int i = 0; i < state.count; i++)
+				pfree(state.sequences[i]);
+		pfree(state.sequences);
+	}
+	else
+	{
+		TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * count);
+		EvalFloatState state;
+		state.linear = linear;
+		state.maxcount = 64;
+		state.instants = palloc(sizeof(TemporalInst *) * state.maxcount);
+		for (int i = 0; i < count; i++)
+		{
+			Period *p = periods[i];
+			state.count = 0;
+			eval_period(expr, temps, p, linear, &eval_float_segment, &state);
+			sequences[i] = temporalseq_from_temporalinstarr(state.instants,
+				state.count, p->lower_inc, p->upper_inc, linear, true);
+			for (int j = 0; j < state.count; j++)
+				pfree(state.instants[j]);
+		}
+		pfree(state.instants);
+		result = (count == 1) ? (Temporal *) sequences[0] :
+			(Temporal *) temporals_from_temporalseqarr(sequences, count,
+				linear, true);
+		if (count > 1)
+			for (int i = 0; i < count; i++)
+				pfree(sequences[i]);
+		pfree(sequences);
+	}
+	for (int i = 0; i < count; i++)
+		pfree(periods[i]);
+	pfree(periods);
+	return result;
+}
+
+/*****************************************************************************
+ * External functions
+ *****************************************************************************/
+
+static Temporal *
+tnumber_eval1(FunctionCallInfo fcinfo, bool boolean)
+{
+	text *txt = PG_GETARG_TEXT_P(0);
+	ArrayType *array = PG_GETARG_ARRAYTYPE_P(1);
+	char *str = text_to_cstring(txt);
+	EvalExpr expr;
+	eval_parse(str, &expr);
+	if (boolean != EVAL_IS_COMPARISON(expr.nodes[expr.root].op))
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg(boolean ?
+				"Invalid expression \"%s\": a comparison is expected" :
+				"Invalid expression \"%s\": a comparison is not allowed, use tevalBool",
+				str)));
+	if (ARR_HASNULL(array))
+		ereport(ERROR, (errcode(ERRCODE_NULL_VALUE_NOT_ALLOWED),
+			errmsg("The array cannot contain null values")));
+	int count = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+	if (count < expr.nvars)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("Invalid expression \"%s\": %d temporal values are referenced but %d are given",
+				str, expr.nvars, count)));
+	Temporal **temps = temporalarr_extract(array, &count);
+	Temporal *result = tnumber_eval_internal(&expr, temps, boolean);
+	pfree(temps);
+	pfree(str);
+	PG_FREE_IF_COPY(txt, 0);
+	PG_FREE_IF_COPY(array, 1);
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(tnumber_eval);
+
+PGDLLEXPORT Datum
+tnumber_eval(PG_FUNCTION_ARGS)
+{
+	Temporal *result = tnumber_eval1(fcinfo, false);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(tnumber_eval_bool);
+
+PGDLLEXPORT Datum
+tnumber_eval_bool(PG_FUNCTION_ARGS)
+{
+	Temporal *result = tnumber_eval1(fcinfo, true);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************/
@@ -21,6 +21,7 @@
 #include "oidcache.h"
 #include "temporal_boxops.h"
 #include "temporal_posops.h"
+#include "temporal_util.h"
 
 /* Minimum accepted ratio of split */
 #define LIMIT_RATIO 0.3
@@ -1037,4 +1038,62 @@ gist_tbox_same(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Hilbert keys for temporal numbers
+ *****************************************************************************/
+
+/*
+ * Position of the center of the box along the Hilbert curve filling the
+ * extent. Only the dimensions present in both boxes are taken into account.
+ */
+static uint64
+tbox_hilbert_key_internal(const TBOX *box, const TBOX *extent)
+{
+	uint32 coords[2];
+	int ndims = 0, bits;
+	double center[2], min[2], max[2];
+	if (MOBDB_FLAGS_GET_X(box->flags) && MOBDB_FLAGS_GET_X(extent->flags))
+	{
+		center[ndims] = box->xmin / 2.0 + box->xmax / 2.0;
+		min[ndims] = extent->xmin;
+		max[ndims++] = extent->xmax;
+	}
+	if (MOBDB_FLAGS_GET_T(box->flags) && MOBDB_FLAGS_GET_T(extent->flags))
+	{
+		center[ndims] = (double) box->tmin / 2.0 + (double) box->tmax / 2.0;
+		min[ndims] = (double) extent->tmin;
+		max[ndims++] = (double) extent->tmax;
+	}
+	if (ndims == 0)
+		return 0;
+	bits = ndims == 1 ? HILBERT_MAX_BITS : 63 / ndims;
+	for (int i = 0; i < ndims; i++)
+		coords[i] = hilbert_coord(center[i], min[i], max[i], bits);
+	return hilbert_index(coords, ndims, bits);
+}
+
+PG_FUNCTION_INFO_V1(tbox_hilbert_key);
+
+PGDLLEXPORT Datum
+tbox_hilbert_key(PG_FUNCTION_ARGS)
+{
+	TBOX *box = PG_GETARG_TBOX_P(0);
+	TBOX *extent = PG_GETARG_TBOX_P(1);
+	PG_RETURN_INT64((int64) tbox_hilbert_key_internal(box, extent));
+}
+
+PG_FUNCTION_INFO_V1(tnumber_hilbert_key);
+
+PGDLLEXPORT Datum
+tnumber_hilbert_key(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	TBOX *extent = PG_GETARG_TBOX_P(1);
+	TBOX box;
+	memset(&box, 0, sizeof(TBOX));
+	temporal_bbox(&box, temp);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_INT64((int64) tbox_hilbert_key_internal(&box, extent));
+}
+
 /*****************************************************************************/
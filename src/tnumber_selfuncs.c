@@ -15,6 +15,7 @@
 #include <assert.h>
 #include <math.h>
 #include <access/htup_details.h>
+#include <catalog/pg_statistic.h>
 #include <utils/builtins.h>
 #include <utils/selfuncs.h>
 #include <temporal_boxops.h>
@@ -708,6 +709,130 @@ tnumber_cachedop_rangeop(CachedOp cachedOp)
 	return op;
 }
 
+/*
+ * Returns the proportion of the cells partitioning the extent [min, max] that
+ * is covered by the interval [lower, upper], which may be unbounded.
+ */
+static void
+tbox_hist_cell_ratios(double lower, double upper, double min, double max,
+	int size, double *ratios)
+{
+	double width = (max - min) / size;
+	for (int i = 0; i < size; i++)
+	{
+		double cmin = min + i * width, cmax = cmin + width;
+		if (width <= 0.0)
+			/* Degenerate extent, all the values are equal to min */
+			ratios[i] = (lower <= min && min <= upper) ? 1.0 : 0.0;
+		else if (upper <= cmin || lower >= cmax)
+			ratios[i] = 0.0;
+		else
+			ratios[i] = (Min(upper, cmax) - Max(lower, cmin)) / width;
+	}
+}
+
+/*
+ * Calculate the selectivity of the bounding box and position operators using
+ * the two-dimensional histogram of the value and time dimensions. 
+ * Each operator restricts the value and/or the time dimensions to an 
+ * interval, and the selectivity is obtained by summing the counts of the 
+ * cells pro-rated by the proportion of the cells covered by these intervals.
+ * In this way the correlation between the value and the time dimensions is
+ * taken into account.
+ *
+ * The containment operators @> and <@ and the same operator ~= are not
+ * estimated with the histogram: its cells keep the pro-rated proportions of
+ * the boxes, not the boxes themselves, so it cannot tell whether a box
+ * contains or is contained in the query box. These operators fall back to
+ * the estimates of the value and time dimensions, whose length histograms
+ * account for containment.
+ *
+ * The function returns -1 if the histogram is not available or the operator
+ * cannot be estimated with it.
+ */
+static double
+calc_tbox_hist_selectivity(VariableStatData *vardata, const TBOX *box,
+	CachedOp cachedOp)
+{
+	AttStatsSlot sslot;
+	TBOX_STATS *hist;
+	double xlower = -1 * get_float8_infinity(), 
+		xupper = get_float8_infinity(),
+		tlower = -1 * get_float8_infinity(), 
+		tupper = get_float8_infinity();
+	double *xratios, *tratios, total_count = 0.0, selec;
+	int xsize, tsize, i, j;
+	bool hasx = MOBDB_FLAGS_GET_X(box->flags), 
+		hast = MOBDB_FLAGS_GET_T(box->flags);
+
+	/* Determine the intervals in each dimension satisfying the operator */
+	if (cachedOp == OVERLAPS_OP)
+	{
+		if (hasx)
+		{
+			xlower = box->xmin; 
+			xupper = box->xmax;
+		}
+		if (hast)
+		{
+			tlower = STATS_TIMESTAMP(box->tmin); 
+			tupper = STATS_TIMESTAMP(box->tmax);
+		}
+	}
+	else if (hasx && cachedOp == LEFT_OP)
+		xupper = box->xmin;
+	else if (hasx && cachedOp == OVERLEFT_OP)
+		xupper = box->xmax;
+	else if (hasx && cachedOp == RIGHT_OP)
+		xlower = box->xmax;
+	else if (hasx && cachedOp == OVERRIGHT_OP)
+		xlower = box->xmin;
+	else if (hast && cachedOp == BEFORE_OP)
+		tupper = STATS_TIMESTAMP(box->tmin);
+	else if (hast && cachedOp == OVERBEFORE_OP)
+		tupper = STATS_TIMESTAMP(box->tmax);
+	else if (hast && cachedOp == AFTER_OP)
+		tlower = STATS_TIMESTAMP(box->tmax);
+	else if (hast && cachedOp == OVERAFTER_OP)
+		tlower = STATS_TIMESTAMP(box->tmin);
+	else
+		return -1.0;
+
+	if (!(HeapTupleIsValid(vardata->statsTuple) &&
+		  get_attstatsslot(&sslot, vardata->statsTuple,
+						   STATISTIC_KIND_TBOX_HISTOGRAM, InvalidOid, 
+						   ATTSTATSSLOT_NUMBERS)))
+		return -1.0;
+
+	hist = (TBOX_STATS *) sslot.numbers;
+	xsize = (int) hist->xsize;
+	tsize = (int) hist->tsize;
+	xratios = palloc(sizeof(double) * xsize);
+	tratios = palloc(sizeof(double) * tsize);
+	tbox_hist_cell_ratios(xlower, xupper, hist->xmin, hist->xmax, xsize, 
+		xratios);
+	tbox_hist_cell_ratios(tlower, tupper, hist->tmin, hist->tmax, tsize, 
+		tratios);
+
+	/* Sum the pro-rated counts of the cells */
+	for (j = 0; j < tsize; j++)
+	{
+		if (tratios[j] == 0.0)
+			continue;
+		for (i = 0; i < xsize; i++)
+			total_count += hist->value[j * xsize + i] * xratios[i] * tratios[j];
+	}
+	selec = total_count / hist->features;
+
+	/* All the operators are strict */
+	selec *= 1.0 - ((Form_pg_statistic) GETSTRUCT(vardata->statsTuple))->stanullfrac;
+
+	pfree(xratios); pfree(tratios);
+	free_attstatsslot(&sslot);
+	CLAMP_PROBABILITY(selec);
+	return selec;
+}
+
 /*
  * Returns a default selectivity estimate for given operator, when we don't
  * have statistics or cannot use them for some reason.
@@ -956,6 +1081,14 @@ tnumbers_sel(PlannerInfo *root, VariableStatData *vardata, TBOX *box,
 	double selec;
 	Oid rangetypid, value_oprid, period_oprid;
 
+	/* 
+	 * Use the joint histogram of the value and time dimensions for the 
+	 * operators that it supports, if it is available
+	 */
+	selec = calc_tbox_hist_selectivity(vardata, box, cachedOp);
+	if (selec >= 0.0)
+		return selec;
+
 	/* Enable the multiplication of the selectivity of the value and time 
 	 * dimensions since either may be missing */
 	selec = 1.0; 
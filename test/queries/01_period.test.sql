@@ -82,6 +82,10 @@ SELECT shift(period '[2000-01-01,2000-01-02)', '5 min');
 SELECT shift(period '(2000-01-01,2000-01-02)', '5 min');
 
 SELECT period_cmp('[2000-01-01,2000-01-01]', '(2000-01-01,2000-01-02)');
+SELECT array_agg(p ORDER BY p) FROM (VALUES (period '(2000-01-01,2000-01-03]'), ('[2000-01-02,2000-01-03]'), ('[2000-01-01,2000-01-02]'), ('[2000-01-01,2000-01-03]')) t(p);
+SELECT count(*) FROM (SELECT p, lag(p) OVER (ORDER BY p) AS prev FROM (SELECT period(d, d + (i % 7 + 1) * interval '1 hour', i % 3 = 0, true) AS p FROM (SELECT i, timestamptz '2000-01-01' + (i % 100) * interval '1 day' AS d FROM generate_series(1, 20000) i) t0) t1) t2 WHERE prev > p;
+SELECT (array_agg(p ORDER BY p))[1] FROM (SELECT period(d, d + (i % 7 + 1) * interval '1 hour', i % 3 = 0, true) AS p FROM (SELECT i, timestamptz '2000-01-01' + (i % 100) * interval '1 day' AS d FROM generate_series(1, 20000) i) t0) t1;
+SELECT (array_agg(p ORDER BY p))[20000] FROM (SELECT period(d, d + (i % 7 + 1) * interval '1 hour', i % 3 = 0, true) AS p FROM (SELECT i, timestamptz '2000-01-01' + (i % 100) * interval '1 day' AS d FROM generate_series(1, 20000) i) t0) t1;
 SELECT period '[2000-01-01,2000-01-01]' = period '(2000-01-01,2000-01-02)';
 SELECT period '[2000-01-01,2000-01-01]' <> period '(2000-01-01,2000-01-02)';
 SELECT period '[2000-01-01,2000-01-01]' < period '(2000-01-01,2000-01-02)';
@@ -132,6 +132,9 @@ SELECT shift(periodset '{(2000-01-01,2000-01-02),(2000-01-03,2000-01-04),(2000-0
 SELECT shift(periodset '{[2000-01-01,2000-01-02),(2000-01-03,2000-01-04),(2000-01-05,2000-01-06]}', '5 min');
 
 SELECT periodset_cmp(periodset '{[2000-01-01,2000-01-01]}', periodset '{(2000-01-01,2000-01-02),(2000-01-02,2000-01-03),(2000-01-03,2000-01-04)}');
+SELECT count(*) FROM (SELECT ps, lag(ps) OVER (ORDER BY ps) AS prev FROM (SELECT periodset(CASE WHEN i % 3 = 0 THEN ARRAY[period(d, d + interval '1 hour')] ELSE ARRAY[period(d, d + interval '1 hour'), period(d + interval '2 hours', d + (i % 7 + 3) * interval '1 hour')] END) AS ps FROM (SELECT i, timestamptz '2000-01-01' + (i % 100) * interval '1 day' AS d FROM generate_series(1, 20000) i) t0) t1) t2 WHERE prev > ps;
+SELECT (array_agg(ps ORDER BY ps))[1] FROM (SELECT periodset(CASE WHEN i % 3 = 0 THEN ARRAY[period(d, d + interval '1 hour')] ELSE ARRAY[period(d, d + interval '1 hour'), period(d + interval '2 hours', d + (i % 7 + 3) * interval '1 hour')] END) AS ps FROM (SELECT i, timestamptz '2000-01-01' + (i % 100) * interval '1 day' AS d FROM generate_series(1, 20000) i) t0) t1;
+SELECT (array_agg(ps ORDER BY ps))[20000] FROM (SELECT periodset(CASE WHEN i % 3 = 0 THEN ARRAY[period(d, d + interval '1 hour')] ELSE ARRAY[period(d, d + interval '1 hour'), period(d + interval '2 hours', d + (i % 7 + 3) * interval '1 hour')] END) AS ps FROM (SELECT i, timestamptz '2000-01-01' + (i % 100) * interval '1 day' AS d FROM generate_series(1, 20000) i) t0) t1;
 SELECT periodset '{[2000-01-01,2000-01-01]}' = periodset '{(2000-01-01,2000-01-02),(2000-01-02,2000-01-03),(2000-01-03,2000-01-04)}';
 SELECT periodset '{[2000-01-01,2000-01-01]}' <> periodset '{(2000-01-01,2000-01-02),(2000-01-02,2000-01-03),(2000-01-03,2000-01-04)}';
 SELECT periodset '{[2000-01-01,2000-01-01]}' < periodset '{(2000-01-01,2000-01-02),(2000-01-02,2000-01-03),(2000-01-03,2000-01-04)}';
@@ -140,4 +140,29 @@ SELECT NULL::period UNION SELECT NULL::period;
 ANALYZE tbl_period_test;
 DROP TABLE tbl_period_test;
 
+-------------------------------------------------------------------------------
+
+SELECT hilbertKey(period '[2000-01-01, 2000-01-01]', period '[2000-01-01, 2000-01-02]');
+SELECT hilbertKey(period '[2000-01-02, 2000-01-02]', period '[2000-01-01, 2000-01-02]');
+
+-------------------------------------------------------------------------------
+
+SELECT hilbertKey(tbox 'TBOX((1, 2000-01-01), (1, 2000-01-01))', tbox 'TBOX((1, 2000-01-01), (2, 2000-01-02))');
+SELECT hilbertKey(tbox 'TBOX((2, 2000-01-02), (2, 2000-01-02))', tbox 'TBOX((1, 2000-01-01), (2, 2000-01-02))');
+SELECT hilbertKey(tbox 'TBOX((1, 2000-01-01), (2, 2000-01-02))', tbox 'TBOX((1, 2000-01-01), (2, 2000-01-02))');
+SELECT hilbertKey(tbox 'TBOX((1.5,), (1.5,))', tbox 'TBOX((1, 2000-01-01), (2, 2000-01-02))');
+SELECT hilbertKey(tbox 'TBOX((1, 2000-01-01), (2, 2000-01-02))', tbox 'TBOX((1, 2000-01-01), (1, 2000-01-01))');
+SELECT hilbertKey(NULL::tbox, tbox 'TBOX((1, 2000-01-01), (2, 2000-01-02))');
+SELECT hilbertKey(tint '[1@2000-01-01, 2@2000-01-02]', tbox 'TBOX((1, 2000-01-01), (2, 2000-01-02))');
+SELECT hilbertKey(tfloat '[1@2000-01-01, 1.5@2000-01-01 12:00:00]', tbox 'TBOX((1, 2000-01-01), (2, 2000-01-02))');
+SELECT hilbertKey(NULL::tfloat, tbox 'TBOX((1, 2000-01-01), (2, 2000-01-02))');
+
+SELECT hilbertKey(stbox 'STBOX T((1, 1, 2000-01-01), (1, 1, 2000-01-01))', stbox 'STBOX T((1, 1, 2000-01-01), (2, 2, 2000-01-02))');
+SELECT hilbertKey(stbox 'STBOX T((2, 2, 2000-01-02), (2, 2, 2000-01-02))', stbox 'STBOX T((1, 1, 2000-01-01), (2, 2, 2000-01-02))');
+SELECT hilbertKey(stbox 'STBOX((1.5, 1.5), (1.5, 1.5))', stbox 'STBOX T((1, 1, 2000-01-01), (2, 2, 2000-01-02))');
+SELECT hilbertKey(stbox 'STBOX T((1, 1, 2000-01-01), (2, 2, 2000-01-02))', stbox 'STBOX T((1, 1, 2000-01-01), (1, 1, 2000-01-01))');
+SELECT hilbertKey(NULL::stbox, stbox 'STBOX T((1, 1, 2000-01-01), (2, 2, 2000-01-02))');
+SELECT hilbertKey(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]', stbox 'STBOX T((1, 1, 2000-01-01), (2, 2, 2000-01-02))');
+SELECT hilbertKey(NULL::tgeompoint, stbox 'STBOX T((1, 1, 2000-01-01), (2, 2, 2000-01-02))');
+
 -------------------------------------------------------------------------------
\ No newline at end of file
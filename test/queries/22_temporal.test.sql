@@ -1056,6 +1056,22 @@ SELECT shift(ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}', '5 min');
 SELECT shift(ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]', '5 min');
 SELECT shift(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}', '5 min');
 
+SELECT resample(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-04}', '2 days');
+SELECT resample(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]', '1 day 12 hours');
+SELECT resample(tfloat '[1@2000-01-01, 3@2000-01-03]', '12 hours');
+SELECT resample(tfloat '(1@2000-01-01, 3@2000-01-03)', '1 day');
+SELECT resample(tfloat '{[1@2000-01-01, 3@2000-01-03],[5@2000-01-05, 5@2000-01-06)}', '1 day');
+SELECT resample(ttext 'AAA@2000-01-01', '1 hour');
+SELECT tbucket, fragment FROM timeSplit(tint '[1@2000-01-01, 2@2000-01-03]', '1 day', '2000-01-01');
+SELECT tbucket, fragment FROM timeSplit(tfloat '[1@2000-01-01, 3@2000-01-03)', '1 day', '2000-01-01');
+SELECT tbucket, fragment FROM timeSplit(tbool '{t@2000-01-01, f@2000-01-03}', '1 day', '2000-01-01');
+
+SELECT simplify(tfloat '{1@2000-01-01, 1.2@2000-01-02}', 0.5);
+SELECT simplify(tfloat '[1@2000-01-01, 1.2@2000-01-02, 1@2000-01-03, 4@2000-01-04, 1@2000-01-05]', 0.5);
+SELECT simplify(tfloat '[1@2000-01-01, 1.2@2000-01-02, 1@2000-01-03, 4@2000-01-04, 1@2000-01-05]', 0.5, true);
+SELECT simplify(tfloat 'Interp=Stepwise;[1@2000-01-01, 1.2@2000-01-02, 1@2000-01-03, 4@2000-01-04, 1@2000-01-05]', 0.5);
+SELECT simplify(tfloat '{[1@2000-01-01, 1.2@2000-01-02, 1@2000-01-03],[3@2000-01-04, 3@2000-01-05]}', 0.5);
+
 -------------------------------------------------------------------------------
 -- Ever/always comparison functions
 -------------------------------------------------------------------------------
@@ -1586,6 +1602,14 @@ SELECT valueAtTimestamp(ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}'
 SELECT valueAtTimestamp(ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]', timestamptz '2000-01-01');
 SELECT valueAtTimestamp(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}', timestamptz '2000-01-01');
 
+SELECT valueAtTimestamps(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}', ARRAY[timestamptz '2000-01-01', '2000-01-02', '2000-01-04']);
+SELECT valueAtTimestamps(tint '{[1@2000-01-01, 2@2000-01-02, 1@2000-01-03],[3@2000-01-04, 3@2000-01-05]}', ARRAY[timestamptz '2000-01-01', '2000-01-02 12:00', '2000-01-03 12:00', '2000-01-05']);
+SELECT valueAtTimestamps(tfloat '[1.5@2000-01-01, 2.5@2000-01-03, 1.5@2000-01-05]', ARRAY[timestamptz '2000-01-01', '2000-01-02', '2000-01-04', '2000-01-06']);
+SELECT valueAtTimestamps(tfloat 'Interp=Stepwise;[1.5@2000-01-01, 2.5@2000-01-03, 1.5@2000-01-05]', ARRAY[timestamptz '2000-01-01', '2000-01-02', '2000-01-04', '2000-01-06']);
+SELECT valueAtTimestamps(tfloat '{[1.5@2000-01-01, 2.5@2000-01-03, 1.5@2000-01-05],[3.5@2000-01-06, 3.5@2000-01-07]}', timestampset '{2000-01-02, 2000-01-05, 2000-01-06}');
+SELECT valueAtTimestamps(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}', timestampset '{2000-01-01, 2000-01-04}');
+SELECT valueAtTimestamps(tint '[1@2000-01-01, 2@2000-01-02]', timestampset '{2000-01-03, 2000-01-04}');
+
 SELECT minusTimestamp(tbool 't@2000-01-01', timestamptz '2000-01-01');
 SELECT minusTimestamp(tbool '{t@2000-01-01}', timestamptz '2000-01-01');
 SELECT minusTimestamp(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}', timestamptz '2000-01-01');
@@ -1928,6 +1952,7 @@ SELECT tbool_cmp(tbool 't@2000-01-01', tbool '{[t@2000-01-01, f@2000-01-02, t@20
 SELECT tbool_cmp(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}', tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@2000-01-05]}');
 SELECT tbool_cmp(tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]', tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@2000-01-05]}');
 SELECT tbool_cmp(tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@2000-01-05]}', tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@2000-01-05]}');
+SELECT array_agg(t::text ORDER BY t) FROM (VALUES (tint '1@2000-01-02'), ('1@2000-01-01'), ('0@2000-01-03'), ('2@2000-01-01')) v(t);
 
 -------------------------------------------------------------------------------
 
@@ -2309,5 +2334,18 @@ SELECT ttext_hash(ttext 'AAA@2000-01-01');
 SELECT ttext_hash(ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}');
 SELECT ttext_hash(ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]');
 SELECT ttext_hash(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}');
+SELECT tfloat_hash(tfloat '{1@2000-01-01, 1@2000-01-02}') = tfloat_hash(tfloat '{[1@2000-01-01], [1@2000-01-02]}');
+SELECT (tint_hash_extended(tint '[1@2000-01-01, 2@2000-01-02]', 0) & 4294967295) = (tint_hash(tint '[1@2000-01-01, 2@2000-01-02]') & 4294967295);
+SELECT tint_hash_extended(tint '[1@2000-01-01, 2@2000-01-02]', 1) <> tint_hash_extended(tint '[1@2000-01-01, 2@2000-01-02]', 0);
+
+------------------------------------------------------------------------------
+
+-- Long sequences with block bounding boxes
+
+SELECT numInstants(temp) FROM (SELECT tfloatseq(array_agg(tfloatinst((i + (i % 2) * 0.5)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(0, 199) i) t;
+SELECT temp ?= 150.25 FROM (SELECT tfloatseq(array_agg(tfloatinst((i + (i % 2) * 0.5)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(0, 199) i) t;
+SELECT temp ?= 127.75 FROM (SELECT tfloatseq(array_agg(tfloatinst((i + (i % 2) * 0.5)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(0, 199) i) t;
+SELECT temp ?= 300.0 FROM (SELECT tfloatseq(array_agg(tfloatinst((i + (i % 2) * 0.5)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(0, 199) i) t;
+SELECT atRange(temp, floatrange '[150,151]') FROM (SELECT tfloatseq(array_agg(tfloatinst((i + (i % 2) * 0.5)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(0, 199) i) t;
 
 ------------------------------------------------------------------------------
@@ -628,3 +628,49 @@ SELECT COUNT(*) FROM tbl_ttext t1, tbl_ttext t2
 WHERE t1.temp >= t2.temp;
 
 ------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Partial detoasting of values stored out of line without compression
+
+DROP TABLE IF EXISTS tbl_tfloats_external;
+CREATE TABLE tbl_tfloats_external(k int, temp tfloat);
+ALTER TABLE tbl_tfloats_external ALTER COLUMN temp SET STORAGE EXTERNAL;
+INSERT INTO tbl_tfloats_external
+SELECT 1, tfloats(array_agg(tfloatseq(ARRAY[
+	tfloatinst(i, timestamptz '2000-01-01' + i * interval '2 hours'),
+	tfloatinst(i + 1, timestamptz '2000-01-01 01:00' + i * interval '2 hours')]) ORDER BY i))
+FROM generate_series(1, 1000) i;
+
+SELECT temp && period '[2000-01-03, 2000-01-04]' FROM tbl_tfloats_external;
+SELECT temp @> period '[2000-01-01 02:00, 2000-01-01 03:00]' FROM tbl_tfloats_external;
+SELECT temp && floatrange '[1000.5, 1001]' FROM tbl_tfloats_external;
+SELECT temp @> floatrange '[0, 1]' FROM tbl_tfloats_external;
+SELECT atPeriod(temp, period '[2000-01-05, 2000-01-06]') =
+	atPeriod(tfloats(sequences(temp)), period '[2000-01-05, 2000-01-06]')
+FROM tbl_tfloats_external;
+SELECT atPeriod(temp, period '[2000-01-01 03:30, 2000-01-01 03:45]') IS NULL FROM tbl_tfloats_external;
+SELECT atPeriod(temp, period '[1999-01-01, 1999-01-02]') IS NULL FROM tbl_tfloats_external;
+SELECT atTimestamp(temp, timestamptz '2000-01-01 02:30') FROM tbl_tfloats_external;
+SELECT valueAtTimestamp(temp, timestamptz '2000-01-01 03:30') IS NULL FROM tbl_tfloats_external;
+
+DROP TABLE tbl_tfloats_external;
+
+DROP TABLE IF EXISTS tbl_tint_external;
+CREATE TABLE tbl_tint_external(k int, temp tint);
+ALTER TABLE tbl_tint_external ALTER COLUMN temp SET STORAGE EXTERNAL;
+INSERT INTO tbl_tint_external
+SELECT 1, tintseq(array_agg(tintinst(i, timestamptz '2000-01-01' + i * interval '1 hour') ORDER BY i))
+FROM generate_series(1, 1000) i;
+INSERT INTO tbl_tint_external
+SELECT 2, tinti(array_agg(tintinst(i, timestamptz '2000-01-01' + i * interval '1 hour') ORDER BY i))
+FROM generate_series(1, 1000) i;
+
+SELECT k, temp && period '[2000-01-02, 2000-01-03]' FROM tbl_tint_external ORDER BY k;
+SELECT k, temp @> period '[2000-01-01 02:00, 2000-01-01 03:00]' FROM tbl_tint_external ORDER BY k;
+SELECT k, atTimestamp(temp, timestamptz '2000-01-01 05:00') FROM tbl_tint_external ORDER BY k;
+SELECT k, valueAtTimestamps(temp, ARRAY[timestamptz '2000-01-01 05:30', '2000-01-01 10:00']) FROM tbl_tint_external ORDER BY k;
+SELECT atPeriod(temp, period '[2000-01-01 05:00, 2000-01-01 07:00]') FROM tbl_tint_external WHERE k = 1;
+
+DROP TABLE tbl_tint_external;
+
+------------------------------------------------------------------------------
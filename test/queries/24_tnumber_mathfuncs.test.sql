@@ -468,3 +468,19 @@ SELECT round(degrees(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]'),
 SELECT round(degrees(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}'), 1);
 
 -------------------------------------------------------------------------------
+
+SELECT teval('a + b', tfloat '[1@2000-01-01, 3@2000-01-03]', tfloat '[2@2000-01-02, 0@2000-01-04]');
+SELECT teval('(a - b) * (a - b)', tfloat '[0@2000-01-01, 2@2000-01-03]', tfloat '[2@2000-01-01, 0@2000-01-03]');
+SELECT tevalBool('a > b', tfloat '[0@2000-01-01, 2@2000-01-03]', tfloat '[2@2000-01-01, 0@2000-01-03]');
+SELECT teval('a * b', tfloat '{1@2000-01-01, 2@2000-01-02}', tfloat '[1@2000-01-01, 2@2000-01-03]');
+SELECT teval('a + b', tfloat '{[1@2000-01-01, 2@2000-01-02), [5@2000-01-02, 6@2000-01-03]}', tfloat '[0@2000-01-01, 0@2000-01-03]');
+SELECT teval('a * b', tfloat '{[1@2000-01-01, 3@2000-01-03], [3@2000-01-04, 5@2000-01-06]}', tfloat '[2@2000-01-02, 2@2000-01-05]');
+SELECT teval('a + b', tfloat 'Interp=Stepwise;{[1@2000-01-01, 2@2000-01-02), [5@2000-01-02, 6@2000-01-03]}', tfloat 'Interp=Stepwise;[0@2000-01-01, 1@2000-01-03]');
+SELECT tevalBool('a > b', tfloat '{[1@2000-01-01, 2@2000-01-02), [5@2000-01-02, 6@2000-01-03]}', tfloat '[3@2000-01-01, 3@2000-01-03]');
+
+/* Errors */
+SELECT teval('a / b', tfloat '[1@2000-01-01, 2@2000-01-02]', tfloat '[-1@2000-01-01, 1@2000-01-02]');
+SELECT teval('a > b', tfloat '[1@2000-01-01, 2@2000-01-02]', tfloat '[-1@2000-01-01, 1@2000-01-02]');
+SELECT teval('a + c', tfloat '[1@2000-01-01, 2@2000-01-02]', tfloat '[-1@2000-01-01, 1@2000-01-02]');
+
+-------------------------------------------------------------------------------
@@ -78,3 +78,14 @@ SELECT ~ tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@200
 
 -------------------------------------------------------------------------------
 
+SELECT tbool '{[t@2000-01-01, t@2000-01-02), [f@2000-01-02, f@2000-01-03]}' & tbool '[f@2000-01-01, f@2000-01-03]';
+SELECT tbool '{[t@2000-01-01, t@2000-01-02), [t@2000-01-03, t@2000-01-04]}' | tbool '{[f@2000-01-01, t@2000-01-02, t@2000-01-04]}';
+
+SELECT whenTrue(tbool 't@2000-01-01');
+SELECT whenTrue(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}');
+SELECT whenTrue(tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]');
+SELECT whenTrue(tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@2000-01-05]}');
+SELECT whenTrue(tbool '[f@2000-01-01, f@2000-01-02]');
+SELECT whenTrue(tfloat '[1@2000-01-01, 3@2000-01-03]' #> 2);
+
+-------------------------------------------------------------------------------
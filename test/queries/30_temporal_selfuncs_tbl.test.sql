@@ -5166,3 +5166,35 @@ END;
 $$ LANGUAGE 'plpgsql';
 
 -------------------------------------------------------------------------------
+
+-- Estimates of the bounding box operators with the value-time histogram
+
+CREATE FUNCTION estimate_within(query text, factor float)
+RETURNS boolean AS $$
+DECLARE
+	J XML;
+	PlanRows float;
+	ActualRows float;
+BEGIN
+	EXECUTE 'EXPLAIN (ANALYZE, FORMAT XML) ' || query INTO J;
+	PlanRows:= (xpath('/n:explain/n:Query/n:Plan/n:Plan-Rows/text()', J, '{{n,http://www.postgresql.org/2009/explain}}'))[1]::text::float;
+	ActualRows:= (xpath('/n:explain/n:Query/n:Plan/n:Actual-Rows/text()', J, '{{n,http://www.postgresql.org/2009/explain}}'))[1]::text::float;
+	RETURN PlanRows BETWEEN ActualRows / factor AND ActualRows * factor;
+END;
+$$ LANGUAGE plpgsql;
+CREATE TABLE tbl_tint_selfuncs AS
+SELECT k, tintseq(ARRAY[tintinst(k % 100, timestamptz '2000-01-01' + k * interval '1 hour'),
+	tintinst(k % 100 + 10, timestamptz '2000-01-01' + (k + 10) * interval '1 hour')]) AS temp
+FROM generate_series(1, 1000) k;
+ANALYZE tbl_tint_selfuncs;
+
+SELECT estimate_within('SELECT * FROM tbl_tint_selfuncs WHERE temp && tbox ''TBOX((0, 2000-01-01), (60, 2000-01-21))''', 2);
+SELECT estimate_within('SELECT * FROM tbl_tint_selfuncs WHERE temp <@ tbox ''TBOX((0, 2000-01-01), (60, 2000-01-21))''', 2);
+SELECT estimate_within('SELECT * FROM tbl_tint_selfuncs WHERE temp @> tbox ''TBOX((45,), (47,))''', 2);
+SELECT estimate_within('SELECT * FROM tbl_tint_selfuncs WHERE temp << tbox ''TBOX((30,), (30,))''', 2);
+SELECT estimate_within('SELECT * FROM tbl_tint_selfuncs WHERE temp #>> tbox ''TBOX((, 2000-01-21), (, 2000-01-21))''', 2);
+
+DROP TABLE tbl_tint_selfuncs;
+DROP FUNCTION estimate_within(text, float);
+
+-------------------------------------------------------------------------------
@@ -154,6 +154,90 @@ SELECT round(tavg(temp), 6) FROM (VALUES
 
 --------------------------------------------------
 
+SELECT tcount_bins(temp, '2000-01-01', '1 day') FROM (VALUES
+(tint '[1@2000-01-01, 3@2000-01-03]'),
+(tint '{2@2000-01-02, 4@2000-01-04}')) t(temp);
+SELECT tsum_bins(temp, '2000-01-01', '1 day') FROM (VALUES
+(tint '[1@2000-01-01, 3@2000-01-03]'),
+(tint '{2@2000-01-02, 4@2000-01-04}')) t(temp);
+SELECT tavg_bins(temp, '2000-01-01', '1 day') FROM (VALUES
+(tint '[1@2000-01-01, 3@2000-01-03]'),
+(tint '{2@2000-01-02, 4@2000-01-04}')) t(temp);
+SELECT tavg_bins(temp, '2000-01-01', '1 day') FROM (VALUES
+(tfloat '[0@2000-01-01, 4@2000-01-03)'),
+(tfloat '10@1999-12-31 12:00:00')) t(temp);
+
+/* Aggregation exceeding work_mem */
+SET work_mem = '64kB';
+SELECT numInstants(temp), maxValue(temp) FROM (SELECT tcount(inst) AS temp FROM (SELECT tintinst(1, timestamptz '2000-01-01' + (i % 1000) * interval '1 minute') AS inst FROM generate_series(1, 2000) i) t) t;
+SELECT numSequences(temp), maxValue(temp) FROM (SELECT tsum(tintseq(ARRAY[tintinst(1, t), tintinst(1, t + interval '30 seconds')])) AS temp FROM (SELECT timestamptz '2000-01-01' + (i % 1000) * interval '1 minute' AS t FROM generate_series(1, 2000) i) t) t;
+RESET work_mem;
+
+/* Aggregation spilling overlapping runs to disk */
+CREATE FUNCTION temp_written(query text)
+RETURNS boolean AS $$
+DECLARE
+	J XML;
+BEGIN
+	EXECUTE 'EXPLAIN (ANALYZE, BUFFERS, FORMAT XML) ' || query INTO J;
+	RETURN (xpath('/n:explain/n:Query/n:Plan/n:Temp-Written-Blocks/text()', J,
+		'{{n,http://www.postgresql.org/2009/explain}}'))[1]::text::int > 0;
+END;
+$$ LANGUAGE plpgsql;
+CREATE TABLE tbl_tint_spill AS
+SELECT i, tintseq(ARRAY[tintinst(i % 3, t), tintinst(i % 3, t + interval '90 minutes')], true, false) AS seq
+FROM (SELECT i, timestamptz '2000-01-01' + (i % 1000) * interval '1 hour' + (i / 1000) * interval '30 minutes' AS t
+FROM generate_series(0, 1999) i) t;
+CREATE TABLE tbl_tint_spill_ref AS
+SELECT tcount(seq) AS count, tsum(seq) AS sum, tavg(seq) AS avg FROM tbl_tint_spill;
+SELECT temp_written('SELECT tcount(seq) FROM tbl_tint_spill');
+
+SET work_mem = '64kB';
+SELECT temp_written('SELECT tcount(seq) FROM tbl_tint_spill');
+SELECT temp_written('SELECT tavg(seq) FROM tbl_tint_spill');
+SELECT tcount(seq) = (SELECT count FROM tbl_tint_spill_ref) FROM tbl_tint_spill;
+SELECT tsum(seq) = (SELECT sum FROM tbl_tint_spill_ref) FROM tbl_tint_spill;
+SELECT tavg(seq) = (SELECT avg FROM tbl_tint_spill_ref) FROM tbl_tint_spill;
+
+/* The final function does not prevent the window aggregate from spilling */
+SELECT temp_written('SELECT tcount(tintseq(ARRAY[tintinst(1, t), tintinst(1, t + interval ''90 minutes'')], true, false)) OVER (ORDER BY i) FROM (SELECT i, timestamptz ''2000-01-01'' + i * interval ''1 hour'' AS t FROM generate_series(0, 399) i) t');
+SELECT count(*) FROM (SELECT i, tcount(seq) OVER (ORDER BY i) AS count FROM tbl_tint_spill WHERE i < 400) t
+WHERE i = 399 AND count = (SELECT tcount(seq) FROM tbl_tint_spill WHERE i < 400);
+
+/* Combine and serialize spilled states */
+CREATE FUNCTION partial_agg(query text)
+RETURNS boolean AS $$
+DECLARE
+	J XML;
+BEGIN
+	EXECUTE 'EXPLAIN (FORMAT XML) ' || query INTO J;
+	RETURN xpath_exists('//n:Partial-Mode[text()="Partial"]', J,
+		'{{n,http://www.postgresql.org/2009/explain}}');
+END;
+$$ LANGUAGE plpgsql;
+SET parallel_setup_cost = 0;
+SET parallel_tuple_cost = 0;
+SET min_parallel_table_scan_size = 0;
+SET max_parallel_workers_per_gather = 2;
+SET force_parallel_mode = on;
+SELECT partial_agg('SELECT tcount(seq) FROM tbl_tint_spill');
+SELECT partial_agg('SELECT tavg(seq) FROM tbl_tint_spill');
+SELECT temp_written('SELECT tcount(seq) FROM tbl_tint_spill');
+SELECT tcount(seq) = (SELECT count FROM tbl_tint_spill_ref) FROM tbl_tint_spill;
+SELECT tsum(seq) = (SELECT sum FROM tbl_tint_spill_ref) FROM tbl_tint_spill;
+SELECT tavg(seq) = (SELECT avg FROM tbl_tint_spill_ref) FROM tbl_tint_spill;
+RESET force_parallel_mode;
+RESET max_parallel_workers_per_gather;
+RESET min_parallel_table_scan_size;
+RESET parallel_tuple_cost;
+RESET parallel_setup_cost;
+RESET work_mem;
+
+DROP TABLE tbl_tint_spill;
+DROP TABLE tbl_tint_spill_ref;
+DROP FUNCTION temp_written(text);
+DROP FUNCTION partial_agg(text);
+
 /* Errors */
 SELECT tsum(temp) FROM ( VALUES
 (tfloat '[1@2000-01-01, 2@2000-01-02]'), 
@@ -164,5 +248,7 @@ SELECT tsum(temp) FROM ( VALUES
 SELECT tsum(temp) FROM (VALUES
 ('Interp=Stepwise;[1@2000-01-01, 2@2000-01-03, 1@2000-01-05, 2@2000-01-07]'::tfloat), 
 ('[3@2000-01-02, 4@2000-01-06]'::tfloat)) t(temp);
+SELECT tcount_bins(temp, '2000-01-01', '1 month') FROM (VALUES
+(tint '[1@2000-01-01, 3@2000-01-03]')) t(temp);
 
 --------------------------------------------------